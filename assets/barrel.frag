@@ -22,6 +22,7 @@ layout(std140, binding = 0) uniform camera
     mat4 view;
     mat4 projection;
     vec3 eye;
+    mat3 view_normal;
 };
 
 struct PointLight
@@ -60,8 +61,10 @@ vec3 calc_point(int index)
     vec3 point_color = points[index].point_color;
     vec3 attenuation = points[index].attenuation;
 
-    vec3 n = texture(tex2, tex_coord).rgb;
-    n = (n * 2.0) - 1.0;
+    // normal maps only store x and y (BC5), rebuild z
+    vec3 n;
+    n.xy = (texture(tex2, tex_coord).rg * 2.0) - 1.0;
+    n.z = sqrt(max(1.0 - dot(n.xy, n.xy), 0.0));
     n = normalize(tbn * n);
 
     float dist = length(point_light - frag_position.xyz);
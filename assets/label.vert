@@ -7,17 +7,19 @@ layout(location = 3) in vec2 in_uv;
 
 out vec2 tex_coord;
 
-uniform mat4 model;
+// rows of the affine model matrix
+uniform mat3x4 model;
 
 layout(std140, binding = 0) uniform camera
 {
     mat4 view;
     mat4 projection;
     vec3 eye;
+    mat3 view_normal;
 };
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(in_position, 1.0);
+    gl_Position = projection * view * vec4(vec4(in_position, 1.0) * model, 1.0);
     tex_coord = vec2(in_uv.x, -in_uv.y);
 }
@@ -10,6 +10,7 @@ layout(std140, binding = 0) uniform camera
     mat4 view;
     mat4 projection;
     vec3 eye;
+    mat3 view_normal;
 };
 
 void main()
@@ -12,27 +12,58 @@ out vec2 tex_coord;
 out vec4 frag_position;
 out mat3 tbn;
 
-uniform mat4 model;
+// rows of the affine model matrix, vec4(p, 1.0) * model transforms a point
+uniform mat3x4 model;
+// inverse transpose of the rotation and scale of model, computed once per entity
+uniform mat3 normal_matrix;
+
+// meshes packed with compact vertices store snorm positions and octahedral normal/tangent
+uniform bool compact_vertices;
+uniform vec3 position_scale;
+uniform vec3 position_bias;
 
 layout(std140, binding = 0) uniform camera
 {
     mat4 view;
     mat4 projection;
     vec3 eye;
+    mat3 view_normal;
 };
 
+vec3 decode_octahedral(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-v.z, 0.0);
+    v.x += v.x >= 0.0 ? -t : t;
+    v.y += v.y >= 0.0 ? -t : t;
+    return normalize(v);
+}
+
 void main()
 {
-    gl_Position = projection * view * model * vec4(in_position, 1.0);
-    normal = normalize(transpose(inverse(mat3(model))) * in_normal);
-    normal_view = normalize(transpose(inverse(mat3(view))) * in_normal);
+    vec3 position = in_position;
+    vec3 object_normal = in_normal;
+    vec3 object_tangent = in_tangent;
+
+    if (compact_vertices)
+    {
+        position = position_bias + position_scale * in_position;
+        object_normal = decode_octahedral(in_normal.xy);
+        object_tangent = decode_octahedral(in_tangent.xy);
+    }
+
+    vec3 world_position = vec4(position, 1.0) * model;
+
+    gl_Position = projection * view * vec4(world_position, 1.0);
+    normal = normalize(normal_matrix * object_normal);
+    normal_view = normalize(view_normal * object_normal);
     tex_coord = in_uv;
 
-    vec3 t = normalize(vec3(model * vec4(in_tangent, 0.0)));
-    vec3 n = normalize(vec3(model * vec4(in_normal, 0.0)));
+    vec3 t = normalize(vec4(object_tangent, 0.0) * model);
+    vec3 n = normalize(vec4(object_normal, 0.0) * model);
     vec3 b = cross(n, t);
     tbn = mat3(t,b,n);
 
-    frag_position = model * vec4(in_position, 1.0);
+    frag_position = vec4(world_position, 1.0);
     view_position = view * frag_position;
 }
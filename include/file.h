@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <limits>
 #include <memory>
 #include <ranges>
 #include <string_view>
@@ -11,7 +12,6 @@
 #ifdef WIN32
 #include <Windows.h>
 #else
-#include <limits>
 #include <sys/mman.h>
 #endif
 
@@ -26,6 +26,23 @@ namespace game
         CREATE
     };
 
+    /**
+     * How a mapped file is going to be read, passed on to the OS as a hint.
+     */
+    enum class AccessHint
+    {
+        NORMAL,
+
+        /** Read front to back once, read ahead aggressively and drop pages behind the reader. */
+        SEQUENTIAL,
+
+        /** Read in no particular order, read ahead would only waste memory. */
+        RANDOM,
+
+        /** Read soon, start reading it in now in the background. */
+        WILL_NEED,
+    };
+
     class File
     {
     public:
@@ -33,6 +50,21 @@ namespace game
         auto as_string() const -> std::string_view;
         auto as_bytes() const -> std::span<const std::byte>;
 
+        /**
+         * Give the OS a hint on how a range of the file is going to be read. Hints are best effort, a hint the
+         * platform does not support is ignored.
+         *
+         * @param hint
+         *   How the range is going to be read.
+         *
+         * @param offset
+         *   Start of the range in bytes.
+         *
+         * @param length
+         *   Length of the range in bytes, clamped to the end of the file.
+         */
+        auto advise(AccessHint hint, std::size_t offset = 0u, std::size_t length = std::numeric_limits<std::size_t>::max()) const -> void;
+
         template <class T>
         auto write(const T &data) -> void
             requires(sizeof(std::ranges::range_value_t<T>) == 1)
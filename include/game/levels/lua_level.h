@@ -43,6 +43,7 @@ namespace game::levels
         LuaLevel(
             PhysicsSystem &ps,
             const ScriptLoader &loader,
+            std::string_view script,
             DefaultCache &resource_cache,
             const ResourceLoader &resource_loader,
             const TlvReader &reader,
@@ -1,17 +1,24 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "game/levels/lua_level.h"
 #include "game/player.h"
 #include "game/routines/routine_base.h"
+#include "graphics/texture.h"
+#include "graphics/texture_streamer.h"
+#include "math/frustum_culler.h"
 #include "messaging/auto_subscribe.h"
 #include "messaging/message_bus.h"
 #include "messaging/subscriber.h"
 #include "physics/physics_sytem.h"
+#include "resources/async_resource_loader.h"
+#include "resources/pack_set.h"
 #include "resources/resource_cache.h"
 #include "scheduler/scheduler.h"
 #include "scheduler/task.h"
@@ -21,10 +28,17 @@
 
 namespace game::routines
 {
+    /**
+     * Runs the current level. A level with its own pack in the manifest gets that pack mounted and its meshes and
+     * textures cached when it is entered, both are released again when it is left. Released textures are only evicted
+     * once the texture budget of the cache is exceeded, so returning to a recent level does not upload them again.
+     * Packs of later levels are loaded and their textures streamed in the background so that switching levels does not
+     * stall a frame.
+     */
     class LevelRoutine : public RoutineBase
     {
     public:
-        LevelRoutine(PhysicsSystem &ps, const Window &window, messaging::MessageBus &bus, Scheduler &scheduler, DefaultCache &resource_cache, const TlvReader &reader, const ResourceLoader &resource_loader);
+        LevelRoutine(PhysicsSystem &ps, const Window &window, messaging::MessageBus &bus, Scheduler &scheduler, DefaultCache &resource_cache, PackSet &packs, const ResourceLoader &resource_loader, AsyncResourceLoader &async_loader, TextureStreamer &texture_streamer);
         ~LevelRoutine() override = default;
         LevelRoutine(const LevelRoutine &) = delete;
         auto operator=(const LevelRoutine &) -> LevelRoutine & = delete;
@@ -38,6 +52,10 @@ namespace game::routines
         virtual auto handle_level_complete(const std::string_view &name) -> void override;
 
     private:
+        auto load_level() -> void;
+        auto unload_level() -> void;
+        auto level_pack(std::size_t level_num) const -> std::optional<std::string>;
+
         PhysicsSystem &_ps;
         const Window &_window;
         Scheduler &_scheduler;
@@ -46,8 +64,27 @@ namespace game::routines
         std::vector<ScriptLoader> _level_names;
         DefaultCache &_resource_cache;
         const ResourceLoader &_resource_loader;
+        AsyncResourceLoader &_async_loader;
+        TextureStreamer &_texture_streamer;
+        PackSet &_packs;
         const TlvReader &_reader;
         std::unique_ptr<levels::LuaLevel> _level;
+
+        /** Pack of the current level and what was cached from it, empty if it only uses the base pack. */
+        std::optional<std::string> _level_pack;
+
+        /** Pack of the next level, loaded in the background before the current level is left. */
+        std::unique_ptr<Pack> _next_level_pack;
+
+        /** Script of the next level, read in the background like its pack. */
+        std::unique_ptr<std::string> _next_level_script;
+        std::vector<std::string> _level_meshes;
+        std::vector<ResourceRef<Texture>> _level_textures;
+
+        /** Bounding boxes of the scene and which of them are visible, refilled every frame. */
+        BoundsBatch _bounds;
+        std::vector<std::uint64_t> _visible;
+
         bool _show_physics_debug;
         bool _show_debug;
     };
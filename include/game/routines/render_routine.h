@@ -2,8 +2,10 @@
 
 #include "game/routines/routine_base.h"
 #include "graphics/debug_ui.h"
+#include "graphics/program_cache.h"
 #include "graphics/renderer.h"
 #include "graphics/shape_wireframe_renderer.h"
+#include "graphics/texture_streamer.h"
 #include "loaders/mesh_loader.h"
 #include "scheduler/scheduler.h"
 #include "scheduler/task.h"
@@ -15,7 +17,7 @@ namespace game::routines
     class RenderRoutine : public RoutineBase
     {
     public:
-        RenderRoutine(const Window &window, messaging::MessageBus &bus, Scheduler &scheduler, const TlvReader &reader, MeshLoader &mesh_loader, std::uint8_t samples = 1);
+        RenderRoutine(const Window &window, messaging::MessageBus &bus, Scheduler &scheduler, ProgramCache &program_cache, const TlvReader &reader, MeshLoader &mesh_loader, TextureStreamer &texture_streamer, std::uint8_t samples = 1);
         ~RenderRoutine() override = default;
         RenderRoutine(const RenderRoutine &) = delete;
         auto operator=(const RenderRoutine &) -> RenderRoutine & = delete;
@@ -31,6 +33,8 @@ namespace game::routines
     private:
         const Window &_window;
         Scheduler &_scheduler;
+        ProgramCache &_program_cache;
+        TextureStreamer &_texture_streamer;
         Renderer _renderer;
         ShapeWireframeRenderer _debug_wireframe_renderer;
         // DebugUi _debug_ui;
@@ -34,6 +34,14 @@ namespace game
         auto anisotropic_filter_samples() const -> std::uint8_t;
         auto set_anisotropic_filter_samples(std::uint8_t samples) -> void;
 
+        /** Texture quality tier, 0 is full resolution and every further tier halves it. */
+        auto texture_tier() const -> std::uint32_t;
+        auto set_texture_tier(std::uint32_t tier) -> void;
+
+        /** Video memory in MiB that cached textures may use before unreferenced level textures are evicted. */
+        auto texture_budget() const -> std::uint32_t;
+        auto set_texture_budget(std::uint32_t mib) -> void;
+
     private:
         Settings();
 
@@ -44,5 +52,7 @@ namespace game
         std::uint8_t _samples;
         bool _anisotropic_filtering;
         std::uint8_t _anisotropic_filter_samples;
+        std::uint32_t _texture_tier;
+        std::uint32_t _texture_budget;
     };
 }
\ No newline at end of file
@@ -17,6 +17,7 @@ namespace game
         auto write(std::span<const std::byte>, std::size_t offset) const -> void;
 
         auto native_handle() const -> ::GLuint;
+        auto size() const -> std::uint32_t;
 
     private:
         AutoRelease<::GLuint> _buffer;
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+namespace game
+{
+    /**
+     * Compact vertex layout chosen at pack time, 20 bytes instead of the 44 of VertexData.
+     *
+     * Positions are snorm16 relative to a per-mesh VertexQuantization, normal and tangent are octahedral encoded
+     * snorm16 and uvs are half floats.
+     */
+    struct CompactVertexData
+    {
+        /** snorm16 position, the fourth component is padding to keep the attribute 4 byte aligned. */
+        std::array<std::int16_t, 4u> position;
+        std::array<std::int16_t, 2u> normal;
+        std::array<std::int16_t, 2u> tangent;
+        std::array<std::uint16_t, 2u> uv;
+    };
+
+    static_assert(sizeof(CompactVertexData) == 20u);
+
+    /**
+     * Per-mesh dequantisation of compact positions: position = bias + scale * snorm.
+     */
+    struct VertexQuantization
+    {
+        Vector3 scale = {1.f};
+        Vector3 bias = {0.f};
+    };
+
+    /**
+     * Convert a float to an IEEE 754 half, rounding to nearest even. Values out of range become infinity.
+     *
+     * @param value
+     *   Value to convert.
+     *
+     * @returns
+     *   Bits of the half.
+     */
+    auto to_half(float value) -> std::uint16_t;
+
+    /**
+     * Convert an IEEE 754 half to a float.
+     *
+     * @param value
+     *   Bits of the half.
+     *
+     * @returns
+     *   Value as a float.
+     */
+    auto from_half(std::uint16_t value) -> float;
+
+    /**
+     * Convert a float in [-1, 1] to a snorm16, out of range values are clamped.
+     */
+    auto to_snorm16(float value) -> std::int16_t;
+
+    /**
+     * Convert a snorm16 to a float in [-1, 1] with the same rules as OpenGL.
+     */
+    auto from_snorm16(std::int16_t value) -> float;
+
+    /**
+     * Encode a unit vector by projecting it onto an octahedron and unfolding that into a square.
+     *
+     * @param value
+     *   Vector to encode, does not have to be normalised.
+     *
+     * @returns
+     *   Two snorm16 components.
+     */
+    auto encode_octahedral(const Vector3 &value) -> std::array<std::int16_t, 2u>;
+
+    /**
+     * Decode an octahedral encoded unit vector, inverse of encode_octahedral.
+     *
+     * @param value
+     *   Two snorm16 components.
+     *
+     * @returns
+     *   Normalised vector.
+     */
+    auto decode_octahedral(const std::array<std::int16_t, 2u> &value) -> Vector3;
+
+    /**
+     * Pack a vertex into the compact layout.
+     *
+     * @param vertex
+     *   Vertex to pack, its position must lie in the range described by quantization.
+     *
+     * @param quantization
+     *   Mesh quantisation.
+     *
+     * @returns
+     *   Compact vertex.
+     */
+    auto compact_vertex(const VertexData &vertex, const VertexQuantization &quantization) -> CompactVertexData;
+
+    /**
+     * Unpack a compact vertex, inverse of compact_vertex.
+     *
+     * @param vertex
+     *   Compact vertex.
+     *
+     * @param quantization
+     *   Mesh quantisation.
+     *
+     * @returns
+     *   Unpacked vertex.
+     */
+    auto expand_vertex(const CompactVertexData &vertex, const VertexQuantization &quantization) -> VertexData;
+
+    /**
+     * Unpack only the position of a compact vertex.
+     *
+     * @param vertex
+     *   Compact vertex.
+     *
+     * @param quantization
+     *   Mesh quantisation.
+     *
+     * @returns
+     *   Object space position.
+     */
+    auto expand_position(const CompactVertexData &vertex, const VertexQuantization &quantization) -> Vector3;
+}
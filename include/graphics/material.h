@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -9,13 +10,14 @@
 
 #include "cube_map.h"
 #include "graphics/color.h"
-#include "graphics/shader.h"
+#include "graphics/program_cache.h"
+#include "math/matrix3.h"
+#include "math/matrix3x4.h"
 #include "math/matrix4.h"
+#include "math/vector3.h"
 #include "opengl.h"
 #include "texture.h"
 #include "texture_sampler.h"
-#include "utils/auto_release.h"
-#include "utils/string_unordered_map.h"
 
 namespace game
 {
@@ -26,13 +28,62 @@ namespace game
     public:
         using UniformCallback = std::function<void(const Material *, const Entity *)>;
 
-        Material(const Shader &vertex_shader, const Shader &fragment_shader);
+        /**
+         * Locations of the uniforms the renderer sets for every draw, so they are looked up by name only once.
+         * Locations of uniforms the program does not have are -1, setting those is a no-op.
+         */
+        struct DrawUniforms
+        {
+            ::GLint model;
+            ::GLint normal_matrix;
+
+            /** Only in programs that can draw meshes with compact vertices. */
+            ::GLint compact_vertices;
+            ::GLint position_scale;
+            ::GLint position_bias;
+        };
+
+        /**
+         * Create a material drawing with a program.
+         *
+         * @param program
+         *   Program from a ProgramCache, materials with the same shaders share it. Must outlive the material.
+         */
+        Material(const Program *program);
 
         auto use() const -> void;
+        auto has_uniform(std::string_view name) const -> bool;
+
+        /**
+         * Get the locations of the per draw uniforms, looked up on the first call, which waits for the program to link.
+         */
+        auto draw_uniforms() const -> const DrawUniforms &;
+
+        /**
+         * Check if the program can draw meshes with compact vertices, see DrawUniforms.
+         */
+        auto supports_compact_vertices() const -> bool;
+
         auto set_uniform(std::string_view name, const Color &obj) const -> void;
+        auto set_uniform(std::string_view name, const Matrix3 &obj) const -> void;
         auto set_uniform(std::string_view name, const Matrix4 &obj) const -> void;
+
+        /**
+         * Set a mat3x4 uniform, its columns are the rows of obj.
+         */
+        auto set_uniform(std::string_view name, const Matrix3x4 &obj) const -> void;
         auto set_uniform(std::string_view name, std::int32_t obj) const -> void;
         auto set_uniform(std::string_view name, float obj) const -> void;
+        auto set_uniform(std::string_view name, const Vector3 &obj) const -> void;
+
+        /**
+         * Set uniforms by location, for locations from draw_uniforms().
+         */
+        auto set_uniform(::GLint location, const Matrix3 &obj) const -> void;
+        auto set_uniform(::GLint location, const Matrix3x4 &obj) const -> void;
+        auto set_uniform(::GLint location, std::int32_t obj) const -> void;
+        auto set_uniform(::GLint location, const Vector3 &obj) const -> void;
+
         auto bind_cube_map(const CubeMap *texture, const TextureSampler *sampler) const -> void;
         auto bind_texture(std::uint32_t index, const Texture *texture) const -> void;
         auto bind_texture(std::uint32_t index, const Texture *texture, const TextureSampler *sampler) const -> void;
@@ -44,8 +95,10 @@ namespace game
         auto native_handle() const -> ::GLuint;
 
     private:
-        AutoRelease<::GLuint> _handle;
-        StringUnorderedMap<::GLuint> _uniforms;
+        auto uniform_location(std::string_view name) const -> ::GLint;
+
+        const Program *_program;
         UniformCallback _uniform_callback;
+        mutable std::optional<DrawUniforms> _draw_uniforms;
     };
 }
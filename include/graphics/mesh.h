@@ -1,9 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "events/key_event.h"
 #include "graphics/buffer.h"
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
 #include "graphics/opengl.h"
 #include "loaders/mesh_loader.h"
 #include "utils/auto_release.h"
@@ -22,16 +26,60 @@ namespace game
         auto bind() const -> void;
         auto unbind() const -> void;
         auto index_count() const -> std::uint32_t;
+        auto index_count(std::size_t lod) const -> std::uint32_t;
         auto index_offset() const -> std::uintptr_t;
+        auto index_offset(std::size_t lod) const -> std::uintptr_t;
+        auto index_type() const -> ::GLenum;
+
+        /**
+         * Number of levels of detail, including the full detail mesh at level 0.
+         */
+        auto lod_count() const -> std::size_t;
+
+        /**
+         * Pick the coarsest level of detail whose error is not visible.
+         *
+         * @param pixels_per_unit
+         *   How many pixels one object space unit covers on screen at the distance the mesh is drawn.
+         *
+         * @param max_pixel_error
+         *   Largest acceptable screen space error in pixels.
+         *
+         * @returns
+         *   Level of detail to draw.
+         */
+        auto select_lod(float pixels_per_unit, float max_pixel_error) const -> std::size_t;
+
+        auto is_compact() const -> bool;
+
+        /**
+         * Object space bounds, as stored in the pack or calculated from the vertices if the pack has none.
+         */
+        auto bounds() const -> const MeshBounds &;
+
+        auto quantization() const -> VertexQuantization;
 
         auto mesh_data() const -> MeshData;
 
+        /**
+         * Video memory used by the vertex and index buffer, in bytes.
+         */
+        auto memory_size() const -> std::size_t;
+
     private:
+        struct LevelOfDetail
+        {
+            std::uint32_t index_count;
+            std::uintptr_t index_offset;
+            float error;
+        };
+
         AutoRelease<GLuint> _vao;
         Buffer _vbo;
 
-        std::uint32_t _index_count;
-        std::uintptr_t _index_offset;
+        std::vector<LevelOfDetail> _lods;
+        ::GLenum _index_type;
+        MeshBounds _bounds;
         MeshData _meshData;
     };
 
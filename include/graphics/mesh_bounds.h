@@ -0,0 +1,46 @@
+#pragma once
+
+#include "math/vector3.h"
+
+namespace game
+{
+    struct MeshData;
+
+    /**
+     * Object space bounds of a mesh, an axis aligned box and a bounding sphere.
+     */
+    struct MeshBounds
+    {
+        Vector3 min;
+        Vector3 max;
+        Vector3 center;
+        float radius;
+    };
+
+    /**
+     * Calculate tight bounds for all vertices of a mesh. The sphere is the smaller of the one around the box centre and
+     * the one found by Ritter's algorithm.
+     *
+     * @param data
+     *   Mesh to calculate bounds for, may use compact vertices.
+     *
+     * @returns
+     *   Bounds of the mesh, all zero for a mesh without vertices.
+     */
+    auto compute_bounds(const MeshData &data) -> MeshBounds;
+
+    /**
+     * Calculate bounds containing two meshes, e.g. the bounds of an object from those of its sub-meshes. The sphere is
+     * the smaller of the one around the merged box and the smallest one around both spheres.
+     *
+     * @param a
+     *   Bounds of the first mesh.
+     *
+     * @param b
+     *   Bounds of the second mesh.
+     *
+     * @returns
+     *   Bounds containing both meshes.
+     */
+    auto merge(const MeshBounds &a, const MeshBounds &b) -> MeshBounds;
+}
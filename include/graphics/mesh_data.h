@@ -1,16 +1,77 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <span>
+#include <vector>
 
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
 #include "graphics/vertex_data.h"
+#include "math/vector3.h"
 
 namespace game
 {
+    /**
+     * A coarser level of detail, its indices reference the same vertices as the full detail mesh and use the same index
+     * width.
+     */
+    struct MeshLod
+    {
+        std::span<const std::uint32_t> indices;
+        std::span<const std::uint16_t> short_indices = {};
+
+        /** Object space error of this level compared to the full detail mesh. */
+        float error = 0.f;
+
+        auto index_count() const -> std::size_t
+        {
+            return short_indices.empty() ? indices.size() : short_indices.size();
+        }
+    };
+
+    /**
+     * Non-owning view of mesh data. Indices are either 32 bit (indices) or 16 bit (short_indices), only one of them
+     * is ever set. Likewise vertices are either full precision (vertices) or packed (compact_vertices, dequantised with
+     * quantization). Optional coarser levels of detail are ordered by increasing error.
+     */
     struct MeshData
     {
         std::span<const VertexData> vertices;
         std::span<const std::uint32_t> indices;
+        std::span<const std::uint16_t> short_indices = {};
+        std::span<const CompactVertexData> compact_vertices = {};
+        VertexQuantization quantization = {};
+
+        /** Precomputed by the packer, missing for meshes built at runtime and for older packs. */
+        std::optional<MeshBounds> bounds = {};
+        std::vector<MeshLod> lods = {};
+
+        auto is_compact() const -> bool
+        {
+            return !compact_vertices.empty();
+        }
+
+        auto vertex_count() const -> std::size_t
+        {
+            return is_compact() ? compact_vertices.size() : vertices.size();
+        }
+
+        auto position(std::size_t i) const -> Vector3
+        {
+            return is_compact() ? expand_position(compact_vertices[i], quantization) : vertices[i].position;
+        }
+
+        auto index_count() const -> std::size_t
+        {
+            return short_indices.empty() ? indices.size() : short_indices.size();
+        }
+
+        auto index(std::size_t i) const -> std::uint32_t
+        {
+            return short_indices.empty() ? indices[i] : short_indices[i];
+        }
     };
 
-}
\ No newline at end of file
+}
@@ -37,7 +37,9 @@
     DO(::PFNGLGETPROGRAMIVPROC, glGetProgramiv)                                               \
     DO(::PFNGLDEBUGMESSAGECALLBACKPROC, glDebugMessageCallback)                               \
     DO(::PFNGLGETUNIFORMLOCATIONPROC, glGetUniformLocation)                                   \
+    DO(::PFNGLUNIFORMMATRIX3FVPROC, glUniformMatrix3fv)                                       \
     DO(::PFNGLUNIFORMMATRIX4FVPROC, glUniformMatrix4fv)                                       \
+    DO(::PFNGLUNIFORMMATRIX3X4FVPROC, glUniformMatrix3x4fv)                                   \
     DO(::PFNGLGETACTIVEUNIFORMPROC, glGetActiveUniform)                                       \
     DO(::PFNGLUNIFORM1IPROC, glUniform1i)                                                     \
     DO(::PFNGLUNIFORM1FPROC, glUniform1f)                                                     \
@@ -58,6 +60,8 @@
     DO(::PFNGLTEXTURESUBIMAGE2DPROC, glTextureSubImage2D)                                     \
     DO(::PFNGLTEXTURESTORAGE3DPROC, glTextureStorage3D)                                       \
     DO(::PFNGLTEXTURESUBIMAGE3DPROC, glTextureSubImage3D)                                     \
+    DO(::PFNGLCOMPRESSEDTEXTURESUBIMAGE2DPROC, glCompressedTextureSubImage2D)                 \
+    DO(::PFNGLCOMPRESSEDTEXTURESUBIMAGE3DPROC, glCompressedTextureSubImage3D)                 \
     DO(::PFNGLCREATESAMPLERSPROC, glCreateSamplers)                                           \
     DO(::PFNGLDELETESAMPLERSPROC, glDeleteSamplers)                                           \
     DO(::PFNGLBINDTEXTUREUNITPROC, glBindTextureUnit)                                         \
@@ -77,7 +81,16 @@
     DO(::PFNGLNAMEDFRAMEBUFFERREADBUFFERPROC, glNamedFramebufferReadBuffer)                   \
     DO(::PFNGLNAMEDRENDERBUFFERSTORAGEMULTISAMPLEPROC, glNamedRenderbufferStorageMultisample) \
     DO(::PFNGLCHECKNAMEDFRAMEBUFFERSTATUSPROC, glCheckNamedFramebufferStatus)                 \
-    DO(::PFNGLDRAWARRAYSEXTPROC, glDrawArraysExt)
+    DO(::PFNGLDRAWARRAYSEXTPROC, glDrawArraysExt)                                             \
+    DO(::PFNGLGETSTRINGIPROC, glGetStringi)                                                   \
+    DO(::PFNGLPROGRAMPARAMETERIPROC, glProgramParameteri)                                     \
+    DO(::PFNGLGETPROGRAMBINARYPROC, glGetProgramBinary)                                       \
+    DO(::PFNGLPROGRAMBINARYPROC, glProgramBinary)
+
+// extension functions, null if the driver does not support them
+#define FOR_OPTIONAL_OPENGL_FUNCTIONS(DO) \
+    DO(::PFNGLMAXSHADERCOMPILERTHREADSKHRPROC, glMaxShaderCompilerThreadsKHR)
 
 #define DO_INLINE(TYPE, NAME) inline TYPE NAME;
 FOR_OPENGL_FUNCTIONS(DO_INLINE)
+FOR_OPTIONAL_OPENGL_FUNCTIONS(DO_INLINE)
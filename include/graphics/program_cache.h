@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+#include "graphics/opengl.h"
+#include "utils/auto_release.h"
+#include "utils/string_unordered_map.h"
+
+namespace game
+{
+    class TlvReader;
+
+    /**
+     * A linked shader program, shared by all materials using the same shaders. Linking may still run on a driver thread
+     * when the program is handed out, its result is checked by ProgramCache::resolve or else when the program is first
+     * used.
+     */
+    class Program
+    {
+    public:
+        /**
+         * Check, without blocking, whether the driver finished linking. Always true without
+         * GL_KHR_parallel_shader_compile, using the program then waits for the link.
+         */
+        auto is_ready() const -> bool;
+
+        /**
+         * Get the program, waiting for the link to finish and checking it succeeded.
+         */
+        auto native_handle() const -> ::GLuint;
+
+        /**
+         * Get the locations of all active uniforms, waiting for the link to finish.
+         */
+        auto uniforms() const -> const StringUnorderedMap<::GLuint> &;
+
+    private:
+        friend class ProgramCache;
+
+        Program(AutoRelease<::GLuint> handle, bool parallel_compile, ::GLuint vertex_shader, ::GLuint fragment_shader, std::optional<std::filesystem::path> binary_path);
+
+        /**
+         * Check the link status and read the uniforms, only done once.
+         */
+        auto resolve() const -> void;
+
+        AutoRelease<::GLuint> _handle;
+        bool _parallel_compile;
+
+        /** Shaders the program was linked from, for their logs if the link failed. 0 if it was loaded from a binary. */
+        ::GLuint _vertex_shader;
+        ::GLuint _fragment_shader;
+
+        /** Where to save the program binary once it is linked, empty if it is not to be saved or already saved. */
+        std::optional<std::filesystem::path> _binary_path;
+
+        mutable std::optional<StringUnorderedMap<::GLuint>> _uniforms;
+    };
+
+    /**
+     * Creates shader programs, once per distinct pair of shader sources. Compiling and linking is started right away
+     * but not waited for, so the driver can work on several programs in parallel (GL_KHR_parallel_shader_compile).
+     *
+     * Linked programs are saved as driver specific binaries in a directory, keyed by a hash of the sources and the
+     * driver. Later runs load the binary instead of compiling the sources, falling back to compiling if the driver
+     * rejects it (e.g. after a driver update).
+     */
+    class ProgramCache
+    {
+    public:
+        /**
+         * Create a cache, the GL context must be current.
+         *
+         * @param binary_dir
+         *   Directory to save and load program binaries in, created if missing. No binaries are used if empty.
+         */
+        ProgramCache(std::optional<std::filesystem::path> binary_dir = std::nullopt);
+
+        ProgramCache(const ProgramCache &) = delete;
+        auto operator=(const ProgramCache &) -> ProgramCache & = delete;
+
+        /**
+         * Get the program for a pair of shaders.
+         *
+         * @param vertex_source
+         *   GLSL source of the vertex shader.
+         *
+         * @param fragment_source
+         *   GLSL source of the fragment shader.
+         *
+         * @returns
+         *   Program, owned by the cache.
+         */
+        auto get(std::string_view vertex_source, std::string_view fragment_source) -> const Program *;
+
+        /**
+         * Get the program for a pair of shaders stored in a pack.
+         *
+         * @param reader
+         *   Reader of the pack.
+         *
+         * @param vertex_name
+         *   Name of the vertex shader text file.
+         *
+         * @param fragment_name
+         *   Name of the fragment shader text file.
+         *
+         * @returns
+         *   Program, owned by the cache.
+         */
+        auto get(const TlvReader &reader, std::string_view vertex_name, std::string_view fragment_name) -> const Program *;
+
+        /**
+         * Check, without blocking, whether every program handed out so far finished linking.
+         */
+        auto is_ready() const -> bool;
+
+        /**
+         * Check every program handed out so far and save the binaries of the ones that were compiled. Waits for
+         * links that are still running, call it once is_ready() holds so neither the wait nor the save lands in a
+         * frame.
+         */
+        auto resolve() -> void;
+
+    private:
+        auto compile(std::string_view source, ::GLenum type) -> ::GLuint;
+        auto load_binary(const std::filesystem::path &path) const -> AutoRelease<::GLuint>;
+
+        std::optional<std::filesystem::path> _binary_dir;
+
+        /** Hash of what the driver reports about itself, binaries from another driver are not looked for. */
+        std::uint64_t _driver_hash;
+        bool _parallel_compile;
+        std::unordered_map<std::uint64_t, AutoRelease<::GLuint>> _shaders;
+        std::unordered_map<std::uint64_t, std::unique_ptr<Program>> _programs;
+    };
+}
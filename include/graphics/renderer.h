@@ -10,8 +10,11 @@
 #include "graphics/frame_buffer.h"
 #include "graphics/material.h"
 #include "graphics/mesh.h"
+#include "graphics/program_cache.h"
 #include "graphics/texture.h"
 #include "loaders/mesh_loader.h"
+#include "math/matrix3x4.h"
+#include "math/transform_batch.h"
 #include "scene.h"
 #include "tlv/tlv_reader.h"
 
@@ -20,7 +23,7 @@ namespace game
     class Renderer
     {
     public:
-        Renderer(const TlvReader &reader, MeshLoader &mesh_loader, std::uint32_t width, std::uint32_t height, std::uint8_t samples = 1);
+        Renderer(ProgramCache &program_cache, const TlvReader &reader, MeshLoader &mesh_loader, std::uint32_t width, std::uint32_t height, std::uint8_t samples = 1);
         auto render(const Camera &camera, const Scene &scene, float gamma) const -> void;
 
     private:
@@ -59,5 +62,9 @@ namespace game
         Material _ssao_material;
         Material _ssao_apply_material;
         Camera _orth_camera;
+
+        /** Per frame scratch space for the model matrices of the scene, kept to reuse the memory. */
+        mutable TransformBatch _transforms;
+        mutable std::vector<Matrix3x4> _models;
     };
 }
\ No newline at end of file
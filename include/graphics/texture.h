@@ -29,7 +29,13 @@ namespace game
     {
         R,
         RGB,
-        RGBA
+        RGBA,
+
+        // block compressed, data holds mip_levels levels back to back
+        BC1,
+        BC3,
+        BC5,
+        BC7
     };
 
     struct TextureDescription
@@ -40,6 +46,7 @@ namespace game
         std::uint32_t width;
         std::uint32_t height;
         std::vector<std::byte> data;
+        std::uint32_t mip_levels = 1u;
     };
 
     class Texture
@@ -47,6 +54,10 @@ namespace game
     public:
         Texture(TextureUsage usage, std::uint32_t width, std::uint32_t height, std::uint8_t samples = 1);
         Texture(const TextureDescription &data, const TextureSampler *sampler);
+
+        /**
+         * Load a texture from a pack, at the quality tier selected in the settings if the pack has one for it.
+         */
         Texture(const TlvReader &reader, std::string_view name, const TextureSampler *sampler);
 
         Texture(Texture &&) noexcept = default;
@@ -57,13 +68,85 @@ namespace game
         auto width() const -> std::uint32_t;
         auto height() const -> std::uint32_t;
 
+        /**
+         * Video memory used by all mip levels (and samples) of the texture, in bytes.
+         */
+        auto memory_size() const -> std::size_t;
+
     private:
         AutoRelease<::GLuint> _handle;
         const TextureSampler *_sampler;
         std::uint32_t _width;
         std::uint32_t _height;
+        std::size_t _memory_size;
     };
 
+    /**
+     * Check if a format is one of the block compressed (BCn) formats.
+     *
+     * @param format
+     *   Format to check.
+     *
+     * @returns
+     *   True if the format is stored as 4x4 blocks.
+     */
+    auto is_block_compressed(TextureFormat format) -> bool;
+
+    /**
+     * Get the size in bytes of a single mip level.
+     *
+     * @param format
+     *   Format of the texture.
+     *
+     * @param width
+     *   Width of the mip level in pixels.
+     *
+     * @param height
+     *   Height of the mip level in pixels.
+     *
+     * @returns
+     *   Number of bytes the level occupies in TextureDescription::data.
+     */
+    auto mip_level_size(TextureFormat format, std::uint32_t width, std::uint32_t height) -> std::size_t;
+
+    /** Number of quality tiers, tier 0 is full resolution and every further tier halves width and height. */
+    inline constexpr auto texture_tier_count = 3u;
+
+    /**
+     * Get the name a reduced resolution tier of a texture is packed under.
+     *
+     * @param name
+     *   Name of the texture.
+     *
+     * @param tier
+     *   Quality tier, 0 is the texture itself.
+     *
+     * @returns
+     *   Name of the tier.
+     */
+    auto texture_tier_name(std::string_view name, std::uint32_t tier) -> std::string;
+
+    /**
+     * Check if a name is that of a reduced resolution tier rather than a texture of its own, i.e. it ends in the
+     * "@<tier>" texture_tier_name appends.
+     */
+    auto is_texture_tier(std::string_view name) -> bool;
+
+    /**
+     * Find a texture in a pack, at the quality tier selected in the settings if the pack has one for it. Does not
+     * touch OpenGL, so it can run on any thread.
+     *
+     * @param reader
+     *   Reader of the pack.
+     *
+     * @param name
+     *   Name of the texture.
+     *
+     * @returns
+     *   Copy of the texture data.
+     */
+    auto find_texture_description(const TlvReader &reader, std::string_view name) -> TextureDescription;
+
     auto to_string(TextureUsage obj) -> std::string;
     auto to_string(TextureFormat obj) -> std::string;
     auto to_string(const TextureDescription &obj) -> std::string;
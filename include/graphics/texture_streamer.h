@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <string_view>
+
+#include "graphics/texture.h"
+#include "resources/async_resource_loader.h"
+#include "resources/resource_cache.h"
+#include "resources/resource_store.h"
+
+namespace game
+{
+    class TextureSampler;
+    class TlvReader;
+
+    /**
+     * Loads textures without blocking the game thread. A streamed texture is cached right away as a 1x1 white
+     * placeholder, its data is found and copied out of the pack on the loader workers and uploaded on the render thread,
+     * a few textures per frame. The upload replaces the placeholder in place, so entities that already point to it pick
+     * up the real texture on their own.
+     */
+    class TextureStreamer
+    {
+    public:
+        /**
+         * Create a streamer.
+         *
+         * @param cache
+         *   Cache to insert textures into, must outlive this.
+         *
+         * @param loader
+         *   Loader whose workers decode the textures, must outlive this.
+         *
+         * @param upload_budget
+         *   Time per frame after which no further textures are uploaded. At least one is always uploaded.
+         */
+        TextureStreamer(DefaultCache &cache, AsyncResourceLoader &loader, std::chrono::microseconds upload_budget = std::chrono::milliseconds{2});
+        ~TextureStreamer();
+
+        TextureStreamer(const TextureStreamer &) = delete;
+        auto operator=(const TextureStreamer &) -> TextureStreamer & = delete;
+
+        /**
+         * Cache a placeholder for a texture and start loading it.
+         *
+         * @param reader
+         *   Reader of the pack with the texture, the pack must stay mounted until wait_for_decodes() returned.
+         *
+         * @param name
+         *   Name of the texture, must not be cached yet.
+         *
+         * @param sampler
+         *   Sampler of the texture.
+         *
+         * @returns
+         *   Reference to the cached texture, evictable once it is released.
+         */
+        auto insert_async(const TlvReader &reader, std::string_view name, const TextureSampler *sampler) -> ResourceRef<Texture>;
+
+        /**
+         * Upload decoded textures until the upload budget is spent. Must be called on the render thread, once per frame.
+         *
+         * @returns
+         *   Number of uploaded textures.
+         */
+        auto upload() -> std::size_t;
+
+        /**
+         * Block until no decode reads from a pack anymore, so that packs can be unmounted. Uploads stay queued.
+         */
+        auto wait_for_decodes() const -> void;
+
+        /**
+         * Get the number of textures still showing their placeholder.
+         */
+        auto pending() const -> std::size_t;
+
+    private:
+        struct PendingUpload
+        {
+            ResourceRef<Texture> texture;
+            const TextureSampler *sampler;
+            LoadHandle<TextureDescription> description;
+        };
+
+        DefaultCache &_cache;
+        AsyncResourceLoader &_loader;
+        std::chrono::microseconds _upload_budget;
+        std::deque<PendingUpload> _pending;
+    };
+}
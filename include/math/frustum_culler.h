@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "math/frustum_plane.h"
+#include "math/vector3.h"
+
+namespace game
+{
+    /**
+     * Axis aligned bounding boxes of many objects stored as structure of arrays, one array per component, so that
+     * several boxes can be culled at a time with simd.
+     */
+    class BoundsBatch
+    {
+    public:
+        /**
+         * Append a box.
+         *
+         * @param center
+         *   Center of the box.
+         *
+         * @param extents
+         *   Distance from the center to the faces along each axis.
+         */
+        auto add(const Vector3 &center, const Vector3 &extents) -> void;
+
+        /**
+         * Remove all boxes, keeping the memory for the next batch.
+         */
+        auto clear() -> void;
+
+        /**
+         * Get the number of boxes.
+         */
+        auto size() const -> std::size_t;
+
+    private:
+        friend class FrustumCuller;
+
+        std::vector<float> _center_x;
+        std::vector<float> _center_y;
+        std::vector<float> _center_z;
+        std::vector<float> _extents_x;
+        std::vector<float> _extents_y;
+        std::vector<float> _extents_z;
+    };
+
+    /**
+     * Tests boxes against the six planes of a view frustum, 8 (AVX) or 4 (SSE, NEON) at a time.
+     */
+    class FrustumCuller
+    {
+    public:
+        /**
+         * Create a culler for a frustum.
+         *
+         * @param planes
+         *   Planes of the frustum with normals pointing inwards, see Camera::frustum_planes.
+         */
+        explicit FrustumCuller(const std::array<FrustumPlane, 6u> &planes);
+
+        /**
+         * Cull boxes, a box is visible unless it is completely outside one of the planes.
+         *
+         * @param bounds
+         *   Boxes to cull.
+         *
+         * @param visible
+         *   Bitset to write the result to, resized to hold a bit for each box. Bit i (bit i % 64 of word i / 64) is set
+         *   if box i is visible.
+         */
+        auto cull(const BoundsBatch &bounds, std::vector<std::uint64_t> &visible) const -> void;
+
+        /**
+         * Query a bit of a bitset written by cull.
+         *
+         * @param visible
+         *   Bitset.
+         *
+         * @param index
+         *   Index of the box.
+         *
+         * @returns
+         *   true if the box is visible.
+         */
+        static auto is_visible(std::span<const std::uint64_t> visible, std::size_t index) -> bool;
+
+    private:
+        /** Plane components, abs_* are the absolute normal components used for the box extents. */
+        struct Plane
+        {
+            float normal_x;
+            float normal_y;
+            float normal_z;
+            float distance;
+            float abs_x;
+            float abs_y;
+            float abs_z;
+        };
+
+        std::array<Plane, 6u> _planes;
+    };
+}
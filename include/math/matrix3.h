@@ -10,6 +10,8 @@
 #include <Jolt/Math/Mat44.h>
 #include <Jolt/Math/Quat.h>
 
+#include "math/matrix3x4.h"
+#include "math/matrix4.h"
 #include "math/quaternion.h"
 #include "math/vector3.h"
 #include "math/vector4.h"
@@ -51,6 +53,38 @@ namespace game
         {
         }
 
+        /**
+         * Create a matrix from the upper left 3x3 part of m, its rotation and scale.
+         */
+        explicit constexpr Matrix3(const Matrix4 &m)
+            : _elements{}
+        {
+            const auto d = m.data();
+            for (auto column = 0u; column < 3u; ++column)
+            {
+                for (auto row = 0u; row < 3u; ++row)
+                {
+                    _elements[row + column * 3u] = d[row + column * 4u];
+                }
+            }
+        }
+
+        /**
+         * Create a matrix from the rotation and scale of m, its translation is dropped.
+         */
+        explicit constexpr Matrix3(const Matrix3x4 &m)
+            : _elements{}
+        {
+            const auto d = m.data();
+            for (auto column = 0u; column < 3u; ++column)
+            {
+                for (auto row = 0u; row < 3u; ++row)
+                {
+                    _elements[row + column * 3u] = d[row * 4u + column];
+                }
+            }
+        }
+
         Matrix3(const std::span<const float> &elements)
             : Matrix3{}
         {
@@ -123,6 +157,39 @@ namespace game
             return {inv_arr};
         }
 
+        /**
+         * Compute the transpose of the inverse, the matrix that transforms normals when m transforms points. This is
+         * the cofactor matrix divided by the determinant, so neither a transpose nor the adjoint is needed.
+         *
+         * @param m
+         *   Matrix to compute the normal matrix of, must not be singular.
+         *
+         * @returns
+         *   Transpose of the inverse of m.
+         */
+        static constexpr auto inverse_transpose(const Matrix3 &m) -> Matrix3
+        {
+            const auto &e = m._elements;
+
+            const auto c00 = e[4] * e[8] - e[7] * e[5];
+            const auto c01 = e[7] * e[2] - e[1] * e[8];
+            const auto c02 = e[1] * e[5] - e[4] * e[2];
+
+            const auto inv_det = 1.f / (e[0] * c00 + e[3] * c01 + e[6] * c02);
+
+            return {{c00 * inv_det,
+                     (e[6] * e[5] - e[3] * e[8]) * inv_det,
+                     (e[3] * e[7] - e[6] * e[4]) * inv_det,
+
+                     c01 * inv_det,
+                     (e[0] * e[8] - e[6] * e[2]) * inv_det,
+                     (e[6] * e[1] - e[0] * e[7]) * inv_det,
+
+                     c02 * inv_det,
+                     (e[3] * e[2] - e[0] * e[5]) * inv_det,
+                     (e[0] * e[4] - e[3] * e[1]) * inv_det}};
+        }
+
         auto to_string() const -> std::string;
 
     private:
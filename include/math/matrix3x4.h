@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <format>
+#include <span>
+#include <string>
+
+#include "math/matrix4.h"
+#include "math/quaternion.h"
+#include "math/vector3.h"
+
+namespace game
+{
+    /**
+     * An affine transform, a Matrix4 without the constant last row (0 0 0 1). Unlike Matrix4 the elements are stored
+     * by row, which is what shaders read as a mat3x4 uniform:
+     *
+     *   uniform mat3x4 model;
+     *   vec3 world_position = vec4(position, 1.0) * model;
+     */
+    class Matrix3x4
+    {
+    public:
+        // initialize to identity
+        constexpr Matrix3x4()
+            : _elements({1.f, 0.f, 0.f, 0.f,
+                         0.f, 1.f, 0.f, 0.f,
+                         0.f, 0.f, 1.f, 0.f})
+        {
+        }
+
+        /**
+         * Create a matrix from its rows.
+         */
+        constexpr Matrix3x4(const std::array<float, 12u> &elements)
+            : _elements{elements}
+        {
+        }
+
+        /**
+         * Create a matrix from an affine Matrix4, its last row is dropped.
+         */
+        explicit constexpr Matrix3x4(const Matrix4 &m)
+            : _elements{}
+        {
+            const auto d = m.data();
+            for (auto row = 0u; row < 3u; ++row)
+            {
+                for (auto column = 0u; column < 4u; ++column)
+                {
+                    _elements[row * 4u + column] = d[row + column * 4u];
+                }
+            }
+        }
+
+        /**
+         * Compose translation * rotation * scale, see Matrix4::compose.
+         */
+        static constexpr auto compose(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale) -> Matrix3x4
+        {
+            return Matrix3x4{Matrix4::compose(translation, rotation, scale)};
+        }
+
+        /**
+         * Invert the matrix, cheaper than inverting a Matrix4 as only the 3x3 part needs a full inverse.
+         *
+         * @param m
+         *   Matrix to invert, must not be singular.
+         *
+         * @returns
+         *   Inverse of m.
+         */
+        static constexpr auto invert(const Matrix3x4 &m) -> Matrix3x4
+        {
+            const auto &e = m._elements;
+
+            // cofactors of the 3x3 part, the inverse is their transpose divided by the determinant
+            const auto c00 = e[5] * e[10] - e[6] * e[9];
+            const auto c01 = e[6] * e[8] - e[4] * e[10];
+            const auto c02 = e[4] * e[9] - e[5] * e[8];
+
+            const auto inv_det = 1.f / (e[0] * c00 + e[1] * c01 + e[2] * c02);
+
+            auto inverse = Matrix3x4{{
+                c00 * inv_det,
+                (e[2] * e[9] - e[1] * e[10]) * inv_det,
+                (e[1] * e[6] - e[2] * e[5]) * inv_det,
+                0.f,
+                c01 * inv_det,
+                (e[0] * e[10] - e[2] * e[8]) * inv_det,
+                (e[2] * e[4] - e[0] * e[6]) * inv_det,
+                0.f,
+                c02 * inv_det,
+                (e[1] * e[8] - e[0] * e[9]) * inv_det,
+                (e[0] * e[5] - e[1] * e[4]) * inv_det,
+                0.f,
+            }};
+
+            // the translation is undone after the rotation and scale
+            const auto translation = inverse.transform_vector({e[3], e[7], e[11]});
+            inverse._elements[3] = -translation.x;
+            inverse._elements[7] = -translation.y;
+            inverse._elements[11] = -translation.z;
+
+            return inverse;
+        }
+
+        /**
+         * Transform a point, the translation is applied.
+         */
+        constexpr auto transform_point(const Vector3 &p) const -> Vector3
+        {
+            const auto &e = _elements;
+            return {e[0] * p.x + e[1] * p.y + e[2] * p.z + e[3],
+                    e[4] * p.x + e[5] * p.y + e[6] * p.z + e[7],
+                    e[8] * p.x + e[9] * p.y + e[10] * p.z + e[11]};
+        }
+
+        /**
+         * Transform a direction, the translation is not applied.
+         */
+        constexpr auto transform_vector(const Vector3 &v) const -> Vector3
+        {
+            const auto &e = _elements;
+            return {e[0] * v.x + e[1] * v.y + e[2] * v.z,
+                    e[4] * v.x + e[5] * v.y + e[6] * v.z,
+                    e[8] * v.x + e[9] * v.y + e[10] * v.z};
+        }
+
+        /**
+         * Get the elements, row by row.
+         */
+        constexpr auto data() const -> std::span<const float>
+        {
+            return _elements;
+        }
+
+        constexpr auto data() -> std::span<float>
+        {
+            return _elements;
+        }
+
+        explicit constexpr operator Matrix4() const
+        {
+            auto m = Matrix4{};
+            auto d = m.data();
+            for (auto row = 0u; row < 3u; ++row)
+            {
+                for (auto column = 0u; column < 4u; ++column)
+                {
+                    d[row + column * 4u] = _elements[row * 4u + column];
+                }
+            }
+
+            return m;
+        }
+
+        friend constexpr auto operator*(const Matrix3x4 &m1, const Matrix3x4 &m2) -> Matrix3x4;
+
+        constexpr auto operator==(const Matrix3x4 &) const -> bool = default;
+
+        auto to_string() const -> std::string;
+
+    private:
+        std::array<float, 12u> _elements;
+    };
+
+    /**
+     * Multiply two affine matrices, m1 is applied last. 36 multiplies instead of the 64 of a Matrix4 product.
+     */
+    constexpr auto operator*(const Matrix3x4 &m1, const Matrix3x4 &m2) -> Matrix3x4
+    {
+        const auto &a = m1._elements;
+        const auto &b = m2._elements;
+        auto result = Matrix3x4{};
+        auto &r = result._elements;
+
+        for (auto row = 0u; row < 3u; ++row)
+        {
+            const auto a0 = a[row * 4u];
+            const auto a1 = a[row * 4u + 1u];
+            const auto a2 = a[row * 4u + 2u];
+
+            for (auto column = 0u; column < 4u; ++column)
+            {
+                r[row * 4u + column] = a0 * b[column] + a1 * b[4u + column] + a2 * b[8u + column];
+            }
+
+            r[row * 4u + 3u] += a[row * 4u + 3u];
+        }
+
+        return result;
+    }
+
+    inline auto Matrix3x4::to_string() const -> std::string
+    {
+        const auto *d = data().data();
+        return std::format("{} {} {} {}\n{} {} {} {}\n{} {} {} {}",
+                           d[0], d[1], d[2], d[3],
+                           d[4], d[5], d[6], d[7],
+                           d[8], d[9], d[10], d[11]);
+    }
+}
@@ -7,6 +7,7 @@
 #include <span>
 
 #include "math/quaternion.h"
+#include "math/simd.h"
 #include "math/vector3.h"
 #include "math/vector4.h"
 #include "utils/ensure.h"
@@ -149,6 +150,23 @@ namespace game
             _elements[10] = (1.f - xx) - yy;
         }
 
+        /**
+         * Compose translation * rotation * scale directly, without multiplying three matrices.
+         *
+         * @param translation
+         *   Translation.
+         *
+         * @param rotation
+         *   Rotation, must be normalized.
+         *
+         * @param scale
+         *   Scale along each axis.
+         *
+         * @returns
+         *   Model matrix.
+         */
+        static constexpr auto compose(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale) -> Matrix4;
+
         static auto look_at(const Vector3 &eye, const Vector3 &look_at, const Vector3 &up) -> Matrix4;
         static auto perspective(float fov, float width, float height, float near_plane, float far_plane) -> Matrix4;
         static auto orthographic(float width, float height, float depth) -> Matrix4;
@@ -163,6 +181,11 @@ namespace game
             return _elements;
         }
 
+        constexpr auto data() -> std::span<float>
+        {
+            return _elements;
+        }
+
         auto operator[](this auto &&self, std::size_t index) -> auto
         {
             return self._elements[index];
@@ -182,10 +205,31 @@ namespace game
         auto to_string() const -> std::string;
 
     private:
+        /** The scalar product, needed for constant evaluation. */
+        static constexpr auto multiply_scalar(const Matrix4 &m1, const Matrix4 &m2) -> Matrix4;
+
+        /** The product with the instruction set picked in simd.h, m1 and m2 may be the same matrix. */
+        static auto multiply_simd(const Matrix4 &m1, const Matrix4 &m2) -> Matrix4;
+
         std::array<float, 16u> _elements;
     };
 
     constexpr auto operator*=(Matrix4 &m1, const Matrix4 &m2) -> Matrix4 &
+    {
+        // constant evaluation cannot use intrinsics, at runtime the scalar loop is only left for targets without simd
+        if consteval
+        {
+            m1 = Matrix4::multiply_scalar(m1, m2);
+        }
+        else
+        {
+            m1 = Matrix4::multiply_simd(m1, m2);
+        }
+
+        return m1;
+    }
+
+    constexpr auto Matrix4::multiply_scalar(const Matrix4 &m1, const Matrix4 &m2) -> Matrix4
     {
         auto result = Matrix4{};
         for (auto i = 0u; i < 4u; i++)
@@ -201,8 +245,69 @@ namespace game
             }
         }
 
-        m1 = result;
-        return m1;
+        return result;
+    }
+
+    inline auto Matrix4::multiply_simd(const Matrix4 &m1, const Matrix4 &m2) -> Matrix4
+    {
+#if !defined(GAME_SIMD_SSE) && !defined(GAME_SIMD_NEON)
+        return multiply_scalar(m1, m2);
+#else
+        // column j of the result is the columns of m1 weighted by column j of m2
+        const auto *a = m1._elements.data();
+        const auto *b = m2._elements.data();
+        auto result = Matrix4{};
+        auto *r = result._elements.data();
+
+#if defined(GAME_SIMD_AVX)
+        // both halves hold the same column of m1, so two result columns are done at once
+        const auto a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a));
+        const auto a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4));
+        const auto a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 8));
+        const auto a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 12));
+
+        for (auto j = 0u; j < 16u; j += 8u)
+        {
+            const auto col = _mm256_loadu_ps(b + j);
+            auto sum = _mm256_mul_ps(a0, _mm256_permute_ps(col, 0x00));
+            sum = simd::madd(a1, _mm256_permute_ps(col, 0x55), sum);
+            sum = simd::madd(a2, _mm256_permute_ps(col, 0xaa), sum);
+            sum = simd::madd(a3, _mm256_permute_ps(col, 0xff), sum);
+            _mm256_storeu_ps(r + j, sum);
+        }
+#elif defined(GAME_SIMD_SSE)
+        const auto a0 = _mm_loadu_ps(a);
+        const auto a1 = _mm_loadu_ps(a + 4);
+        const auto a2 = _mm_loadu_ps(a + 8);
+        const auto a3 = _mm_loadu_ps(a + 12);
+
+        for (auto j = 0u; j < 16u; j += 4u)
+        {
+            auto sum = _mm_mul_ps(a0, _mm_set1_ps(b[j]));
+            sum = simd::madd(a1, _mm_set1_ps(b[j + 1u]), sum);
+            sum = simd::madd(a2, _mm_set1_ps(b[j + 2u]), sum);
+            sum = simd::madd(a3, _mm_set1_ps(b[j + 3u]), sum);
+            _mm_storeu_ps(r + j, sum);
+        }
+#elif defined(GAME_SIMD_NEON)
+        const auto a0 = vld1q_f32(a);
+        const auto a1 = vld1q_f32(a + 4);
+        const auto a2 = vld1q_f32(a + 8);
+        const auto a3 = vld1q_f32(a + 12);
+
+        for (auto j = 0u; j < 16u; j += 4u)
+        {
+            const auto col = vld1q_f32(b + j);
+            auto sum = vmulq_laneq_f32(a0, col, 0);
+            sum = vfmaq_laneq_f32(sum, a1, col, 1);
+            sum = vfmaq_laneq_f32(sum, a2, col, 2);
+            sum = vfmaq_laneq_f32(sum, a3, col, 3);
+            vst1q_f32(r + j, sum);
+        }
+#endif
+
+        return result;
+#endif
     }
 
     constexpr auto operator*(const Matrix4 &m1, const Matrix4 &m2) -> Matrix4
@@ -213,14 +318,57 @@ namespace game
 
     constexpr auto operator*(const Matrix4 &m, const Vector4 &v) -> Vector4
     {
+        if !consteval
+        {
+#if defined(GAME_SIMD_SSE)
+            const auto *c = m.data().data();
+            auto sum = _mm_mul_ps(_mm_loadu_ps(c), _mm_set1_ps(v.x));
+            sum = simd::madd(_mm_loadu_ps(c + 4), _mm_set1_ps(v.y), sum);
+            sum = simd::madd(_mm_loadu_ps(c + 8), _mm_set1_ps(v.z), sum);
+            sum = simd::madd(_mm_loadu_ps(c + 12), _mm_set1_ps(v.w), sum);
+
+            alignas(16) float result[4];
+            _mm_store_ps(result, sum);
+            return {result[0], result[1], result[2], result[3]};
+#elif defined(GAME_SIMD_NEON)
+            const auto *c = m.data().data();
+            auto sum = vmulq_n_f32(vld1q_f32(c), v.x);
+            sum = vfmaq_n_f32(sum, vld1q_f32(c + 4), v.y);
+            sum = vfmaq_n_f32(sum, vld1q_f32(c + 8), v.z);
+            sum = vfmaq_n_f32(sum, vld1q_f32(c + 12), v.w);
+
+            return {vgetq_lane_f32(sum, 0), vgetq_lane_f32(sum, 1), vgetq_lane_f32(sum, 2), vgetq_lane_f32(sum, 3)};
+#endif
+        }
+
+        const auto c = m.data();
         return {
-            m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
-            m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
-            m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
-            m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w,
+            c[0] * v.x + c[4] * v.y + c[8] * v.z + c[12] * v.w,
+            c[1] * v.x + c[5] * v.y + c[9] * v.z + c[13] * v.w,
+            c[2] * v.x + c[6] * v.y + c[10] * v.z + c[14] * v.w,
+            c[3] * v.x + c[7] * v.y + c[11] * v.z + c[15] * v.w,
         };
     }
 
+    constexpr auto Matrix4::compose(const Vector3 &translation, const Quaternion &rotation, const Vector3 &scale) -> Matrix4
+    {
+        // the rotation matrix with its columns scaled, see the quaternion constructor for the rotation
+        auto m = Matrix4{rotation};
+
+        for (auto i = 0u; i < 3u; ++i)
+        {
+            m._elements[i] *= scale.x;
+            m._elements[i + 4u] *= scale.y;
+            m._elements[i + 8u] *= scale.z;
+        }
+
+        m._elements[12] = translation.x;
+        m._elements[13] = translation.y;
+        m._elements[14] = translation.z;
+
+        return m;
+    }
+
     inline auto Matrix4::look_at(const Vector3 &eye, const Vector3 &look_at, const Vector3 &up) -> Matrix4
     {
         const auto f = Vector3::normalize(look_at - eye);
@@ -0,0 +1,256 @@
+#pragma once
+
+// Instruction set of the math kernels, picked at compile time from what the compiler targets. x86-64 always has SSE2,
+// configure with -DGAME_ENABLE_AVX2=ON to also use AVX2 and FMA. Without any of them the scalar code is used.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GAME_SIMD_SSE
+#include <immintrin.h>
+#if defined(__AVX__)
+#define GAME_SIMD_AVX
+#endif
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define GAME_SIMD_FMA
+#endif
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#define GAME_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(GAME_SIMD_SSE) || defined(GAME_SIMD_NEON)
+#define GAME_SIMD_FLOAT4
+#endif
+
+#include <cstdint>
+
+namespace game::simd
+{
+#if defined(GAME_SIMD_SSE)
+    /** Four floats in a register. */
+    using float4 = __m128;
+
+    inline auto load(const float *ptr) -> float4
+    {
+        return _mm_loadu_ps(ptr);
+    }
+
+    inline auto store(float *ptr, float4 v) -> void
+    {
+        _mm_storeu_ps(ptr, v);
+    }
+
+    /**
+     * Load from a 16 byte aligned address.
+     */
+    inline auto load_aligned(const float *ptr) -> float4
+    {
+        return _mm_load_ps(ptr);
+    }
+
+    /**
+     * Store to a 16 byte aligned address.
+     */
+    inline auto store_aligned(float *ptr, float4 v) -> void
+    {
+        _mm_store_ps(ptr, v);
+    }
+
+    inline auto splat(float value) -> float4
+    {
+        return _mm_set1_ps(value);
+    }
+
+    inline auto add(float4 a, float4 b) -> float4
+    {
+        return _mm_add_ps(a, b);
+    }
+
+    inline auto sub(float4 a, float4 b) -> float4
+    {
+        return _mm_sub_ps(a, b);
+    }
+
+    inline auto mul(float4 a, float4 b) -> float4
+    {
+        return _mm_mul_ps(a, b);
+    }
+
+    inline auto abs(float4 v) -> float4
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.f), v);
+    }
+
+    /**
+     * Compare lane by lane.
+     *
+     * @returns
+     *   Bit n set if a[n] < b[n].
+     */
+    inline auto less_mask(float4 a, float4 b) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmplt_ps(a, b)));
+    }
+
+    /**
+     * Keep the lanes of v where a > b, zero the others.
+     */
+    inline auto select_greater(float4 v, float4 a, float4 b) -> float4
+    {
+        return _mm_and_ps(v, _mm_cmpgt_ps(a, b));
+    }
+
+    /**
+     * Approximate 1 / sqrt(v), the hardware estimate refined with a Newton-Raphson step (relative error below 1e-6).
+     */
+    inline auto rsqrt(float4 v) -> float4
+    {
+        const auto estimate = _mm_rsqrt_ps(v);
+        const auto half_v_ee = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(.5f), v), _mm_mul_ps(estimate, estimate));
+        return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), half_v_ee));
+    }
+
+    /**
+     * Add all four lanes.
+     */
+    inline auto sum(float4 v) -> float
+    {
+        const auto shuffled = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        const auto pairs = _mm_add_ps(v, shuffled);
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(shuffled, pairs)));
+    }
+
+    /**
+     * Rotate the first three lanes, (x, y, z, w) becomes (y, z, x, w).
+     */
+    inline auto yzxw(float4 v) -> float4
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    /**
+     * Compute a * b + c, fused if the target has FMA.
+     */
+    inline auto madd(float4 a, float4 b, float4 c) -> float4
+    {
+#if defined(GAME_SIMD_FMA)
+        return _mm_fmadd_ps(a, b, c);
+#else
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+    }
+
+    /**
+     * Transpose four registers as the rows of a 4x4 matrix.
+     */
+    inline auto transpose(float4 &r0, float4 &r1, float4 &r2, float4 &r3) -> void
+    {
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    }
+
+#if defined(GAME_SIMD_AVX)
+    inline auto madd(__m256 a, __m256 b, __m256 c) -> __m256
+    {
+#if defined(GAME_SIMD_FMA)
+        return _mm256_fmadd_ps(a, b, c);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+    }
+#endif
+#elif defined(GAME_SIMD_NEON)
+    using float4 = float32x4_t;
+
+    inline auto load(const float *ptr) -> float4
+    {
+        return vld1q_f32(ptr);
+    }
+
+    inline auto store(float *ptr, float4 v) -> void
+    {
+        vst1q_f32(ptr, v);
+    }
+
+    inline auto load_aligned(const float *ptr) -> float4
+    {
+        return vld1q_f32(ptr);
+    }
+
+    inline auto store_aligned(float *ptr, float4 v) -> void
+    {
+        vst1q_f32(ptr, v);
+    }
+
+    inline auto splat(float value) -> float4
+    {
+        return vdupq_n_f32(value);
+    }
+
+    inline auto add(float4 a, float4 b) -> float4
+    {
+        return vaddq_f32(a, b);
+    }
+
+    inline auto sub(float4 a, float4 b) -> float4
+    {
+        return vsubq_f32(a, b);
+    }
+
+    inline auto mul(float4 a, float4 b) -> float4
+    {
+        return vmulq_f32(a, b);
+    }
+
+    inline auto abs(float4 v) -> float4
+    {
+        return vabsq_f32(v);
+    }
+
+    inline auto less_mask(float4 a, float4 b) -> std::uint32_t
+    {
+        static constexpr std::uint32_t bits[] = {1u, 2u, 4u, 8u};
+        return vaddvq_u32(vandq_u32(vcltq_f32(a, b), vld1q_u32(bits)));
+    }
+
+    inline auto select_greater(float4 v, float4 a, float4 b) -> float4
+    {
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), vcgtq_f32(a, b)));
+    }
+
+    inline auto rsqrt(float4 v) -> float4
+    {
+        // the NEON estimate is only 8 bits, it needs two steps
+        auto estimate = vrsqrteq_f32(v);
+        estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(v, estimate), estimate));
+        return vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(v, estimate), estimate));
+    }
+
+    inline auto sum(float4 v) -> float
+    {
+        return vaddvq_f32(v);
+    }
+
+    inline auto yzxw(float4 v) -> float4
+    {
+        const auto yzwx = vextq_f32(v, v, 1);
+        return vsetq_lane_f32(vgetq_lane_f32(v, 3), vsetq_lane_f32(vgetq_lane_f32(v, 0), yzwx, 2), 3);
+    }
+
+    inline auto madd(float4 a, float4 b, float4 c) -> float4
+    {
+        return vfmaq_f32(c, a, b);
+    }
+
+    inline auto transpose(float4 &r0, float4 &r1, float4 &r2, float4 &r3) -> void
+    {
+        const auto t0 = vreinterpretq_f64_f32(vtrn1q_f32(r0, r1));
+        const auto t1 = vreinterpretq_f64_f32(vtrn2q_f32(r0, r1));
+        const auto t2 = vreinterpretq_f64_f32(vtrn1q_f32(r2, r3));
+        const auto t3 = vreinterpretq_f64_f32(vtrn2q_f32(r2, r3));
+
+        r0 = vreinterpretq_f32_f64(vtrn1q_f64(t0, t2));
+        r1 = vreinterpretq_f32_f64(vtrn1q_f64(t1, t3));
+        r2 = vreinterpretq_f32_f64(vtrn2q_f64(t0, t2));
+        r3 = vreinterpretq_f32_f64(vtrn2q_f64(t1, t3));
+    }
+#endif
+}
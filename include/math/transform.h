@@ -29,7 +29,7 @@ namespace game
 
         constexpr operator Matrix4() const
         {
-            return Matrix4{position} * Matrix4{rotation} * Matrix4{scale, Matrix4::Scale{}};
+            return Matrix4::compose(position, rotation, scale);
         }
 
         Vector3 position;
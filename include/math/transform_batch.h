@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "math/matrix3x4.h"
+#include "math/matrix4.h"
+#include "math/transform.h"
+
+namespace game
+{
+    /**
+     * Transforms of many objects stored as structure of arrays, one array per component, so that their model matrices
+     * can be composed several at a time with simd.
+     */
+    class TransformBatch
+    {
+    public:
+        /**
+         * Append a transform.
+         *
+         * @param transform
+         *   Transform to append, its rotation must be normalized.
+         */
+        auto add(const Transform &transform) -> void;
+
+        /**
+         * Remove all transforms, keeping the memory for the next batch.
+         */
+        auto clear() -> void;
+
+        /**
+         * Get the number of transforms.
+         */
+        auto size() const -> std::size_t;
+
+        /**
+         * Compose the model matrix of every transform, same as Matrix4::compose on each of them.
+         *
+         * @param models
+         *   Span to write the matrices to, in the order the transforms were added. Must hold size() matrices.
+         */
+        auto compose(std::span<Matrix4> models) const -> void;
+        auto compose(std::span<Matrix3x4> models) const -> void;
+
+    private:
+        template <class M>
+        auto compose_into(std::span<M> models) const -> void;
+
+        std::vector<float> _position_x;
+        std::vector<float> _position_y;
+        std::vector<float> _position_z;
+        std::vector<float> _rotation_x;
+        std::vector<float> _rotation_y;
+        std::vector<float> _rotation_z;
+        std::vector<float> _rotation_w;
+        std::vector<float> _scale_x;
+        std::vector<float> _scale_y;
+        std::vector<float> _scale_z;
+    };
+}
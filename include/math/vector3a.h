@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cmath>
+#include <format>
+#include <limits>
+#include <span>
+#include <string>
+
+#include "math/simd.h"
+#include "math/vector3.h"
+
+namespace game
+{
+    /**
+     * A Vector3 padded to 16 bytes and aligned, so it loads into a SIMD register in one instruction. Meant for hot
+     * loops (collision, culling, camera), gameplay code should keep using Vector3 and convert at the boundary.
+     *
+     * The padding lane w is always zero, so it does not change dot products, lengths or cross products.
+     */
+    struct alignas(16) Vector3A
+    {
+        constexpr Vector3A()
+            : Vector3A(0.f)
+        {
+        }
+
+        constexpr Vector3A(float scalar)
+            : Vector3A(scalar, scalar, scalar)
+        {
+        }
+
+        constexpr Vector3A(float x, float y, float z)
+            : x(x), y(y), z(z), w(0.f)
+        {
+        }
+
+        explicit constexpr Vector3A(const Vector3 &v)
+            : Vector3A(v.x, v.y, v.z)
+        {
+        }
+
+        float x;
+        float y;
+        float z;
+        float w;
+
+        static auto dot(const Vector3A &v1, const Vector3A &v2) -> float
+        {
+#if defined(GAME_SIMD_FLOAT4)
+            return simd::sum(simd::mul(simd::load_aligned(&v1.x), simd::load_aligned(&v2.x)));
+#else
+            return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+#endif
+        }
+
+        static auto cross(const Vector3A &v1, const Vector3A &v2) -> Vector3A
+        {
+#if defined(GAME_SIMD_FLOAT4)
+            const auto a = simd::load_aligned(&v1.x);
+            const auto b = simd::load_aligned(&v2.x);
+
+            auto result = Vector3A{};
+            simd::store_aligned(&result.x, simd::yzxw(simd::sub(simd::mul(a, simd::yzxw(b)), simd::mul(simd::yzxw(a), b))));
+            return result;
+#else
+            return {(v1.y * v2.z) - (v1.z * v2.y), (v1.z * v2.x) - (v1.x * v2.z), (v1.x * v2.y) - (v1.y * v2.x)};
+#endif
+        }
+
+        /**
+         * Normalize with an approximate reciprocal square root, see simd::rsqrt. Unlike Vector3::normalize this is
+         * not overflow safe, components must stay below ~1e19. Below ~1e-19 the squared length is subnormal, where
+         * rsqrt is not accurate, so vectors with a squared length of at most std::numeric_limits<float>::min() are
+         * treated as zero.
+         *
+         * @param v
+         *   Vector to normalize.
+         *
+         * @returns
+         *   v scaled to unit length, or zero if v is (almost) zero.
+         */
+        static auto normalize(const Vector3A &v) -> Vector3A
+        {
+            const auto length_squared = dot(v, v);
+            if (length_squared <= std::numeric_limits<float>::min())
+            {
+                return {};
+            }
+
+#if defined(GAME_SIMD_FLOAT4)
+            const auto vec = simd::load_aligned(&v.x);
+
+            auto result = Vector3A{};
+            simd::store_aligned(&result.x, simd::mul(vec, simd::rsqrt(simd::splat(length_squared))));
+            return result;
+#else
+            const auto scale = 1.f / std::sqrt(length_squared);
+            return {v.x * scale, v.y * scale, v.z * scale};
+#endif
+        }
+
+        /**
+         * Compute the dot products of pairs of vectors, four at a time.
+         *
+         * @param v1
+         *   First vector of each pair.
+         *
+         * @param v2
+         *   Second vector of each pair, same size as v1.
+         *
+         * @param result
+         *   Span to write the dot products to, at least the size of v1.
+         */
+        static auto dot(std::span<const Vector3A> v1, std::span<const Vector3A> v2, std::span<float> result) -> void;
+
+        /**
+         * Compute the cross products of pairs of vectors.
+         *
+         * @param v1
+         *   First vector of each pair.
+         *
+         * @param v2
+         *   Second vector of each pair, same size as v1.
+         *
+         * @param result
+         *   Span to write the cross products to, at least the size of v1. May be v1 or v2.
+         */
+        static auto cross(std::span<const Vector3A> v1, std::span<const Vector3A> v2, std::span<Vector3A> result) -> void;
+
+        /**
+         * Normalize vectors four at a time, see normalize(const Vector3A &).
+         *
+         * @param vectors
+         *   Vectors to normalize.
+         *
+         * @param result
+         *   Span to write the normalized vectors to, at least the size of vectors. May be vectors.
+         */
+        static auto normalize(std::span<const Vector3A> vectors, std::span<Vector3A> result) -> void;
+
+        auto length() const -> float
+        {
+            return std::sqrt(dot(*this, *this));
+        }
+
+        constexpr auto operator==(const Vector3A &) const -> bool = default;
+
+        explicit constexpr operator Vector3() const
+        {
+            return Vector3{x, y, z};
+        }
+
+        auto to_string() const -> std::string;
+    };
+
+    static_assert(sizeof(Vector3A) == 16u);
+
+    constexpr auto operator-=(Vector3A &v1, const Vector3A &v2) -> Vector3A &
+    {
+        v1.x -= v2.x;
+        v1.y -= v2.y;
+        v1.z -= v2.z;
+
+        return v1;
+    }
+    constexpr auto operator-(const Vector3A &v1, const Vector3A &v2) -> Vector3A
+    {
+        auto tmp = v1;
+        return tmp -= v2;
+    }
+    constexpr auto operator+=(Vector3A &v1, const Vector3A &v2) -> Vector3A &
+    {
+        v1.x += v2.x;
+        v1.y += v2.y;
+        v1.z += v2.z;
+
+        return v1;
+    }
+    constexpr auto operator+(const Vector3A &v1, const Vector3A &v2) -> Vector3A
+    {
+        auto tmp = v1;
+        return tmp += v2;
+    }
+    constexpr auto operator*=(Vector3A &v1, float scale) -> Vector3A &
+    {
+        v1.x *= scale;
+        v1.y *= scale;
+        v1.z *= scale;
+
+        return v1;
+    }
+    constexpr auto operator*(const Vector3A &v1, float scale) -> Vector3A
+    {
+        auto tmp = v1;
+        return tmp *= scale;
+    }
+    constexpr auto operator-(const Vector3A &v) -> Vector3A
+    {
+        return {-v.x, -v.y, -v.z};
+    }
+
+    inline auto Vector3A::to_string() const -> std::string
+    {
+        return std::format("x={} y={} z={}", x, y, z);
+    }
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cmath>
+#include <format>
+#include <limits>
+#include <span>
+#include <string>
+
+#include "math/simd.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+namespace game
+{
+    /**
+     * A Vector4 aligned to 16 bytes, so it loads into a SIMD register in one instruction. See Vector3A.
+     */
+    struct alignas(16) Vector4A
+    {
+        constexpr Vector4A()
+            : Vector4A(0.f)
+        {
+        }
+
+        constexpr Vector4A(float scalar)
+            : Vector4A(scalar, scalar, scalar, scalar)
+        {
+        }
+
+        constexpr Vector4A(float x, float y, float z, float w)
+            : x(x), y(y), z(z), w(w)
+        {
+        }
+
+        constexpr Vector4A(const Vector3 &xyz, float w)
+            : Vector4A(xyz.x, xyz.y, xyz.z, w)
+        {
+        }
+
+        explicit constexpr Vector4A(const Vector4 &v)
+            : Vector4A(v.x, v.y, v.z, v.w)
+        {
+        }
+
+        float x;
+        float y;
+        float z;
+        float w;
+
+        static auto dot(const Vector4A &v1, const Vector4A &v2) -> float
+        {
+#if defined(GAME_SIMD_FLOAT4)
+            return simd::sum(simd::mul(simd::load_aligned(&v1.x), simd::load_aligned(&v2.x)));
+#else
+            return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+#endif
+        }
+
+        /**
+         * Normalize with an approximate reciprocal square root, see simd::rsqrt. Components must stay between ~1e-19
+         * and ~1e19, see Vector3A::normalize, vectors with a smaller squared length are treated as zero.
+         *
+         * @param v
+         *   Vector to normalize.
+         *
+         * @returns
+         *   v scaled to unit length, or zero if v is (almost) zero.
+         */
+        static auto normalize(const Vector4A &v) -> Vector4A
+        {
+            const auto length_squared = dot(v, v);
+            if (length_squared <= std::numeric_limits<float>::min())
+            {
+                return {};
+            }
+
+#if defined(GAME_SIMD_FLOAT4)
+            auto result = Vector4A{};
+            simd::store_aligned(&result.x, simd::mul(simd::load_aligned(&v.x), simd::rsqrt(simd::splat(length_squared))));
+            return result;
+#else
+            const auto scale = 1.f / std::sqrt(length_squared);
+            return {v.x * scale, v.y * scale, v.z * scale, v.w * scale};
+#endif
+        }
+
+        /**
+         * Compute the dot products of pairs of vectors, four at a time.
+         *
+         * @param v1
+         *   First vector of each pair.
+         *
+         * @param v2
+         *   Second vector of each pair, same size as v1.
+         *
+         * @param result
+         *   Span to write the dot products to, at least the size of v1.
+         */
+        static auto dot(std::span<const Vector4A> v1, std::span<const Vector4A> v2, std::span<float> result) -> void;
+
+        /**
+         * Normalize vectors four at a time, see normalize(const Vector4A &).
+         *
+         * @param vectors
+         *   Vectors to normalize.
+         *
+         * @param result
+         *   Span to write the normalized vectors to, at least the size of vectors. May be vectors.
+         */
+        static auto normalize(std::span<const Vector4A> vectors, std::span<Vector4A> result) -> void;
+
+        constexpr auto operator==(const Vector4A &) const -> bool = default;
+
+        explicit constexpr operator Vector4() const
+        {
+            return Vector4{x, y, z, w};
+        }
+
+        explicit constexpr operator Vector3() const
+        {
+            return Vector3{x, y, z};
+        }
+
+        auto to_string() const -> std::string;
+    };
+
+    static_assert(sizeof(Vector4A) == 16u);
+
+    constexpr auto operator-=(Vector4A &v1, const Vector4A &v2) -> Vector4A &
+    {
+        v1.x -= v2.x;
+        v1.y -= v2.y;
+        v1.z -= v2.z;
+        v1.w -= v2.w;
+
+        return v1;
+    }
+    constexpr auto operator-(const Vector4A &v1, const Vector4A &v2) -> Vector4A
+    {
+        auto tmp = v1;
+        return tmp -= v2;
+    }
+    constexpr auto operator+=(Vector4A &v1, const Vector4A &v2) -> Vector4A &
+    {
+        v1.x += v2.x;
+        v1.y += v2.y;
+        v1.z += v2.z;
+        v1.w += v2.w;
+
+        return v1;
+    }
+    constexpr auto operator+(const Vector4A &v1, const Vector4A &v2) -> Vector4A
+    {
+        auto tmp = v1;
+        return tmp += v2;
+    }
+    constexpr auto operator*=(Vector4A &v1, float scale) -> Vector4A &
+    {
+        v1.x *= scale;
+        v1.y *= scale;
+        v1.z *= scale;
+        v1.w *= scale;
+
+        return v1;
+    }
+    constexpr auto operator*(const Vector4A &v1, float scale) -> Vector4A
+    {
+        auto tmp = v1;
+        return tmp *= scale;
+    }
+    constexpr auto operator-(const Vector4A &v) -> Vector4A
+    {
+        return {-v.x, -v.y, -v.z, -v.w};
+    }
+
+    inline auto Vector4A::to_string() const -> std::string
+    {
+        return std::format("x={} y={} z={} w={}", x, y, z, w);
+    }
+}
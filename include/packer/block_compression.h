@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/texture.h"
+
+namespace game::packer
+{
+    /**
+     * Expand tightly packed R, RGB or RGBA pixels to RGBA8, which is what all encoders expect.
+     *
+     * @param pixels
+     *   Source pixel data.
+     *
+     * @param num_channels
+     *   Number of channels per pixel in the source data (1, 3 or 4).
+     *
+     * @returns
+     *   Pixel data with four channels per pixel, missing channels are 0 (alpha is 255).
+     */
+    auto expand_to_rgba(std::span<const std::byte> pixels, std::uint32_t num_channels) -> std::vector<std::byte>;
+
+    /**
+     * Encode an RGBA8 image into a block compressed format.
+     *
+     * Images which are not a multiple of four are padded by repeating the edge pixels.
+     *
+     * @param format
+     *   One of the block compressed formats (BC1, BC3, BC5 or BC7).
+     *
+     * @param rgba
+     *   Image data, four bytes per pixel.
+     *
+     * @param width
+     *   Width of image in pixels.
+     *
+     * @param height
+     *   Height of image in pixels.
+     *
+     * @returns
+     *   Encoded blocks in row major order.
+     */
+    auto encode(TextureFormat format, std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height)
+        -> std::vector<std::byte>;
+
+    /**
+     * Decode a block compressed image back into RGBA8, used to verify the encoder.
+     *
+     * Channels not stored by the format are decoded as 0 (alpha as 255).
+     *
+     * @param format
+     *   One of the block compressed formats (BC1, BC3, BC5 or BC7).
+     *
+     * @param blocks
+     *   Encoded blocks in row major order.
+     *
+     * @param width
+     *   Width of image in pixels.
+     *
+     * @param height
+     *   Height of image in pixels.
+     *
+     * @returns
+     *   Image data, four bytes per pixel.
+     */
+    auto decode(TextureFormat format, std::span<const std::byte> blocks, std::uint32_t width, std::uint32_t height)
+        -> std::vector<std::byte>;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace game::packer
+{
+    /**
+     * Downscale an image with a separable Lanczos-3 filter, widened by the scale factor so every source pixel
+     * contributes. Colour channels of sRGB images are filtered in linear space, alpha always is.
+     *
+     * @param pixels
+     *   Tightly packed source pixels.
+     *
+     * @param width
+     *   Width of the source in pixels.
+     *
+     * @param height
+     *   Height of the source in pixels.
+     *
+     * @param num_channels
+     *   Number of channels per pixel (1 to 4), the fourth channel is alpha.
+     *
+     * @param new_width
+     *   Width to scale to, at most width.
+     *
+     * @param new_height
+     *   Height to scale to, at most height.
+     *
+     * @param srgb
+     *   True if the colour channels are sRGB encoded.
+     *
+     * @returns
+     *   Scaled pixels with the same number of channels.
+     */
+    auto downscale_image(
+        std::span<const std::byte> pixels,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t num_channels,
+        std::uint32_t new_width,
+        std::uint32_t new_height,
+        bool srgb) -> std::vector<std::byte>;
+}
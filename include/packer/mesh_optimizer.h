@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "graphics/vertex_data.h"
+
+namespace game::packer
+{
+    /**
+     * Owning mesh data produced by the optimisation passes.
+     */
+    struct OptimizedMesh
+    {
+        std::vector<VertexData> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+    /**
+     * Post-transform vertex cache statistics for an index buffer.
+     */
+    struct VertexCacheStatistics
+    {
+        /** Number of vertices transformed (cache misses). */
+        std::uint32_t vertices_transformed;
+
+        /** Average cache miss ratio, transformed vertices per triangle (0.5 is optimal for large grids, 3 is worst). */
+        float acmr;
+
+        /** Average transform to vertex ratio, transformed vertices per unique vertex (1 is optimal). */
+        float atvr;
+    };
+
+    /**
+     * Merge bitwise identical vertices and remap the index buffer accordingly.
+     *
+     * @param vertices
+     *   Source vertices.
+     *
+     * @param indices
+     *   Triangle list indexing into vertices.
+     *
+     * @returns
+     *   Mesh with unique vertices, in order of first occurrence.
+     */
+    auto deduplicate_vertices(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices) -> OptimizedMesh;
+
+    /**
+     * Reorder triangles for the post-transform vertex cache, using Forsyth's linear-speed algorithm.
+     *
+     * @param indices
+     *   Triangle list.
+     *
+     * @param vertex_count
+     *   Number of vertices referenced by the indices.
+     *
+     * @returns
+     *   Reordered triangle list.
+     */
+    auto optimize_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count) -> std::vector<std::uint32_t>;
+
+    /**
+     * Reorder clusters of a cache optimised triangle list so that outward facing clusters are drawn first, which reduces
+     * overdraw. In the spirit of Tipsify the cache order inside each cluster is kept.
+     *
+     * @param indices
+     *   Triangle list, should already be cache optimised.
+     *
+     * @param vertices
+     *   Vertices referenced by the indices.
+     *
+     * @param threshold
+     *   How much the ACMR is allowed to get worse, 1.05 allows 5%.
+     *
+     * @returns
+     *   Reordered triangle list (or a copy of the input if reordering would exceed the threshold).
+     */
+    auto optimize_overdraw(std::span<const std::uint32_t> indices, std::span<const VertexData> vertices, float threshold)
+        -> std::vector<std::uint32_t>;
+
+    /**
+     * Reorder vertices in order of first use by the index buffer for better vertex fetch locality. Unreferenced vertices
+     * are removed.
+     *
+     * @param vertices
+     *   Source vertices.
+     *
+     * @param indices
+     *   Triangle list indexing into vertices.
+     *
+     * @returns
+     *   Mesh with remapped vertices and indices.
+     */
+    auto optimize_vertex_fetch(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices) -> OptimizedMesh;
+
+    /**
+     * Run all optimisation passes: deduplication, vertex cache, overdraw and vertex fetch.
+     *
+     * @param vertices
+     *   Source vertices.
+     *
+     * @param indices
+     *   Triangle list indexing into vertices.
+     *
+     * @returns
+     *   Optimised mesh.
+     */
+    auto optimize_mesh(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices) -> OptimizedMesh;
+
+    /**
+     * Simulate a FIFO post-transform vertex cache.
+     *
+     * @param indices
+     *   Triangle list.
+     *
+     * @param vertex_count
+     *   Number of vertices referenced by the indices.
+     *
+     * @param cache_size
+     *   Number of entries in the simulated cache.
+     *
+     * @returns
+     *   Cache statistics.
+     */
+    auto analyze_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count, std::size_t cache_size = 16u)
+        -> VertexCacheStatistics;
+
+    /**
+     * Narrow an index buffer to 16 bits.
+     *
+     * @param indices
+     *   Triangle list.
+     *
+     * @returns
+     *   16 bit indices, or an empty optional if any index does not fit.
+     */
+    auto to_short_indices(std::span<const std::uint32_t> indices) -> std::optional<std::vector<std::uint16_t>>;
+
+    auto to_string(const VertexCacheStatistics &obj) -> std::string;
+}
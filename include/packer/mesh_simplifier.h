@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/vertex_data.h"
+
+namespace game::packer
+{
+    /**
+     * A simplified triangle list, it indexes into the same vertices as the mesh it was created from.
+     */
+    struct SimplifiedMesh
+    {
+        std::vector<std::uint32_t> indices;
+
+        /** Object space deviation from the source mesh, in the same units as the vertex positions. */
+        float error;
+    };
+
+    /**
+     * Simplify a mesh with quadric error metric edge collapses (Garland and Heckbert). Vertices are only ever collapsed
+     * onto existing vertices, so the result can share the vertex buffer of the source.
+     *
+     * Vertices on open borders and on attribute seams (several vertices sharing a position) are never moved, which keeps
+     * the silhouette of open meshes and avoids cracks along uv seams.
+     *
+     * @param vertices
+     *   Mesh vertices.
+     *
+     * @param indices
+     *   Triangle list indexing into vertices.
+     *
+     * @param target_index_count
+     *   Stop once the triangle list is at most this long.
+     *
+     * @param target_error
+     *   Largest object space error a single collapse is allowed to introduce.
+     *
+     * @returns
+     *   Simplified triangle list and the error it introduced.
+     */
+    auto simplify_mesh(
+        std::span<const VertexData> vertices,
+        std::span<const std::uint32_t> indices,
+        std::size_t target_index_count,
+        float target_error) -> SimplifiedMesh;
+
+    /**
+     * Build a chain of progressively coarser levels of detail, each roughly halving the triangle count of the one
+     * before it. Levels that would not save at least a fifth of the previous level are not generated. Every level is
+     * optimised for the vertex cache.
+     *
+     * @param vertices
+     *   Mesh vertices.
+     *
+     * @param indices
+     *   Triangle list of the full detail mesh.
+     *
+     * @param max_levels
+     *   Maximum number of levels to generate, not counting the full detail mesh.
+     *
+     * @returns
+     *   Coarser levels, ordered by increasing error.
+     */
+    auto generate_lod_chain(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices, std::size_t max_levels)
+        -> std::vector<SimplifiedMesh>;
+}
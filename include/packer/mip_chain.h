@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace game::packer
+{
+    struct MipLevel
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::vector<std::byte> data;
+    };
+
+    /**
+     * Get the number of levels in a full mip chain, down to and including 1x1.
+     *
+     * @param width
+     *   Width of the top level.
+     *
+     * @param height
+     *   Height of the top level.
+     *
+     * @returns
+     *   Number of mip levels.
+     */
+    auto mip_level_count(std::uint32_t width, std::uint32_t height) -> std::uint32_t;
+
+    /**
+     * Generate a full mip chain for an RGBA8 image using a 2x2 box filter. Colour channels of sRGB images are
+     * averaged in linear space, alpha always is.
+     *
+     * @param rgba
+     *   Image data, four bytes per pixel.
+     *
+     * @param width
+     *   Width of image in pixels.
+     *
+     * @param height
+     *   Height of image in pixels.
+     *
+     * @param srgb
+     *   True if the colour channels are sRGB encoded.
+     *
+     * @returns
+     *   All mip levels, the first being a copy of the source image.
+     */
+    auto generate_mip_chain(std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height, bool srgb) -> std::vector<MipLevel>;
+}
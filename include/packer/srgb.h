@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cmath>
+
+namespace game::packer
+{
+    /**
+     * Decode an sRGB encoded value to linear.
+     *
+     * @param value
+     *   sRGB encoded value in [0, 1].
+     *
+     * @returns
+     *   Linear value in [0, 1].
+     */
+    inline auto srgb_to_linear(float value) -> float
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    /**
+     * Encode a linear value as sRGB.
+     *
+     * @param value
+     *   Linear value in [0, 1].
+     *
+     * @returns
+     *   sRGB encoded value in [0, 1].
+     */
+    inline auto linear_to_srgb(float value) -> float
+    {
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "graphics/compact_vertex_data.h"
+#include "graphics/vertex_data.h"
+
+namespace game::packer
+{
+    /**
+     * Owning compact vertex data produced by quantize_vertices.
+     */
+    struct QuantizedVertices
+    {
+        std::vector<CompactVertexData> vertices;
+        VertexQuantization quantization;
+    };
+
+    /**
+     * Largest errors introduced by quantisation, measured against the source vertices.
+     */
+    struct QuantizationError
+    {
+        /** Largest position error in object space units. */
+        float position;
+
+        /** Largest angle between source and decoded normal or tangent, in degrees. */
+        float direction;
+
+        /** Largest uv error. */
+        float uv;
+    };
+
+    /**
+     * Pack vertices into the compact layout. Positions are quantised relative to the bounding box of the mesh.
+     *
+     * @param vertices
+     *   Source vertices.
+     *
+     * @returns
+     *   Compact vertices and the quantisation needed to decode them.
+     */
+    auto quantize_vertices(std::span<const VertexData> vertices) -> QuantizedVertices;
+
+    /**
+     * Measure how much precision quantize_vertices lost.
+     *
+     * @param vertices
+     *   Source vertices.
+     *
+     * @param quantized
+     *   Result of quantize_vertices for the same vertices.
+     *
+     * @returns
+     *   Largest errors.
+     */
+    auto measure_quantization_error(std::span<const VertexData> vertices, const QuantizedVertices &quantized) -> QuantizationError;
+
+    auto to_string(const QuantizationError &obj) -> std::string;
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "file.h"
+#include "resources/pack.h"
+#include "resources/resource_loader.h"
+#include "utils/ensure.h"
+
+namespace game
+{
+    /**
+     * Completion handle of a background load. Copies share the same load, a scheduler task can co_await a Wait on it
+     * and take the result once it is ready.
+     */
+    template <class T>
+    class LoadHandle
+    {
+    public:
+        auto name() const -> const std::string &
+        {
+            return _state->name;
+        }
+
+        auto is_ready() const -> bool
+        {
+            return _state->ready.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Block until the load finished, for shutdown and other places that cannot yield to the scheduler.
+         */
+        auto wait() const -> void
+        {
+            _state->ready.wait(false, std::memory_order_acquire);
+        }
+
+        /**
+         * Take the loaded resource, rethrowing whatever the load threw. Can only be called once per load.
+         *
+         * @returns
+         *   Loaded resource, heap allocated as files and packs must not move.
+         */
+        auto get() -> std::unique_ptr<T>
+        {
+            expect(is_ready(), "load of {} not finished", _state->name);
+
+            if (_state->error)
+            {
+                std::rethrow_exception(_state->error);
+            }
+
+            expect(_state->value != nullptr, "load of {} already taken", _state->name);
+            return std::move(_state->value);
+        }
+
+    private:
+        friend class AsyncResourceLoader;
+
+        struct State
+        {
+            std::string name;
+            std::atomic<bool> ready = false;
+            std::unique_ptr<T> value = nullptr;
+            std::exception_ptr error = nullptr;
+        };
+
+        LoadHandle(std::string_view name)
+            : _state{std::make_shared<State>()}
+        {
+            _state->name = name;
+        }
+
+        std::shared_ptr<State> _state;
+    };
+
+    /**
+     * Loads resources on worker threads so that opening, mapping and paging in a file never blocks the game thread.
+     * Files are paged in before they are handed over, packs are also decompressed. Prefetches share the same workers.
+     */
+    class AsyncResourceLoader
+    {
+    public:
+        /**
+         * Start the workers.
+         *
+         * @param loader
+         *   Loader to open resources with, must outlive this.
+         *
+         * @param thread_count
+         *   Number of workers, loads beyond that are queued.
+         */
+        AsyncResourceLoader(const ResourceLoader &loader, std::uint32_t thread_count = 2u);
+        ~AsyncResourceLoader();
+
+        AsyncResourceLoader(const AsyncResourceLoader &) = delete;
+        auto operator=(const AsyncResourceLoader &) -> AsyncResourceLoader & = delete;
+
+        /**
+         * Load a file in the background.
+         *
+         * @param name
+         *   Name of the resource.
+         *
+         * @returns
+         *   Handle that becomes ready once the file is mapped and paged in.
+         */
+        auto load(std::string_view name) -> LoadHandle<File>;
+
+        /**
+         * Load a pack in the background.
+         *
+         * @param name
+         *   Name of the pack.
+         *
+         * @returns
+         *   Handle that becomes ready once the pack can be read without touching the disk.
+         */
+        auto load_pack(std::string_view name) -> LoadHandle<Pack>;
+
+        /**
+         * Start reading a range of a file into the page cache, without waiting for it or keeping it open. A later
+         * load of the file then finds it in memory. Failures are only logged, a prefetch is a hint.
+         *
+         * @param name
+         *   Name of the resource.
+         *
+         * @param offset
+         *   Start of the range in bytes.
+         *
+         * @param length
+         *   Length of the range in bytes, clamped to the end of the file.
+         */
+        auto prefetch(std::string_view name, std::size_t offset = 0u, std::size_t length = std::numeric_limits<std::size_t>::max()) -> void;
+
+        /**
+         * Run any load on the workers.
+         *
+         * @param name
+         *   Name of what is loaded, for messages.
+         *
+         * @param load
+         *   Function returning a std::unique_ptr<T>, called on a worker. What it throws is rethrown by get().
+         *
+         * @returns
+         *   Handle that becomes ready once load returned.
+         */
+        template <class T, class F>
+        auto submit(std::string_view name, F &&load) -> LoadHandle<T>
+        {
+            auto handle = LoadHandle<T>{name};
+
+            auto job = [state = handle._state, load = std::forward<F>(load)]
+            {
+                try
+                {
+                    state->value = load();
+                }
+                catch (...)
+                {
+                    state->error = std::current_exception();
+                }
+
+                state->ready.store(true, std::memory_order_release);
+                state->ready.notify_all();
+            };
+
+            enqueue(std::move(job));
+
+            return handle;
+        }
+
+    private:
+        auto enqueue(std::move_only_function<void()> job) -> void;
+        auto run_worker(std::stop_token stop) -> void;
+
+        const ResourceLoader &_loader;
+        std::mutex _mutex;
+        std::condition_variable_any _jobs_available;
+        std::deque<std::move_only_function<void()>> _jobs;
+
+        /** Last member, so the workers are stopped and joined before the queue goes away. */
+        std::vector<std::jthread> _workers;
+    };
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "resources/resource_id.h"
+#include "utils/ensure.h"
+
+namespace game
+{
+    /**
+     * Storage for the objects of a single type in a ConcurrentResourceCache. Objects are never erased, which is what
+     * makes lookups lock free: a lookup only follows atomic pointers in a fixed bucket array, inserts link new nodes in
+     * under one of several shard locks. Objects never move.
+     */
+    template <class T>
+    class ConcurrentResourceStore
+    {
+    public:
+        /**
+         * Create an empty store.
+         *
+         * @param bucket_count
+         *   Number of hash buckets, fixed for the lifetime of the store. Lookups slow down once there are many more
+         *   objects than buckets.
+         */
+        explicit ConcurrentResourceStore(std::size_t bucket_count = 1024u)
+            : _buckets(bucket_count),
+              _shards{},
+              _size{}
+        {
+            expect(bucket_count > 0u, "need at least one bucket");
+        }
+
+        ~ConcurrentResourceStore()
+        {
+            for (auto &bucket : _buckets)
+            {
+                auto *node = bucket.load(std::memory_order_relaxed);
+                while (node != nullptr)
+                {
+                    delete std::exchange(node, node->next);
+                }
+            }
+        }
+
+        ConcurrentResourceStore(const ConcurrentResourceStore &) = delete;
+        auto operator=(const ConcurrentResourceStore &) -> ConcurrentResourceStore & = delete;
+
+        /**
+         * Construct an object. Safe to call from any thread.
+         *
+         * @param name
+         *   Name of the object, must not be in the store yet.
+         *
+         * @param args
+         *   Arguments to pass to the constructor of the object.
+         *
+         * @returns
+         *   Pointer to the object, valid until the store is destroyed.
+         */
+        template <class... Args>
+        auto insert(std::string_view name, Args &&...args) -> T *
+        {
+            auto node = std::make_unique<Node>(name);
+            node->value.emplace(T{std::forward<Args>(args)...});
+            node->state.store(State::READY, std::memory_order_relaxed);
+
+            auto *obj = std::addressof(*node->value);
+            expect(link(std::move(node)) == nullptr, "{} already exists", name);
+
+            return obj;
+        }
+
+        /**
+         * Get an object, creating it if it doesn't exist yet. Safe to call from any thread, if several threads ask for
+         * the same object it is created exactly once and the others wait for it. If creating throws the exception is
+         * passed on and one of the waiting threads, or the next caller, tries again.
+         *
+         * @param name
+         *   Name of the object.
+         *
+         * @param create
+         *   Function returning the object, only called if it doesn't exist. Must not ask for the same object.
+         *
+         * @returns
+         *   Pointer to the object, valid until the store is destroyed.
+         */
+        template <class F>
+        auto get_or_create(std::string_view name, F &&create) -> T *
+        {
+            const auto id = ResourceId{name};
+
+            auto *node = find_node(id);
+            if (node == nullptr)
+            {
+                // state starts out as BUILDING, so whoever links the node builds it
+                auto new_node = std::make_unique<Node>(name);
+                auto *candidate = new_node.get();
+
+                node = link(std::move(new_node));
+                if (node == nullptr)
+                {
+                    return build(*candidate, std::forward<F>(create));
+                }
+            }
+
+            while (true)
+            {
+                auto state = node->state.load(std::memory_order_acquire);
+                switch (state)
+                {
+                case State::READY:
+                    return std::addressof(*node->value);
+                case State::BUILDING:
+                    node->state.wait(State::BUILDING, std::memory_order_acquire);
+                    break;
+                case State::FAILED:
+                    if (node->state.compare_exchange_strong(state, State::BUILDING, std::memory_order_acquire))
+                    {
+                        return build(*node, std::forward<F>(create));
+                    }
+                    break;
+                }
+            }
+        }
+
+        /**
+         * Look up an object, never blocks.
+         *
+         * @param id
+         *   Id of the object.
+         *
+         * @returns
+         *   Pointer to the object, nullptr if it doesn't exist or is still being created.
+         */
+        auto find(ResourceId id) const -> T *
+        {
+            auto *node = find_node(id);
+            if (node == nullptr || node->state.load(std::memory_order_acquire) != State::READY)
+            {
+                return nullptr;
+            }
+
+            return std::addressof(*node->value);
+        }
+
+        /**
+         * Get the number of objects, including those still being created.
+         */
+        auto size() const -> std::size_t
+        {
+            return _size.load(std::memory_order_relaxed);
+        }
+
+    private:
+        enum class State : std::uint8_t
+        {
+            BUILDING,
+            READY,
+            FAILED
+        };
+
+        struct Node
+        {
+            explicit Node(std::string_view name)
+                : id{name},
+                  name{name}
+            {
+            }
+
+            ResourceId id;
+            std::string name;
+            std::atomic<State> state = State::BUILDING;
+            std::optional<T> value = std::nullopt;
+            Node *next = nullptr;
+        };
+
+        /** Inserts into buckets of different shards do not wait for each other, a bucket always belongs to the same shard. */
+        static constexpr auto shard_count = 16u;
+
+        auto bucket_index(ResourceId id) const -> std::size_t
+        {
+            return static_cast<std::size_t>(id.value % _buckets.size());
+        }
+
+        auto find_node(ResourceId id) const -> Node *
+        {
+            // next is written before a node is published and never changes afterwards
+            for (auto *node = _buckets[bucket_index(id)].load(std::memory_order_acquire); node != nullptr; node = node->next)
+            {
+                if (node->id == id)
+                {
+                    return node;
+                }
+            }
+
+            return nullptr;
+        }
+
+        /**
+         * Publish a node, unless one with the same id got there first.
+         *
+         * @returns
+         *   nullptr if the node was linked, else the existing node.
+         */
+        auto link(std::unique_ptr<Node> node) -> Node *
+        {
+            const auto id = node->id;
+            const auto index = bucket_index(id);
+            auto &head = _buckets[index];
+
+            // all inserts into a bucket take the same lock
+            const auto lock = std::scoped_lock{_shards[index % shard_count]};
+
+            if (auto *existing = find_node(id); existing != nullptr)
+            {
+                expect(existing->name == node->name, "{} and {} have the same id", existing->name, node->name);
+                return existing;
+            }
+
+            node->next = head.load(std::memory_order_relaxed);
+            head.store(node.release(), std::memory_order_release);
+            _size.fetch_add(1u, std::memory_order_relaxed);
+
+            return nullptr;
+        }
+
+        template <class F>
+        auto build(Node &node, F &&create) -> T *
+        {
+            try
+            {
+                node.value.emplace(std::forward<F>(create)());
+            }
+            catch (...)
+            {
+                node.state.store(State::FAILED, std::memory_order_release);
+                node.state.notify_all();
+                throw;
+            }
+
+            node.state.store(State::READY, std::memory_order_release);
+            node.state.notify_all();
+
+            return std::addressof(*node.value);
+        }
+
+        std::vector<std::atomic<Node *>> _buckets;
+        std::array<std::mutex, shard_count> _shards;
+        std::atomic<std::size_t> _size;
+    };
+
+    /**
+     * A resource cache that can be used from several threads at once, e.g. by parallel loaders. Lookups are lock free,
+     * inserts only lock a shard of the cache. Unlike ResourceCache objects cannot be erased, they stay until the cache is
+     * destroyed, so it suits resources that are loaded once and then only read.
+     */
+    template <class... T>
+    class ConcurrentResourceCache
+    {
+    public:
+        ConcurrentResourceCache() = default;
+
+        ConcurrentResourceCache(const ConcurrentResourceCache &) = delete;
+        auto operator=(const ConcurrentResourceCache &) -> ConcurrentResourceCache & = delete;
+
+        /**
+         * Insert an object into the cache (of the given type).
+         *
+         * @param name
+         *   Name of object to insert, must not exist.
+         *
+         * @param args
+         *   Arguments to pass to the constructor of the object.
+         *
+         * @returns
+         *   Pointer to the object.
+         */
+        template <class U, class... Args>
+        auto insert(std::string_view name, Args &&...args) -> U *
+        {
+            return std::get<ConcurrentResourceStore<U>>(_stores).insert(name, std::forward<Args>(args)...);
+        }
+
+        /**
+         * Get an object, creating it exactly once no matter how many threads ask for it.
+         *
+         * @param name
+         *   Name of object.
+         *
+         * @param create
+         *   Function returning the object, called if it doesn't exist yet.
+         *
+         * @returns
+         *   Pointer to the object.
+         */
+        template <class U, class F>
+        auto get_or_create(std::string_view name, F &&create) -> U *
+        {
+            return std::get<ConcurrentResourceStore<U>>(_stores).get_or_create(name, std::forward<F>(create));
+        }
+
+        /**
+         * Get an object.
+         *
+         * @param name
+         *   Name of object to get, undefined behaviour if it doesn't exist.
+         *
+         * @returns
+         *   Pointer to requested object.
+         */
+        template <class U>
+        auto get(std::string_view name) const -> U *
+        {
+            auto *obj = std::get<ConcurrentResourceStore<U>>(_stores).find(ResourceId{name});
+            expect(obj != nullptr, "{} doesn't exist", name);
+
+            return obj;
+        }
+
+        template <class U>
+        auto get(ResourceId id) const -> U *
+        {
+            auto *obj = std::get<ConcurrentResourceStore<U>>(_stores).find(id);
+            expect(obj != nullptr, "{} doesn't exist", id.value);
+
+            return obj;
+        }
+
+        /**
+         * Query, if a name is in cache
+         *
+         * @param name
+         *   Name to query.
+         *
+         * @returns
+         *   true, if the object exists and is not being created anymore
+         */
+        template <class U>
+        auto contains(std::string_view name) const -> bool
+        {
+            return contains<U>(ResourceId{name});
+        }
+
+        template <class U>
+        auto contains(ResourceId id) const -> bool
+        {
+            return std::get<ConcurrentResourceStore<U>>(_stores).find(id) != nullptr;
+        }
+
+    private:
+        /** Object store for given types. */
+        std::tuple<ConcurrentResourceStore<T>...> _stores;
+    };
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "file.h"
+#include "resources/resource_loader.h"
+#include "tlv/tlv_sink.h"
+
+namespace game
+{
+    /**
+     * How the packer stores the TLV of a pack on disk.
+     */
+    enum class PackMode
+    {
+        /** Single zstd frame at the default level, smallest on disk. */
+        ZSTD,
+
+        /** Independent zstd frames, decompressed in parallel. */
+        ZSTD_CHUNKED,
+
+        /** Chunked zstd at a negative level, close to lz4 in speed. */
+        ZSTD_FAST,
+
+        /** Uncompressed, the TLV is read straight from the mapped file. */
+        RAW,
+    };
+
+    /**
+     * Encode a TLV buffer for writing to disk.
+     *
+     * @param tlv
+     *   Contents of the pack.
+     *
+     * @param mode
+     *   How to store it.
+     *
+     * @returns
+     *   Bytes to write.
+     */
+    auto encode_pack(std::span<const std::byte> tlv, PackMode mode) -> std::vector<std::byte>;
+
+    /**
+     * Create a sink that encodes a TLV as it is written, producing the same kind of pack as encode_pack. The single
+     * frame of a streamed ZSTD pack does not store its content size, decompress handles that.
+     *
+     * @param path
+     *   File to write the pack to, replaced if it exists.
+     *
+     * @param mode
+     *   How to store it.
+     *
+     * @returns
+     *   Sink to pass to a TlvWriter.
+     */
+    auto create_pack_sink(const std::filesystem::path &path, PackMode mode) -> std::unique_ptr<TlvSink>;
+
+    /**
+     * A pack loaded for reading. Compressed packs are decompressed into memory, raw packs are used in place from the
+     * mapped file so pages are only read in when an entry is touched.
+     */
+    class Pack
+    {
+    public:
+        /**
+         * Load a pack, the mode is detected from its contents.
+         *
+         * @param loader
+         *   Loader to open the pack with.
+         *
+         * @param name
+         *   Name of the pack.
+         */
+        Pack(const ResourceLoader &loader, std::string_view name);
+
+        /**
+         * Get the TLV of the pack, valid for the lifetime of the pack.
+         *
+         * @returns
+         *   TLV bytes.
+         */
+        auto as_bytes() const -> std::span<const std::byte>;
+
+        /**
+         * Check if the pack is read straight from the mapped file.
+         *
+         * @returns
+         *   True for raw packs.
+         */
+        auto is_mapped() const -> bool;
+
+        /**
+         * Give the OS a hint on how the mapped file is going to be read, ignored for decompressed packs.
+         *
+         * @param hint
+         *   How the pack is going to be read.
+         */
+        auto advise(AccessHint hint) const -> void;
+
+    private:
+        File _file;
+        std::vector<std::byte> _decompressed;
+    };
+
+    auto to_string(PackMode obj) -> std::string;
+}
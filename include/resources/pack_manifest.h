@@ -0,0 +1,60 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "utils/string_unordered_map.h"
+
+namespace game
+{
+    /**
+     * Which packs make up the game's resources. The base pack is always mounted, a level pack only while the level
+     * using it is running.
+     *
+     * The manifest is a text file with one statement per line, blank lines and lines starting with # are ignored:
+     *
+     *   base <pack>
+     *   level <level script> <pack>
+     */
+    struct PackManifest
+    {
+        std::string base = "resources";
+
+        /** Level script name to the name of its pack. */
+        StringUnorderedMap<std::string> level_packs = {};
+
+        /**
+         * Get the pack of a level.
+         *
+         * @param level_name
+         *   Name of the level script.
+         *
+         * @returns
+         *   Name of the pack, empty if the level only uses the base pack.
+         */
+        auto level_pack(std::string_view level_name) const -> std::optional<std::string>;
+    };
+
+    /**
+     * Parse a pack manifest.
+     *
+     * @param text
+     *   Contents of the manifest.
+     *
+     * @returns
+     *   Parsed manifest, without a base statement the base pack is "resources".
+     */
+    auto parse_pack_manifest(std::string_view text) -> PackManifest;
+
+    /**
+     * Write a pack manifest, the inverse of parse_pack_manifest.
+     *
+     * @param manifest
+     *   Manifest to write.
+     *
+     * @returns
+     *   Manifest text, level statements are sorted by level script name so the output is stable.
+     */
+    auto write_pack_manifest(const PackManifest &manifest) -> std::string;
+}
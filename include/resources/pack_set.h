@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "file.h"
+#include "resources/pack.h"
+#include "resources/pack_manifest.h"
+#include "resources/resource_loader.h"
+#include "tlv/tlv_entry.h"
+#include "tlv/tlv_reader.h"
+
+namespace game
+{
+    /**
+     * The packs currently mounted. The base pack stays mounted for the lifetime of the set, level packs are mounted
+     * and unmounted as levels come and go. Names resolve against the most recently mounted pack first and the base
+     * pack last, so a level pack can override a base asset.
+     */
+    class PackSet
+    {
+    public:
+        /**
+         * Read the manifest and mount the base pack. Without a manifest the base pack is "resources" and there are no
+         * level packs.
+         *
+         * @param loader
+         *   Loader to open the manifest and packs with, must outlive the set.
+         *
+         * @param manifest_name
+         *   Name of the manifest.
+         */
+        PackSet(const ResourceLoader &loader, std::string_view manifest_name);
+
+        PackSet(const PackSet &) = delete;
+        auto operator=(const PackSet &) -> PackSet & = delete;
+
+        auto manifest() const -> const PackManifest &;
+
+        /**
+         * Get the reader of the base pack.
+         */
+        auto base() const -> const TlvReader &;
+
+        /**
+         * Mount a pack, mounting an already mounted pack is a no-op.
+         *
+         * @param name
+         *   Name of the pack.
+         *
+         * @returns
+         *   Reader of the pack, valid until it is unmounted.
+         */
+        auto mount(std::string_view name) -> const TlvReader &;
+
+        /**
+         * Mount a pack that was already loaded, such as by an AsyncResourceLoader. If a pack of that name is already
+         * mounted the new one is dropped.
+         *
+         * @param name
+         *   Name of the pack.
+         *
+         * @param pack
+         *   Loaded pack.
+         *
+         * @returns
+         *   Reader of the pack, valid until it is unmounted.
+         */
+        auto mount(std::string_view name, std::unique_ptr<Pack> pack) -> const TlvReader &;
+
+        /**
+         * Unmount a pack, everything read from it is invalidated. The base pack cannot be unmounted.
+         *
+         * @param name
+         *   Name of the pack.
+         */
+        auto unmount(std::string_view name) -> void;
+
+        auto is_mounted(std::string_view name) const -> bool;
+
+        /**
+         * Give the OS a hint on how the mounted packs are going to be read, see Pack::advise.
+         *
+         * @param hint
+         *   How the packs are going to be read.
+         */
+        auto advise(AccessHint hint) const -> void;
+
+        /**
+         * Find the first entry matching a predicate, in resolution order.
+         *
+         * @param pred
+         *   Predicate to match entries with.
+         *
+         * @returns
+         *   The entry if any pack has one, valid while its pack is mounted.
+         */
+        template <class P>
+        auto find(P &&pred) const -> std::optional<TlvEntry>
+        {
+            for (const auto &mounted : _packs | std::views::reverse)
+            {
+                const auto entry = std::ranges::find_if(mounted->reader, pred);
+                if (entry != std::ranges::end(mounted->reader))
+                {
+                    return *entry;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+    private:
+        struct MountedPack
+        {
+            MountedPack(std::string_view name, std::unique_ptr<Pack> pack);
+
+            std::string name;
+            std::unique_ptr<Pack> pack;
+            TlvReader reader;
+        };
+
+        const ResourceLoader &_loader;
+        PackManifest _manifest;
+
+        /** Mount order, the base pack is first. Packs are not movable as they may point into a mapped file. */
+        std::vector<std::unique_ptr<MountedPack>> _packs;
+    };
+}
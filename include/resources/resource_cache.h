@@ -1,12 +1,13 @@
 #pragma once
 
-#include <ranges>
+#include <cstddef>
 #include <string_view>
 #include <tuple>
 
+#include "resources/resource_id.h"
+#include "resources/resource_store.h"
 #include "sound/sound_data.h"
 #include "utils/ensure.h"
-#include "utils/string_unordered_map.h"
 
 namespace game
 {
@@ -17,6 +18,14 @@ namespace game
 
     /**
      * A generic resource cache. Allows you to store string keys against the templated types. Keys must be unique per type.
+     *
+     * Objects can be looked up by name, by ResourceId or by ResourceHandle. Names are hashed on every call, per frame
+     * lookups should use an _id literal or keep a handle, which is a plain index into the storage.
+     *
+     * Objects inserted with insert() stay until they are erased. Objects inserted with insert_evictable() are owned by
+     * their ResourceRefs: once none are left they stay cached, so they can be acquired again, until the memory of their
+     * type exceeds its budget, then the least recently used ones are evicted. Raw pointers to evictable objects are only
+     * safe while a reference is held.
      */
     template <class... T>
     class ResourceCache
@@ -30,18 +39,109 @@ namespace game
          *
          * @param args
          *   Arguments to pass to the constructor of the object.
+         *
+         * @returns
+         *   Pointer to the object, stays valid until it is erased.
          */
         template <class U, class... Args>
         auto insert(std::string_view name, Args &&...args) -> U *
         {
-            auto &map = std::get<StringUnorderedMap<U>>(_maps);
+            auto &store = std::get<ResourceStore<U>>(_stores);
+            const auto handle = store.emplace(name, false, std::forward<Args>(args)...);
+            store.trim();
 
-            expect(!map.contains(name), "{} already exists", name);
-            const auto [iter, inserted] = map.emplace(std::make_pair(name, U{std::forward<Args>(args)...}));
+            return store.get(handle);
+        }
 
-            expect(inserted, "insertion failed as key exists");
+        /**
+         * Insert an object that may be evicted once it is no longer referenced.
+         *
+         * @param name
+         *   Name of object to insert, must not exist.
+         *
+         * @param args
+         *   Arguments to pass to the constructor of the object.
+         *
+         * @returns
+         *   Reference to the object.
+         */
+        template <class U, class... Args>
+        auto insert_evictable(std::string_view name, Args &&...args) -> ResourceRef<U>
+        {
+            auto &store = std::get<ResourceStore<U>>(_stores);
+            auto ref = store.acquire(store.emplace(name, true, std::forward<Args>(args)...));
+            store.trim();
 
-            return std::addressof(iter->second);
+            return ref;
+        }
+
+        /**
+         * Replace an object in place, e.g. a placeholder by the real resource once it is loaded. Pointers, handles and
+         * references to it stay valid.
+         *
+         * @param handle
+         *   Handle of object to replace, undefined behaviour if it was erased.
+         *
+         * @param args
+         *   Arguments to pass to the constructor of the new object.
+         */
+        template <class U, class... Args>
+        auto replace(ResourceHandle<U> handle, Args &&...args) -> void
+        {
+            auto &store = std::get<ResourceStore<U>>(_stores);
+            store.replace(handle, std::forward<Args>(args)...);
+            store.trim();
+        }
+
+        /**
+         * Take a reference to an object, it is not evicted while referenced.
+         *
+         * @param id
+         *   Id of object, undefined behaviour if it doesn't exist.
+         *
+         * @returns
+         *   Reference to the object.
+         */
+        template <class U>
+        auto acquire(ResourceId id) -> ResourceRef<U>
+        {
+            auto &store = std::get<ResourceStore<U>>(_stores);
+
+            const auto handle = store.find(id);
+            expect(!!handle, "{} doesn't exist", id.value);
+
+            return store.acquire(handle);
+        }
+
+        /**
+         * Set the most memory objects of a type should use, unreferenced evictable objects are evicted to stay within
+         * it. Unlimited by default.
+         *
+         * @param bytes
+         *   Budget in bytes.
+         */
+        template <class U>
+        auto set_budget(std::size_t bytes) -> void
+        {
+            std::get<ResourceStore<U>>(_stores).set_budget(bytes);
+        }
+
+        template <class U>
+        auto budget() const -> std::size_t
+        {
+            return std::get<ResourceStore<U>>(_stores).budget();
+        }
+
+        /**
+         * Get the memory used by all cached objects of a type, pinned or not.
+         *
+         * @returns
+         *   Memory in bytes, video memory for textures and meshes.
+         */
+        template <class U>
+        auto memory_used() const -> std::size_t
+        {
+            return std::get<ResourceStore<U>>(_stores).memory_used();
         }
 
         /**
@@ -54,14 +154,63 @@ namespace game
          *   Pointer to requested object.
          */
         template <class U>
-        auto get(std::string_view name)
+        auto get(std::string_view name) -> U *
+        {
+            const auto handle = std::get<ResourceStore<U>>(_stores).find(ResourceId{name});
+            expect(!!handle, "{} doesn't exist", name);
+
+            return get(handle);
+        }
+
+        /**
+         * Get an object.
+         *
+         * @param id
+         *   Id of object to get, undefined behaviour if it doesn't exist.
+         *
+         * @returns
+         *   Pointer to requested object.
+         */
+        template <class U>
+        auto get(ResourceId id) -> U *
         {
-            auto &map = std::get<StringUnorderedMap<U>>(_maps);
+            const auto handle = std::get<ResourceStore<U>>(_stores).find(id);
+            expect(!!handle, "{} doesn't exist", id.value);
 
-            const auto iter = map.find(name);
-            expect(iter != std::ranges::end(map), "{} doesn't exist", name);
+            return get(handle);
+        }
 
-            return std::addressof(iter->second);
+        /**
+         * Get an object.
+         *
+         * @param handle
+         *   Handle of object to get, undefined behaviour if it was erased.
+         *
+         * @returns
+         *   Pointer to requested object.
+         */
+        template <class U>
+        auto get(ResourceHandle<U> handle) -> U *
+        {
+            auto *obj = std::get<ResourceStore<U>>(_stores).get(handle);
+            expect(obj != nullptr, "stale handle {}", handle.index);
+
+            return obj;
+        }
+
+        /**
+         * Look up the handle of an object, to skip the lookup on later gets.
+         *
+         * @param id
+         *   Id of object.
+         *
+         * @returns
+         *   Handle of the object, invalid if it doesn't exist.
+         */
+        template <class U>
+        auto handle(ResourceId id) const -> ResourceHandle<U>
+        {
+            return std::get<ResourceStore<U>>(_stores).find(id);
         }
 
         /**
@@ -74,17 +223,64 @@ namespace game
          *   true, if name was found in cache of objects of type U
          */
         template <class U>
-        auto contains(std::string_view name)
+        auto contains(std::string_view name) const -> bool
+        {
+            return contains<U>(ResourceId{name});
+        }
+
+        template <class U>
+        auto contains(ResourceId id) const -> bool
+        {
+            return !!handle<U>(id);
+        }
+
+        /**
+         * Query, if a handle still refers to an object.
+         *
+         * @param handle
+         *   Handle to query.
+         *
+         * @returns
+         *   true, if the object has not been erased
+         */
+        template <class U>
+        auto contains(ResourceHandle<U> handle) const -> bool
+        {
+            return std::get<ResourceStore<U>>(_stores).is_valid(handle);
+        }
+
+        /**
+         * Remove an object, pointers and handles to it are invalidated.
+         *
+         * @param name
+         *   Name of object to remove, undefined behaviour if it doesn't exist or is referenced.
+         */
+        template <class U>
+        auto erase(std::string_view name) -> void
+        {
+            const auto handle = std::get<ResourceStore<U>>(_stores).find(ResourceId{name});
+            expect(!!handle, "{} doesn't exist", name);
+
+            erase(handle);
+        }
+
+        /**
+         * Remove an object, pointers and handles to it are invalidated.
+         *
+         * @param handle
+         *   Handle of object to remove, undefined behaviour if it was erased or is referenced.
+         */
+        template <class U>
+        auto erase(ResourceHandle<U> handle) -> void
         {
-            auto &map = std::get<StringUnorderedMap<U>>(_maps);
-            return map.contains(name);
+            std::get<ResourceStore<U>>(_stores).erase(handle);
         }
 
     private:
         /** Object store for given types. */
-        std::tuple<StringUnorderedMap<T>...> _maps;
+        std::tuple<ResourceStore<T>...> _stores;
     };
 
     // default cache for the game
     using DefaultCache = ResourceCache<Mesh, Material, Texture, TextureSampler, SoundData>;
-}
\ No newline at end of file
+}
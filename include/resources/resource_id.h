@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace game
+{
+    /**
+     * Name of a cached resource, stored as its 64 bit FNV-1a hash. Ids of string literals are computed at compile time
+     * with the _id suffix, so looking them up never hashes a string at runtime.
+     */
+    struct ResourceId
+    {
+        constexpr explicit ResourceId(std::string_view name)
+            : value{0xcbf29ce484222325ull}
+        {
+            for (const auto c : name)
+            {
+                value ^= static_cast<std::uint8_t>(c);
+                value *= 0x100000001b3ull;
+            }
+        }
+
+        constexpr auto operator==(const ResourceId &) const -> bool = default;
+
+        std::uint64_t value;
+    };
+
+    /**
+     * Reference to an object in a ResourceCache. Slots are reused after an object is erased, the generation tells an
+     * old handle apart from one to the new occupant. A default constructed handle is invalid.
+     */
+    template <class T>
+    struct ResourceHandle
+    {
+        std::uint32_t index = 0u;
+
+        /** 0 is never used by a live slot. */
+        std::uint32_t generation = 0u;
+
+        constexpr auto operator==(const ResourceHandle &) const -> bool = default;
+
+        constexpr explicit operator bool() const
+        {
+            return generation != 0u;
+        }
+    };
+
+    inline namespace literals
+    {
+        consteval auto operator""_id(const char *name, std::size_t length) -> ResourceId
+        {
+            return ResourceId{std::string_view{name, length}};
+        }
+    }
+}
+
+template <>
+struct std::hash<game::ResourceId>
+{
+    auto operator()(const game::ResourceId &id) const -> std::size_t
+    {
+        // already a good hash
+        return static_cast<std::size_t>(id.value);
+    }
+};
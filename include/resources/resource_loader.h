@@ -14,6 +14,17 @@ namespace game
 
         auto load(std::string_view name) const -> File;
 
+        /**
+         * Check if a resource exists, for optional resources that load would fail on.
+         *
+         * @param name
+         *   Name of the resource.
+         *
+         * @returns
+         *   True if the resource can be loaded.
+         */
+        auto exists(std::string_view name) const -> bool;
+
     private:
         std::filesystem::path _root;
     };
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "resources/resource_id.h"
+#include "utils/ensure.h"
+
+namespace game
+{
+    template <class T>
+    class ResourceRef;
+
+    /**
+     * Storage for the objects of a single type in a ResourceCache. Objects live in slots that are allocated in chunks,
+     * so they sit next to each other in memory and never move, pointers to them stay valid until they are erased.
+     * Freed slots are reused.
+     *
+     * Objects are pinned unless they are inserted as evictable. Evictable objects are destroyed, least recently used
+     * first, once the memory of all objects exceeds the budget and nothing references them anymore. Memory is what
+     * memory_size() reports for types that have one (video memory for textures and meshes), else sizeof(T).
+     */
+    template <class T>
+    class ResourceStore
+    {
+    public:
+        using Handle = ResourceHandle<T>;
+
+        ResourceStore() = default;
+
+        ResourceStore(const ResourceStore &) = delete;
+        auto operator=(const ResourceStore &) -> ResourceStore & = delete;
+
+        /**
+         * Construct an object in a free slot. Does not evict, so an evictable object can be referenced before trim().
+         *
+         * @param name
+         *   Name of the object, must not be in the store yet.
+         *
+         * @param evictable
+         *   Whether the object may be evicted once it is no longer referenced.
+         *
+         * @param args
+         *   Arguments to pass to the constructor of the object.
+         *
+         * @returns
+         *   Handle to the object.
+         */
+        template <class... Args>
+        auto emplace(std::string_view name, bool evictable, Args &&...args) -> Handle
+        {
+            const auto id = ResourceId{name};
+            expect(!_index.contains(id), "{} already exists", name);
+
+            auto index = static_cast<std::uint32_t>(_slots.size());
+            if (_free.empty())
+            {
+                _slots.emplace_back();
+            }
+            else
+            {
+                index = _free.back();
+                _free.pop_back();
+            }
+
+            auto &slot = _slots[index];
+            slot.value.emplace(T{std::forward<Args>(args)...});
+            slot.name = name;
+            slot.evictable = evictable;
+            slot.last_used = ++_clock;
+            slot.memory_size = memory_size_of(*slot.value);
+            _index.emplace(id, index);
+
+            _memory_used += slot.memory_size;
+
+            return {index, slot.generation};
+        }
+
+        /**
+         * Look up an object by id.
+         *
+         * @param id
+         *   Id of the object.
+         *
+         * @returns
+         *   Handle to the object, invalid if there is none.
+         */
+        auto find(ResourceId id) const -> Handle
+        {
+            const auto iter = _index.find(id);
+            if (iter == std::ranges::end(_index))
+            {
+                return {};
+            }
+
+            return {iter->second, _slots[iter->second].generation};
+        }
+
+        /**
+         * Get an object, this counts as a use for eviction.
+         *
+         * @param handle
+         *   Handle to the object.
+         *
+         * @returns
+         *   Pointer to the object, nullptr if the handle is invalid or the object was erased.
+         */
+        auto get(Handle handle) -> T *
+        {
+            if (!is_valid(handle))
+            {
+                return nullptr;
+            }
+
+            auto &slot = _slots[handle.index];
+            slot.last_used = ++_clock;
+
+            return std::addressof(*slot.value);
+        }
+
+        /**
+         * Replace an object with a new one in the same slot, pointers and handles to it stay valid.
+         *
+         * @param handle
+         *   Handle to the object.
+         *
+         * @param args
+         *   Arguments to pass to the constructor of the new object.
+         */
+        template <class... Args>
+        auto replace(Handle handle, Args &&...args) -> void
+        {
+            expect(is_valid(handle), "invalid handle {}", handle.index);
+
+            auto &slot = _slots[handle.index];
+            *slot.value = T{std::forward<Args>(args)...};
+
+            _memory_used -= slot.memory_size;
+            slot.memory_size = memory_size_of(*slot.value);
+            _memory_used += slot.memory_size;
+        }
+
+        auto is_valid(Handle handle) const -> bool
+        {
+            return handle && handle.index < _slots.size() && _slots[handle.index].generation == handle.generation &&
+                   _slots[handle.index].value.has_value();
+        }
+
+        auto name(Handle handle) const -> std::string_view
+        {
+            expect(is_valid(handle), "invalid handle {}", handle.index);
+            return _slots[handle.index].name;
+        }
+
+        /**
+         * Take a reference to an object, it is not evicted while referenced.
+         *
+         * @param handle
+         *   Handle to the object.
+         *
+         * @returns
+         *   Reference to the object.
+         */
+        auto acquire(Handle handle) -> ResourceRef<T>
+        {
+            return {*this, handle};
+        }
+
+        auto ref_count(Handle handle) const -> std::uint32_t
+        {
+            expect(is_valid(handle), "invalid handle {}", handle.index);
+            return _slots[handle.index].ref_count;
+        }
+
+        /**
+         * Destroy an object, handles and pointers to it are invalidated.
+         *
+         * @param handle
+         *   Handle to the object, must not be referenced.
+         */
+        auto erase(Handle handle) -> void
+        {
+            expect(is_valid(handle), "invalid handle {}", handle.index);
+
+            auto &slot = _slots[handle.index];
+            expect(slot.ref_count == 0u, "{} is still referenced", slot.name);
+
+            _index.erase(ResourceId{slot.name});
+            _memory_used -= slot.memory_size;
+            slot.value.reset();
+            slot.name.clear();
+
+            // skip 0 when wrapping, it marks an invalid handle
+            slot.generation = slot.generation == std::numeric_limits<std::uint32_t>::max() ? 1u : slot.generation + 1u;
+            _free.push_back(handle.index);
+        }
+
+        /**
+         * Evict unreferenced evictable objects, least recently used first, until the memory used fits the budget or
+         * nothing more can be evicted.
+         *
+         * @returns
+         *   Number of evicted objects.
+         */
+        auto trim() -> std::size_t
+        {
+            auto evicted = std::size_t{};
+
+            while (_memory_used > _budget)
+            {
+                auto victim = std::optional<std::uint32_t>{};
+                for (auto index = 0u; index < _slots.size(); ++index)
+                {
+                    const auto &slot = _slots[index];
+                    if (slot.value && slot.evictable && slot.ref_count == 0u &&
+                        (!victim || slot.last_used < _slots[*victim].last_used))
+                    {
+                        victim = index;
+                    }
+                }
+
+                if (!victim)
+                {
+                    break;
+                }
+
+                erase({*victim, _slots[*victim].generation});
+                ++evicted;
+            }
+
+            return evicted;
+        }
+
+        /**
+         * Set the most memory the objects should use, evicting right away if it is exceeded.
+         *
+         * @param bytes
+         *   Budget in bytes.
+         */
+        auto set_budget(std::size_t bytes) -> void
+        {
+            _budget = bytes;
+            trim();
+        }
+
+        auto budget() const -> std::size_t
+        {
+            return _budget;
+        }
+
+        auto memory_used() const -> std::size_t
+        {
+            return _memory_used;
+        }
+
+        auto size() const -> std::size_t
+        {
+            return _index.size();
+        }
+
+    private:
+        friend class ResourceRef<T>;
+
+        struct Slot
+        {
+            std::optional<T> value;
+            std::uint32_t generation = 1u;
+            std::uint32_t ref_count = 0u;
+            bool evictable = false;
+            std::uint64_t last_used = 0u;
+            std::size_t memory_size = 0u;
+            std::string name;
+        };
+
+        static auto memory_size_of(const T &obj) -> std::size_t
+        {
+            if constexpr (requires { obj.memory_size(); })
+            {
+                return obj.memory_size();
+            }
+            else
+            {
+                return sizeof(T);
+            }
+        }
+
+        auto add_ref(Handle handle) -> void
+        {
+            expect(is_valid(handle), "invalid handle {}", handle.index);
+
+            auto &slot = _slots[handle.index];
+            ++slot.ref_count;
+            slot.last_used = ++_clock;
+        }
+
+        auto remove_ref(Handle handle) -> void
+        {
+            expect(is_valid(handle), "invalid handle {}", handle.index);
+
+            auto &slot = _slots[handle.index];
+            expect(slot.ref_count > 0u, "{} is not referenced", slot.name);
+
+            slot.last_used = ++_clock;
+            if (--slot.ref_count == 0u && slot.evictable)
+            {
+                trim();
+            }
+        }
+
+        /** A deque never moves its elements when it grows, unlike a vector. */
+        std::deque<Slot> _slots;
+        std::vector<std::uint32_t> _free;
+        std::unordered_map<ResourceId, std::uint32_t> _index;
+        std::size_t _budget = std::numeric_limits<std::size_t>::max();
+        std::size_t _memory_used = 0u;
+
+        /** Counts uses, orders objects by when they were last used. */
+        std::uint64_t _clock = 0u;
+    };
+
+    /**
+     * Counted reference to an object in a ResourceStore, keeps the object from being evicted until the last copy is
+     * destroyed. The store must outlive its references.
+     */
+    template <class T>
+    class ResourceRef
+    {
+    public:
+        ResourceRef() = default;
+
+        ResourceRef(ResourceStore<T> &store, ResourceHandle<T> handle)
+            : _store{std::addressof(store)},
+              _handle{handle}
+        {
+            _store->add_ref(_handle);
+        }
+
+        ~ResourceRef()
+        {
+            reset();
+        }
+
+        ResourceRef(const ResourceRef &other)
+            : _store{other._store},
+              _handle{other._handle}
+        {
+            if (_store != nullptr)
+            {
+                _store->add_ref(_handle);
+            }
+        }
+
+        auto operator=(const ResourceRef &other) -> ResourceRef &
+        {
+            auto copy = other;
+            swap(copy);
+            return *this;
+        }
+
+        ResourceRef(ResourceRef &&other) noexcept
+            : _store{std::exchange(other._store, nullptr)},
+              _handle{std::exchange(other._handle, {})}
+        {
+        }
+
+        auto operator=(ResourceRef &&other) noexcept -> ResourceRef &
+        {
+            auto moved = std::move(other);
+            swap(moved);
+            return *this;
+        }
+
+        auto swap(ResourceRef &other) noexcept -> void
+        {
+            std::ranges::swap(_store, other._store);
+            std::ranges::swap(_handle, other._handle);
+        }
+
+        /**
+         * Drop the reference, the object may be evicted if this was the last one.
+         */
+        auto reset() -> void
+        {
+            if (_store != nullptr)
+            {
+                std::exchange(_store, nullptr)->remove_ref(std::exchange(_handle, {}));
+            }
+        }
+
+        auto get() const -> T *
+        {
+            return _store == nullptr ? nullptr : _store->get(_handle);
+        }
+
+        auto operator->() const -> T *
+        {
+            return get();
+        }
+
+        auto operator*() const -> T &
+        {
+            return *get();
+        }
+
+        auto handle() const -> ResourceHandle<T>
+        {
+            return _handle;
+        }
+
+        explicit operator bool() const
+        {
+            return _store != nullptr;
+        }
+
+    private:
+        ResourceStore<T> *_store = nullptr;
+        ResourceHandle<T> _handle = {};
+    };
+}
@@ -28,6 +28,11 @@ namespace game
         auto reschedule(std::coroutine_handle<> handle, std::unique_ptr<std::uint32_t> counter) -> void;
         auto reschedule(std::coroutine_handle<> handle, GameState state) -> void;
 
+        /**
+         * Resume a task once a condition holds, it is checked once per tick.
+         */
+        auto reschedule(std::coroutine_handle<> handle, std::move_only_function<bool()> check_resume) -> void;
+
         auto run() -> void;
 
         auto handle_state_change(GameState state) -> void override;
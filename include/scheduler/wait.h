@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts>
 #include <coroutine>
 #include <memory>
 
@@ -30,6 +31,12 @@ namespace game
                 _scheduler.add(std::move(_wait_object), counter.get());
                 _scheduler.reschedule(h, std::move(counter));
             }
+            else if constexpr (requires(const T &wait_object) { { wait_object.is_ready() } -> std::same_as<bool>; })
+            {
+                // anything that completes on its own, such as a background load
+                _scheduler.reschedule(h, [wait_object = _wait_object]
+                                      { return wait_object.is_ready(); });
+            }
             else
             {
                 _scheduler.reschedule(h, _wait_object);
@@ -3,6 +3,7 @@
 #include <optional>
 #include <string>
 
+#include "resources/async_resource_loader.h"
 #include "tlv/tlv_reader.h"
 
 namespace game
@@ -16,6 +17,17 @@ namespace game
         auto name() const -> std::string;
         auto load() const -> std::string;
 
+        /**
+         * Read the script on a loader worker, so a loose script file does not block the game thread.
+         *
+         * @param loader
+         *   Loader to read the script with.
+         *
+         * @returns
+         *   Handle that becomes ready once the script is read, the loader and any pack must outlive it.
+         */
+        auto load(AsyncResourceLoader &loader) const -> LoadHandle<std::string>;
+
     private:
         std::string _name;
         std::optional<const TlvReader *> _reader;
@@ -3,11 +3,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
 #include "graphics/mesh_data.h"
 #include "graphics/texture.h"
 #include "sound/sound_data.h"
@@ -38,42 +41,154 @@ namespace game
         OBJECT_SUB_MESH_NAMES,
         TEXT_FILE,
         SOUND_DATA,
+
+        // scalar, appended to keep the ids of existing packs stable
+        UINT16_ARRAY,
+        COMPACT_VERTEX_DATA_ARRAY,
+        VERTEX_QUANTIZATION,
+        FLOAT,
+        MESH_LOD,
+        MESH_BOUNDS,
+
+        /** u64 offset of an earlier entry with the same payload, from the start of the pack. Resolved by TlvReader. */
+        ALIAS,
+    };
+
+    enum class TlvVersion : std::uint32_t
+    {
+        /** Headerless, u32 type and u32 length followed by an unaligned payload. */
+        V1 = 1u,
+
+        /** File header, u32 type, u32 padding and u64 length, payloads aligned to TlvFormat::alignment. */
+        V2 = 2u,
     };
 
+    /**
+     * Layout of the entries in a buffer. Composite payloads use the same format as the buffer they are stored in.
+     */
+    struct TlvFormat
+    {
+        TlvVersion version = TlvVersion::V2;
+
+        /** Payload alignment in bytes, a power of two of at least 16 for v2 and always 1 for v1. */
+        std::uint32_t alignment = 16u;
+    };
+
+    /**
+     * Start of every v2 buffer, followed by padding up to the payload alignment. v1 buffers start directly with an
+     * entry, whose type can never match the magic.
+     */
+    struct TlvFileHeader
+    {
+        std::uint32_t magic;
+        TlvVersion version;
+        std::uint32_t flags;
+        std::uint32_t alignment;
+    };
+
+    static_assert(sizeof(TlvFileHeader) == 16u);
+
+    /** "UGTL" in a little endian file. */
+    inline constexpr auto tlv_magic = std::uint32_t{0x4c544755u};
+
+    /**
+     * Entry header of a v2 buffer. The payload starts padding bytes after the header, entries start on 16 byte
+     * boundaries.
+     */
+    struct TlvEntryHeader
+    {
+        TlvType type;
+        std::uint32_t padding;
+        std::uint64_t length;
+    };
+
+    static_assert(sizeof(TlvEntryHeader) == 16u);
+
     class TlvEntry
     {
     public:
+        /**
+         * Create a v1 entry.
+         */
         TlvEntry(TlvType type, std::span<const std::byte> value);
 
+        /**
+         * Create an entry read from a buffer.
+         *
+         * @param type
+         *   Entry type.
+         *
+         * @param value
+         *   Payload, composite payloads are parsed with format.
+         *
+         * @param format
+         *   Format of the buffer the entry was read from.
+         *
+         * @param size
+         *   Bytes from the start of this entry to the start of the next one.
+         *
+         * @param pack
+         *   Whole pack the entry is part of, aliases in composite payloads are resolved against it.
+         */
+        TlvEntry(TlvType type, std::span<const std::byte> value, TlvFormat format, std::uint64_t size, std::span<const std::byte> pack = {});
+
         auto type() const -> TlvType;
-        auto length() const -> std::uint32_t;
+        auto length() const -> std::uint64_t;
 
         auto uint32_value() const -> std::uint32_t;
+        auto float_value() const -> float;
         auto uint32_array_value() const -> std::vector<std::uint32_t>;
+        auto uint16_array_value() const -> std::vector<std::uint16_t>;
         auto string_value() const -> std::string;
         auto byte_array_value() const -> std::vector<std::byte>;
         auto texture_usage_value() const -> TextureUsage;
         auto texture_format_value() const -> TextureFormat;
         auto texture_description_value() const -> TextureDescription;
         auto is_texture(std::string_view name) const -> bool;
+
+        /**
+         * Name of a texture, read without copying its data.
+         */
+        auto texture_name_value() const -> std::string;
         auto vertex_data_value() const -> VertexData;
         auto vertex_data_array_value() const -> std::vector<VertexData>;
+        auto compact_vertex_data_array_value() const -> std::vector<CompactVertexData>;
+        auto vertex_quantization_value() const -> VertexQuantization;
+        auto mesh_lod_value() const -> MeshLod;
+        auto mesh_bounds_value() const -> MeshBounds;
         auto mesh_value() const -> MeshData;
         auto is_mesh(std::string_view name) const -> bool;
         auto text_file_value() const -> TextFile;
         auto is_text_file(std::string_view name) const -> bool;
         auto is_object_data(std::string_view name) const -> bool;
         auto object_data_value() const -> std::vector<std::string>;
+
+        /**
+         * Get the bounds of all sub-meshes of an object together.
+         *
+         * @returns
+         *   Merged bounds of the sub-meshes, empty if the pack does not store them.
+         */
+        auto object_bounds_value() const -> std::optional<MeshBounds>;
         auto sound_data_value() const -> SoundData;
         auto is_sound(std::string_view name) const -> bool;
 
-        auto size() const -> std::uint32_t;
+        auto size() const -> std::uint64_t;
+
+        /**
+         * Raw payload, it points into the buffer the entry was read from. In a v2 buffer it is aligned to the pack
+         * alignment (provided the buffer itself is, as an mmap is), so it can be handed over without a copy.
+         */
+        auto value() const -> std::span<const std::byte>;
 
         auto to_string() -> std::string;
 
     private:
         TlvType _type;
         std::span<const std::byte> _value;
+        TlvFormat _format;
+        std::uint64_t _size;
+        std::span<const std::byte> _pack;
     };
 
 }
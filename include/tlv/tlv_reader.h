@@ -20,7 +20,7 @@ namespace game
             using value_type = TlvEntry;
 
             Iterator() = default;
-            Iterator(std::span<const std::byte> buffer);
+            Iterator(std::span<const std::byte> buffer, TlvFormat format, std::span<const std::byte> pack);
 
             auto operator*() const -> value_type;
             auto operator++() -> Iterator &;
@@ -29,26 +29,53 @@ namespace game
 
         private:
             std::span<const std::byte> _buffer;
+            TlvFormat _format;
+            std::span<const std::byte> _pack;
         };
 
         static_assert(std::forward_iterator<Iterator>);
 
+        /**
+         * Read a pack, the format is detected from the file header. Buffers without one are read as v1. Alias entries
+         * are resolved transparently, iterating yields the entry they point at.
+         *
+         * @param buffer
+         *   Pack to read, for aligned v2 payloads it has to be aligned to the pack alignment itself.
+         */
         TlvReader(std::span<const std::byte> buffer);
 
+        /**
+         * Read the entries of a composite payload, which has no header of its own.
+         *
+         * @param buffer
+         *   Payload to read.
+         *
+         * @param format
+         *   Format of the buffer the payload was read from.
+         *
+         * @param pack
+         *   Whole pack the payload is part of, to resolve aliases against.
+         */
+        TlvReader(std::span<const std::byte> buffer, TlvFormat format, std::span<const std::byte> pack = {});
+
         auto begin(this auto &&self) -> Iterator
         {
-            return {self._buffer};
+            return {self._buffer, self._format, self._pack};
         }
 
         auto end(this auto &&self) -> Iterator
         {
-            return {{self._buffer.data() + self._buffer.size(), self._buffer.data() + self._buffer.size()}};
+            return {{self._buffer.data() + self._buffer.size(), self._buffer.data() + self._buffer.size()}, self._format, self._pack};
         }
 
+        auto format() const -> TlvFormat;
+
         static auto get_text_file(const TlvReader &reader, std::string_view name) -> TextFile;
 
     private:
         std::span<const std::byte> _buffer;
+        TlvFormat _format;
+        std::span<const std::byte> _pack;
     };
 
 }
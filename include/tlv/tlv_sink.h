@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+#include "utils/auto_release.h"
+
+// opaque zstd context, keeps zstd.h out of this header
+struct ZSTD_CCtx_s;
+
+namespace game
+{
+    /**
+     * Destination for a streaming TlvWriter. Bytes arrive in order and are never revisited.
+     */
+    class TlvSink
+    {
+    public:
+        virtual ~TlvSink() = default;
+
+        virtual auto write(std::span<const std::byte> data) -> void = 0;
+
+        /**
+         * Flush everything written so far, no more writes are allowed afterwards.
+         */
+        virtual auto finish() -> void = 0;
+    };
+
+    /**
+     * Write a pack uncompressed to a file.
+     */
+    class FileSink : public TlvSink
+    {
+    public:
+        FileSink(const std::filesystem::path &path);
+
+        auto write(std::span<const std::byte> data) -> void override;
+        auto finish() -> void override;
+
+    private:
+        std::ofstream _out;
+    };
+
+    /**
+     * Compress a pack to a file with zstd while it is being written, memory use is bounded by the compression window
+     * (and the chunk size) rather than the pack size.
+     */
+    class CompressedFileSink : public TlvSink
+    {
+    public:
+        /**
+         * Create a compressing sink.
+         *
+         * @param path
+         *   File to write.
+         *
+         * @param level
+         *   zstd compression level.
+         *
+         * @param chunk_size
+         *   Zero to stream a single frame, otherwise the uncompressed size of independent frames that can be
+         *   decompressed in parallel.
+         */
+        CompressedFileSink(const std::filesystem::path &path, int level, std::size_t chunk_size = 0u);
+
+        auto write(std::span<const std::byte> data) -> void override;
+        auto finish() -> void override;
+
+    private:
+        auto compress_chunk() -> void;
+        auto write_stream(std::span<const std::byte> data, bool end) -> void;
+
+        std::ofstream _out;
+        AutoRelease<::ZSTD_CCtx_s *, nullptr> _context;
+        std::size_t _chunk_size;
+        std::vector<std::byte> _chunk;
+        std::vector<std::byte> _compressed;
+    };
+}
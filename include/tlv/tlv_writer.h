@@ -3,27 +3,95 @@
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
 #include "graphics/mesh_data.h"
 #include "graphics/texture.h"
 #include "graphics/vertex_data.h"
 #include "sound/sound_data.h"
 #include "tlv/tlv_entry.h"
+#include "tlv/tlv_sink.h"
 
 namespace game
 {
+    /**
+     * Writes TLV entries. Composite entries are written in place with their length patched once they are complete, so
+     * only the top level entry currently being written is held in memory. Without a sink everything is collected for
+     * yield, with one every completed top level entry is passed on to it.
+     */
     class TlvWriter
     {
     public:
+        /**
+         * Create a writer for a v2 pack with 16 byte payload alignment.
+         */
         TlvWriter();
 
+        /**
+         * Create a writer for a pack of the given format.
+         *
+         * @param format
+         *   Version and payload alignment to write.
+         */
+        TlvWriter(TlvFormat format);
+
+        /**
+         * Create a streaming writer.
+         *
+         * @param format
+         *   Version and payload alignment to write.
+         *
+         * @param sink
+         *   Receives the pack as it is written, must outlive the writer.
+         */
+        TlvWriter(TlvFormat format, TlvSink &sink);
+
+        /**
+         * Take everything written so far, starting with the file header for v2. The writer can be reused afterwards.
+         * Not available for streaming writers.
+         *
+         * @returns
+         *   Pack contents.
+         */
         auto yield() -> std::vector<std::byte>;
+
+        /**
+         * Pass everything still buffered to the sink and finish it.
+         */
+        auto finish() -> void;
+
+        auto format() const -> TlvFormat;
+
+        /**
+         * Number of bytes written so far, including the file header.
+         */
+        auto size() const -> std::uint64_t;
+
+        /**
+         * Write an alias instead of an array payload that is identical to one written before. Payloads are matched by
+         * type, length and a 128 bit FNV-1a digest, so the earlier copy does not have to be kept around.
+         *
+         * @param deduplicate
+         *   True to deduplicate everything written from now on.
+         */
+        auto set_deduplicate(bool deduplicate) -> void;
+
+        /**
+         * Number of payload bytes replaced by aliases so far.
+         */
+        auto deduplicated_bytes() const -> std::uint64_t;
+
         auto write(std::uint32_t value) -> void;
+        auto write(float value) -> void;
         auto write(std::span<const std::uint32_t> value) -> void;
+        auto write(std::span<const std::uint16_t> value) -> void;
         auto write(std::string_view value) -> void;
         auto write(std::span<const std::byte> value) -> void;
         auto write(TextureFormat value) -> void;
@@ -31,13 +99,74 @@ namespace game
         auto write(TextureDescription &value) -> void;
         auto write(const VertexData &value) -> void;
         auto write(std::span<const VertexData> value) -> void;
+        auto write(const VertexQuantization &value) -> void;
+        auto write(std::span<const CompactVertexData> value) -> void;
+        auto write(const MeshLod &value) -> void;
+        auto write(const MeshBounds &value) -> void;
         auto write(std::string_view name, const MeshData &value) -> void;
         auto write(std::string_view name, std::string_view value) -> void;
-        auto write(std::string_view name, std::span<const std::string> sub_mesh_names) -> void;
+        auto write(std::string_view name, std::span<const std::string> sub_mesh_names, const std::optional<MeshBounds> &bounds = std::nullopt) -> void;
         auto write(std::string_view name, const SoundData &data) -> void;
 
     private:
+        /**
+         * Where a payload was first written, to alias later copies to.
+         */
+        struct PayloadRecord
+        {
+            TlvType type;
+            std::uint64_t length;
+            std::uint64_t offset;
+        };
+
+        struct PayloadDigest
+        {
+            std::uint64_t high;
+            std::uint64_t low;
+
+            auto operator==(const PayloadDigest &) const -> bool = default;
+        };
+
+        struct PayloadDigestHash
+        {
+            auto operator()(const PayloadDigest &digest) const -> std::size_t
+            {
+                return static_cast<std::size_t>(digest.high ^ digest.low);
+            }
+        };
+
+        auto write_entry(TlvType type, std::span<const std::byte> value) -> void;
+        auto write_alias(TlvType type, std::span<const std::byte> value) -> bool;
+
+        /**
+         * Write the header of a composite entry with a placeholder length.
+         *
+         * @returns
+         *   Offset of the header in the buffer, to pass to end_composite.
+         */
+        auto begin_composite(TlvType type) -> std::size_t;
+
+        /**
+         * Patch the length of a composite entry now that all its members are written.
+         */
+        auto end_composite(std::size_t header_offset) -> void;
+
+        auto write_header() -> void;
+        auto flush(bool force) -> void;
+
         std::vector<std::byte> _buffer;
+        TlvFormat _format;
+        TlvSink *_sink;
+
+        /** Bytes already passed to the sink, alignment is relative to the start of the pack. */
+        std::uint64_t _flushed;
+        std::size_t _open_composites;
+
+        bool _deduplicate;
+        std::uint64_t _deduplicated_bytes;
+
+        /** Payload digest to the first entry with that payload. */
+        std::unordered_map<PayloadDigest, PayloadRecord, PayloadDigestHash> _payloads;
     };
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <vector>
@@ -7,4 +8,35 @@
 namespace game
 {
     auto compress(std::span<const std::byte> data) -> std::vector<std::byte>;
-}
\ No newline at end of file
+
+    /**
+     * Compress data into a single zstd frame.
+     *
+     * @param data
+     *   Data to compress.
+     *
+     * @param level
+     *   zstd compression level, negative levels trade ratio for lz4 like speed.
+     *
+     * @returns
+     *   Compressed frame.
+     */
+    auto compress(std::span<const std::byte> data, int level) -> std::vector<std::byte>;
+
+    /**
+     * Compress data as a sequence of independent zstd frames, which decompress can unpack in parallel.
+     *
+     * @param data
+     *   Data to compress.
+     *
+     * @param chunk_size
+     *   Uncompressed size of every frame but the last.
+     *
+     * @param level
+     *   zstd compression level.
+     *
+     * @returns
+     *   Concatenated frames.
+     */
+    auto compress_chunked(std::span<const std::byte> data, std::size_t chunk_size, int level) -> std::vector<std::byte>;
+}
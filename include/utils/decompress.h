@@ -6,5 +6,26 @@
 
 namespace game
 {
+    /**
+     * Decompress one or more concatenated zstd frames. Frames that store their content size are decompressed in
+     * parallel, if any frame does not (a single streamed frame) the whole input is decompressed as one stream.
+     *
+     * @param data
+     *   Compressed frames.
+     *
+     * @returns
+     *   Decompressed data.
+     */
     auto decompress(std::span<const std::byte> data) -> std::vector<std::byte>;
-}
\ No newline at end of file
+
+    /**
+     * Check if data starts with a zstd frame.
+     *
+     * @param data
+     *   Data to check.
+     *
+     * @returns
+     *   True if data can be passed to decompress.
+     */
+    auto is_compressed(std::span<const std::byte> data) -> bool;
+}
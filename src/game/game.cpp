@@ -1,30 +1,37 @@
 #include "game/game.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
 #include <ranges>
 #include <string>
 #include <string_view>
 #include <utility>
 
+#include "file.h"
 #include "game/routines/input_routine.h"
 #include "game/routines/level_routine.h"
 #include "game/routines/main_menu_routine.h"
 #include "game/routines/physics_routine.h"
 #include "game/routines/render_routine.h"
 #include "game/routines/sound_routine.h"
+#include "game/settings.h"
 #include "graphics/material.h"
-#include "graphics/shader.h"
+#include "graphics/program_cache.h"
 #include "graphics/texture.h"
 #include "graphics/texture_sampler.h"
+#include "graphics/texture_streamer.h"
 #include "loaders/mesh_loader.h"
 #include "log.h"
 #include "messaging/message_bus.h"
+#include "resources/async_resource_loader.h"
+#include "resources/pack_set.h"
 #include "resources/resource_cache.h"
 #include "resources/resource_loader.h"
 #include "scheduler/scheduler.h"
 #include "sound/sound_data.h"
 #include "tlv/tlv_entry.h"
 #include "tlv/tlv_reader.h"
-#include "utils/decompress.h"
 #include "window.h"
 
 using namespace std::literals;
@@ -58,6 +65,12 @@ namespace
         return static_cast<std::uint8_t>(u32);
     }
 
+    auto has_object(const game::TlvReader &reader, std::string_view obj_name) -> bool
+    {
+        return std::ranges::any_of(reader, [obj_name](const auto &e)
+                                   { return e.is_object_data(obj_name); });
+    }
+
     auto load_sub_meshes_into_cache(game::DefaultCache &resource_cache, std::string_view obj_name, const game::TlvReader &reader) -> void
     {
 
@@ -91,6 +104,9 @@ namespace game
               get_uint_arg(args, "-y"sv),
               _samples}
     {
+        // lower tiers trade texture detail for vram and upload time
+        Settings::instance().set_texture_tier(std::min(get_uint_arg(args, "-texture-tier"sv), texture_tier_count - 1u));
+        Settings::instance().set_texture_budget(get_uint_arg(args, "-texture-budget"sv, Settings::instance().texture_budget()));
     }
 
     Game::~Game() = default;
@@ -98,7 +114,9 @@ namespace game
     auto Game::run(std::string_view resource_root) -> void
     {
         auto mesh_loader = game::MeshLoader{};
+        auto program_cache = game::ProgramCache{std::filesystem::path{resource_root} / "program_cache"};
         auto resource_cache = game::DefaultCache{};
+        resource_cache.set_budget<Texture>(std::size_t{Settings::instance().texture_budget()} * 1024u * 1024u);
 
         const auto *mipmap = resource_cache.insert<game::TextureSampler>("mipmap", TextureSampler{FilterType::LINEAR_MIPMAP, FilterType::NEAREST, std::make_optional(16.f)});
         resource_cache.insert<TextureSampler>("sky_box", TextureSampler{FilterType::NEAREST, FilterType::NEAREST});
@@ -107,40 +125,31 @@ namespace game
         game::log::info("loading resources...");
         auto resource_loader = game::ResourceLoader{resource_root};
 
-        game::log::info("decompressing...");
-        const auto tlv_file = [&resource_loader]
-        {
-            const auto compressed_tlv_file = resource_loader.load("resources");
-            return game::decompress(compressed_tlv_file.as_bytes());
-        }();
-
-        const auto reader = game::TlvReader{tlv_file};
+        // only the base pack is mounted up front, level packs are mounted by the level routine
+        auto packs = game::PackSet{resource_loader, "manifest"};
+        auto async_loader = game::AsyncResourceLoader{resource_loader};
+        auto texture_streamer = game::TextureStreamer{resource_cache, async_loader};
+        const auto &reader = packs.base();
 
         game::log::info("Loading meshes...");
         resource_cache.insert<Mesh>("barrel", reader, "Cylinder.014");
         resource_cache.insert<Mesh>("floor", mesh_loader.cube());
 
-        load_sub_meshes_into_cache(resource_cache, "SHC factory hall renovated", reader);
+        // a single pack build carries the level assets in the base pack, with a manifest they come from the level pack
+        const auto level_assets_in_base = has_object(reader, "SHC factory hall renovated");
+        if (level_assets_in_base)
+        {
+            load_sub_meshes_into_cache(resource_cache, "SHC factory hall renovated", reader);
+        }
 
         game::log::info("Creating materials...");
 
-        const auto vertex_shader_file = TlvReader::get_text_file(reader, "simple.vert");
-        const auto fragment_shader_file = TlvReader::get_text_file(reader, "barrel.frag");
-
-        const auto vertex_shader = game::Shader{vertex_shader_file.data, game::ShaderType::VERTEX};
-        const auto fragment_shader = game::Shader{fragment_shader_file.data, game::ShaderType::FRAGMENT};
-        resource_cache.insert<Material>("barrel_material", vertex_shader, fragment_shader);
-
-        const auto checker_vertex_shader_file = TlvReader::get_text_file(reader, "simple.vert");
-        const auto checker_fragment_shader_file = TlvReader::get_text_file(reader, "checker.frag");
-        const auto checker_vertex_shader = game::Shader{checker_vertex_shader_file.data, game::ShaderType::VERTEX};
-        const auto checker_fragment_shader = game::Shader{checker_fragment_shader_file.data, game::ShaderType::FRAGMENT};
-        resource_cache.insert<Material>("checkerboard_material", checker_vertex_shader, checker_fragment_shader);
-
-        const auto simple_fragment_shader_file = TlvReader::get_text_file(reader, "simple.frag");
-        const auto simple_fragment_shader = game::Shader{simple_fragment_shader_file.data, game::ShaderType::FRAGMENT};
-        resource_cache.insert<Material>("floor_material", vertex_shader, simple_fragment_shader);
-        resource_cache.insert<Material>("level_material", vertex_shader, simple_fragment_shader);
+        // materials sharing shaders share the program, linking continues in the background until the render routine
+        // resolves the programs before its first frame
+        resource_cache.insert<Material>("barrel_material", program_cache.get(reader, "simple.vert", "barrel.frag"));
+        resource_cache.insert<Material>("checkerboard_material", program_cache.get(reader, "simple.vert", "checker.frag"));
+        resource_cache.insert<Material>("floor_material", program_cache.get(reader, "simple.vert", "simple.frag"));
+        resource_cache.insert<Material>("level_material", program_cache.get(reader, "simple.vert", "simple.frag"));
 
         game::log::info("Creating GL textures...");
 
@@ -148,13 +157,16 @@ namespace game
         resource_cache.insert<Texture>("barrel_specular", reader, "barrel_metallic", mipmap);
         resource_cache.insert<Texture>("barrel_normal", reader, "barrel_normal_ogl", mipmap);
 
-        resource_cache.insert<Texture>("Concrete042A_2K-JPG_Color", reader, "Concrete042A_2K-JPG_Color", mipmap);
-        resource_cache.insert<Texture>("Concrete042A_2K-JPG_NormalGL", reader, "Concrete042A_2K-JPG_NormalGL", mipmap);
-        resource_cache.insert<Texture>("Metal025_2K-JPG_NormalGL", reader, "Metal025_2K-JPG_NormalGL", mipmap);
-        resource_cache.insert<Texture>("Floor lines map", reader, "Floor lines map", mipmap);
-        resource_cache.insert<Texture>("Blue line map", reader, "Blue line map", mipmap);
-        resource_cache.insert<Texture>("Floor diffuse", reader, "Floor diffuse", mipmap);
-        resource_cache.insert<Texture>("Main walls diffuse", reader, "Main walls diffuse", mipmap);
+        if (level_assets_in_base)
+        {
+            resource_cache.insert<Texture>("Concrete042A_2K-JPG_Color", reader, "Concrete042A_2K-JPG_Color", mipmap);
+            resource_cache.insert<Texture>("Concrete042A_2K-JPG_NormalGL", reader, "Concrete042A_2K-JPG_NormalGL", mipmap);
+            resource_cache.insert<Texture>("Metal025_2K-JPG_NormalGL", reader, "Metal025_2K-JPG_NormalGL", mipmap);
+            resource_cache.insert<Texture>("Floor lines map", reader, "Floor lines map", mipmap);
+            resource_cache.insert<Texture>("Blue line map", reader, "Blue line map", mipmap);
+            resource_cache.insert<Texture>("Floor diffuse", reader, "Floor diffuse", mipmap);
+            resource_cache.insert<Texture>("Main walls diffuse", reader, "Main walls diffuse", mipmap);
+        }
 
         resource_cache.insert<Texture>("Iron_diffuse",
                                        TextureDescription{
@@ -197,8 +209,8 @@ namespace game
         auto scheduler = Scheduler{_message_bus};
 
         auto input_routine = routines::InputRoutine{_window, _message_bus, scheduler};
-        auto level_routine = routines::LevelRoutine{ps, _window, _message_bus, scheduler, resource_cache, reader, resource_loader};
-        auto render_routine = routines::RenderRoutine{_window, _message_bus, scheduler, reader, mesh_loader, _samples};
+        auto level_routine = routines::LevelRoutine{ps, _window, _message_bus, scheduler, resource_cache, packs, resource_loader, async_loader, texture_streamer};
+        auto render_routine = routines::RenderRoutine{_window, _message_bus, scheduler, program_cache, reader, mesh_loader, texture_streamer, _samples};
         auto sound_routine = routines::SoundRoutine{_message_bus, scheduler, resource_cache};
         auto physics_routine = routines::PhysicsRoutine{ps, _message_bus, scheduler};
 
@@ -212,6 +224,9 @@ namespace game
         scheduler.add(level_routine.create_task());
         scheduler.add(render_routine.create_task());
 
+        // startup loading is done, from here on mapped packs are only read entry by entry, read ahead would waste memory
+        packs.advise(AccessHint::RANDOM);
+
         game::log::info("Running scheduler...");
         scheduler.run();
     }
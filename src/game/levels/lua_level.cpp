@@ -1,6 +1,8 @@
 #include "game/levels/lua_level.h"
 
 #include <algorithm>
+#include <cstddef>
+#include <limits>
 #include <optional>
 #include <ranges>
 #include <span>
@@ -34,18 +36,27 @@ namespace
 {
     auto calculate_bounding_box(const game::Mesh *mesh, const game::Transform &transform) -> std::tuple<game::Vector3, game::Vector3>
     {
-        const auto minmax_x = std::ranges::minmax(mesh->mesh_data().vertices, std::less<>{}, [](const auto &v)
-                                                  { return v.position.x; });
-        const auto minmax_y = std::ranges::minmax(mesh->mesh_data().vertices, std::less<>{}, [](const auto &v)
-                                                  { return v.position.y; });
-        const auto minmax_z = std::ranges::minmax(mesh->mesh_data().vertices, std::less<>{}, [](const auto &v)
-                                                  { return v.position.z; });
-
-        const auto transformed_min = game::Matrix4{transform} * game::Vector4{minmax_x.min.position.x, minmax_y.min.position.y, minmax_z.min.position.z, 1.0};
-        const auto transformed_max = game::Matrix4{transform} * game::Vector4{minmax_x.max.position.x, minmax_y.max.position.y, minmax_z.max.position.z, 1.0};
-        auto result = std::make_tuple(static_cast<game::Vector3>(transformed_min), static_cast<game::Vector3>(transformed_max));
-
-        return result;
+        // the packer stores object space bounds, so only the corners of that box need to be transformed
+        const auto &bounds = mesh->bounds();
+        const auto model = game::Matrix4{transform};
+
+        auto min = game::Vector3{std::numeric_limits<float>::max()};
+        auto max = game::Vector3{std::numeric_limits<float>::lowest()};
+
+        for (auto corner = 0u; corner < 8u; ++corner)
+        {
+            const auto transformed = static_cast<game::Vector3>(
+                model * game::Vector4{
+                            (corner & 1u) != 0u ? bounds.max.x : bounds.min.x,
+                            (corner & 2u) != 0u ? bounds.max.y : bounds.min.y,
+                            (corner & 4u) != 0u ? bounds.max.z : bounds.min.z,
+                            1.f});
+
+            min = {std::min(min.x, transformed.x), std::min(min.y, transformed.y), std::min(min.z, transformed.z)};
+            max = {std::max(max.x, transformed.x), std::max(max.y, transformed.y), std::max(max.z, transformed.z)};
+        }
+
+        return {min, max};
     }
 
     auto albedo_texture_name(std::string_view mesh_name) -> std::string
@@ -226,13 +237,14 @@ namespace game::levels
     LuaLevel::LuaLevel(
         PhysicsSystem &ps,
         const ScriptLoader &loader,
+        std::string_view script,
         DefaultCache &resource_cache,
         const ResourceLoader &resource_loader,
         const TlvReader &reader,
         const Player &player,
         messaging::MessageBus &bus)
         : _ps{ps},
-          _script{loader.load()},
+          _script{script},
           _entities{},
           _level_entities{},
           _skybox{reader, {"skybox_right", "skybox_left", "skybox_top", "skybox_bottom", "skybox_front", "skybox_back"}},
@@ -248,16 +260,16 @@ namespace game::levels
         runner.execute("Level_init_level", player.position());
 
         const Texture *barrel_textures[]{
-            _resource_cache.get<Texture>("barrel_albedo"),
-            _resource_cache.get<Texture>("barrel_specular"),
-            _resource_cache.get<Texture>("barrel_normal"),
+            _resource_cache.get<Texture>("barrel_albedo"_id),
+            _resource_cache.get<Texture>("barrel_specular"_id),
+            _resource_cache.get<Texture>("barrel_normal"_id),
         };
 
         const auto barrel_count = runner.execute<std::int64_t>("Level_entity_count");
         for (std::int64_t i = 0; i < barrel_count; ++i)
         {
             const auto info = runner.execute<Vector3, Vector3, float, std::int64_t, std::int64_t>("Level_entity_info", i + 1);
-            const auto *mesh = _resource_cache.get<Mesh>("barrel");
+            const auto *mesh = _resource_cache.get<Mesh>("barrel"_id);
             const auto &[min, max] = calculate_bounding_box(mesh, {std::get<0>(info),
                                                                    {0.4f}});
             const auto half_extents = (max - min) / 2.f;
@@ -268,7 +280,7 @@ namespace game::levels
                     std::fabs(half_extents.z),
                 });
             _entities.emplace_back(Entity{mesh,
-                                          _resource_cache.get<Material>("barrel_material"),
+                                          _resource_cache.get<Material>("barrel_material"_id),
                                           std::get<0>(info),
                                           {0.4f},
                                           {{0.f}, {1.f}, {0.707107f, 0.f, 0.f, 0.707107f}},
@@ -281,8 +293,8 @@ namespace game::levels
         }
 
         const auto text_factory = TextFactory{resource_loader};
-        static auto text_test = text_factory.create("Hello World!", _resource_cache.get<TextureSampler>("ui"), 16);
-        static auto text_test2 = text_factory.create("Hello Corner!", _resource_cache.get<TextureSampler>("ui"), 16);
+        static auto text_test = text_factory.create("Hello World!", _resource_cache.get<TextureSampler>("ui"_id), 16);
+        static auto text_test2 = text_factory.create("Hello Corner!", _resource_cache.get<TextureSampler>("ui"_id), 16);
 
         _scene = Scene{
             .entities = _entities |
@@ -305,7 +317,7 @@ namespace game::levels
                         .quad_attenuation = 0.017f}},
             .debug_lines = {},
             .skybox = &_skybox,
-            .skybox_sampler = _resource_cache.get<TextureSampler>("sky_box"),
+            .skybox_sampler = _resource_cache.get<TextureSampler>("sky_box"_id),
             .labels = {{0, 0, &text_test, Color::white()}, {1707, 0, &text_test2, Color::white()}},
             .effects = {.hdr = true, .grey_scale = false, .blur = false, .ssao = true}};
 
@@ -360,6 +372,7 @@ namespace game::levels
         };
 
         constexpr auto level_origin = Vector3{-180.f, -3.5f, 40.f};
+        constexpr auto min_half_extent = 0.05f;
 
         _level_entities =
             level_entity_names |
@@ -367,6 +380,15 @@ namespace game::levels
                 [&](const auto e)
                 { 
                     auto *mesh = resource_cache.get<Mesh>(e);
+                    const auto &[min, max] = calculate_bounding_box(mesh, {level_origin, {10.f}});
+                    const auto half_extents = (max - min) / 2.f;
+
+                    // flat meshes still need a valid box, jolt rejects half extents below the convex radius
+                    auto *bounding_box = _ps.create_shape<BoxShape>(Vector3{
+                        std::max(half_extents.x, min_half_extent),
+                        std::max(half_extents.y, min_half_extent),
+                        std::max(half_extents.z, min_half_extent)});
+
                     auto collider =
                         is_collision_relevant_mesh(e) ?
                         std::make_optional(TransformedShape{_ps.create_shape<MeshShape>(mesh->mesh_data(), 10.f), {level_origin, {1.f}, {}}}) :
@@ -381,7 +403,7 @@ namespace game::levels
                             resource_cache.get<Texture>(albedo_texture_name(e)),
                             resource_cache.get<Texture>(specular_texture_name(e)),
                             resource_cache.get<Texture>(normal_map_texture_name(e))},
-                        {_ps.create_shape<BoxShape>(Vector3{10.f}), {level_origin, {10.f}, {}}},
+                        {bounding_box, {(min + max) / 2.f, {1.f}, {}}},
                         2u,
                         2u,
                         collider}; }) |
@@ -444,7 +466,7 @@ namespace game::levels
             entity.set_visibility(visibility);
         }
 
-        _resource_cache.get<Material>("barrel_material")->set_uniform_callback([this](const auto *mat, const auto *ent)
+        _resource_cache.get<Material>("barrel_material"_id)->set_uniform_callback([this](const auto *mat, const auto *ent)
                                                                                {
             if(const auto info = _barrel_info.find(ent); info != std::ranges::cend(_barrel_info))
             {
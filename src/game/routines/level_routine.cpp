@@ -1,63 +1,53 @@
 #include "game/routines/level_routine.h"
 
 #include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
 #include <numbers>
+#include <optional>
+#include <ranges>
 #include <string>
 #include <vector>
 
+#include "file.h"
 #include "game/levels/level.h"
 #include "game/routines/routine_base.h"
 #include "graphics/camera.h"
 #include "graphics/line_data.h"
+#include "graphics/mesh.h"
+#include "graphics/texture.h"
+#include "graphics/texture_sampler.h"
+#include "graphics/texture_streamer.h"
 #include "log.h"
+#include "math/frustum_culler.h"
 #include "messaging/message_bus.h"
 #include "messaging/subscriber.h"
 #include "physics/box_shape.h"
 #include "physics/physics_sytem.h"
 #include "primitives/entity.h"
+#include "resources/async_resource_loader.h"
+#include "resources/pack_set.h"
 #include "resources/resource_cache.h"
 #include "scheduler/scheduler.h"
 #include "scheduler/task.h"
 #include "scheduler/wait.h"
 #include "scripting/script_loader.h"
+#include "tlv/tlv_entry.h"
 #include "tlv/tlv_reader.h"
 
 using namespace std::string_view_literals;
 
 namespace
 {
-    auto intersects_frustum(const game::TransformedShape &bounding_box, const std::array<game::FrustumPlane, 6u> &planes) -> bool
+    auto add_bounds(game::BoundsBatch &bounds, const game::TransformedShape &bounding_box) -> void
     {
         game::expect(bounding_box.shape()->type() == game::ShapeType::BOX, "Not a bounding BOX");
 
-        const auto *box_shape = dynamic_cast<const game::BoxShape *>(bounding_box.shape());
-        const auto position = bounding_box.transform().position;
-
-        const auto min = position - box_shape->dimensions();
-        const auto max = position + box_shape->dimensions();
-
-        for (const auto &plane : planes)
-        {
-            auto pos_vert = min;
-            if (plane.normal.x >= 0)
-            {
-                pos_vert.x = max.x;
-            }
-            if (plane.normal.y >= 0)
-            {
-                pos_vert.y = max.y;
-            }
-            if (plane.normal.z >= 0)
-            {
-                pos_vert.z = max.z;
-            }
-
-            if (game::Vector3::dot(plane.normal, pos_vert) + plane.distance < 0.f)
-            {
-                return false;
-            }
-        }
-        return true;
+        // the type was checked, no need for a dynamic_cast per entity per frame
+        const auto *box_shape = static_cast<const game::BoxShape *>(bounding_box.shape());
+        bounds.add(bounding_box.transform().position, box_shape->dimensions());
     }
 
     auto create_camera(const game::Window &window) -> game::Camera
@@ -113,26 +103,79 @@ namespace
 
         return level_loaders;
     }
+
+    /**
+     * Cache all meshes and textures of a pack. Meshes that are already cached (by the base pack) are left alone.
+     * Textures are referenced, those of earlier levels that are still cached are reused and new ones are streamed.
+     */
+    auto load_pack_into_cache(
+        game::DefaultCache &resource_cache,
+        game::TextureStreamer &texture_streamer,
+        const game::TlvReader &reader,
+        std::vector<std::string> &meshes,
+        std::vector<game::ResourceRef<game::Texture>> &textures) -> void
+    {
+        const auto *sampler = resource_cache.get<game::TextureSampler>("mipmap");
+
+        for (const auto &entry : reader)
+        {
+            if (entry.type() == game::TlvType::OBJECT_SUB_MESH_NAMES)
+            {
+                for (const auto &name : entry.object_data_value())
+                {
+                    if (!resource_cache.contains<game::Mesh>(name))
+                    {
+                        resource_cache.insert<game::Mesh>(name, reader, name);
+                        meshes.push_back(name);
+                    }
+                }
+            }
+            else if (entry.type() == game::TlvType::TEXTURE_DESCRIPTION)
+            {
+                // lower quality tiers are picked up by the texture they belong to
+                const auto name = entry.texture_name_value();
+                if (game::is_texture_tier(name))
+                {
+                    continue;
+                }
+
+                const auto id = game::ResourceId{name};
+                textures.push_back(resource_cache.contains<game::Texture>(id) ? resource_cache.acquire<game::Texture>(id)
+                                                                              : texture_streamer.insert_async(reader, name, sampler));
+            }
+        }
+    }
 }
 
 namespace game::routines
 {
     LevelRoutine::LevelRoutine(PhysicsSystem &ps, const Window &window, messaging::MessageBus &bus, Scheduler &scheduler, DefaultCache &resource_cache,
-                               const TlvReader &reader, const ResourceLoader &resource_loader)
+                               PackSet &packs, const ResourceLoader &resource_loader, AsyncResourceLoader &async_loader, TextureStreamer &texture_streamer)
         : RoutineBase{bus, {messaging::MessageType::KEY_PRESS, messaging::MessageType::LEVEL_COMPLETE}},
           _ps{ps},
           _window{window},
           _scheduler{scheduler},
           _player{bus, create_camera(window), _ps.character_controller()},
           _level_num{},
-          _level_names{get_level_loaders(reader)},
+          _level_names{get_level_loaders(packs.base())},
           _resource_cache{resource_cache},
           _resource_loader{resource_loader},
-          _reader{reader},
-          _level{std::make_unique<levels::LuaLevel>(_ps, _level_names[_level_num], _resource_cache, _resource_loader, _reader, _player, _bus)},
+          _async_loader{async_loader},
+          _texture_streamer{texture_streamer},
+          _packs{packs},
+          _reader{packs.base()},
+          _level{},
+          _level_pack{},
+          _next_level_pack{},
+          _next_level_script{},
+          _level_meshes{},
+          _level_textures{},
+          _bounds{},
+          _visible{},
           _show_physics_debug{false},
           _show_debug{false}
     {
+        load_level();
         // _window.set_title(_level_names[_level_num].name());
     }
 
@@ -150,9 +193,21 @@ namespace game::routines
 
             if (_level == nullptr || curernt_level != _level_num)
             {
+                // the next level pack and script are read in the background, the current level stays on screen until
+                // they are ready
+                auto pending_script = _level_names[_level_num].load(_async_loader);
+                if (const auto next_pack = level_pack(_level_num); next_pack && !_packs.is_mounted(*next_pack))
+                {
+                    auto pending = _async_loader.load_pack(*next_pack);
+                    co_await Wait{_scheduler, pending};
+                    _next_level_pack = pending.get();
+                }
+                co_await Wait{_scheduler, pending_script};
+                _next_level_script = pending_script.get();
+
                 _player.restart();
-                _level.reset();
-                _level = std::make_unique<levels::LuaLevel>(_ps, _level_names[_level_num], _resource_cache, _resource_loader, _reader, _player, _bus);
+                unload_level();
+                load_level();
                 _level->set_show_debug(_show_debug);
                 _level->set_show_physics_debug(_show_physics_debug);
                 _level->restart();
@@ -165,9 +220,20 @@ namespace game::routines
             _player.update();
             level->update(_player);
 
-            for (auto &entity : level->scene().entities)
+            auto &entities = level->scene().entities;
+
+            _bounds.clear();
+            for (const auto *entity : entities)
+            {
+                add_bounds(_bounds, entity->bounding_box());
+            }
+
+            const auto culler = FrustumCuller{_player.camera().frustum_planes()};
+            culler.cull(_bounds, _visible);
+
+            for (const auto &[index, entity] : entities | std::views::enumerate)
             {
-                entity->set_visibility(intersects_frustum(entity->bounding_box(), _player.camera().frustum_planes()));
+                entity->set_visibility(FrustumCuller::is_visible(_visible, static_cast<std::size_t>(index)));
             }
 
             if (_show_physics_debug)
@@ -194,6 +260,64 @@ namespace game::routines
         log::info("LevelRoutine ending");
     }
 
+    auto LevelRoutine::load_level() -> void
+    {
+        const auto &loader = _level_names[_level_num];
+
+        _level_pack = level_pack(_level_num);
+        if (_level_pack)
+        {
+            const auto &reader = _next_level_pack ? _packs.mount(*_level_pack, std::move(_next_level_pack)) : _packs.mount(*_level_pack);
+            load_pack_into_cache(_resource_cache, _texture_streamer, reader, _level_meshes, _level_textures);
+            log::info("loaded {} meshes and {} textures from {}", _level_meshes.size(), _level_textures.size(), *_level_pack);
+        }
+
+        // only the first level is read here, on startup, later ones were read in the background by create_task
+        const auto script = _next_level_script ? std::move(*_next_level_script) : loader.load();
+        _next_level_script.reset();
+
+        _level = std::make_unique<levels::LuaLevel>(_ps, loader, script, _resource_cache, _resource_loader, _reader, _player, _bus);
+
+        // the level is loaded, its pack is now only read by streamed textures, entry by entry
+        _packs.advise(AccessHint::RANDOM);
+
+        // warm the page cache with the pack of the level after this one while this one is played
+        const auto next_level_pack = level_pack((_level_num + 1u) % _level_names.size());
+        if (next_level_pack && next_level_pack != _level_pack)
+        {
+            _async_loader.prefetch(*next_level_pack);
+        }
+    }
+
+    auto LevelRoutine::level_pack(std::size_t level_num) const -> std::optional<std::string>
+    {
+        // custom levels are named by their path, the manifest only knows the file name
+        return _packs.manifest().level_pack(std::filesystem::path{_level_names[level_num].name()}.filename().string());
+    }
+
+    auto LevelRoutine::unload_level() -> void
+    {
+        // the level references cached resources, which reference the pack, so release in that order
+        _level.reset();
+
+        for (const auto &name : _level_meshes)
+        {
+            _resource_cache.erase<Mesh>(name);
+        }
+        _level_meshes.clear();
+
+        // textures do not reference the pack, they stay cached until the texture budget is exceeded
+        _level_textures.clear();
+
+        if (_level_pack)
+        {
+            // textures still being read from the pack
+            _texture_streamer.wait_for_decodes();
+            _packs.unmount(*_level_pack);
+            _level_pack.reset();
+        }
+    }
+
     auto LevelRoutine::player() const -> const Player &
     {
         return _player;
@@ -211,13 +211,13 @@ namespace game::routines
         _window.set_title("game: MainMenu");
 
         const Texture *barrel_textures[]{
-            _resource_cache.get<Texture>("barrel_albedo"),
-            _resource_cache.get<Texture>("barrel_specular"),
-            _resource_cache.get<Texture>("barrel_normal"),
+            _resource_cache.get<Texture>("barrel_albedo"_id),
+            _resource_cache.get<Texture>("barrel_specular"_id),
+            _resource_cache.get<Texture>("barrel_normal"_id),
         };
-        const auto *mesh = _resource_cache.get<Mesh>("barrel");
+        const auto *mesh = _resource_cache.get<Mesh>("barrel"_id);
         _entities.emplace_back(Entity{mesh,
-                                      _resource_cache.get<Material>("barrel_material"),
+                                      _resource_cache.get<Material>("barrel_material"_id),
                                       Vector3{0.f},
                                       {0.4f},
                                       {{0.f}, {1.f}, {0.707107f, 0.f, 0.f, 0.707107f}},
@@ -228,10 +228,10 @@ namespace game::routines
 
         const auto text_factory = TextFactory{resource_loader};
 
-        _labels.push_back(text_factory.create("Barrel Game", _resource_cache.get<TextureSampler>("ui"), 32));
-        _labels.push_back(text_factory.create("Press any key to start", _resource_cache.get<TextureSampler>("ui"), 24));
-        _labels.push_back(text_factory.create("or ESC to exit", _resource_cache.get<TextureSampler>("ui"), 24));
-        _labels.push_back(text_factory.create(std::format("v{}.{}.{}", version::major, version::minor, version::patch), _resource_cache.get<TextureSampler>("ui"), 16));
+        _labels.push_back(text_factory.create("Barrel Game", _resource_cache.get<TextureSampler>("ui"_id), 32));
+        _labels.push_back(text_factory.create("Press any key to start", _resource_cache.get<TextureSampler>("ui"_id), 24));
+        _labels.push_back(text_factory.create("or ESC to exit", _resource_cache.get<TextureSampler>("ui"_id), 24));
+        _labels.push_back(text_factory.create(std::format("v{}.{}.{}", version::major, version::minor, version::patch), _resource_cache.get<TextureSampler>("ui"_id), 16));
 
         const auto ambient_vec = Vector3{0.15f};
         const auto direction_light_dir = Vector3{0.f, 0.f, 1.f};
@@ -263,7 +263,7 @@ namespace game::routines
                         .quad_attenuation = 0.017f}},
             .debug_lines = {},
             .skybox = nullptr,
-            .skybox_sampler = _resource_cache.get<TextureSampler>("sky_box"),
+            .skybox_sampler = _resource_cache.get<TextureSampler>("sky_box"_id),
             .labels = {
                 {window.width() / 2 - _labels[0].width() / 2, 360, &_labels[0], Color::red()},
                 {window.width() / 2 - _labels[1].width() / 2, 900, &_labels[1], Color::green()},
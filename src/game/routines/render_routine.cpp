@@ -5,8 +5,10 @@
 #include "game/routines/level_routine.h"
 #include "game/routines/routine_base.h"
 #include "graphics/debug_ui.h"
+#include "graphics/program_cache.h"
 #include "graphics/renderer.h"
 #include "graphics/shape_wireframe_renderer.h"
+#include "graphics/texture_streamer.h"
 #include "loaders/mesh_loader.h"
 #include "messaging/message_bus.h"
 #include "scheduler/scheduler.h"
@@ -22,8 +24,10 @@ namespace game::routines
         const Window &window,
         messaging::MessageBus &bus,
         Scheduler &scheduler,
+        ProgramCache &program_cache,
         const TlvReader &reader,
         MeshLoader &mesh_loader,
+        TextureStreamer &texture_streamer,
         std::uint8_t samples)
         : RoutineBase(bus, {messaging::MessageType::KEY_PRESS,
                             messaging::MessageType::MOUSE_MOVE,
@@ -31,7 +35,10 @@ namespace game::routines
                             messaging::MessageType::CHANGE_SCENE}),
           _window(window),
           _scheduler(scheduler),
-          _renderer{reader,
+          _program_cache(program_cache),
+          _texture_streamer(texture_streamer),
+          _renderer{program_cache,
+                    reader,
                     mesh_loader,
                     _window.width(),
                     _window.height(),
@@ -49,11 +56,19 @@ namespace game::routines
         auto gamma = 2.2f;
         // const auto debug_ui = game::DebugUi(_window.native_handle(), _level_routine.level().scene(), _player.camera(), gamma);
 
+        // the other routines start while the driver links, so the first frame neither waits for a link nor saves binaries
+        co_await Wait{_scheduler, [this]
+                      { return _program_cache.is_ready(); }};
+        _program_cache.resolve();
+
         while (_state != GameState::EXITING)
         {
             expect(_scene, "scene cannot be null");
             expect(_camera, "camera cannot be null");
 
+            // textures of a level that is still loading replace their placeholders over the next frames
+            _texture_streamer.upload();
+
             _renderer.render(*_camera, *_scene, gamma);
             if (_show_debug)
             {
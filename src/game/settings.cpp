@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex> // added
 
+#include "graphics/texture.h"
 #include "utils/ensure.h"
 
 namespace game
@@ -17,7 +18,9 @@ namespace game
           _anti_aliasing(false),
           _samples(1),
           _anisotropic_filtering(true),
-          _anisotropic_filter_samples(16)
+          _anisotropic_filter_samples(16),
+          _texture_tier(0),
+          _texture_budget(512)
     {
     }
 
@@ -104,4 +107,26 @@ namespace game
         _anisotropic_filter_samples = samples;
     }
 
+    auto Settings::texture_tier() const -> std::uint32_t
+    {
+        return _texture_tier;
+    }
+
+    auto Settings::set_texture_tier(std::uint32_t tier) -> void
+    {
+        expect(tier < texture_tier_count, "Invalid texture tier: {}", tier);
+
+        _texture_tier = tier;
+    }
+
+    auto Settings::texture_budget() const -> std::uint32_t
+    {
+        return _texture_budget;
+    }
+
+    auto Settings::set_texture_budget(std::uint32_t mib) -> void
+    {
+        _texture_budget = mib;
+    }
+
 }
\ No newline at end of file
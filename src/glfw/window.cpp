@@ -189,10 +189,19 @@ namespace
         function = reinterpret_cast<T>(address);
     }
 
+    template <class T>
+    auto resolve_optional_gl_function(T &function, const std::string &name) -> void
+    {
+        function = reinterpret_cast<T>(::GL_GET_PROC_ADDRESS(name.c_str()));
+    }
+
     auto resolve_global_gl_functions() -> void
     {
 #define RESOLVE(TYPE, NAME) resolve_gl_function(NAME, #NAME);
         FOR_OPENGL_FUNCTIONS(RESOLVE);
+
+#define RESOLVE_OPTIONAL(TYPE, NAME) resolve_optional_gl_function(NAME, #NAME);
+        FOR_OPTIONAL_OPENGL_FUNCTIONS(RESOLVE_OPTIONAL);
     }
 
     auto setup_debug() -> void
@@ -30,4 +30,9 @@ namespace game
         return _buffer;
     }
 
+    auto Buffer::size() const -> std::uint32_t
+    {
+        return _size;
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "graphics/compact_vertex_data.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+namespace
+{
+    auto sign_not_zero(float value) -> float
+    {
+        return value >= 0.f ? 1.f : -1.f;
+    }
+
+    auto quantize(float value, float bias, float scale) -> std::int16_t
+    {
+        return game::to_snorm16((value - bias) / scale);
+    }
+}
+
+namespace game
+{
+    auto to_half(float value) -> std::uint16_t
+    {
+        const auto bits = std::bit_cast<std::uint32_t>(value);
+        const auto sign = static_cast<std::uint16_t>((bits >> 16u) & 0x8000u);
+        const auto exponent = static_cast<std::int32_t>((bits >> 23u) & 0xffu);
+        auto mantissa = bits & 0x7fffffu;
+
+        if (exponent == 0xff)
+        {
+            // keep nan a nan
+            return static_cast<std::uint16_t>(sign | 0x7c00u | (mantissa != 0u ? 0x200u : 0u));
+        }
+
+        const auto half_exponent = exponent - 127 + 15;
+        if (half_exponent >= 0x1f)
+        {
+            return static_cast<std::uint16_t>(sign | 0x7c00u);
+        }
+
+        if (half_exponent <= 0)
+        {
+            if (half_exponent < -10)
+            {
+                return sign;
+            }
+
+            // subnormal half, shift the mantissa (with its implicit bit) into place and round to nearest even
+            mantissa |= 0x800000u;
+            const auto shift = static_cast<std::uint32_t>(14 - half_exponent);
+            auto half_mantissa = mantissa >> shift;
+            const auto remainder = mantissa & ((1u << shift) - 1u);
+            const auto halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u) != 0u))
+            {
+                ++half_mantissa;
+            }
+
+            return static_cast<std::uint16_t>(sign | half_mantissa);
+        }
+
+        auto half = (static_cast<std::uint32_t>(half_exponent) << 10u) | (mantissa >> 13u);
+        const auto remainder = mantissa & 0x1fffu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u) != 0u))
+        {
+            // a carry into the exponent is still correct, it rounds up to the next power of two (or infinity)
+            ++half;
+        }
+
+        return static_cast<std::uint16_t>(sign | half);
+    }
+
+    auto from_half(std::uint16_t value) -> float
+    {
+        const auto sign = static_cast<std::uint32_t>(value & 0x8000u) << 16u;
+        const auto exponent = static_cast<std::uint32_t>((value >> 10u) & 0x1fu);
+        const auto mantissa = static_cast<std::uint32_t>(value & 0x3ffu);
+
+        if (exponent == 0u)
+        {
+            const auto subnormal = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign != 0u ? -subnormal : subnormal;
+        }
+
+        if (exponent == 0x1fu)
+        {
+            return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13u));
+        }
+
+        return std::bit_cast<float>(sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+    }
+
+    auto to_snorm16(float value) -> std::int16_t
+    {
+        return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.f, 1.f) * 32767.f));
+    }
+
+    auto from_snorm16(std::int16_t value) -> float
+    {
+        return std::max(static_cast<float>(value) / 32767.f, -1.f);
+    }
+
+    auto encode_octahedral(const Vector3 &value) -> std::array<std::int16_t, 2u>
+    {
+        const auto l1_norm = std::abs(value.x) + std::abs(value.y) + std::abs(value.z);
+        if (l1_norm == 0.f)
+        {
+            return {};
+        }
+
+        auto x = value.x / l1_norm;
+        auto y = value.y / l1_norm;
+
+        if (value.z < 0.f)
+        {
+            // fold the lower hemisphere over the diagonals
+            const auto folded_x = (1.f - std::abs(y)) * sign_not_zero(x);
+            const auto folded_y = (1.f - std::abs(x)) * sign_not_zero(y);
+            x = folded_x;
+            y = folded_y;
+        }
+
+        return {to_snorm16(x), to_snorm16(y)};
+    }
+
+    auto decode_octahedral(const std::array<std::int16_t, 2u> &value) -> Vector3
+    {
+        auto x = from_snorm16(value[0]);
+        auto y = from_snorm16(value[1]);
+        const auto z = 1.f - std::abs(x) - std::abs(y);
+
+        const auto t = std::max(-z, 0.f);
+        x += x >= 0.f ? -t : t;
+        y += y >= 0.f ? -t : t;
+
+        return Vector3::normalize({x, y, z});
+    }
+
+    auto compact_vertex(const VertexData &vertex, const VertexQuantization &quantization) -> CompactVertexData
+    {
+        const auto &[scale, bias] = quantization;
+
+        return {
+            .position = {
+                quantize(vertex.position.x, bias.x, scale.x),
+                quantize(vertex.position.y, bias.y, scale.y),
+                quantize(vertex.position.z, bias.z, scale.z),
+                0},
+            .normal = encode_octahedral(vertex.normal),
+            .tangent = encode_octahedral(vertex.tangent),
+            .uv = {to_half(vertex.uv.u), to_half(vertex.uv.v)}};
+    }
+
+    auto expand_vertex(const CompactVertexData &vertex, const VertexQuantization &quantization) -> VertexData
+    {
+        return {
+            .position = expand_position(vertex, quantization),
+            .normal = decode_octahedral(vertex.normal),
+            .tangent = decode_octahedral(vertex.tangent),
+            .uv = {from_half(vertex.uv[0]), from_half(vertex.uv[1])}};
+    }
+
+    auto expand_position(const CompactVertexData &vertex, const VertexQuantization &quantization) -> Vector3
+    {
+        const auto &[scale, bias] = quantization;
+
+        return {
+            bias.x + scale.x * from_snorm16(vertex.position[0]),
+            bias.y + scale.y * from_snorm16(vertex.position[1]),
+            bias.z + scale.z * from_snorm16(vertex.position[2])};
+    }
+}
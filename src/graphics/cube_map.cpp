@@ -16,6 +16,23 @@
 
 namespace
 {
+    auto get_compressed_format(game::TextureFormat format) -> ::GLenum
+    {
+        switch (format)
+        {
+            using enum game::TextureFormat;
+        case BC1:
+            return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+        case BC3:
+            return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT;
+        case BC7:
+            return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+        default:
+            game::ensure(false, "unhandled compressed format {}", format);
+            return 0u;
+        }
+    }
+
     auto num_channels_from_format(game::TextureFormat format) -> std::int32_t
     {
         switch (format)
@@ -62,6 +79,39 @@ namespace game
             "all widths and heights have to be the same");
 
         ::glCreateTextures(GL_TEXTURE_CUBE_MAP, 1u, &_handle);
+
+        const auto format = datas.front().format;
+        if (is_block_compressed(format))
+        {
+            ensure(
+                std::ranges::all_of(datas, [format](const auto &e)
+                                    { return e.format == format; }),
+                "all compressed faces have to use the same format");
+
+            // only the top level is used, the sky box is sampled without mips
+            const auto internal_format = get_compressed_format(format);
+            const auto face_size = mip_level_size(format, width, height);
+            ::glTextureStorage2D(_handle, 1, internal_format, width, height);
+
+            for (const auto &[index, data] : std::views::enumerate(datas))
+            {
+                ::glCompressedTextureSubImage3D(
+                    _handle,
+                    0,
+                    0,
+                    0,
+                    static_cast<::GLint>(index),
+                    width,
+                    height,
+                    1,
+                    internal_format,
+                    static_cast<::GLsizei>(face_size),
+                    data.data.data());
+            }
+
+            return;
+        }
+
         ::glTextureStorage2D(_handle, 1, GL_SRGB8, width, height);
 
         for (const auto &[index, data] : std::views::enumerate(datas))
@@ -1,109 +1,121 @@
 #include "graphics/material.h"
 
 #include <format>
+#include <optional>
 #include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
 
 #include "graphics/opengl.h"
-#include "graphics/shader.h"
+#include "graphics/program_cache.h"
 #include "graphics/texture.h"
 #include "graphics/texture_sampler.h"
 #include "log.h"
-#include "utils/auto_release.h"
+#include "math/matrix3.h"
+#include "math/matrix3x4.h"
+#include "math/vector3.h"
 #include "utils/ensure.h"
 
 namespace game
 {
-    Material::Material(const Shader &vertex_shader, const Shader &fragment_shader)
-        : _handle{},
-          _uniforms{},
-          _uniform_callback{}
+    Material::Material(const Program *program)
+        : _program{program},
+          _uniform_callback{},
+          _draw_uniforms{}
     {
-        ensure(vertex_shader.type() == ShaderType::VERTEX, "vertex_shader is not a vertex shader");
-        ensure(fragment_shader.type() == ShaderType::FRAGMENT, "fragment_shader is not a fragment shader");
-
-        _handle = AutoRelease<::GLuint>{::glCreateProgram(), ::glDeleteProgram};
-        ensure(_handle, "failed ot create opengl program");
-
-        ::glAttachShader(_handle, vertex_shader.native_handle());
-        ::glAttachShader(_handle, fragment_shader.native_handle());
-        ::glLinkProgram(_handle);
-
-        ::GLint result{};
-        ::glGetProgramiv(_handle, GL_LINK_STATUS, &result);
-
-        if (result != GL_TRUE)
-        {
-            char log[1024];
-            ::glGetProgramInfoLog(_handle, sizeof(log), nullptr, log);
+        expect(_program != nullptr, "material needs a program");
+    }
 
-            game::ensure(result == GL_TRUE, "failed to link program \n{}", log);
-        }
+    auto Material::use() const -> void
+    {
+        ::glUseProgram(_program->native_handle());
+    }
 
-        auto uniform_count = ::GLint{};
-        ::glGetProgramiv(_handle, GL_ACTIVE_UNIFORMS, &uniform_count);
+    auto Material::has_uniform(std::string_view name) const -> bool
+    {
+        return _program->uniforms().contains(name);
+    }
 
-        if (uniform_count == 0)
+    auto Material::draw_uniforms() const -> const DrawUniforms &
+    {
+        if (!_draw_uniforms)
         {
-            return;
+            const auto optional_location = [this](std::string_view name)
+            {
+                return has_uniform(name) ? uniform_location(name) : -1;
+            };
+
+            _draw_uniforms = DrawUniforms{
+                .model = uniform_location("model"),
+                .normal_matrix = uniform_location("normal_matrix"),
+                .compact_vertices = optional_location("compact_vertices"),
+                .position_scale = optional_location("position_scale"),
+                .position_bias = optional_location("position_bias")};
         }
 
-        auto max_name_length = ::GLint{};
-        ::glGetProgramiv(_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
-
-        auto length = ::GLsizei{};
-        auto count = ::GLsizei{};
-        auto type = ::GLenum{};
-
-        for (auto i = ::GLint{}; i < uniform_count; ++i)
-        {
-            auto name = std::string(max_name_length, '\0');
-
-            ::glGetActiveUniform(_handle, i, max_name_length, &length, &count, &type, name.data());
-            name.resize(length);
-
-            const auto location = ::glGetUniformLocation(_handle, name.c_str());
-            _uniforms[name] = location;
-        }
+        return *_draw_uniforms;
     }
 
-    auto Material::use() const -> void
+    auto Material::supports_compact_vertices() const -> bool
     {
-        ::glUseProgram(_handle);
+        const auto &uniforms = draw_uniforms();
+        return uniforms.compact_vertices != -1 && uniforms.position_scale != -1 && uniforms.position_bias != -1;
     }
 
     auto Material::set_uniform(std::string_view name, const Color &obj) const -> void
     {
-        const auto uniform = _uniforms.find(name);
-        ensure(uniform != std::ranges::cend(_uniforms), "uniform not found: {}", name);
+        ::glUniform3fv(uniform_location(name), 1, reinterpret_cast<const ::GLfloat *>(std::addressof(obj)));
+    }
 
-        ::glUniform3fv(uniform->second, 1, reinterpret_cast<const ::GLfloat *>(std::addressof(obj)));
+    auto Material::set_uniform(std::string_view name, const Matrix3 &obj) const -> void
+    {
+        set_uniform(uniform_location(name), obj);
     }
 
     auto Material::set_uniform(std::string_view name, const Matrix4 &obj) const -> void
     {
-        const auto uniform = _uniforms.find(name);
-        ensure(uniform != std::ranges::cend(_uniforms), "uniform not found: {}", name);
+        ::glUniformMatrix4fv(uniform_location(name), 1, GL_FALSE, obj.data().data());
+    }
 
-        ::glUniformMatrix4fv(uniform->second, 1, GL_FALSE, obj.data().data());
+    auto Material::set_uniform(std::string_view name, const Matrix3x4 &obj) const -> void
+    {
+        set_uniform(uniform_location(name), obj);
     }
 
     auto Material::set_uniform(std::string_view name, std::int32_t obj) const -> void
     {
-        const auto uniform = _uniforms.find(name);
-        ensure(uniform != std::ranges::cend(_uniforms), "uniform not found: {}", name);
-
-        ::glUniform1i(uniform->second, obj);
+        set_uniform(uniform_location(name), obj);
     }
 
     auto Material::set_uniform(std::string_view name, float obj) const -> void
     {
-        const auto uniform = _uniforms.find(name);
-        ensure(uniform != std::ranges::cend(_uniforms), "uniform not found: {}", name);
+        ::glUniform1f(uniform_location(name), obj);
+    }
 
-        ::glUniform1f(uniform->second, obj);
+    auto Material::set_uniform(std::string_view name, const Vector3 &obj) const -> void
+    {
+        ::glUniform3fv(uniform_location(name), 1, reinterpret_cast<const ::GLfloat *>(std::addressof(obj)));
+    }
+
+    auto Material::set_uniform(::GLint location, const Matrix3 &obj) const -> void
+    {
+        ::glUniformMatrix3fv(location, 1, GL_FALSE, obj.data().data());
+    }
+
+    auto Material::set_uniform(::GLint location, const Matrix3x4 &obj) const -> void
+    {
+        ::glUniformMatrix3x4fv(location, 1, GL_FALSE, obj.data().data());
+    }
+
+    auto Material::set_uniform(::GLint location, std::int32_t obj) const -> void
+    {
+        ::glUniform1i(location, obj);
+    }
+
+    auto Material::set_uniform(::GLint location, const Vector3 &obj) const -> void
+    {
+        ::glUniform3fv(location, 1, reinterpret_cast<const ::GLfloat *>(std::addressof(obj)));
     }
 
     auto Material::bind_cube_map(const CubeMap *texture, const TextureSampler *sampler) const -> void
@@ -153,7 +165,16 @@ namespace game
 
     auto Material::native_handle() const -> ::GLuint
     {
-        return _handle;
+        return _program->native_handle();
+    }
+
+    auto Material::uniform_location(std::string_view name) const -> ::GLint
+    {
+        const auto &uniforms = _program->uniforms();
+        const auto uniform = uniforms.find(name);
+        ensure(uniform != std::ranges::cend(uniforms), "uniform not found: {}", name);
+
+        return static_cast<::GLint>(uniform->second);
     }
 
 }
\ No newline at end of file
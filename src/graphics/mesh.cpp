@@ -1,11 +1,16 @@
 #include "graphics/mesh.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <ranges>
+#include <span>
 #include <string_view>
 
 #include "core/buffer_writer.h"
 #include "events/key_event.h"
 #include "graphics/buffer.h"
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
 #include "graphics/opengl.h"
 #include "graphics/vertex_data.h"
 #include "loaders/mesh_loader.h"
@@ -13,14 +18,29 @@
 #include "utils/auto_release.h"
 #include "utils/ensure.h"
 
+namespace
+{
+    auto buffer_size(const game::MeshData &data) -> std::uint32_t
+    {
+        auto size = data.vertices.size_bytes() + data.compact_vertices.size_bytes() + data.indices.size_bytes() + data.short_indices.size_bytes();
+        for (const auto &lod : data.lods)
+        {
+            size += lod.indices.size_bytes() + lod.short_indices.size_bytes();
+        }
+
+        return static_cast<std::uint32_t>(size);
+    }
+}
+
 namespace game
 {
     Mesh::Mesh(const TlvReader &reader, std::string_view name)
         : _vao{0u, [](auto vao)
                { ::glDeleteVertexArrays(1, &vao); }},
           _vbo{1u},
-          _index_count{},
-          _index_offset{}
+          _lods{},
+          _index_type{GL_UNSIGNED_INT},
+          _bounds{}
     {
         const auto data = std::ranges::find_if(reader, [name](const auto &e)
                                                { return e.is_mesh(name); });
@@ -30,28 +50,61 @@ namespace game
 
         std::ranges::swap(_vao, mesh._vao);
         std::ranges::swap(_vbo, mesh._vbo);
-        std::ranges::swap(_index_count, mesh._index_count);
-        std::ranges::swap(_index_offset, mesh._index_offset);
+        std::ranges::swap(_lods, mesh._lods);
+        std::ranges::swap(_index_type, mesh._index_type);
+        std::ranges::swap(_bounds, mesh._bounds);
         std::ranges::swap(_meshData, mesh._meshData);
     }
 
     Mesh::Mesh(MeshData data)
         : _vao{0u, [](auto vao)
                { ::glDeleteVertexArrays(1, &vao); }},
-          _vbo{static_cast<std::uint32_t>(data.vertices.size_bytes() + data.indices.size_bytes())},
-          _index_count(static_cast<std::uint32_t>(data.indices.size())),
-          _index_offset{data.vertices.size_bytes()},
+          _vbo{buffer_size(data)},
+          _lods{},
+          _index_type{data.short_indices.empty() ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT},
+          _bounds{data.bounds ? *data.bounds : compute_bounds(data)},
           _meshData(data)
     {
         {
             auto writer = BufferWriter{_vbo};
-            writer.write(data.vertices);
-            writer.write(data.indices);
+            if (data.is_compact())
+            {
+                writer.write(data.compact_vertices);
+            }
+            else
+            {
+                writer.write(data.vertices);
+            }
+
+            // the full detail indices are followed by the indices of every coarser level
+            auto index_offset = static_cast<std::uintptr_t>(data.vertices.size_bytes() + data.compact_vertices.size_bytes());
+            const auto write_indices = [&](std::span<const std::uint32_t> indices, std::span<const std::uint16_t> short_indices, float error)
+            {
+                ensure(short_indices.empty() == (_index_type == GL_UNSIGNED_INT), "all levels of detail must use the same index type");
+
+                if (short_indices.empty())
+                {
+                    writer.write(indices);
+                }
+                else
+                {
+                    writer.write(short_indices);
+                }
+
+                const auto index_count = short_indices.empty() ? indices.size() : short_indices.size();
+                _lods.push_back({.index_count = static_cast<std::uint32_t>(index_count), .index_offset = index_offset, .error = error});
+                index_offset += indices.size_bytes() + short_indices.size_bytes();
+            };
+
+            write_indices(data.indices, data.short_indices, 0.f);
+            for (const auto &lod : data.lods)
+            {
+                write_indices(lod.indices, lod.short_indices, lod.error);
+            }
         }
 
         ::glCreateVertexArrays(1, &_vao);
 
-        ::glVertexArrayVertexBuffer(_vao, 0, _vbo.native_handle(), 0, sizeof(VertexData));
         ::glVertexArrayElementBuffer(_vao, _vbo.native_handle());
 
         ::glEnableVertexArrayAttrib(_vao, 0); // position
@@ -59,10 +112,25 @@ namespace game
         ::glEnableVertexArrayAttrib(_vao, 2); // tangent
         ::glEnableVertexArrayAttrib(_vao, 3); // uv
 
-        ::glVertexArrayAttribFormat(_vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(VertexData, position));
-        ::glVertexArrayAttribFormat(_vao, 1, 3, GL_FLOAT, GL_FALSE, offsetof(VertexData, normal));
-        ::glVertexArrayAttribFormat(_vao, 2, 3, GL_FLOAT, GL_FALSE, offsetof(VertexData, tangent));
-        ::glVertexArrayAttribFormat(_vao, 3, 2, GL_FLOAT, GL_FALSE, offsetof(VertexData, uv));
+        if (data.is_compact())
+        {
+            // position is dequantised and normal/tangent are decoded in the vertex shader
+            ::glVertexArrayVertexBuffer(_vao, 0, _vbo.native_handle(), 0, sizeof(CompactVertexData));
+
+            ::glVertexArrayAttribFormat(_vao, 0, 3, GL_SHORT, GL_TRUE, offsetof(CompactVertexData, position));
+            ::glVertexArrayAttribFormat(_vao, 1, 2, GL_SHORT, GL_TRUE, offsetof(CompactVertexData, normal));
+            ::glVertexArrayAttribFormat(_vao, 2, 2, GL_SHORT, GL_TRUE, offsetof(CompactVertexData, tangent));
+            ::glVertexArrayAttribFormat(_vao, 3, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(CompactVertexData, uv));
+        }
+        else
+        {
+            ::glVertexArrayVertexBuffer(_vao, 0, _vbo.native_handle(), 0, sizeof(VertexData));
+
+            ::glVertexArrayAttribFormat(_vao, 0, 3, GL_FLOAT, GL_FALSE, offsetof(VertexData, position));
+            ::glVertexArrayAttribFormat(_vao, 1, 3, GL_FLOAT, GL_FALSE, offsetof(VertexData, normal));
+            ::glVertexArrayAttribFormat(_vao, 2, 3, GL_FLOAT, GL_FALSE, offsetof(VertexData, tangent));
+            ::glVertexArrayAttribFormat(_vao, 3, 2, GL_FLOAT, GL_FALSE, offsetof(VertexData, uv));
+        }
 
         ::glVertexArrayAttribBinding(_vao, 0, 0);
         ::glVertexArrayAttribBinding(_vao, 1, 0);
@@ -81,15 +149,68 @@ namespace game
     }
     auto Mesh::index_count() const -> std::uint32_t
     {
-        return _index_count;
+        return index_count(0u);
+    }
+
+    auto Mesh::index_count(std::size_t lod) const -> std::uint32_t
+    {
+        return _lods[lod].index_count;
     }
+
     auto Mesh::index_offset() const -> std::uintptr_t
     {
-        return _index_offset;
+        return index_offset(0u);
+    }
+
+    auto Mesh::index_offset(std::size_t lod) const -> std::uintptr_t
+    {
+        return _lods[lod].index_offset;
+    }
+
+    auto Mesh::index_type() const -> ::GLenum
+    {
+        return _index_type;
+    }
+
+    auto Mesh::lod_count() const -> std::size_t
+    {
+        return _lods.size();
+    }
+
+    auto Mesh::select_lod(float pixels_per_unit, float max_pixel_error) const -> std::size_t
+    {
+        // levels are ordered by increasing error, so stop at the first one that would be visible
+        auto lod = std::size_t{};
+        while (lod + 1u < _lods.size() && _lods[lod + 1u].error * pixels_per_unit <= max_pixel_error)
+        {
+            ++lod;
+        }
+
+        return lod;
+    }
+
+    auto Mesh::is_compact() const -> bool
+    {
+        return _meshData.is_compact();
+    }
+
+    auto Mesh::bounds() const -> const MeshBounds &
+    {
+        return _bounds;
+    }
+
+    auto Mesh::quantization() const -> VertexQuantization
+    {
+        return _meshData.quantization;
     }
 
     auto Mesh::mesh_data() const -> MeshData
     {
         return _meshData;
     }
+
+    auto Mesh::memory_size() const -> std::size_t
+    {
+        return _vbo.size();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "graphics/mesh_bounds.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <tuple>
+
+#include "graphics/mesh_data.h"
+#include "math/vector3.h"
+
+namespace
+{
+    /**
+     * Grow a sphere until it contains all positions, starting from the two extreme points furthest apart.
+     */
+    auto ritter_sphere(const game::MeshData &data, const std::array<std::size_t, 6u> &extremes) -> std::tuple<game::Vector3, float>
+    {
+        auto a = data.position(extremes[0]);
+        auto b = data.position(extremes[1]);
+        for (auto axis = 1u; axis < 3u; ++axis)
+        {
+            const auto min = data.position(extremes[axis * 2u]);
+            const auto max = data.position(extremes[axis * 2u + 1u]);
+            if (game::Vector3::distance(min, max) > game::Vector3::distance(a, b))
+            {
+                a = min;
+                b = max;
+            }
+        }
+
+        auto center = (a + b) * 0.5f;
+        auto radius = game::Vector3::distance(a, b) * 0.5f;
+
+        for (auto i = 0u; i < data.vertex_count(); ++i)
+        {
+            const auto position = data.position(i);
+            const auto distance = game::Vector3::distance(center, position);
+            if (distance > radius)
+            {
+                // move the centre towards the point just far enough to cover it and the opposite side of the sphere
+                const auto new_radius = (radius + distance) * 0.5f;
+                center += (position - center) * ((new_radius - radius) / distance);
+                radius = new_radius;
+            }
+        }
+
+        return {center, radius};
+    }
+}
+
+namespace game
+{
+    auto compute_bounds(const MeshData &data) -> MeshBounds
+    {
+        if (data.vertex_count() == 0u)
+        {
+            return {.min = {}, .max = {}, .center = {}, .radius = 0.f};
+        }
+
+        auto min = data.position(0u);
+        auto max = min;
+
+        // indices of the vertices with the smallest and largest x, y and z
+        auto extremes = std::array<std::size_t, 6u>{};
+
+        for (auto i = 1u; i < data.vertex_count(); ++i)
+        {
+            const auto position = data.position(i);
+            const auto components = std::array{position.x, position.y, position.z};
+            auto mins = std::array{&min.x, &min.y, &min.z};
+            auto maxs = std::array{&max.x, &max.y, &max.z};
+
+            for (auto axis = 0u; axis < 3u; ++axis)
+            {
+                if (components[axis] < *mins[axis])
+                {
+                    *mins[axis] = components[axis];
+                    extremes[axis * 2u] = i;
+                }
+                if (components[axis] > *maxs[axis])
+                {
+                    *maxs[axis] = components[axis];
+                    extremes[axis * 2u + 1u] = i;
+                }
+            }
+        }
+
+        auto center = (min + max) * 0.5f;
+        auto radius = 0.f;
+        for (auto i = 0u; i < data.vertex_count(); ++i)
+        {
+            radius = std::max(radius, Vector3::distance(center, data.position(i)));
+        }
+
+        if (const auto [ritter_center, ritter_radius] = ritter_sphere(data, extremes); ritter_radius < radius)
+        {
+            center = ritter_center;
+            radius = ritter_radius;
+        }
+
+        return {.min = min, .max = max, .center = center, .radius = radius};
+    }
+
+    auto merge(const MeshBounds &a, const MeshBounds &b) -> MeshBounds
+    {
+        const auto min = Vector3{std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)};
+        const auto max = Vector3{std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)};
+
+        // the box contains both meshes, so the sphere around it does as well
+        auto center = (min + max) * 0.5f;
+        auto radius = Vector3::distance(min, max) * 0.5f;
+
+        // one sphere may already contain the other, otherwise the sphere spans from the far side of a to that of b
+        const auto distance = Vector3::distance(a.center, b.center);
+        auto sphere_center = a.center;
+        auto sphere_radius = a.radius;
+
+        if (distance + a.radius <= b.radius)
+        {
+            sphere_center = b.center;
+            sphere_radius = b.radius;
+        }
+        else if (distance + b.radius > a.radius)
+        {
+            sphere_radius = (distance + a.radius + b.radius) * 0.5f;
+            sphere_center = a.center + (b.center - a.center) * ((sphere_radius - a.radius) / distance);
+        }
+
+        if (sphere_radius < radius)
+        {
+            center = sphere_center;
+            radius = sphere_radius;
+        }
+
+        return {.min = min, .max = max, .center = center, .radius = radius};
+    }
+}
@@ -0,0 +1,336 @@
+#include "graphics/program_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "file.h"
+#include "graphics/opengl.h"
+#include "log.h"
+#include "resources/resource_id.h"
+#include "tlv/tlv_reader.h"
+#include "utils/auto_release.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    /**
+     * Hash several strings as one, the separator keeps ("ab", "c") and ("a", "bc") apart.
+     */
+    auto hash(std::initializer_list<std::string_view> parts) -> std::uint64_t
+    {
+        auto joined = std::string{};
+        for (const auto part : parts)
+        {
+            joined.append(part);
+            joined.push_back('\0');
+        }
+
+        return game::ResourceId{joined}.value;
+    }
+
+    auto gl_string(::GLenum name) -> std::string_view
+    {
+        const auto *str = ::glGetString(name);
+        return str == nullptr ? std::string_view{} : reinterpret_cast<const char *>(str);
+    }
+
+    auto has_extension(std::string_view extension) -> bool
+    {
+        auto count = ::GLint{};
+        ::glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+        for (auto i = ::GLint{}; i < count; ++i)
+        {
+            const auto *name = ::glGetStringi(GL_EXTENSIONS, static_cast<::GLuint>(i));
+            if (name != nullptr && reinterpret_cast<const char *>(name) == extension)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    auto shader_log(::GLuint shader) -> std::string
+    {
+        if (shader == 0u)
+        {
+            return {};
+        }
+
+        char log[1024] = {};
+        ::glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        return log;
+    }
+
+    /**
+     * Save a linked program as [format: 4 bytes][binary]. Failing to save only costs a compile on the next run.
+     */
+    auto save_binary(::GLuint program, const std::filesystem::path &path) -> void
+    {
+        auto length = ::GLint{};
+        ::glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+        {
+            game::log::warn("driver provides no binary for program {}", program);
+            return;
+        }
+
+        auto binary = std::vector<std::byte>(sizeof(::GLenum) + static_cast<std::size_t>(length));
+        auto format = ::GLenum{};
+        ::glGetProgramBinary(program, length, nullptr, &format, binary.data() + sizeof(::GLenum));
+        std::memcpy(binary.data(), &format, sizeof(::GLenum));
+
+        auto out = std::ofstream{path, std::ios::binary};
+        out.write(reinterpret_cast<const char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+        if (!out)
+        {
+            game::log::warn("could not save program binary {}", path.string());
+        }
+    }
+}
+
+namespace game
+{
+    Program::Program(AutoRelease<::GLuint> handle, bool parallel_compile, ::GLuint vertex_shader, ::GLuint fragment_shader, std::optional<std::filesystem::path> binary_path)
+        : _handle{std::move(handle)},
+          _parallel_compile{parallel_compile},
+          _vertex_shader{vertex_shader},
+          _fragment_shader{fragment_shader},
+          _binary_path{std::move(binary_path)},
+          _uniforms{}
+    {
+    }
+
+    auto Program::is_ready() const -> bool
+    {
+        if (_uniforms || !_parallel_compile)
+        {
+            return true;
+        }
+
+        auto completed = ::GLint{};
+        ::glGetProgramiv(_handle, GL_COMPLETION_STATUS_KHR, &completed);
+        return completed == GL_TRUE;
+    }
+
+    auto Program::native_handle() const -> ::GLuint
+    {
+        resolve();
+        return _handle;
+    }
+
+    auto Program::uniforms() const -> const StringUnorderedMap<::GLuint> &
+    {
+        resolve();
+        return *_uniforms;
+    }
+
+    auto Program::resolve() const -> void
+    {
+        if (_uniforms)
+        {
+            return;
+        }
+
+        // blocks until the driver is done
+        ::GLint result{};
+        ::glGetProgramiv(_handle, GL_LINK_STATUS, &result);
+
+        if (result != GL_TRUE)
+        {
+            char log[1024];
+            ::glGetProgramInfoLog(_handle, sizeof(log), nullptr, log);
+
+            game::ensure(result == GL_TRUE, "failed to link program \n{}\n{}\n{}", log, shader_log(_vertex_shader), shader_log(_fragment_shader));
+        }
+
+        auto uniforms = StringUnorderedMap<::GLuint>{};
+
+        auto uniform_count = ::GLint{};
+        ::glGetProgramiv(_handle, GL_ACTIVE_UNIFORMS, &uniform_count);
+
+        auto max_name_length = ::GLint{};
+        ::glGetProgramiv(_handle, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+        auto length = ::GLsizei{};
+        auto count = ::GLsizei{};
+        auto type = ::GLenum{};
+
+        for (auto i = ::GLint{}; i < uniform_count; ++i)
+        {
+            auto name = std::string(max_name_length, '\0');
+
+            ::glGetActiveUniform(_handle, i, max_name_length, &length, &count, &type, name.data());
+            name.resize(length);
+
+            const auto location = ::glGetUniformLocation(_handle, name.c_str());
+            uniforms[name] = location;
+        }
+
+        _uniforms = std::move(uniforms);
+    }
+
+    ProgramCache::ProgramCache(std::optional<std::filesystem::path> binary_dir)
+        : _binary_dir{std::move(binary_dir)},
+          _driver_hash{hash({gl_string(GL_VENDOR), gl_string(GL_RENDERER), gl_string(GL_VERSION)})},
+          _parallel_compile{has_extension("GL_KHR_parallel_shader_compile") && ::glMaxShaderCompilerThreadsKHR != nullptr},
+          _shaders{},
+          _programs{}
+    {
+        if (_parallel_compile)
+        {
+            // let the driver pick the number of threads
+            ::glMaxShaderCompilerThreadsKHR(0xffffffffu);
+        }
+
+        if (_binary_dir)
+        {
+            auto error = std::error_code{};
+            std::filesystem::create_directories(*_binary_dir, error);
+            if (error)
+            {
+                log::warn("could not create program binary directory {}: {}", _binary_dir->string(), error.message());
+                _binary_dir.reset();
+            }
+        }
+
+        log::info("program cache: parallel compile {}, binaries {}", _parallel_compile, _binary_dir ? _binary_dir->string() : "off");
+    }
+
+    auto ProgramCache::get(std::string_view vertex_source, std::string_view fragment_source) -> const Program *
+    {
+        const auto key = hash({vertex_source, fragment_source});
+        if (const auto program = _programs.find(key); program != std::ranges::end(_programs))
+        {
+            return program->second.get();
+        }
+
+        auto binary_path = std::optional<std::filesystem::path>{};
+        if (_binary_dir)
+        {
+            binary_path = *_binary_dir / std::format("{:016x}_{:016x}.bin", key, _driver_hash);
+        }
+
+        if (binary_path && std::filesystem::exists(*binary_path))
+        {
+            if (auto handle = load_binary(*binary_path); handle)
+            {
+                auto program = std::unique_ptr<Program>{new Program{std::move(handle), false, 0u, 0u, std::nullopt}};
+                return _programs.emplace(key, std::move(program)).first->second.get();
+            }
+        }
+
+        auto handle = AutoRelease<::GLuint>{::glCreateProgram(), ::glDeleteProgram};
+        ensure(handle, "failed ot create opengl program");
+
+        const auto vertex_shader = compile(vertex_source, GL_VERTEX_SHADER);
+        const auto fragment_shader = compile(fragment_source, GL_FRAGMENT_SHADER);
+
+        if (binary_path)
+        {
+            ::glProgramParameteri(handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+
+        ::glAttachShader(handle, vertex_shader);
+        ::glAttachShader(handle, fragment_shader);
+        ::glLinkProgram(handle);
+
+        auto program = std::unique_ptr<Program>{new Program{std::move(handle), _parallel_compile, vertex_shader, fragment_shader, binary_path}};
+        return _programs.emplace(key, std::move(program)).first->second.get();
+    }
+
+    auto ProgramCache::get(const TlvReader &reader, std::string_view vertex_name, std::string_view fragment_name) -> const Program *
+    {
+        const auto vertex_file = TlvReader::get_text_file(reader, vertex_name);
+        const auto fragment_file = TlvReader::get_text_file(reader, fragment_name);
+
+        return get(vertex_file.data, fragment_file.data);
+    }
+
+    auto ProgramCache::is_ready() const -> bool
+    {
+        return std::ranges::all_of(_programs | std::views::values, [](const auto &program)
+                                   { return program->is_ready(); });
+    }
+
+    auto ProgramCache::resolve() -> void
+    {
+        for (auto &program : _programs | std::views::values)
+        {
+            program->resolve();
+
+            if (program->_binary_path)
+            {
+                save_binary(program->_handle, *program->_binary_path);
+                program->_binary_path.reset();
+            }
+        }
+    }
+
+    auto ProgramCache::compile(std::string_view source, ::GLenum type) -> ::GLuint
+    {
+        // programs sharing a shader share its compile too
+        const auto key = hash({std::to_string(type), source});
+        if (const auto shader = _shaders.find(key); shader != std::ranges::end(_shaders))
+        {
+            return shader->second;
+        }
+
+        auto shader = AutoRelease<::GLuint>{::glCreateShader(type), ::glDeleteShader};
+
+        const ::GLchar *strings[] = {source.data()};
+        const ::GLint lengths[] = {static_cast<::GLint>(source.length())};
+
+        // the compile status is not checked here, that would wait for the compile, a failure shows in the link log
+        ::glShaderSource(shader, 1, strings, lengths);
+        ::glCompileShader(shader);
+
+        return _shaders.emplace(key, std::move(shader)).first->second;
+    }
+
+    auto ProgramCache::load_binary(const std::filesystem::path &path) const -> AutoRelease<::GLuint>
+    {
+        try
+        {
+            const auto file = File{path};
+            const auto bytes = file.as_bytes();
+            ensure(bytes.size() > sizeof(::GLenum), "program binary {} is truncated", path.string());
+
+            auto format = ::GLenum{};
+            std::memcpy(&format, bytes.data(), sizeof(::GLenum));
+
+            auto handle = AutoRelease<::GLuint>{::glCreateProgram(), ::glDeleteProgram};
+            ::glProgramBinary(handle, format, bytes.data() + sizeof(::GLenum), static_cast<::GLsizei>(bytes.size() - sizeof(::GLenum)));
+
+            // a binary is used as is, there is nothing to wait for
+            auto result = ::GLint{};
+            ::glGetProgramiv(handle, GL_LINK_STATUS, &result);
+            if (result == GL_TRUE)
+            {
+                return handle;
+            }
+
+            log::info("driver rejected program binary {}, compiling", path.string());
+        }
+        catch (const Exception &err)
+        {
+            log::warn("could not load program binary: {}", err);
+        }
+
+        return {};
+    }
+}
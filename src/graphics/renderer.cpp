@@ -1,5 +1,7 @@
 #include "graphics/renderer.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <ranges>
 
@@ -11,16 +13,24 @@
 #include "graphics/material.h"
 #include "graphics/mesh.h"
 #include "graphics/opengl.h"
+#include "graphics/program_cache.h"
 #include "graphics/scene.h"
 #include "graphics/texture.h"
 #include "graphics/texture_sampler.h"
 #include "loaders/mesh_loader.h"
+#include "math/matrix3.h"
+#include "math/matrix3x4.h"
+#include "math/transform_batch.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
 #include "primitives/entity.h"
 #include "tlv/tlv_reader.h"
 #include "utils/ensure.h"
 
 namespace
 {
+    // coarser levels of detail are used as long as their error stays below a pixel
+    constexpr auto max_lod_pixel_error = 1.f;
 
 #if defined(_MSC_VER)
 // disable weird warning about alingas in MSVC
@@ -46,16 +56,9 @@ namespace
 #pragma warning(pop)
 #endif
 
-    auto create_material(const game::TlvReader &reader, std::string_view vert_name, std::string_view frag_name) -> game::Material
+    auto create_material(game::ProgramCache &program_cache, const game::TlvReader &reader, std::string_view vert_name, std::string_view frag_name) -> game::Material
     {
-        const auto vert_file = game::TlvReader::get_text_file(reader, vert_name);
-        const auto vert_data = vert_file.data;
-        const auto vertex_shader = game::Shader{vert_data, game::ShaderType::VERTEX};
-
-        const auto frag_file = game::TlvReader::get_text_file(reader, frag_name);
-        const auto frag_data = frag_file.data;
-        const auto fragment_shader = game::Shader{frag_data, game::ShaderType::FRAGMENT};
-        return game::Material{vertex_shader, fragment_shader};
+        return game::Material{program_cache.get(reader, vert_name, frag_name)};
     }
 
     auto generate_textures(std::size_t n, game::TextureUsage usage, std::uint32_t width, std::uint32_t height, std::uint8_t sample_count) -> std::vector<game::Texture>
@@ -70,13 +73,13 @@ namespace
 
     auto model_matrix_for_label(std::uint32_t x, std::uint32_t y, std::uint32_t width, std::uint32_t height, std::uint32_t offset = 5)
     {
-        return game::Matrix4{
+        return game::Matrix3x4{game::Matrix4{
             game::Vector3{static_cast<float>(x) + (width / 2.f) + offset,
                           -static_cast<float>(y) - (height / 2.f),
                           0.0f},
             game::Vector3{static_cast<float>(width) / 2.f,
                           static_cast<float>(height) / 2.f,
-                          1.0f}};
+                          1.0f}}};
     }
 
     auto blit_all(const game::FrameBuffer &src, ::GLenum src_attachment, const game::FrameBuffer &dst, ::GLenum dst_attachment, ::GLbitfield mask = GL_COLOR_BUFFER_BIT) -> void
@@ -130,7 +133,7 @@ namespace
         {
             material_callback(material);
         }
-        ::glDrawElements(GL_TRIANGLES, sprite.index_count(), GL_UNSIGNED_INT, reinterpret_cast<void *>(sprite.index_offset()));
+        ::glDrawElements(GL_TRIANGLES, sprite.index_count(), sprite.index_type(), reinterpret_cast<void *>(sprite.index_offset()));
 
         std::ranges::swap(read_fb, write_fb);
     }
@@ -141,17 +144,27 @@ namespace
         writer.write(camera.view());
         writer.write(camera.projection());
         writer.write(camera.position());
+
+        // std140 starts the mat3 on the next 16 bytes and pads each of its columns to a vec4
+        writer.write(0.f);
+
+        const auto view_normal = game::Matrix3::inverse_transpose(game::Matrix3{game::Matrix4{camera.view()}});
+        const auto columns = view_normal.data();
+        const float view_normal_std140[] = {columns[0], columns[1], columns[2], 0.f,
+                                            columns[3], columns[4], columns[5], 0.f,
+                                            columns[6], columns[7], columns[8], 0.f};
+        writer.write(view_normal_std140);
     }
 }
 
 namespace game
 {
-    Renderer::Renderer(const TlvReader &reader, MeshLoader &mesh_loader, std::uint32_t width, std::uint32_t height, std::uint8_t samples)
-        : _camera_buffer(sizeof(Matrix4) * 2u + sizeof(Vector3)),
+    Renderer::Renderer(ProgramCache &program_cache, const TlvReader &reader, MeshLoader &mesh_loader, std::uint32_t width, std::uint32_t height, std::uint8_t samples)
+        : _camera_buffer(sizeof(Matrix4) * 2u + sizeof(Vector4) + sizeof(float) * 12u),
           _light_buffer(10240u),
           _skybox_cube(mesh_loader.cube()),
-          _skybox_material(create_material(reader, "cube.vert", "cube.frag")),
-          _debug_line_material(create_material(reader, "line.vert", "line.frag")),
+          _skybox_material(create_material(program_cache, reader, "cube.vert", "cube.frag")),
+          _debug_line_material(create_material(program_cache, reader, "line.vert", "line.frag")),
           _main_framebuffer{generate_textures(3uz, TextureUsage::FRAMEBUFFER, width, height, samples),
                             {TextureUsage::DEPTH, width, height, samples}},
           _ssao_framebuffer{generate_textures(3uz, TextureUsage::FRAMEBUFFER, width, height, 1),
@@ -161,13 +174,15 @@ namespace game
           _post_processing_framebuffer_2{generate_textures(1zu, TextureUsage::FRAMEBUFFER, width, height, 1),
                                          {TextureUsage::DEPTH, width, height, 1}},
           _sprite{mesh_loader.sprite()},
-          _hdr_material{create_material(reader, "hdr.vert", "hdr.frag")},
-          _grey_scale_material{create_material(reader, "grey_scale.vert", "grey_scale.frag")},
-          _label_material{create_material(reader, "label.vert", "label.frag")},
-          _blur_material{create_material(reader, "blur.vert", "blur.frag")},
-          _ssao_material{create_material(reader, "ssao.vert", "ssao.frag")},
-          _ssao_apply_material{create_material(reader, "ssao.vert", "ssao_apply.frag")},
-          _orth_camera{static_cast<float>(width), static_cast<float>(height), 1000.f}
+          _hdr_material{create_material(program_cache, reader, "hdr.vert", "hdr.frag")},
+          _grey_scale_material{create_material(program_cache, reader, "grey_scale.vert", "grey_scale.frag")},
+          _label_material{create_material(program_cache, reader, "label.vert", "label.frag")},
+          _blur_material{create_material(program_cache, reader, "blur.vert", "blur.frag")},
+          _ssao_material{create_material(program_cache, reader, "ssao.vert", "ssao.frag")},
+          _ssao_apply_material{create_material(program_cache, reader, "ssao.vert", "ssao_apply.frag")},
+          _orth_camera{static_cast<float>(width), static_cast<float>(height), 1000.f},
+          _transforms{},
+          _models{}
     {
         _orth_camera.set_position({width / 2.f, height / -2.f, 0.f});
         _orth_camera.update();
@@ -202,21 +217,53 @@ namespace game
 
         ::glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _light_buffer.native_handle());
 
+        // pixels covered by one world unit at a distance of one unit, used to turn lod errors into screen space
+        const auto pixels_per_unit = camera.height() / (2.f * std::tan(camera.fov() / 2.f));
+
+        // all model matrices are composed up front in one batch
+        _transforms.clear();
+        for (const auto *entity : scene.entities)
+        {
+            _transforms.add(entity->transform());
+        }
+        _models.resize(scene.entities.size());
+        _transforms.compose(_models);
+
         // for (const auto *entity : scene.entities | std::views::filter([](const auto *e)
         //                                                               { return e->is_visible(); }))
-        for (const auto *entity : scene.entities)
+        for (const auto &[index, entity] : scene.entities | std::views::enumerate)
         {
             const auto *mesh = entity->mesh();
             const auto *material = entity->material();
 
             material->use();
-            const auto model = Matrix4{entity->transform()};
-            material->set_uniform("model", model);
+            const auto &uniforms = material->draw_uniforms();
+            const auto &model = _models[index];
+            material->set_uniform(uniforms.model, model);
+            material->set_uniform(uniforms.normal_matrix, Matrix3::inverse_transpose(Matrix3{model}));
+
+            // uniforms are program state, so they have to be reset for full precision meshes sharing the material,
+            // entities made sure on creation that a compact mesh has a material that can draw it
+            if (uniforms.compact_vertices != -1)
+            {
+                const auto quantization = mesh->quantization();
+                material->set_uniform(uniforms.compact_vertices, static_cast<std::int32_t>(mesh->is_compact()));
+                material->set_uniform(uniforms.position_scale, quantization.scale);
+                material->set_uniform(uniforms.position_bias, quantization.bias);
+            }
+
             material->invoke_uniform_callback(entity);
             material->bind_textures(entity->textures());
 
+            const auto &transform = entity->transform();
+            const auto scale = std::max({std::abs(transform.scale.x), std::abs(transform.scale.y), std::abs(transform.scale.z)});
+            const auto &bounds = mesh->bounds();
+            const auto center = model.transform_point(bounds.center);
+            const auto distance = std::max(Vector3::distance(camera.position(), center) - bounds.radius * scale, camera.near_plane());
+            const auto lod = mesh->select_lod(pixels_per_unit * scale / distance, max_lod_pixel_error);
+
             mesh->bind();
-            ::glDrawElements(GL_TRIANGLES, mesh->index_count(), GL_UNSIGNED_INT, reinterpret_cast<void *>(mesh->index_offset()));
+            ::glDrawElements(GL_TRIANGLES, mesh->index_count(lod), mesh->index_type(), reinterpret_cast<void *>(mesh->index_offset(lod)));
         }
 
         if (scene.skybox)
@@ -229,7 +276,7 @@ namespace game
             _skybox_material.use();
             _skybox_material.bind_cube_map(scene.skybox, scene.skybox_sampler);
 
-            ::glDrawElements(GL_TRIANGLES, _skybox_cube.index_count(), GL_UNSIGNED_INT, reinterpret_cast<void *>(_skybox_cube.index_offset()));
+            ::glDrawElements(GL_TRIANGLES, _skybox_cube.index_count(), _skybox_cube.index_type(), reinterpret_cast<void *>(_skybox_cube.index_offset()));
 
             ::glDepthFunc(GL_LESS);
             ::glEnable(GL_CULL_FACE);
@@ -266,7 +313,7 @@ namespace game
             _ssao_material.set_uniform("width", static_cast<float>(_ssao_framebuffer.frame_buffer.width()));
             _ssao_material.set_uniform("height", static_cast<float>(_ssao_framebuffer.frame_buffer.height()));
 
-            ::glDrawElements(GL_TRIANGLES, _sprite.index_count(), GL_UNSIGNED_INT, reinterpret_cast<void *>(_sprite.index_offset()));
+            ::glDrawElements(GL_TRIANGLES, _sprite.index_count(), _sprite.index_type(), reinterpret_cast<void *>(_sprite.index_offset()));
 
             std::ranges::swap(read_fb, write_fb);
 
@@ -276,7 +323,7 @@ namespace game
             _ssao_apply_material.bind_texture(0, &_ssao_framebuffer.color_textures[0], scene.skybox_sampler);
             _ssao_apply_material.bind_texture(1, read_fb->color_textures().front(), scene.skybox_sampler);
 
-            ::glDrawElements(GL_TRIANGLES, _sprite.index_count(), GL_UNSIGNED_INT, reinterpret_cast<void *>(_sprite.index_offset()));
+            ::glDrawElements(GL_TRIANGLES, _sprite.index_count(), _sprite.index_type(), reinterpret_cast<void *>(_sprite.index_offset()));
 
             std::ranges::swap(read_fb, write_fb);
         }
@@ -327,7 +374,7 @@ namespace game
 
                 _label_material.bind_texture(0, texture, scene.skybox_sampler);
 
-                ::glDrawElements(GL_TRIANGLES, _sprite.index_count(), GL_UNSIGNED_INT, reinterpret_cast<void *>(_sprite.index_offset()));
+                ::glDrawElements(GL_TRIANGLES, _sprite.index_count(), _sprite.index_type(), reinterpret_cast<void *>(_sprite.index_offset()));
             }
             ::glDisable(GL_BLEND);
         }
@@ -1,17 +1,24 @@
 #include "graphics/texture.h"
 
 #include <algorithm>
+#include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <format>
 #include <memory>
 #include <optional>
 #include <ranges>
 #include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
 
+#include "game/settings.h"
 #include "graphics/opengl.h"
 #include "log.h"
+#include "tlv/tlv_entry.h"
 #include "tlv/tlv_reader.h"
+#include "utils/auto_release.h"
 #include "utils/ensure.h"
 #include "utils/formatter.h"
 
@@ -67,6 +74,27 @@ namespace
         }
     }
 
+    auto get_compressed_format(game::TextureFormat format, game::TextureUsage usage) -> ::GLenum
+    {
+        const auto srgb = usage == game::TextureUsage::SRGB;
+
+        switch (format)
+        {
+            using enum game::TextureFormat;
+        case BC1:
+            return srgb ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case BC3:
+            return srgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case BC5:
+            return GL_COMPRESSED_RG_RGTC2;
+        case BC7:
+            return srgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+        default:
+            game::ensure(false, "unhandled compressed format {}", format);
+            return 0u;
+        }
+    }
+
     auto num_channels_from_format(game::TextureFormat format) -> std::int32_t
     {
         switch (format)
@@ -93,16 +121,52 @@ namespace game
                   { ::glDeleteTextures(1u, &texture); }},
           _sampler(sampler),
           _width{data.width},
-          _height{data.height}
+          _height{data.height},
+          _memory_size{}
     {
         log::info("creating texture with: {}", data);
 
         ::glCreateTextures(GL_TEXTURE_2D, 1u, &_handle);
 
+        ensure(data.mip_levels > 0u, "texture must have at least one mip level");
+
+        if (is_block_compressed(data.format))
+        {
+            // compressed textures cannot have their mips generated on the gpu, so the packer provides all of them
+            const auto internal_format = get_compressed_format(data.format, data.usage);
+            ::glTextureStorage2D(_handle, data.mip_levels, internal_format, data.width, data.height);
+
+            auto offset = std::size_t{};
+            for (auto level = 0u; level < data.mip_levels; ++level)
+            {
+                const auto level_width = std::max(data.width >> level, 1u);
+                const auto level_height = std::max(data.height >> level, 1u);
+                const auto level_size = mip_level_size(data.format, level_width, level_height);
+
+                ensure(offset + level_size <= data.data.size(), "texture data too small for mip level {}", level);
+
+                ::glCompressedTextureSubImage2D(
+                    _handle,
+                    level,
+                    0,
+                    0,
+                    level_width,
+                    level_height,
+                    internal_format,
+                    static_cast<::GLsizei>(level_size),
+                    data.data.data() + offset);
+
+                offset += level_size;
+            }
+
+            _memory_size = offset;
+            return;
+        }
+
         auto num_channels = num_channels_from_format(data.format);
 
-        ::GLsizei levels = 1;
-        if (data.usage == TextureUsage::SRGB)
+        ::GLsizei levels = static_cast<::GLsizei>(data.mip_levels);
+        if (data.usage == TextureUsage::SRGB && data.mip_levels == 1u)
         {
             levels += static_cast<::GLsizei>(std::floor(std::log(std::max(data.width, data.height))));
         }
@@ -113,26 +177,41 @@ namespace game
             get_storage_format(data.usage, num_channels),
             data.width,
             data.height);
-        ::glTextureSubImage2D(_handle, 0, 0, 0, data.width, data.height, get_sub_image_format(num_channels), GL_UNSIGNED_BYTE, data.data.data());
-        if (data.usage == TextureUsage::SRGB)
+
+        // rows are tightly packed, which matters for RGB and R data and for the small mip levels, the previous
+        // alignment is restored once the upload is done (or has thrown)
+        auto previous_alignment = ::GLint{};
+        ::glGetIntegerv(GL_UNPACK_ALIGNMENT, &previous_alignment);
+        const auto restore_alignment = AutoRelease<::GLint>{previous_alignment, [](auto alignment)
+                                                            { ::glPixelStorei(GL_UNPACK_ALIGNMENT, alignment); }};
+        ::glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        auto offset = std::size_t{};
+        for (auto level = 0u; level < data.mip_levels; ++level)
+        {
+            const auto level_width = std::max(data.width >> level, 1u);
+            const auto level_height = std::max(data.height >> level, 1u);
+
+            ensure(offset + mip_level_size(data.format, level_width, level_height) <= data.data.size(), "texture data too small for mip level {}", level);
+
+            ::glTextureSubImage2D(_handle, level, 0, 0, level_width, level_height, get_sub_image_format(num_channels), GL_UNSIGNED_BYTE, data.data.data() + offset);
+            offset += mip_level_size(data.format, level_width, level_height);
+        }
+
+        if (data.usage == TextureUsage::SRGB && data.mip_levels == 1u)
         {
             ::glGenerateTextureMipmap(_handle);
         }
+
+        for (auto level = 0u; level < static_cast<std::uint32_t>(levels); ++level)
+        {
+            _memory_size += mip_level_size(data.format, std::max(data.width >> level, 1u), std::max(data.height >> level, 1u));
+        }
     }
 
     Texture::Texture(const TlvReader &reader, std::string_view name, const TextureSampler *sampler)
-        : _handle{0u, [](auto texture)
-                  { ::glDeleteTextures(1u, &texture); }},
-          _sampler(sampler)
-
+        : Texture{find_texture_description(reader, name), sampler}
     {
-        const auto data = std::ranges::find_if(reader, [name](const auto &e)
-                                               { return e.is_texture(name); });
-        ensure(data != std::ranges::end(reader), "failed to load texture '{}'", name);
-
-        auto tex = Texture{(*data).texture_description_value(), _sampler};
-
-        std::ranges::swap(_handle, tex._handle);
     }
 
     Texture::Texture(TextureUsage usage, std::uint32_t width, std::uint32_t height, std::uint8_t samples)
@@ -140,10 +219,15 @@ namespace game
                   { ::glDeleteTextures(1u, &texture); }},
           _sampler(nullptr),
           _width{width},
-          _height{height}
+          _height{height},
+          _memory_size{}
     {
         expect(samples > 0, "cannot have 0 samples");
 
+        // RGB16F is padded to four channels by the drivers, DEPTH_COMPONENT24 to 32 bits
+        const auto texel_size = usage == TextureUsage::FRAMEBUFFER ? 8u : 4u;
+        _memory_size = static_cast<std::size_t>(width) * height * texel_size * samples;
+
         switch (usage)
         {
             using enum TextureUsage;
@@ -199,6 +283,90 @@ namespace game
         return _height;
     }
 
+    auto Texture::memory_size() const -> std::size_t
+    {
+        return _memory_size;
+    }
+
+    auto is_block_compressed(TextureFormat format) -> bool
+    {
+        switch (format)
+        {
+            using enum TextureFormat;
+        case BC1:
+        case BC3:
+        case BC5:
+        case BC7:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    auto mip_level_size(TextureFormat format, std::uint32_t width, std::uint32_t height) -> std::size_t
+    {
+        const auto blocks = static_cast<std::size_t>((width + 3u) / 4u) * ((height + 3u) / 4u);
+
+        switch (format)
+        {
+            using enum TextureFormat;
+        case BC1:
+            return blocks * 8u;
+        case BC3:
+        case BC5:
+        case BC7:
+            return blocks * 16u;
+        default:
+            return static_cast<std::size_t>(width) * height * static_cast<std::size_t>(num_channels_from_format(format));
+        }
+    }
+
+    auto find_texture_description(const TlvReader &reader, std::string_view name) -> TextureDescription
+    {
+        // at tier 0 the tier name is the name, so the first match ends the scan
+        const auto tier_name = texture_tier_name(name, Settings::instance().texture_tier());
+        auto data = std::optional<TlvEntry>{};
+
+        for (const auto &entry : reader)
+        {
+            if (entry.is_texture(tier_name))
+            {
+                data = entry;
+                break;
+            }
+
+            // textures too small to have lower tiers fall back to full resolution
+            if (!data && entry.is_texture(name))
+            {
+                data = entry;
+            }
+        }
+        ensure(data.has_value(), "failed to load texture '{}'", name);
+
+        return data->texture_description_value();
+    }
+
+    auto texture_tier_name(std::string_view name, std::uint32_t tier) -> std::string
+    {
+        return tier == 0u ? std::string{name} : std::format("{}@{}", name, tier);
+    }
+
+    auto is_texture_tier(std::string_view name) -> bool
+    {
+        // exactly what texture_tier_name appends, other names may contain an '@' of their own
+        const auto separator = name.rfind('@');
+        if (separator == std::string_view::npos)
+        {
+            return false;
+        }
+
+        const auto suffix = name.substr(separator + 1u);
+        auto tier = std::uint32_t{};
+        const auto [end, error] = std::from_chars(suffix.data(), suffix.data() + suffix.size(), tier);
+
+        return error == std::errc{} && end == suffix.data() + suffix.size() && suffix.front() != '0' && tier < texture_tier_count;
+    }
+
     auto to_string(TextureUsage obj) -> std::string
     {
         switch (obj)
@@ -228,6 +396,14 @@ namespace game
             return "RGB";
         case RGBA:
             return "RGBA";
+        case BC1:
+            return "BC1";
+        case BC3:
+            return "BC3";
+        case BC5:
+            return "BC5";
+        case BC7:
+            return "BC7";
         default:
             return std::format("{}", std::to_underlying(obj));
         }
@@ -235,11 +411,12 @@ namespace game
 
     auto to_string(const TextureDescription &obj) -> std::string
     {
-        return std::format("width={} height={} format={} usage={} data={}",
+        return std::format("width={} height={} format={} usage={} mip_levels={} data={}",
                            obj.width,
                            obj.height,
                            obj.format,
                            obj.usage,
+                           obj.mip_levels,
                            obj.data.size());
     }
 
@@ -0,0 +1,107 @@
+#include "graphics/texture_streamer.h"
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+
+#include "graphics/texture.h"
+#include "log.h"
+#include "resources/async_resource_loader.h"
+#include "resources/resource_cache.h"
+#include "resources/resource_store.h"
+#include "tlv/tlv_reader.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto placeholder_description() -> game::TextureDescription
+    {
+        return {
+            .name = "placeholder",
+            .format = game::TextureFormat::RGB,
+            .usage = game::TextureUsage::SRGB,
+            .width = 1u,
+            .height = 1u,
+            .data = {static_cast<std::byte>(0xff), static_cast<std::byte>(0xff), static_cast<std::byte>(0xff)}};
+    }
+}
+
+namespace game
+{
+    TextureStreamer::TextureStreamer(DefaultCache &cache, AsyncResourceLoader &loader, std::chrono::microseconds upload_budget)
+        : _cache{cache},
+          _loader{loader},
+          _upload_budget{upload_budget},
+          _pending{}
+    {
+    }
+
+    TextureStreamer::~TextureStreamer()
+    {
+        // decodes still reference packs and their results
+        wait_for_decodes();
+    }
+
+    auto TextureStreamer::insert_async(const TlvReader &reader, std::string_view name, const TextureSampler *sampler) -> ResourceRef<Texture>
+    {
+        auto texture = _cache.insert_evictable<Texture>(name, placeholder_description(), sampler);
+
+        auto description = _loader.submit<TextureDescription>(name, [&reader, name = std::string{name}]
+                                                              { return std::make_unique<TextureDescription>(find_texture_description(reader, name)); });
+
+        _pending.push_back({texture, sampler, std::move(description)});
+
+        return texture;
+    }
+
+    auto TextureStreamer::upload() -> std::size_t
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto uploaded = std::size_t{};
+
+        for (auto iter = std::ranges::begin(_pending); iter != std::ranges::end(_pending);)
+        {
+            if (uploaded > 0u && std::chrono::steady_clock::now() - start >= _upload_budget)
+            {
+                break;
+            }
+
+            if (!iter->description.is_ready())
+            {
+                ++iter;
+                continue;
+            }
+
+            try
+            {
+                _cache.replace(iter->texture.handle(), *iter->description.get(), iter->sampler);
+            }
+            catch (const Exception &err)
+            {
+                // the placeholder stays
+                log::error("could not stream texture {}: {}", iter->description.name(), err);
+            }
+
+            iter = _pending.erase(iter);
+            ++uploaded;
+        }
+
+        return uploaded;
+    }
+
+    auto TextureStreamer::wait_for_decodes() const -> void
+    {
+        for (const auto &pending : _pending)
+        {
+            pending.description.wait();
+        }
+    }
+
+    auto TextureStreamer::pending() const -> std::size_t
+    {
+        return _pending.size();
+    }
+}
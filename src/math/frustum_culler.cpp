@@ -0,0 +1,147 @@
+#include "math/frustum_culler.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "math/frustum_plane.h"
+#include "math/simd.h"
+#include "math/vector3.h"
+
+namespace game
+{
+    auto BoundsBatch::add(const Vector3 &center, const Vector3 &extents) -> void
+    {
+        _center_x.push_back(center.x);
+        _center_y.push_back(center.y);
+        _center_z.push_back(center.z);
+        _extents_x.push_back(extents.x);
+        _extents_y.push_back(extents.y);
+        _extents_z.push_back(extents.z);
+    }
+
+    auto BoundsBatch::clear() -> void
+    {
+        _center_x.clear();
+        _center_y.clear();
+        _center_z.clear();
+        _extents_x.clear();
+        _extents_y.clear();
+        _extents_z.clear();
+    }
+
+    auto BoundsBatch::size() const -> std::size_t
+    {
+        return _center_x.size();
+    }
+
+    FrustumCuller::FrustumCuller(const std::array<FrustumPlane, 6u> &planes)
+        : _planes{}
+    {
+        for (auto i = 0u; i < planes.size(); ++i)
+        {
+            const auto &normal = planes[i].normal;
+            _planes[i] = {
+                .normal_x = normal.x,
+                .normal_y = normal.y,
+                .normal_z = normal.z,
+                .distance = planes[i].distance,
+                .abs_x = std::abs(normal.x),
+                .abs_y = std::abs(normal.y),
+                .abs_z = std::abs(normal.z)};
+        }
+    }
+
+    auto FrustumCuller::cull(const BoundsBatch &bounds, std::vector<std::uint64_t> &visible) const -> void
+    {
+        const auto count = bounds.size();
+        visible.assign((count + 63u) / 64u, 0u);
+
+        // the distance of the box corner furthest along the normal is the distance of the center plus the extents
+        // projected onto the normal, the box is outside if even that corner is behind the plane
+        auto i = 0zu;
+
+#if defined(GAME_SIMD_AVX)
+        const auto zero8 = _mm256_setzero_ps();
+
+        for (; i + 8u <= count; i += 8u)
+        {
+            const auto cx = _mm256_loadu_ps(bounds._center_x.data() + i);
+            const auto cy = _mm256_loadu_ps(bounds._center_y.data() + i);
+            const auto cz = _mm256_loadu_ps(bounds._center_z.data() + i);
+            const auto ex = _mm256_loadu_ps(bounds._extents_x.data() + i);
+            const auto ey = _mm256_loadu_ps(bounds._extents_y.data() + i);
+            const auto ez = _mm256_loadu_ps(bounds._extents_z.data() + i);
+
+            auto outside = 0u;
+            for (const auto &plane : _planes)
+            {
+                auto distance = simd::madd(_mm256_set1_ps(plane.normal_x), cx, _mm256_set1_ps(plane.distance));
+                distance = simd::madd(_mm256_set1_ps(plane.normal_y), cy, distance);
+                distance = simd::madd(_mm256_set1_ps(plane.normal_z), cz, distance);
+                distance = simd::madd(_mm256_set1_ps(plane.abs_x), ex, distance);
+                distance = simd::madd(_mm256_set1_ps(plane.abs_y), ey, distance);
+                distance = simd::madd(_mm256_set1_ps(plane.abs_z), ez, distance);
+
+                outside |= static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(distance, zero8, _CMP_LT_OQ)));
+            }
+
+            // i is a multiple of 8, so the bits never cross a word
+            visible[i / 64u] |= std::uint64_t{~outside & 0xffu} << (i % 64u);
+        }
+#endif
+
+#if defined(GAME_SIMD_FLOAT4)
+        const auto zero = simd::splat(0.f);
+
+        for (; i + 4u <= count; i += 4u)
+        {
+            const auto cx = simd::load(bounds._center_x.data() + i);
+            const auto cy = simd::load(bounds._center_y.data() + i);
+            const auto cz = simd::load(bounds._center_z.data() + i);
+            const auto ex = simd::load(bounds._extents_x.data() + i);
+            const auto ey = simd::load(bounds._extents_y.data() + i);
+            const auto ez = simd::load(bounds._extents_z.data() + i);
+
+            auto outside = 0u;
+            for (const auto &plane : _planes)
+            {
+                auto distance = simd::madd(simd::splat(plane.normal_x), cx, simd::splat(plane.distance));
+                distance = simd::madd(simd::splat(plane.normal_y), cy, distance);
+                distance = simd::madd(simd::splat(plane.normal_z), cz, distance);
+                distance = simd::madd(simd::splat(plane.abs_x), ex, distance);
+                distance = simd::madd(simd::splat(plane.abs_y), ey, distance);
+                distance = simd::madd(simd::splat(plane.abs_z), ez, distance);
+
+                outside |= simd::less_mask(distance, zero);
+            }
+
+            visible[i / 64u] |= std::uint64_t{~outside & 0xfu} << (i % 64u);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            auto is_outside = false;
+            for (const auto &plane : _planes)
+            {
+                const auto distance = plane.normal_x * bounds._center_x[i] + plane.normal_y * bounds._center_y[i] + plane.normal_z * bounds._center_z[i] + plane.distance +
+                                      plane.abs_x * bounds._extents_x[i] + plane.abs_y * bounds._extents_y[i] + plane.abs_z * bounds._extents_z[i];
+                is_outside |= distance < 0.f;
+            }
+
+            if (!is_outside)
+            {
+                visible[i / 64u] |= std::uint64_t{1u} << (i % 64u);
+            }
+        }
+    }
+
+    auto FrustumCuller::is_visible(std::span<const std::uint64_t> visible, std::size_t index) -> bool
+    {
+        return (visible[index / 64u] >> (index % 64u) & 1u) != 0u;
+    }
+}
@@ -0,0 +1,151 @@
+#include "math/transform_batch.h"
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+#include "math/matrix3x4.h"
+#include "math/matrix4.h"
+#include "math/quaternion.h"
+#include "math/simd.h"
+#include "math/transform.h"
+#include "math/vector3.h"
+#include "utils/ensure.h"
+
+namespace game
+{
+    auto TransformBatch::add(const Transform &transform) -> void
+    {
+        _position_x.push_back(transform.position.x);
+        _position_y.push_back(transform.position.y);
+        _position_z.push_back(transform.position.z);
+        _rotation_x.push_back(transform.rotation.x);
+        _rotation_y.push_back(transform.rotation.y);
+        _rotation_z.push_back(transform.rotation.z);
+        _rotation_w.push_back(transform.rotation.w);
+        _scale_x.push_back(transform.scale.x);
+        _scale_y.push_back(transform.scale.y);
+        _scale_z.push_back(transform.scale.z);
+    }
+
+    auto TransformBatch::clear() -> void
+    {
+        _position_x.clear();
+        _position_y.clear();
+        _position_z.clear();
+        _rotation_x.clear();
+        _rotation_y.clear();
+        _rotation_z.clear();
+        _rotation_w.clear();
+        _scale_x.clear();
+        _scale_y.clear();
+        _scale_z.clear();
+    }
+
+    auto TransformBatch::size() const -> std::size_t
+    {
+        return _position_x.size();
+    }
+
+    auto TransformBatch::compose(std::span<Matrix4> models) const -> void
+    {
+        compose_into(models);
+    }
+
+    auto TransformBatch::compose(std::span<Matrix3x4> models) const -> void
+    {
+        compose_into(models);
+    }
+
+    template <class M>
+    auto TransformBatch::compose_into(std::span<M> models) const -> void
+    {
+        expect(models.size() >= size(), "need space for {} matrices, got {}", size(), models.size());
+
+        auto i = 0zu;
+
+#if defined(GAME_SIMD_FLOAT4)
+        // four transforms per iteration, each register holds one element of four matrices
+        const auto one = simd::splat(1.f);
+        const auto zero = simd::splat(0.f);
+
+        for (; i + 4u <= size(); i += 4u)
+        {
+            const auto x = simd::load(_rotation_x.data() + i);
+            const auto y = simd::load(_rotation_y.data() + i);
+            const auto z = simd::load(_rotation_z.data() + i);
+            const auto w = simd::load(_rotation_w.data() + i);
+
+            const auto tx = simd::add(x, x);
+            const auto ty = simd::add(y, y);
+            const auto tz = simd::add(z, z);
+
+            const auto xx = simd::mul(tx, x);
+            const auto yy = simd::mul(ty, y);
+            const auto zz = simd::mul(tz, z);
+            const auto xy = simd::mul(tx, y);
+            const auto xz = simd::mul(tx, z);
+            const auto xw = simd::mul(tx, w);
+            const auto yz = simd::mul(ty, z);
+            const auto yw = simd::mul(ty, w);
+            const auto zw = simd::mul(tz, w);
+
+            const auto sx = simd::load(_scale_x.data() + i);
+            const auto sy = simd::load(_scale_y.data() + i);
+            const auto sz = simd::load(_scale_z.data() + i);
+
+            simd::float4 columns[4][4] = {
+                {simd::mul(simd::sub(simd::sub(one, yy), zz), sx),
+                 simd::mul(simd::add(xy, zw), sx),
+                 simd::mul(simd::sub(xz, yw), sx),
+                 zero},
+                {simd::mul(simd::sub(xy, zw), sy),
+                 simd::mul(simd::sub(simd::sub(one, zz), xx), sy),
+                 simd::mul(simd::add(yz, xw), sy),
+                 zero},
+                {simd::mul(simd::add(xz, yw), sz),
+                 simd::mul(simd::sub(yz, xw), sz),
+                 simd::mul(simd::sub(simd::sub(one, xx), yy), sz),
+                 zero},
+                {simd::load(_position_x.data() + i),
+                 simd::load(_position_y.data() + i),
+                 simd::load(_position_z.data() + i),
+                 one}};
+
+            if constexpr (std::is_same_v<M, Matrix4>)
+            {
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    // afterwards columns[c][n] is column c of the matrix of transform i + n
+                    simd::transpose(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+                    for (auto n = 0u; n < 4u; ++n)
+                    {
+                        simd::store(models[i + n].data().data() + c * 4u, columns[c][n]);
+                    }
+                }
+            }
+            else
+            {
+                // Matrix3x4 is stored by row and has no last row
+                for (auto r = 0u; r < 3u; ++r)
+                {
+                    // afterwards columns[n][r] is row r of the matrix of transform i + n
+                    simd::transpose(columns[0][r], columns[1][r], columns[2][r], columns[3][r]);
+                    for (auto n = 0u; n < 4u; ++n)
+                    {
+                        simd::store(models[i + n].data().data() + r * 4u, columns[n][r]);
+                    }
+                }
+            }
+        }
+#endif
+
+        for (; i < size(); ++i)
+        {
+            models[i] = M::compose(
+                {_position_x[i], _position_y[i], _position_z[i]},
+                {_rotation_x[i], _rotation_y[i], _rotation_z[i], _rotation_w[i]},
+                {_scale_x[i], _scale_y[i], _scale_z[i]});
+        }
+    }
+}
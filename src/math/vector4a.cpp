@@ -0,0 +1,85 @@
+#include "math/vector4a.h"
+
+#include <cstddef>
+#include <limits>
+#include <span>
+
+#include "math/simd.h"
+#include "utils/ensure.h"
+
+namespace game
+{
+    auto Vector4A::dot(std::span<const Vector4A> v1, std::span<const Vector4A> v2, std::span<float> result) -> void
+    {
+        expect(v1.size() == v2.size(), "vector count mismatch {} {}", v1.size(), v2.size());
+        expect(result.size() >= v1.size(), "need space for {} dot products, got {}", v1.size(), result.size());
+
+        auto i = 0zu;
+
+#if defined(GAME_SIMD_FLOAT4)
+        // transposed, each register holds one component of four vectors
+        for (; i + 4u <= v1.size(); i += 4u)
+        {
+            auto x1 = simd::load_aligned(&v1[i].x);
+            auto y1 = simd::load_aligned(&v1[i + 1u].x);
+            auto z1 = simd::load_aligned(&v1[i + 2u].x);
+            auto w1 = simd::load_aligned(&v1[i + 3u].x);
+            simd::transpose(x1, y1, z1, w1);
+
+            auto x2 = simd::load_aligned(&v2[i].x);
+            auto y2 = simd::load_aligned(&v2[i + 1u].x);
+            auto z2 = simd::load_aligned(&v2[i + 2u].x);
+            auto w2 = simd::load_aligned(&v2[i + 3u].x);
+            simd::transpose(x2, y2, z2, w2);
+
+            simd::store(result.data() + i, simd::madd(x1, x2, simd::madd(y1, y2, simd::madd(z1, z2, simd::mul(w1, w2)))));
+        }
+#endif
+
+        for (; i < v1.size(); ++i)
+        {
+            result[i] = dot(v1[i], v2[i]);
+        }
+    }
+
+    auto Vector4A::normalize(std::span<const Vector4A> vectors, std::span<Vector4A> result) -> void
+    {
+        expect(result.size() >= vectors.size(), "need space for {} vectors, got {}", vectors.size(), result.size());
+
+        auto i = 0zu;
+
+#if defined(GAME_SIMD_FLOAT4)
+        const auto min_length_squared = simd::splat(std::numeric_limits<float>::min());
+
+        for (; i + 4u <= vectors.size(); i += 4u)
+        {
+            auto x = simd::load_aligned(&vectors[i].x);
+            auto y = simd::load_aligned(&vectors[i + 1u].x);
+            auto z = simd::load_aligned(&vectors[i + 2u].x);
+            auto w = simd::load_aligned(&vectors[i + 3u].x);
+            simd::transpose(x, y, z, w);
+
+            // zero and subnormal vectors get a scale of zero instead of the infinity or garbage rsqrt gives them, like
+            // normalize(const Vector4A &)
+            const auto length_squared = simd::madd(x, x, simd::madd(y, y, simd::madd(z, z, simd::mul(w, w))));
+            const auto scale = simd::select_greater(simd::rsqrt(length_squared), length_squared, min_length_squared);
+
+            x = simd::mul(x, scale);
+            y = simd::mul(y, scale);
+            z = simd::mul(z, scale);
+            w = simd::mul(w, scale);
+            simd::transpose(x, y, z, w);
+
+            simd::store_aligned(&result[i].x, x);
+            simd::store_aligned(&result[i + 1u].x, y);
+            simd::store_aligned(&result[i + 2u].x, z);
+            simd::store_aligned(&result[i + 3u].x, w);
+        }
+#endif
+
+        for (; i < vectors.size(); ++i)
+        {
+            result[i] = normalize(vectors[i]);
+        }
+    }
+}
@@ -0,0 +1,870 @@
+#include "packer/block_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "graphics/texture.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    using Pixel = std::array<float, 4u>;
+    using Block = std::array<Pixel, 16u>;
+
+    auto distance_squared(const Pixel &a, const Pixel &b, std::size_t channels) -> float
+    {
+        auto d = 0.0f;
+        for (auto c = 0u; c < channels; ++c)
+        {
+            d += (a[c] - b[c]) * (a[c] - b[c]);
+        }
+        return d;
+    }
+
+    auto load_block(std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height, std::uint32_t bx, std::uint32_t by) -> Block
+    {
+        auto block = Block{};
+
+        for (auto y = 0u; y < 4u; ++y)
+        {
+            const auto src_y = std::min(by * 4u + y, height - 1u);
+            for (auto x = 0u; x < 4u; ++x)
+            {
+                const auto src_x = std::min(bx * 4u + x, width - 1u);
+                const auto offset = (static_cast<std::size_t>(src_y) * width + src_x) * 4u;
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    block[y * 4u + x][c] = static_cast<float>(std::to_integer<std::uint8_t>(rgba[offset + c]));
+                }
+            }
+        }
+
+        return block;
+    }
+
+    auto store_block(std::span<std::byte> rgba, std::uint32_t width, std::uint32_t height, std::uint32_t bx, std::uint32_t by, const std::array<std::array<std::uint8_t, 4u>, 16u> &block) -> void
+    {
+        for (auto y = 0u; y < 4u && by * 4u + y < height; ++y)
+        {
+            for (auto x = 0u; x < 4u && bx * 4u + x < width; ++x)
+            {
+                const auto offset = (static_cast<std::size_t>(by * 4u + y) * width + bx * 4u + x) * 4u;
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    rgba[offset + c] = static_cast<std::byte>(block[y * 4u + x][c]);
+                }
+            }
+        }
+    }
+
+    auto write_u16(std::byte *dst, std::uint16_t value) -> void
+    {
+        dst[0] = static_cast<std::byte>(value & 0xffu);
+        dst[1] = static_cast<std::byte>(value >> 8u);
+    }
+
+    auto read_u16(const std::byte *src) -> std::uint16_t
+    {
+        return static_cast<std::uint16_t>(std::to_integer<std::uint16_t>(src[0]) | (std::to_integer<std::uint16_t>(src[1]) << 8u));
+    }
+
+    /**
+     * Find the line through a set of points which best fits them (principal component), returned as the two
+     * extreme projections of the points onto that line.
+     */
+    auto principal_endpoints(const Block &block, std::size_t channels) -> std::pair<Pixel, Pixel>
+    {
+        auto mean = Pixel{};
+        for (const auto &p : block)
+        {
+            for (auto c = 0u; c < channels; ++c)
+            {
+                mean[c] += p[c] / 16.0f;
+            }
+        }
+
+        auto covariance = std::array<std::array<float, 4u>, 4u>{};
+        for (const auto &p : block)
+        {
+            for (auto i = 0u; i < channels; ++i)
+            {
+                for (auto j = 0u; j < channels; ++j)
+                {
+                    covariance[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]);
+                }
+            }
+        }
+
+        // power iteration, start from the diagonal of the covariance which is a good guess for most blocks
+        auto axis = Pixel{};
+        for (auto c = 0u; c < channels; ++c)
+        {
+            axis[c] = covariance[c][c];
+        }
+
+        for (auto iteration = 0u; iteration < 8u; ++iteration)
+        {
+            auto next = Pixel{};
+            for (auto i = 0u; i < channels; ++i)
+            {
+                for (auto j = 0u; j < channels; ++j)
+                {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+            }
+
+            const auto length = std::sqrt(distance_squared(next, Pixel{}, channels));
+            if (length < 1e-6f)
+            {
+                break;
+            }
+
+            for (auto c = 0u; c < channels; ++c)
+            {
+                axis[c] = next[c] / length;
+            }
+        }
+
+        auto min_t = std::numeric_limits<float>::max();
+        auto max_t = std::numeric_limits<float>::lowest();
+        for (const auto &p : block)
+        {
+            auto t = 0.0f;
+            for (auto c = 0u; c < channels; ++c)
+            {
+                t += (p[c] - mean[c]) * axis[c];
+            }
+            min_t = std::min(min_t, t);
+            max_t = std::max(max_t, t);
+        }
+
+        auto start = Pixel{};
+        auto end = Pixel{};
+        for (auto c = 0u; c < channels; ++c)
+        {
+            start[c] = std::clamp(mean[c] + axis[c] * min_t, 0.0f, 255.0f);
+            end[c] = std::clamp(mean[c] + axis[c] * max_t, 0.0f, 255.0f);
+        }
+
+        return {start, end};
+    }
+
+    /**
+     * Solve for the two endpoints which minimise the squared error for a fixed set of interpolation weights.
+     * Returns false if the system is degenerate (e.g. all pixels use the same weight).
+     */
+    auto least_squares_endpoints(const Block &block, std::span<const float> weights, std::size_t channels, Pixel &start, Pixel &end)
+        -> bool
+    {
+        auto aa = 0.0f;
+        auto ab = 0.0f;
+        auto bb = 0.0f;
+        auto ax = Pixel{};
+        auto bx = Pixel{};
+
+        for (auto index = 0u; index < block.size(); ++index)
+        {
+            const auto &p = block[index];
+            const auto b = weights[index];
+            const auto a = 1.0f - b;
+            aa += a * a;
+            ab += a * b;
+            bb += b * b;
+            for (auto c = 0u; c < channels; ++c)
+            {
+                ax[c] += a * p[c];
+                bx[c] += b * p[c];
+            }
+        }
+
+        const auto det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f)
+        {
+            return false;
+        }
+
+        for (auto c = 0u; c < channels; ++c)
+        {
+            start[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+            end[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+        }
+
+        return true;
+    }
+
+    // BC1
+
+    auto to_565(const Pixel &p) -> std::uint16_t
+    {
+        const auto r = static_cast<std::uint16_t>(std::lround(p[0] * 31.0f / 255.0f));
+        const auto g = static_cast<std::uint16_t>(std::lround(p[1] * 63.0f / 255.0f));
+        const auto b = static_cast<std::uint16_t>(std::lround(p[2] * 31.0f / 255.0f));
+        return static_cast<std::uint16_t>((r << 11u) | (g << 5u) | b);
+    }
+
+    auto from_565(std::uint16_t c) -> std::array<std::uint8_t, 4u>
+    {
+        const auto r = static_cast<std::uint32_t>((c >> 11u) & 0x1fu);
+        const auto g = static_cast<std::uint32_t>((c >> 5u) & 0x3fu);
+        const auto b = static_cast<std::uint32_t>(c & 0x1fu);
+        return {
+            static_cast<std::uint8_t>((r << 3u) | (r >> 2u)),
+            static_cast<std::uint8_t>((g << 2u) | (g >> 4u)),
+            static_cast<std::uint8_t>((b << 3u) | (b >> 2u)),
+            0xffu};
+    }
+
+    auto bc1_palette(std::uint16_t c0, std::uint16_t c1) -> std::array<std::array<std::uint8_t, 4u>, 4u>
+    {
+        const auto p0 = from_565(c0);
+        const auto p1 = from_565(c1);
+        auto palette = std::array<std::array<std::uint8_t, 4u>, 4u>{p0, p1, p0, p1};
+
+        for (auto c = 0u; c < 3u; ++c)
+        {
+            if (c0 > c1)
+            {
+                palette[2][c] = static_cast<std::uint8_t>((2u * p0[c] + p1[c]) / 3u);
+                palette[3][c] = static_cast<std::uint8_t>((p0[c] + 2u * p1[c]) / 3u);
+            }
+            else
+            {
+                palette[2][c] = static_cast<std::uint8_t>((p0[c] + p1[c]) / 2u);
+                palette[3][c] = 0u;
+            }
+        }
+
+        if (c0 <= c1)
+        {
+            palette[3][3] = 0u;
+        }
+
+        return palette;
+    }
+
+    struct Bc1Candidate
+    {
+        std::uint16_t c0;
+        std::uint16_t c1;
+        std::uint32_t indices;
+        float error;
+    };
+
+    auto bc1_fit(const Block &block, const Pixel &start, const Pixel &end) -> Bc1Candidate
+    {
+        auto c0 = to_565(start);
+        auto c1 = to_565(end);
+
+        if (c0 == c1)
+        {
+            // solid block, every pixel uses the first endpoint
+            const auto palette = bc1_palette(c0, c1);
+            auto error = 0.0f;
+            for (const auto &p : block)
+            {
+                error += distance_squared(p, {static_cast<float>(palette[0][0]), static_cast<float>(palette[0][1]), static_cast<float>(palette[0][2])}, 3u);
+            }
+            return {c0, c1, 0u, error};
+        }
+
+        // always use the four colour mode, which requires c0 > c1
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+        }
+
+        const auto palette = bc1_palette(c0, c1);
+
+        auto indices = std::uint32_t{};
+        auto error = 0.0f;
+        for (auto index = 0u; index < block.size(); ++index)
+        {
+            const auto &p = block[index];
+            auto best = 0u;
+            auto best_error = std::numeric_limits<float>::max();
+            for (auto i = 0u; i < 4u; ++i)
+            {
+                const auto e = distance_squared(
+                    p, {static_cast<float>(palette[i][0]), static_cast<float>(palette[i][1]), static_cast<float>(palette[i][2])}, 3u);
+                if (e < best_error)
+                {
+                    best_error = e;
+                    best = i;
+                }
+            }
+
+            indices |= best << (index * 2u);
+            error += best_error;
+        }
+
+        return {c0, c1, indices, error};
+    }
+
+    auto encode_bc1_block(const Block &block, std::byte *dst) -> void
+    {
+        const auto [start, end] = principal_endpoints(block, 3u);
+        auto best = bc1_fit(block, start, end);
+
+        // refine the endpoints using the selected indices, keep whichever is better after quantisation
+        static constexpr float index_weights[] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        for (auto iteration = 0u; iteration < 2u && best.c0 != best.c1; ++iteration)
+        {
+            auto weights = std::array<float, 16u>{};
+            for (auto i = 0u; i < 16u; ++i)
+            {
+                weights[i] = index_weights[(best.indices >> (i * 2u)) & 0x3u];
+            }
+
+            auto refined_start = Pixel{};
+            auto refined_end = Pixel{};
+            if (!least_squares_endpoints(block, weights, 3u, refined_start, refined_end))
+            {
+                break;
+            }
+
+            const auto candidate = bc1_fit(block, refined_start, refined_end);
+            if (candidate.error >= best.error)
+            {
+                break;
+            }
+            best = candidate;
+        }
+
+        write_u16(dst, best.c0);
+        write_u16(dst + 2u, best.c1);
+        for (auto i = 0u; i < 4u; ++i)
+        {
+            dst[4u + i] = static_cast<std::byte>((best.indices >> (i * 8u)) & 0xffu);
+        }
+    }
+
+    auto decode_bc1_block(const std::byte *src, bool force_four_colour) -> std::array<std::array<std::uint8_t, 4u>, 16u>
+    {
+        const auto c0 = read_u16(src);
+        const auto c1 = read_u16(src + 2u);
+
+        auto palette = bc1_palette(c0, c1);
+        if (force_four_colour && c0 <= c1)
+        {
+            // BC2/BC3 colour blocks always interpolate
+            const auto p0 = from_565(c0);
+            const auto p1 = from_565(c1);
+            for (auto c = 0u; c < 3u; ++c)
+            {
+                palette[2][c] = static_cast<std::uint8_t>((2u * p0[c] + p1[c]) / 3u);
+                palette[3][c] = static_cast<std::uint8_t>((p0[c] + 2u * p1[c]) / 3u);
+            }
+            palette[3][3] = 0xffu;
+        }
+
+        auto block = std::array<std::array<std::uint8_t, 4u>, 16u>{};
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            const auto byte = std::to_integer<std::uint32_t>(src[4u + i / 4u]);
+            block[i] = palette[(byte >> ((i % 4u) * 2u)) & 0x3u];
+        }
+
+        return block;
+    }
+
+    // BC4 (single channel), used for BC3 alpha and both BC5 channels
+
+    auto bc4_palette(std::uint8_t e0, std::uint8_t e1) -> std::array<std::uint8_t, 8u>
+    {
+        auto palette = std::array<std::uint8_t, 8u>{e0, e1};
+
+        if (e0 > e1)
+        {
+            for (auto i = 1u; i < 7u; ++i)
+            {
+                palette[i + 1u] = static_cast<std::uint8_t>(((7u - i) * e0 + i * e1 + 3u) / 7u);
+            }
+        }
+        else
+        {
+            for (auto i = 1u; i < 5u; ++i)
+            {
+                palette[i + 1u] = static_cast<std::uint8_t>(((5u - i) * e0 + i * e1 + 2u) / 5u);
+            }
+            palette[6] = 0u;
+            palette[7] = 255u;
+        }
+
+        return palette;
+    }
+
+    auto bc4_fit(const std::array<float, 16u> &values, std::uint8_t e0, std::uint8_t e1, std::uint64_t &indices) -> float
+    {
+        const auto palette = bc4_palette(e0, e1);
+
+        indices = 0u;
+        auto error = 0.0f;
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            auto best = 0u;
+            auto best_error = std::numeric_limits<float>::max();
+            for (auto j = 0u; j < 8u; ++j)
+            {
+                const auto d = values[i] - static_cast<float>(palette[j]);
+                if (d * d < best_error)
+                {
+                    best_error = d * d;
+                    best = j;
+                }
+            }
+
+            indices |= static_cast<std::uint64_t>(best) << (i * 3u);
+            error += best_error;
+        }
+
+        return error;
+    }
+
+    auto encode_bc4_block(const Block &block, std::size_t channel, std::byte *dst) -> void
+    {
+        auto values = std::array<float, 16u>{};
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            values[i] = block[i][channel];
+        }
+
+        const auto [min, max] = std::ranges::minmax(values);
+
+        // eight interpolated values
+        auto e0 = static_cast<std::uint8_t>(max);
+        auto e1 = static_cast<std::uint8_t>(min);
+        auto indices = std::uint64_t{};
+        auto error = bc4_fit(values, e0, e1, indices);
+
+        // six interpolated values plus explicit 0 and 255, which helps blocks with a few outliers at the extremes
+        auto inner_min = 255.0f;
+        auto inner_max = 0.0f;
+        for (const auto v : values)
+        {
+            if (v > 0.0f && v < 255.0f)
+            {
+                inner_min = std::min(inner_min, v);
+                inner_max = std::max(inner_max, v);
+            }
+        }
+
+        if (inner_min <= inner_max)
+        {
+            const auto six_e0 = static_cast<std::uint8_t>(inner_min);
+            const auto six_e1 = static_cast<std::uint8_t>(inner_max);
+            auto six_indices = std::uint64_t{};
+            const auto six_error = bc4_fit(values, six_e0, six_e1, six_indices);
+
+            if (six_error < error)
+            {
+                e0 = six_e0;
+                e1 = six_e1;
+                indices = six_indices;
+                error = six_error;
+            }
+        }
+
+        dst[0] = static_cast<std::byte>(e0);
+        dst[1] = static_cast<std::byte>(e1);
+        for (auto i = 0u; i < 6u; ++i)
+        {
+            dst[2u + i] = static_cast<std::byte>((indices >> (i * 8u)) & 0xffu);
+        }
+    }
+
+    auto decode_bc4_block(const std::byte *src) -> std::array<std::uint8_t, 16u>
+    {
+        const auto palette = bc4_palette(std::to_integer<std::uint8_t>(src[0]), std::to_integer<std::uint8_t>(src[1]));
+
+        auto indices = std::uint64_t{};
+        for (auto i = 0u; i < 6u; ++i)
+        {
+            indices |= std::to_integer<std::uint64_t>(src[2u + i]) << (i * 8u);
+        }
+
+        auto values = std::array<std::uint8_t, 16u>{};
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            values[i] = palette[(indices >> (i * 3u)) & 0x7u];
+        }
+
+        return values;
+    }
+
+    // BC7, only mode 6 is used: a single subset with 7.7.7.7 endpoints, a p-bit per endpoint and 4 bit indices.
+    // This keeps the encoder small while still being a large quality improvement over BC1 for colour and alpha.
+
+    constexpr std::uint32_t bc7_weights[] = {0u, 4u, 9u, 13u, 17u, 21u, 26u, 30u, 34u, 38u, 43u, 47u, 51u, 55u, 60u, 64u};
+
+    class BitWriter
+    {
+      public:
+        explicit BitWriter(std::byte *dst)
+            : _dst(dst),
+              _offset(0u)
+        {
+            std::fill_n(_dst, 16u, std::byte{});
+        }
+
+        auto write(std::uint32_t value, std::uint32_t bits) -> void
+        {
+            for (auto i = 0u; i < bits; ++i, ++_offset)
+            {
+                if ((value >> i) & 0x1u)
+                {
+                    _dst[_offset / 8u] |= static_cast<std::byte>(1u << (_offset % 8u));
+                }
+            }
+        }
+
+      private:
+        std::byte *_dst;
+        std::uint32_t _offset;
+    };
+
+    class BitReader
+    {
+      public:
+        explicit BitReader(const std::byte *src)
+            : _src(src),
+              _offset(0u)
+        {
+        }
+
+        auto read(std::uint32_t bits) -> std::uint32_t
+        {
+            auto value = 0u;
+            for (auto i = 0u; i < bits; ++i, ++_offset)
+            {
+                value |= ((std::to_integer<std::uint32_t>(_src[_offset / 8u]) >> (_offset % 8u)) & 0x1u) << i;
+            }
+            return value;
+        }
+
+      private:
+        const std::byte *_src;
+        std::uint32_t _offset;
+    };
+
+    struct Bc7Endpoints
+    {
+        std::array<std::uint32_t, 4u> e0;
+        std::array<std::uint32_t, 4u> e1;
+        std::uint32_t p0;
+        std::uint32_t p1;
+    };
+
+    auto bc7_unquantise(const std::array<std::uint32_t, 4u> &e, std::uint32_t p) -> std::array<std::uint32_t, 4u>
+    {
+        return {(e[0] << 1u) | p, (e[1] << 1u) | p, (e[2] << 1u) | p, (e[3] << 1u) | p};
+    }
+
+    auto bc7_palette(const Bc7Endpoints &endpoints) -> std::array<std::array<std::uint8_t, 4u>, 16u>
+    {
+        const auto e0 = bc7_unquantise(endpoints.e0, endpoints.p0);
+        const auto e1 = bc7_unquantise(endpoints.e1, endpoints.p1);
+
+        auto palette = std::array<std::array<std::uint8_t, 4u>, 16u>{};
+        for (auto i = 0u; i < 16u; ++i)
+        {
+            for (auto c = 0u; c < 4u; ++c)
+            {
+                palette[i][c] = static_cast<std::uint8_t>(((64u - bc7_weights[i]) * e0[c] + bc7_weights[i] * e1[c] + 32u) >> 6u);
+            }
+        }
+
+        return palette;
+    }
+
+    auto bc7_quantise(const Pixel &p, std::uint32_t p_bit) -> std::array<std::uint32_t, 4u>
+    {
+        auto e = std::array<std::uint32_t, 4u>{};
+        for (auto c = 0u; c < 4u; ++c)
+        {
+            e[c] = static_cast<std::uint32_t>(std::clamp(std::lround((p[c] - static_cast<float>(p_bit)) / 2.0f), 0l, 127l));
+        }
+        return e;
+    }
+
+    struct Bc7Candidate
+    {
+        Bc7Endpoints endpoints;
+        std::array<std::uint32_t, 16u> indices;
+        float error;
+    };
+
+    auto bc7_fit(const Block &block, const Pixel &start, const Pixel &end) -> Bc7Candidate
+    {
+        auto best = Bc7Candidate{.endpoints = {}, .indices = {}, .error = std::numeric_limits<float>::max()};
+
+        // try every p-bit combination, they shift the representable endpoints by one
+        for (auto p0 = 0u; p0 < 2u; ++p0)
+        {
+            for (auto p1 = 0u; p1 < 2u; ++p1)
+            {
+                const auto endpoints = Bc7Endpoints{.e0 = bc7_quantise(start, p0), .e1 = bc7_quantise(end, p1), .p0 = p0, .p1 = p1};
+                const auto palette = bc7_palette(endpoints);
+
+                auto candidate = Bc7Candidate{.endpoints = endpoints, .indices = {}, .error = 0.0f};
+                for (auto index = 0u; index < block.size(); ++index)
+                {
+                    const auto &p = block[index];
+                    auto best_error = std::numeric_limits<float>::max();
+                    for (auto i = 0u; i < 16u; ++i)
+                    {
+                        const auto e = distance_squared(
+                            p,
+                            {static_cast<float>(palette[i][0]),
+                             static_cast<float>(palette[i][1]),
+                             static_cast<float>(palette[i][2]),
+                             static_cast<float>(palette[i][3])},
+                            4u);
+                        if (e < best_error)
+                        {
+                            best_error = e;
+                            candidate.indices[index] = i;
+                        }
+                    }
+                    candidate.error += best_error;
+                }
+
+                if (candidate.error < best.error)
+                {
+                    best = candidate;
+                }
+            }
+        }
+
+        return best;
+    }
+
+    auto encode_bc7_block(const Block &block, std::byte *dst) -> void
+    {
+        const auto [start, end] = principal_endpoints(block, 4u);
+        auto best = bc7_fit(block, start, end);
+
+        for (auto iteration = 0u; iteration < 2u; ++iteration)
+        {
+            auto weights = std::array<float, 16u>{};
+            for (auto i = 0u; i < 16u; ++i)
+            {
+                weights[i] = static_cast<float>(bc7_weights[best.indices[i]]) / 64.0f;
+            }
+
+            auto refined_start = Pixel{};
+            auto refined_end = Pixel{};
+            if (!least_squares_endpoints(block, weights, 4u, refined_start, refined_end))
+            {
+                break;
+            }
+
+            const auto candidate = bc7_fit(block, refined_start, refined_end);
+            if (candidate.error >= best.error)
+            {
+                break;
+            }
+            best = candidate;
+        }
+
+        // the msb of the first index is implicitly zero, swap the endpoints if that is not the case
+        if (best.indices[0] >= 8u)
+        {
+            std::swap(best.endpoints.e0, best.endpoints.e1);
+            std::swap(best.endpoints.p0, best.endpoints.p1);
+            for (auto &index : best.indices)
+            {
+                index = 15u - index;
+            }
+        }
+
+        auto writer = BitWriter{dst};
+        writer.write(1u << 6u, 7u);
+        for (auto c = 0u; c < 4u; ++c)
+        {
+            writer.write(best.endpoints.e0[c], 7u);
+            writer.write(best.endpoints.e1[c], 7u);
+        }
+        writer.write(best.endpoints.p0, 1u);
+        writer.write(best.endpoints.p1, 1u);
+        writer.write(best.indices[0], 3u);
+        for (auto i = 1u; i < 16u; ++i)
+        {
+            writer.write(best.indices[i], 4u);
+        }
+    }
+
+    auto decode_bc7_block(const std::byte *src) -> std::array<std::array<std::uint8_t, 4u>, 16u>
+    {
+        auto reader = BitReader{src};
+        game::ensure(reader.read(7u) == (1u << 6u), "only BC7 mode 6 blocks are supported");
+
+        auto endpoints = Bc7Endpoints{};
+        for (auto c = 0u; c < 4u; ++c)
+        {
+            endpoints.e0[c] = reader.read(7u);
+            endpoints.e1[c] = reader.read(7u);
+        }
+        endpoints.p0 = reader.read(1u);
+        endpoints.p1 = reader.read(1u);
+
+        const auto palette = bc7_palette(endpoints);
+
+        auto block = std::array<std::array<std::uint8_t, 4u>, 16u>{};
+        block[0] = palette[reader.read(3u)];
+        for (auto i = 1u; i < 16u; ++i)
+        {
+            block[i] = palette[reader.read(4u)];
+        }
+
+        return block;
+    }
+
+    auto block_size(game::TextureFormat format) -> std::size_t
+    {
+        switch (format)
+        {
+            using enum game::TextureFormat;
+        case BC1:
+            return 8u;
+        case BC3:
+        case BC5:
+        case BC7:
+            return 16u;
+        default:
+            throw game::Exception("unsupported block compression format {}", format);
+        }
+    }
+}
+
+namespace game::packer
+{
+    auto expand_to_rgba(std::span<const std::byte> pixels, std::uint32_t num_channels) -> std::vector<std::byte>
+    {
+        ensure(num_channels == 1u || num_channels == 3u || num_channels == 4u, "unsupported number of channels {}", num_channels);
+        ensure(pixels.size() % num_channels == 0u, "pixel data is not a multiple of {}", num_channels);
+
+        const auto pixel_count = pixels.size() / num_channels;
+        auto rgba = std::vector<std::byte>(pixel_count * 4u);
+
+        for (auto i = 0u; i < pixel_count; ++i)
+        {
+            rgba[i * 4u + 3u] = std::byte{0xff};
+            for (auto c = 0u; c < num_channels; ++c)
+            {
+                rgba[i * 4u + c] = pixels[i * num_channels + c];
+            }
+        }
+
+        return rgba;
+    }
+
+    auto encode(TextureFormat format, std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height)
+        -> std::vector<std::byte>
+    {
+        ensure(width > 0u && height > 0u, "cannot encode empty image");
+        ensure(rgba.size() == static_cast<std::size_t>(width) * height * 4u, "image data does not match dimensions {}x{}", width, height);
+
+        const auto blocks_x = (width + 3u) / 4u;
+        const auto blocks_y = (height + 3u) / 4u;
+        const auto size = block_size(format);
+
+        auto encoded = std::vector<std::byte>(blocks_x * blocks_y * size);
+
+        for (auto by = 0u; by < blocks_y; ++by)
+        {
+            for (auto bx = 0u; bx < blocks_x; ++bx)
+            {
+                const auto block = load_block(rgba, width, height, bx, by);
+                auto *dst = encoded.data() + (by * blocks_x + bx) * size;
+
+                switch (format)
+                {
+                    using enum TextureFormat;
+                case BC1:
+                    encode_bc1_block(block, dst);
+                    break;
+                case BC3:
+                    encode_bc4_block(block, 3u, dst);
+                    encode_bc1_block(block, dst + 8u);
+                    break;
+                case BC5:
+                    encode_bc4_block(block, 0u, dst);
+                    encode_bc4_block(block, 1u, dst + 8u);
+                    break;
+                case BC7:
+                    encode_bc7_block(block, dst);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        return encoded;
+    }
+
+    auto decode(TextureFormat format, std::span<const std::byte> blocks, std::uint32_t width, std::uint32_t height)
+        -> std::vector<std::byte>
+    {
+        const auto blocks_x = (width + 3u) / 4u;
+        const auto blocks_y = (height + 3u) / 4u;
+        const auto size = block_size(format);
+
+        ensure(blocks.size() == blocks_x * blocks_y * size, "block data does not match dimensions {}x{}", width, height);
+
+        auto rgba = std::vector<std::byte>(static_cast<std::size_t>(width) * height * 4u);
+
+        for (auto by = 0u; by < blocks_y; ++by)
+        {
+            for (auto bx = 0u; bx < blocks_x; ++bx)
+            {
+                const auto *src = blocks.data() + (by * blocks_x + bx) * size;
+                auto block = std::array<std::array<std::uint8_t, 4u>, 16u>{};
+
+                switch (format)
+                {
+                    using enum TextureFormat;
+                case BC1:
+                    block = decode_bc1_block(src, false);
+                    break;
+                case BC3:
+                {
+                    block = decode_bc1_block(src + 8u, true);
+                    const auto alpha = decode_bc4_block(src);
+                    for (auto i = 0u; i < 16u; ++i)
+                    {
+                        block[i][3] = alpha[i];
+                    }
+                    break;
+                }
+                case BC5:
+                {
+                    const auto red = decode_bc4_block(src);
+                    const auto green = decode_bc4_block(src + 8u);
+                    for (auto i = 0u; i < 16u; ++i)
+                    {
+                        block[i] = {red[i], green[i], 0u, 0xffu};
+                    }
+                    break;
+                }
+                case BC7:
+                    block = decode_bc7_block(src);
+                    break;
+                default:
+                    break;
+                }
+
+                store_block(rgba, width, height, bx, by, block);
+            }
+        }
+
+        return rgba;
+    }
+}
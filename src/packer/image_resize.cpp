@@ -0,0 +1,158 @@
+#include "packer/image_resize.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+
+#include "packer/srgb.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    constexpr auto lanczos_lobes = 3.f;
+
+    auto sinc(float x) -> float
+    {
+        if (std::abs(x) < 1e-6f)
+        {
+            return 1.f;
+        }
+
+        const auto pi_x = std::numbers::pi_v<float> * x;
+        return std::sin(pi_x) / pi_x;
+    }
+
+    auto lanczos(float x) -> float
+    {
+        return std::abs(x) < lanczos_lobes ? sinc(x) * sinc(x / lanczos_lobes) : 0.f;
+    }
+
+    struct Contribution
+    {
+        std::uint32_t first;
+        std::vector<float> weights;
+    };
+
+    /**
+     * Work out which source pixels contribute to every destination pixel along one axis, and by how much.
+     */
+    auto compute_contributions(std::uint32_t src_size, std::uint32_t dst_size) -> std::vector<Contribution>
+    {
+        const auto scale = static_cast<float>(src_size) / static_cast<float>(dst_size);
+        const auto support = lanczos_lobes * scale;
+
+        auto contributions = std::vector<Contribution>(dst_size);
+
+        for (auto i = 0u; i < dst_size; ++i)
+        {
+            const auto center = (static_cast<float>(i) + 0.5f) * scale;
+            const auto first = static_cast<std::int64_t>(std::floor(center - support));
+            const auto last = static_cast<std::int64_t>(std::ceil(center + support));
+
+            const auto lo = static_cast<std::uint32_t>(std::clamp<std::int64_t>(first, 0, src_size - 1u));
+            const auto hi = static_cast<std::uint32_t>(std::clamp<std::int64_t>(last, 0, src_size - 1u));
+
+            // pixels past the edge repeat the edge pixel, so their weights are folded into it
+            auto &weights = contributions[i].weights;
+            weights.resize(hi - lo + 1u, 0.f);
+            auto total = 0.f;
+            for (auto j = first; j <= last; ++j)
+            {
+                const auto weight = lanczos((static_cast<float>(j) + 0.5f - center) / scale);
+                weights[static_cast<std::size_t>(std::clamp<std::int64_t>(j, lo, hi) - lo)] += weight;
+                total += weight;
+            }
+
+            for (auto &weight : weights)
+            {
+                weight /= total;
+            }
+            contributions[i].first = lo;
+        }
+
+        return contributions;
+    }
+}
+
+namespace game::packer
+{
+    auto downscale_image(
+        std::span<const std::byte> pixels,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t num_channels,
+        std::uint32_t new_width,
+        std::uint32_t new_height,
+        bool srgb) -> std::vector<std::byte>
+    {
+        ensure(num_channels >= 1u && num_channels <= 4u, "unsupported channel count {}", num_channels);
+        ensure(pixels.size() == static_cast<std::size_t>(width) * height * num_channels, "image data does not match dimensions {}x{}", width, height);
+        ensure(new_width >= 1u && new_width <= width && new_height >= 1u && new_height <= height, "cannot downscale {}x{} to {}x{}", width, height, new_width, new_height);
+
+        const auto is_colour = [&](std::uint32_t channel)
+        { return srgb && channel < 3u; };
+
+        auto to_linear = std::array<float, 256u>{};
+        for (auto i = 0u; i < to_linear.size(); ++i)
+        {
+            to_linear[i] = srgb_to_linear(static_cast<float>(i) / 255.f);
+        }
+
+        auto source = std::vector<float>(pixels.size());
+        for (auto i = 0u; i < pixels.size(); ++i)
+        {
+            const auto value = std::to_integer<std::uint32_t>(pixels[i]);
+            source[i] = is_colour(i % num_channels) ? to_linear[value] : static_cast<float>(value) / 255.f;
+        }
+
+        // filter rows first, then columns of the narrower intermediate image
+        const auto horizontal = compute_contributions(width, new_width);
+        auto rows = std::vector<float>(static_cast<std::size_t>(new_width) * height * num_channels, 0.f);
+        for (auto y = 0u; y < height; ++y)
+        {
+            for (auto x = 0u; x < new_width; ++x)
+            {
+                const auto &[first, weights] = horizontal[x];
+                for (auto c = 0u; c < num_channels; ++c)
+                {
+                    auto sum = 0.f;
+                    for (auto k = 0u; k < weights.size(); ++k)
+                    {
+                        sum += weights[k] * source[(static_cast<std::size_t>(y) * width + first + k) * num_channels + c];
+                    }
+                    rows[(static_cast<std::size_t>(y) * new_width + x) * num_channels + c] = sum;
+                }
+            }
+        }
+
+        const auto vertical = compute_contributions(height, new_height);
+        auto result = std::vector<std::byte>(static_cast<std::size_t>(new_width) * new_height * num_channels);
+        for (auto y = 0u; y < new_height; ++y)
+        {
+            const auto &[first, weights] = vertical[y];
+            for (auto x = 0u; x < new_width; ++x)
+            {
+                for (auto c = 0u; c < num_channels; ++c)
+                {
+                    auto sum = 0.f;
+                    for (auto k = 0u; k < weights.size(); ++k)
+                    {
+                        sum += weights[k] * rows[((static_cast<std::size_t>(first) + k) * new_width + x) * num_channels + c];
+                    }
+
+                    // the negative lobes can ring past the valid range at hard edges
+                    sum = std::clamp(sum, 0.f, 1.f);
+                    const auto encoded = is_colour(c) ? linear_to_srgb(sum) : sum;
+                    result[(static_cast<std::size_t>(y) * new_width + x) * num_channels + c] = static_cast<std::byte>(std::lround(encoded * 255.f));
+                }
+            }
+        }
+
+        return result;
+    }
+}
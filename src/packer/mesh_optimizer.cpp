@@ -0,0 +1,396 @@
+#include "packer/mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    // Forsyth's tuning values, see "Linear-Speed Vertex Cache Optimisation"
+    constexpr auto forsyth_cache_size = 32u;
+    constexpr auto forsyth_cache_decay_power = 1.5f;
+    constexpr auto forsyth_last_triangle_score = 0.75f;
+    constexpr auto forsyth_valence_boost_scale = 2.0f;
+    constexpr auto forsyth_valence_boost_power = 0.5f;
+
+    auto forsyth_vertex_score(std::int32_t cache_position, std::uint32_t remaining_triangles) -> float
+    {
+        if (remaining_triangles == 0u)
+        {
+            return -1.0f;
+        }
+
+        auto score = 0.0f;
+
+        if (cache_position >= 0)
+        {
+            if (cache_position < 3)
+            {
+                // the vertices of the last triangle get a fixed score so the next triangle is not chosen from them
+                score = forsyth_last_triangle_score;
+            }
+            else
+            {
+                const auto scale = 1.0f / static_cast<float>(forsyth_cache_size - 3u);
+                score = std::pow(1.0f - static_cast<float>(cache_position - 3) * scale, forsyth_cache_decay_power);
+            }
+        }
+
+        // boost vertices with few triangles left, so they are finished off and don't leave lone triangles behind
+        score += forsyth_valence_boost_scale * std::pow(static_cast<float>(remaining_triangles), -forsyth_valence_boost_power);
+
+        return score;
+    }
+
+    auto triangle_centroid(std::span<const game::VertexData> vertices, std::span<const std::uint32_t> triangle) -> game::Vector3
+    {
+        return (vertices[triangle[0]].position + vertices[triangle[1]].position + vertices[triangle[2]].position) / 3.0f;
+    }
+
+    auto triangle_normal(std::span<const game::VertexData> vertices, std::span<const std::uint32_t> triangle) -> game::Vector3
+    {
+        // not normalised, the length is twice the area which weights larger triangles more
+        const auto &p0 = vertices[triangle[0]].position;
+        const auto &p1 = vertices[triangle[1]].position;
+        const auto &p2 = vertices[triangle[2]].position;
+
+        return game::Vector3::cross(p1 - p0, p2 - p0);
+    }
+}
+
+namespace game::packer
+{
+    auto deduplicate_vertices(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices) -> OptimizedMesh
+    {
+        // vertices are compared bitwise, using their bytes as key
+        auto unique = std::unordered_map<std::string_view, std::uint32_t>{};
+        unique.reserve(vertices.size());
+
+        auto remap = std::vector<std::uint32_t>(vertices.size());
+        auto mesh = OptimizedMesh{};
+
+        for (auto i = 0u; i < vertices.size(); ++i)
+        {
+            const auto key = std::string_view{reinterpret_cast<const char *>(&vertices[i]), sizeof(VertexData)};
+            const auto [it, inserted] = unique.try_emplace(key, static_cast<std::uint32_t>(mesh.vertices.size()));
+            if (inserted)
+            {
+                mesh.vertices.push_back(vertices[i]);
+            }
+            remap[i] = it->second;
+        }
+
+        mesh.indices = indices |
+                       std::views::transform([&remap](auto index)
+                                             { return remap[index]; }) |
+                       std::ranges::to<std::vector>();
+
+        return mesh;
+    }
+
+    auto optimize_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count) -> std::vector<std::uint32_t>
+    {
+        ensure(indices.size() % 3u == 0u, "index count {} is not a triangle list", indices.size());
+
+        const auto triangle_count = indices.size() / 3u;
+        if (triangle_count == 0u)
+        {
+            return {};
+        }
+
+        // build vertex -> triangle adjacency, stored as one array with an offset per vertex
+        auto remaining = std::vector<std::uint32_t>(vertex_count);
+        for (const auto index : indices)
+        {
+            ensure(index < vertex_count, "index {} out of range", index);
+            ++remaining[index];
+        }
+
+        auto adjacency_offsets = std::vector<std::uint32_t>(vertex_count + 1u);
+        std::inclusive_scan(std::ranges::cbegin(remaining), std::ranges::cend(remaining), std::ranges::begin(adjacency_offsets) + 1u);
+
+        auto adjacency = std::vector<std::uint32_t>(indices.size());
+        {
+            auto fill = adjacency_offsets;
+            for (auto i = 0u; i < indices.size(); ++i)
+            {
+                adjacency[fill[indices[i]]++] = static_cast<std::uint32_t>(i / 3u);
+            }
+        }
+
+        auto cache_position = std::vector<std::int32_t>(vertex_count, -1);
+        auto vertex_score = std::vector<float>(vertex_count);
+        for (auto v = 0u; v < vertex_count; ++v)
+        {
+            vertex_score[v] = forsyth_vertex_score(-1, remaining[v]);
+        }
+
+        auto triangle_score = std::vector<float>(triangle_count);
+        auto emitted = std::vector<bool>(triangle_count, false);
+        for (auto t = 0u; t < triangle_count; ++t)
+        {
+            triangle_score[t] = vertex_score[indices[t * 3u]] + vertex_score[indices[t * 3u + 1u]] + vertex_score[indices[t * 3u + 2u]];
+        }
+
+        auto best_triangle = static_cast<std::uint32_t>(std::ranges::distance(
+            std::ranges::cbegin(triangle_score), std::ranges::max_element(triangle_score)));
+
+        auto cache = std::vector<std::uint32_t>{};
+        auto new_cache = std::vector<std::uint32_t>{};
+        cache.reserve(forsyth_cache_size + 3u);
+        new_cache.reserve(forsyth_cache_size + 3u);
+
+        auto result = std::vector<std::uint32_t>{};
+        result.reserve(indices.size());
+
+        // fallback cursor for when no triangle adjacent to the cache is left
+        auto next_unemitted = 0u;
+
+        for (auto emitted_count = 0u; emitted_count < triangle_count; ++emitted_count)
+        {
+            if (best_triangle == std::numeric_limits<std::uint32_t>::max())
+            {
+                while (emitted[next_unemitted])
+                {
+                    ++next_unemitted;
+                }
+                best_triangle = next_unemitted;
+            }
+
+            const auto triangle = indices.subspan(best_triangle * 3u, 3u);
+            result.append_range(triangle);
+            emitted[best_triangle] = true;
+
+            // the triangle is done, remove it from the adjacency of its vertices
+            for (const auto v : triangle)
+            {
+                const auto begin = std::ranges::begin(adjacency) + adjacency_offsets[v];
+                const auto end = begin + remaining[v];
+                const auto found = std::ranges::find(begin, end, best_triangle);
+                std::iter_swap(found, end - 1);
+                --remaining[v];
+            }
+
+            // move the triangle's vertices to the front of the cache
+            new_cache.assign(std::ranges::cbegin(triangle), std::ranges::cend(triangle));
+            for (const auto v : cache)
+            {
+                if (!std::ranges::contains(triangle, v))
+                {
+                    new_cache.push_back(v);
+                }
+            }
+
+            for (auto i = 0u; i < new_cache.size(); ++i)
+            {
+                const auto v = new_cache[i];
+                cache_position[v] = i < forsyth_cache_size ? static_cast<std::int32_t>(i) : -1;
+                vertex_score[v] = forsyth_vertex_score(cache_position[v], remaining[v]);
+            }
+
+            // rescore all triangles touching the cache and pick the best one for the next step
+            best_triangle = std::numeric_limits<std::uint32_t>::max();
+            auto best_score = std::numeric_limits<float>::lowest();
+            for (const auto v : new_cache)
+            {
+                for (auto i = adjacency_offsets[v]; i < adjacency_offsets[v] + remaining[v]; ++i)
+                {
+                    const auto t = adjacency[i];
+                    triangle_score[t] = vertex_score[indices[t * 3u]] + vertex_score[indices[t * 3u + 1u]] + vertex_score[indices[t * 3u + 2u]];
+                    if (triangle_score[t] > best_score)
+                    {
+                        best_score = triangle_score[t];
+                        best_triangle = t;
+                    }
+                }
+            }
+
+            if (new_cache.size() > forsyth_cache_size)
+            {
+                new_cache.resize(forsyth_cache_size);
+            }
+            std::swap(cache, new_cache);
+        }
+
+        return result;
+    }
+
+    auto optimize_overdraw(std::span<const std::uint32_t> indices, std::span<const VertexData> vertices, float threshold)
+        -> std::vector<std::uint32_t>
+    {
+        ensure(indices.size() % 3u == 0u, "index count {} is not a triangle list", indices.size());
+
+        const auto triangle_count = indices.size() / 3u;
+        if (triangle_count == 0u)
+        {
+            return {};
+        }
+
+        // split into clusters wherever the cache order starts over, i.e. a triangle misses the cache for all vertices
+        constexpr auto cache_size = 16u;
+        auto cache_time = std::vector<std::uint32_t>(vertices.size(), 0u);
+        auto time = cache_size + 1u;
+
+        auto cluster_starts = std::vector<std::size_t>{};
+        for (auto t = 0u; t < triangle_count; ++t)
+        {
+            auto misses = 0u;
+            for (const auto v : indices.subspan(t * 3u, 3u))
+            {
+                if (time - cache_time[v] > cache_size)
+                {
+                    cache_time[v] = time++;
+                    ++misses;
+                }
+            }
+
+            if (t == 0u || misses == 3u)
+            {
+                cluster_starts.push_back(t);
+            }
+        }
+        cluster_starts.push_back(triangle_count);
+
+        auto mesh_centroid = Vector3{};
+        for (auto t = 0u; t < triangle_count; ++t)
+        {
+            mesh_centroid += triangle_centroid(vertices, indices.subspan(t * 3u, 3u));
+        }
+        mesh_centroid /= static_cast<float>(triangle_count);
+
+        struct Cluster
+        {
+            std::size_t begin;
+            std::size_t end;
+            float sort_key;
+        };
+
+        auto clusters = std::vector<Cluster>{};
+        for (auto i = 0u; i + 1u < cluster_starts.size(); ++i)
+        {
+            auto centroid = Vector3{};
+            auto normal = Vector3{};
+            for (auto t = cluster_starts[i]; t < cluster_starts[i + 1u]; ++t)
+            {
+                const auto triangle = indices.subspan(t * 3u, 3u);
+                centroid += triangle_centroid(vertices, triangle);
+                normal += triangle_normal(vertices, triangle);
+            }
+            centroid /= static_cast<float>(cluster_starts[i + 1u] - cluster_starts[i]);
+
+            // clusters facing away from the centre are likely to occlude the ones facing inwards, draw them first. The
+            // normals of a closed or back to back cluster cancel out, it faces nowhere and gets a neutral key, which
+            // also keeps NaN out of the sort
+            const auto length = normal.length();
+            const auto sort_key = length > std::numeric_limits<float>::min() ? Vector3::dot(centroid - mesh_centroid, normal / length) : 0.f;
+            clusters.push_back({cluster_starts[i], cluster_starts[i + 1u], std::isfinite(sort_key) ? sort_key : 0.f});
+        }
+
+        std::ranges::stable_sort(clusters, std::ranges::greater{}, &Cluster::sort_key);
+
+        auto result = std::vector<std::uint32_t>{};
+        result.reserve(indices.size());
+        for (const auto &cluster : clusters)
+        {
+            result.append_range(indices.subspan(cluster.begin * 3u, (cluster.end - cluster.begin) * 3u));
+        }
+
+        const auto before = analyze_vertex_cache(indices, vertices.size());
+        const auto after = analyze_vertex_cache(result, vertices.size());
+        if (after.acmr > before.acmr * threshold)
+        {
+            return indices | std::ranges::to<std::vector>();
+        }
+
+        return result;
+    }
+
+    auto optimize_vertex_fetch(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices) -> OptimizedMesh
+    {
+        constexpr auto unmapped = std::numeric_limits<std::uint32_t>::max();
+        auto remap = std::vector<std::uint32_t>(vertices.size(), unmapped);
+
+        auto mesh = OptimizedMesh{};
+        mesh.indices.reserve(indices.size());
+
+        for (const auto index : indices)
+        {
+            if (remap[index] == unmapped)
+            {
+                remap[index] = static_cast<std::uint32_t>(mesh.vertices.size());
+                mesh.vertices.push_back(vertices[index]);
+            }
+            mesh.indices.push_back(remap[index]);
+        }
+
+        return mesh;
+    }
+
+    auto optimize_mesh(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices) -> OptimizedMesh
+    {
+        const auto deduplicated = deduplicate_vertices(vertices, indices);
+        const auto cache_optimized = optimize_vertex_cache(deduplicated.indices, deduplicated.vertices.size());
+        const auto overdraw_optimized = optimize_overdraw(cache_optimized, deduplicated.vertices, 1.05f);
+
+        return optimize_vertex_fetch(deduplicated.vertices, overdraw_optimized);
+    }
+
+    auto analyze_vertex_cache(std::span<const std::uint32_t> indices, std::size_t vertex_count, std::size_t cache_size)
+        -> VertexCacheStatistics
+    {
+        // a fifo cache simulated with timestamps, a vertex is a hit if it was inserted less than cache_size misses ago
+        auto cache_time = std::vector<std::size_t>(vertex_count, 0u);
+        auto time = cache_size + 1u;
+        auto misses = 0u;
+
+        for (const auto index : indices)
+        {
+            if (time - cache_time[index] > cache_size)
+            {
+                cache_time[index] = time++;
+                ++misses;
+            }
+        }
+
+        const auto triangle_count = indices.size() / 3u;
+
+        return {
+            .vertices_transformed = misses,
+            .acmr = triangle_count == 0u ? 0.0f : static_cast<float>(misses) / static_cast<float>(triangle_count),
+            .atvr = vertex_count == 0u ? 0.0f : static_cast<float>(misses) / static_cast<float>(vertex_count)};
+    }
+
+    auto to_short_indices(std::span<const std::uint32_t> indices) -> std::optional<std::vector<std::uint16_t>>
+    {
+        if (std::ranges::any_of(indices, [](auto index)
+                                { return index > std::numeric_limits<std::uint16_t>::max(); }))
+        {
+            return std::nullopt;
+        }
+
+        return indices |
+               std::views::transform([](auto index)
+                                     { return static_cast<std::uint16_t>(index); }) |
+               std::ranges::to<std::vector>();
+    }
+
+    auto to_string(const VertexCacheStatistics &obj) -> std::string
+    {
+        return std::format("acmr={:.3f} atvr={:.3f} transformed={}", obj.acmr, obj.atvr, obj.vertices_transformed);
+    }
+}
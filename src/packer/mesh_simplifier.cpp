@@ -0,0 +1,375 @@
+#include "packer/mesh_simplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "packer/mesh_optimizer.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    /**
+     * Symmetric 4x4 matrix of the plane equation outer product, only the upper triangle is stored.
+     */
+    struct Quadric
+    {
+        double a2;
+        double ab;
+        double ac;
+        double ad;
+        double b2;
+        double bc;
+        double bd;
+        double c2;
+        double cd;
+        double d2;
+    };
+
+    auto operator+=(Quadric &q1, const Quadric &q2) -> Quadric &
+    {
+        q1.a2 += q2.a2;
+        q1.ab += q2.ab;
+        q1.ac += q2.ac;
+        q1.ad += q2.ad;
+        q1.b2 += q2.b2;
+        q1.bc += q2.bc;
+        q1.bd += q2.bd;
+        q1.c2 += q2.c2;
+        q1.cd += q2.cd;
+        q1.d2 += q2.d2;
+
+        return q1;
+    }
+
+    auto plane_quadric(const game::Vector3 &p0, const game::Vector3 &p1, const game::Vector3 &p2) -> Quadric
+    {
+        // a zero area triangle has no plane, it must not add NaN to the quadrics of its vertices
+        const auto cross = game::Vector3::cross(p1 - p0, p2 - p0);
+        const auto length = cross.length();
+        if (!(length > std::numeric_limits<float>::min()))
+        {
+            return {};
+        }
+
+        const auto normal = cross / length;
+
+        const auto a = static_cast<double>(normal.x);
+        const auto b = static_cast<double>(normal.y);
+        const auto c = static_cast<double>(normal.z);
+        const auto d = -static_cast<double>(game::Vector3::dot(normal, p0));
+
+        return {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d};
+    }
+
+    /**
+     * Sum of squared distances from a point to all planes accumulated in the quadric.
+     */
+    auto evaluate(const Quadric &q, const game::Vector3 &p) -> double
+    {
+        const auto x = static_cast<double>(p.x);
+        const auto y = static_cast<double>(p.y);
+        const auto z = static_cast<double>(p.z);
+
+        const auto error = q.a2 * x * x + 2.0 * q.ab * x * y + 2.0 * q.ac * x * z + 2.0 * q.ad * x +
+                           q.b2 * y * y + 2.0 * q.bc * y * z + 2.0 * q.bd * y +
+                           q.c2 * z * z + 2.0 * q.cd * z +
+                           q.d2;
+
+        // can dip below zero through rounding
+        return std::max(error, 0.0);
+    }
+
+    /**
+     * Map every vertex to the first vertex with the same position.
+     */
+    auto build_position_remap(std::span<const game::VertexData> vertices) -> std::vector<std::uint32_t>
+    {
+        auto unique = std::unordered_map<std::string_view, std::uint32_t>{};
+        unique.reserve(vertices.size());
+
+        auto remap = std::vector<std::uint32_t>(vertices.size());
+        for (auto i = 0u; i < vertices.size(); ++i)
+        {
+            const auto key = std::string_view{reinterpret_cast<const char *>(&vertices[i].position), sizeof(game::Vector3)};
+            remap[i] = unique.try_emplace(key, i).first->second;
+        }
+
+        return remap;
+    }
+
+    /**
+     * Vertices that must not move: attribute seams (more than one vertex at the same position) and vertices on an edge
+     * that is not shared by exactly two triangles.
+     */
+    auto find_locked_vertices(std::span<const std::uint32_t> indices, std::span<const std::uint32_t> position_remap)
+        -> std::vector<bool>
+    {
+        auto locked = std::vector<bool>(position_remap.size(), false);
+
+        auto vertices_at_position = std::vector<std::uint32_t>(position_remap.size(), 0u);
+        for (auto i = 0u; i < position_remap.size(); ++i)
+        {
+            ++vertices_at_position[position_remap[i]];
+        }
+
+        auto edge_count = std::unordered_map<std::uint64_t, std::uint32_t>{};
+        for (auto i = 0u; i < indices.size(); i += 3u)
+        {
+            for (auto e = 0u; e < 3u; ++e)
+            {
+                const auto p0 = position_remap[indices[i + e]];
+                const auto p1 = position_remap[indices[i + (e + 1u) % 3u]];
+                ++edge_count[(static_cast<std::uint64_t>(std::min(p0, p1)) << 32u) | std::max(p0, p1)];
+            }
+        }
+
+        auto position_locked = std::vector<bool>(position_remap.size(), false);
+        for (const auto &[edge, count] : edge_count)
+        {
+            if (count != 2u)
+            {
+                position_locked[static_cast<std::uint32_t>(edge >> 32u)] = true;
+                position_locked[static_cast<std::uint32_t>(edge & 0xffffffffu)] = true;
+            }
+        }
+
+        for (auto i = 0u; i < position_remap.size(); ++i)
+        {
+            const auto position = position_remap[i];
+            locked[i] = vertices_at_position[position] > 1u || position_locked[position];
+        }
+
+        return locked;
+    }
+
+    /**
+     * Check if moving one corner of a triangle onto a new position would flip it.
+     */
+    auto flips(
+        std::span<const game::VertexData> vertices,
+        std::span<const std::uint32_t> triangle,
+        std::uint32_t from,
+        std::uint32_t to) -> bool
+    {
+        const auto &p0 = vertices[triangle[0]].position;
+        const auto &p1 = vertices[triangle[1]].position;
+        const auto &p2 = vertices[triangle[2]].position;
+        const auto before = game::Vector3::cross(p1 - p0, p2 - p0);
+
+        const auto &q0 = vertices[triangle[0] == from ? to : triangle[0]].position;
+        const auto &q1 = vertices[triangle[1] == from ? to : triangle[1]].position;
+        const auto &q2 = vertices[triangle[2] == from ? to : triangle[2]].position;
+        const auto after = game::Vector3::cross(q1 - q0, q2 - q0);
+
+        return game::Vector3::dot(before, after) <= 0.f;
+    }
+
+    struct Collapse
+    {
+        std::uint32_t from;
+        std::uint32_t to;
+        double cost;
+    };
+}
+
+namespace game::packer
+{
+    auto simplify_mesh(
+        std::span<const VertexData> vertices,
+        std::span<const std::uint32_t> indices,
+        std::size_t target_index_count,
+        float target_error) -> SimplifiedMesh
+    {
+        ensure(indices.size() % 3u == 0u, "index count {} is not a triangle list", indices.size());
+
+        const auto position_remap = build_position_remap(vertices);
+        const auto locked = find_locked_vertices(indices, position_remap);
+
+        // quadrics are accumulated per position so that seam vertices share them
+        auto quadrics = std::vector<Quadric>(vertices.size(), Quadric{});
+        for (auto i = 0u; i < indices.size(); i += 3u)
+        {
+            const auto quadric = plane_quadric(vertices[indices[i]].position, vertices[indices[i + 1u]].position, vertices[indices[i + 2u]].position);
+            for (auto corner = 0u; corner < 3u; ++corner)
+            {
+                quadrics[position_remap[indices[i + corner]]] += quadric;
+            }
+        }
+
+        const auto max_cost = static_cast<double>(target_error) * static_cast<double>(target_error);
+        auto max_collapsed_cost = 0.0;
+        auto result = std::vector<std::uint32_t>(std::ranges::cbegin(indices), std::ranges::cend(indices));
+
+        // every pass collapses an independent set of the cheapest edges, then rebuilds the triangle list
+        while (result.size() > target_index_count)
+        {
+            auto adjacency_offsets = std::vector<std::uint32_t>(vertices.size() + 1u, 0u);
+            for (const auto index : result)
+            {
+                ++adjacency_offsets[index + 1u];
+            }
+            std::partial_sum(std::ranges::cbegin(adjacency_offsets), std::ranges::cend(adjacency_offsets), std::ranges::begin(adjacency_offsets));
+
+            auto adjacency = std::vector<std::uint32_t>(result.size());
+            auto fill = std::vector<std::uint32_t>(std::ranges::cbegin(adjacency_offsets), std::ranges::cend(adjacency_offsets) - 1);
+            for (auto i = 0u; i < result.size(); ++i)
+            {
+                adjacency[fill[result[i]]++] = i / 3u;
+            }
+
+            auto collapses = std::vector<Collapse>{};
+            for (auto i = 0u; i < result.size(); i += 3u)
+            {
+                for (auto e = 0u; e < 3u; ++e)
+                {
+                    const auto v0 = result[i + e];
+                    const auto v1 = result[i + (e + 1u) % 3u];
+
+                    for (const auto &[from, to] : {std::pair{v0, v1}, std::pair{v1, v0}})
+                    {
+                        if (locked[from])
+                        {
+                            continue;
+                        }
+
+                        const auto cost = evaluate(quadrics[position_remap[from]], vertices[to].position);
+                        if (cost <= max_cost)
+                        {
+                            collapses.push_back({from, to, cost});
+                        }
+                    }
+                }
+            }
+
+            std::ranges::sort(collapses, {}, &Collapse::cost);
+
+            auto collapse_remap = std::vector<std::uint32_t>(vertices.size());
+            std::iota(std::ranges::begin(collapse_remap), std::ranges::end(collapse_remap), 0u);
+            auto touched = std::vector<bool>(vertices.size(), false);
+            auto removed_index_count = 0u;
+            auto collapsed = false;
+
+            for (const auto &[from, to, cost] : collapses)
+            {
+                if (result.size() - removed_index_count <= target_index_count)
+                {
+                    break;
+                }
+
+                if (touched[from] || touched[to])
+                {
+                    continue;
+                }
+
+                const auto triangles = std::span{adjacency}.subspan(adjacency_offsets[from], adjacency_offsets[from + 1u] - adjacency_offsets[from]);
+                const auto triangle_at = [&result](auto triangle)
+                { return std::span<const std::uint32_t>{result}.subspan(triangle * 3u, 3u); };
+
+                const auto would_flip = std::ranges::any_of(triangles, [&](auto triangle)
+                                                            {
+                                                                const auto corners = triangle_at(triangle);
+                                                                return !std::ranges::contains(corners, to) && flips(vertices, corners, from, to); });
+                if (would_flip)
+                {
+                    continue;
+                }
+
+                // nothing around this collapse may move again in this pass, so the flip checks stay valid
+                for (const auto triangle : triangles)
+                {
+                    const auto corners = triangle_at(triangle);
+                    for (const auto corner : corners)
+                    {
+                        touched[corner] = true;
+                    }
+
+                    if (std::ranges::contains(corners, to))
+                    {
+                        removed_index_count += 3u;
+                    }
+                }
+                touched[to] = true;
+
+                collapse_remap[from] = to;
+                quadrics[position_remap[to]] += quadrics[position_remap[from]];
+                max_collapsed_cost = std::max(max_collapsed_cost, cost);
+                collapsed = true;
+            }
+
+            if (!collapsed)
+            {
+                break;
+            }
+
+            auto simplified = std::vector<std::uint32_t>{};
+            simplified.reserve(result.size() - removed_index_count);
+            for (auto i = 0u; i < result.size(); i += 3u)
+            {
+                const auto i0 = collapse_remap[result[i]];
+                const auto i1 = collapse_remap[result[i + 1u]];
+                const auto i2 = collapse_remap[result[i + 2u]];
+
+                if (i0 != i1 && i1 != i2 && i0 != i2)
+                {
+                    simplified.append_range(std::array{i0, i1, i2});
+                }
+            }
+
+            result = std::move(simplified);
+        }
+
+        return {.indices = std::move(result), .error = static_cast<float>(std::sqrt(max_collapsed_cost))};
+    }
+
+    auto generate_lod_chain(std::span<const VertexData> vertices, std::span<const std::uint32_t> indices, std::size_t max_levels)
+        -> std::vector<SimplifiedMesh>
+    {
+        if (indices.empty())
+        {
+            return {};
+        }
+
+        // the error allowed for the coarsest level is relative to the size of the mesh
+        auto min = vertices[indices.front()].position;
+        auto max = min;
+        for (const auto index : indices)
+        {
+            const auto &position = vertices[index].position;
+            min = {std::min(min.x, position.x), std::min(min.y, position.y), std::min(min.z, position.z)};
+            max = {std::max(max.x, position.x), std::max(max.y, position.y), std::max(max.z, position.z)};
+        }
+        const auto max_error = (max - min).length() * 0.05f;
+
+        auto levels = std::vector<SimplifiedMesh>{};
+        auto previous_index_count = indices.size();
+
+        for (auto level = 0u; level < max_levels; ++level)
+        {
+            const auto target_index_count = (previous_index_count / 6u) * 3u;
+            auto simplified = simplify_mesh(vertices, indices, target_index_count, max_error);
+
+            if (simplified.indices.empty() || simplified.indices.size() * 5u > previous_index_count * 4u)
+            {
+                break;
+            }
+
+            simplified.indices = optimize_vertex_cache(simplified.indices, vertices.size());
+            previous_index_count = simplified.indices.size();
+            levels.push_back(std::move(simplified));
+        }
+
+        return levels;
+    }
+}
@@ -0,0 +1,109 @@
+#include "packer/mip_chain.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "packer/srgb.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    /**
+     * A mip level with unquantised channels, colour channels of sRGB images are stored linear.
+     */
+    struct FloatLevel
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        std::vector<float> data;
+    };
+
+    auto downsample(const FloatLevel &level) -> FloatLevel
+    {
+        const auto width = std::max(level.width / 2u, 1u);
+        const auto height = std::max(level.height / 2u, 1u);
+
+        auto data = std::vector<float>(static_cast<std::size_t>(width) * height * 4u);
+
+        for (auto y = 0u; y < height; ++y)
+        {
+            const auto y0 = std::min(y * 2u, level.height - 1u);
+            const auto y1 = std::min(y * 2u + 1u, level.height - 1u);
+
+            for (auto x = 0u; x < width; ++x)
+            {
+                const auto x0 = std::min(x * 2u, level.width - 1u);
+                const auto x1 = std::min(x * 2u + 1u, level.width - 1u);
+
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    const auto sample = [&](std::uint32_t sx, std::uint32_t sy)
+                    { return level.data[(static_cast<std::size_t>(sy) * level.width + sx) * 4u + c]; };
+
+                    const auto sum = sample(x0, y0) + sample(x1, y0) + sample(x0, y1) + sample(x1, y1);
+                    data[(static_cast<std::size_t>(y) * width + x) * 4u + c] = sum / 4.f;
+                }
+            }
+        }
+
+        return {.width = width, .height = height, .data = std::move(data)};
+    }
+
+    auto encode(const FloatLevel &level, bool srgb) -> game::packer::MipLevel
+    {
+        auto data = std::vector<std::byte>(level.data.size());
+        for (auto i = 0u; i < data.size(); ++i)
+        {
+            const auto value = srgb && i % 4u < 3u ? game::packer::linear_to_srgb(level.data[i]) : level.data[i];
+            data[i] = static_cast<std::byte>(std::lround(std::clamp(value, 0.f, 1.f) * 255.f));
+        }
+
+        return {.width = level.width, .height = level.height, .data = std::move(data)};
+    }
+}
+
+namespace game::packer
+{
+    auto mip_level_count(std::uint32_t width, std::uint32_t height) -> std::uint32_t
+    {
+        return static_cast<std::uint32_t>(std::bit_width(std::max(width, height)));
+    }
+
+    auto generate_mip_chain(std::span<const std::byte> rgba, std::uint32_t width, std::uint32_t height, bool srgb) -> std::vector<MipLevel>
+    {
+        ensure(rgba.size() == static_cast<std::size_t>(width) * height * 4u, "image data does not match dimensions {}x{}", width, height);
+
+        auto levels = std::vector<MipLevel>{};
+        levels.push_back({.width = width, .height = height, .data = {std::ranges::cbegin(rgba), std::ranges::cend(rgba)}});
+
+        auto to_linear = std::array<float, 256u>{};
+        for (auto i = 0u; i < to_linear.size(); ++i)
+        {
+            to_linear[i] = srgb ? srgb_to_linear(static_cast<float>(i) / 255.f) : static_cast<float>(i) / 255.f;
+        }
+
+        // keep filtering the unquantised level so rounding errors do not accumulate down the chain
+        auto current = FloatLevel{.width = width, .height = height, .data = std::vector<float>(rgba.size())};
+        for (auto i = 0u; i < rgba.size(); ++i)
+        {
+            const auto value = std::to_integer<std::uint32_t>(rgba[i]);
+            current.data[i] = i % 4u < 3u ? to_linear[value] : static_cast<float>(value) / 255.f;
+        }
+
+        const auto count = mip_level_count(width, height);
+        while (levels.size() < count)
+        {
+            current = downsample(current);
+            levels.push_back(encode(current, srgb));
+        }
+
+        return levels;
+    }
+}
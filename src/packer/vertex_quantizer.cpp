@@ -0,0 +1,88 @@
+#include "packer/vertex_quantizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <ranges>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "graphics/compact_vertex_data.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    auto angle_between(const game::Vector3 &a, const game::Vector3 &b) -> float
+    {
+        if (a.length() == 0.f || b.length() == 0.f)
+        {
+            // missing normals/tangents decode to an arbitrary direction, which is fine as they were never defined
+            return 0.f;
+        }
+
+        const auto cos_angle = std::clamp(game::Vector3::dot(game::Vector3::normalize(a), game::Vector3::normalize(b)), -1.f, 1.f);
+        return std::acos(cos_angle) * 180.f / std::numbers::pi_v<float>;
+    }
+
+    auto half_extent(float min, float max) -> float
+    {
+        // flat axes still need a non zero scale to be decodable
+        const auto extent = (max - min) * 0.5f;
+        return extent > 0.f ? extent : 1.f;
+    }
+}
+
+namespace game::packer
+{
+    auto quantize_vertices(std::span<const VertexData> vertices) -> QuantizedVertices
+    {
+        ensure(!vertices.empty(), "cannot quantize empty vertex data");
+
+        auto min = vertices.front().position;
+        auto max = vertices.front().position;
+        for (const auto &vertex : vertices)
+        {
+            min = {std::min(min.x, vertex.position.x), std::min(min.y, vertex.position.y), std::min(min.z, vertex.position.z)};
+            max = {std::max(max.x, vertex.position.x), std::max(max.y, vertex.position.y), std::max(max.z, vertex.position.z)};
+        }
+
+        const auto quantization = VertexQuantization{
+            .scale = {half_extent(min.x, max.x), half_extent(min.y, max.y), half_extent(min.z, max.z)},
+            .bias = (min + max) * 0.5f};
+
+        return {
+            .vertices = vertices |
+                        std::views::transform([&quantization](const auto &vertex)
+                                              { return compact_vertex(vertex, quantization); }) |
+                        std::ranges::to<std::vector>(),
+            .quantization = quantization};
+    }
+
+    auto measure_quantization_error(std::span<const VertexData> vertices, const QuantizedVertices &quantized) -> QuantizationError
+    {
+        ensure(vertices.size() == quantized.vertices.size(), "vertex count mismatch");
+
+        auto error = QuantizationError{.position = 0.f, .direction = 0.f, .uv = 0.f};
+
+        for (auto i = 0u; i < vertices.size(); ++i)
+        {
+            const auto &source = vertices[i];
+            const auto decoded = expand_vertex(quantized.vertices[i], quantized.quantization);
+
+            error.position = std::max(error.position, Vector3::distance(source.position, decoded.position));
+            error.direction = std::max({error.direction, angle_between(source.normal, decoded.normal), angle_between(source.tangent, decoded.tangent)});
+            error.uv = std::max({error.uv, std::abs(source.uv.u - decoded.uv.u), std::abs(source.uv.v - decoded.uv.v)});
+        }
+
+        return error;
+    }
+
+    auto to_string(const QuantizationError &obj) -> std::string
+    {
+        return std::format("position={:.6f} direction={:.4f}deg uv={:.6f}", obj.position, obj.direction, obj.uv);
+    }
+}
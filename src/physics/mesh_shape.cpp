@@ -1,5 +1,6 @@
 #include "physics/mesh_shape.h"
 
+#include <cstddef>
 #include <format>
 #include <ranges>
 #include <string>
@@ -21,16 +22,20 @@ namespace
     auto create_mesh_shape(game::MeshData mesh_data, float scale = {1.f}) -> ::JPH::Ref<::JPH::Shape>
     {
         auto jolt_vertex_list =
-            mesh_data.vertices |
-            std::views::transform([scale](const auto &e)
-                                  { return ::JPH::Float3{e.position.x * scale, e.position.y * scale, e.position.z * scale}; }) |
+            std::views::iota(std::size_t{}, mesh_data.vertex_count()) |
+            std::views::transform([&mesh_data, scale](auto index)
+                                  {
+                                      const auto position = mesh_data.position(index);
+                                      return ::JPH::Float3{position.x * scale, position.y * scale, position.z * scale}; }) |
             std::ranges::to<::JPH::VertexList>();
 
         auto jolt_index_list =
-            mesh_data.indices |
-            std::views::chunk(3u) |
-            std::views::transform([](const auto &e)
-                                  { return ::JPH::IndexedTriangle{e[0], e[1], e[2]}; }) |
+            std::views::iota(std::size_t{}, mesh_data.index_count() / 3u) |
+            std::views::transform([&mesh_data](auto triangle)
+                                  { return ::JPH::IndexedTriangle{
+                                        mesh_data.index(triangle * 3u),
+                                        mesh_data.index(triangle * 3u + 1u),
+                                        mesh_data.index(triangle * 3u + 2u)}; }) |
             std::ranges::to<::JPH::IndexedTriangleList>();
 
         auto settings = ::JPH::MeshShapeSettings{jolt_vertex_list, jolt_index_list};
@@ -4,11 +4,13 @@
 
 #include "file.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <memory>
 #include <string_view>
+#include <utility>
 
 #ifndef WIN32
 #include <errno.h>
@@ -79,28 +81,6 @@ namespace game
         ensure(_map_view.get() != MAP_FAILED, "failed to map file");
 
         _mapped = true;
-
-        // int linuxHint = 0;
-        // switch (_hint)
-        // {
-        // case Normal:
-        //     linuxHint = MADV_NORMAL;
-        //     break;
-        // case SequentialScan:
-        //     linuxHint = MADV_SEQUENTIAL;
-        //     break;
-        // case RandomAccess:
-        //     linuxHint = MADV_RANDOM;
-        //     break;
-        // default:
-        //     break;
-        // }
-        // // assume that file will be accessed soon
-        // // linuxHint |= MADV_WILLNEED;
-        // // assume that file will be large
-        // // linuxHint |= MADV_HUGEPAGE;
-
-        // ::madvise(_map_view, 0, linuxHint);
     }
 
     auto File::as_string() const -> std::string_view
@@ -113,6 +93,44 @@ namespace game
         return {reinterpret_cast<const std::byte *>(_map_view.get()), _filesize};
     }
 
+    auto File::advise(AccessHint hint, std::size_t offset, std::size_t length) const -> void
+    {
+        if (offset >= _filesize)
+        {
+            return;
+        }
+
+        auto advice = MADV_NORMAL;
+        switch (hint)
+        {
+            using enum AccessHint;
+        case NORMAL:
+            advice = MADV_NORMAL;
+            break;
+        case SEQUENTIAL:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case RANDOM:
+            advice = MADV_RANDOM;
+            break;
+        case WILL_NEED:
+            advice = MADV_WILLNEED;
+            break;
+        }
+
+        // madvise wants a page aligned start
+        static const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        const auto start = offset & ~(page_size - 1u);
+        const auto end = offset + std::min(length, _filesize - offset);
+
+        auto *view = static_cast<std::byte *>(_map_view.get());
+        if (::madvise(view + start, end - start, advice) != 0)
+        {
+            auto e = errno;
+            log::warn("madvise {} failed: {}", std::to_underlying(hint), e);
+        }
+    }
+
     auto File::get_file_size() -> void
     {
         struct stat64 statInfo;
@@ -11,6 +11,7 @@
 #include "math/matrix4.h"
 #include "math/quaternion.h"
 #include "math/vector3.h"
+#include "utils/ensure.h"
 
 namespace game
 {
@@ -34,6 +35,8 @@ namespace game
           _collision_mask(collision_mask),
           _static_collider{std::move(static_collider)}
     {
+        // fail on load rather than on the first draw
+        ensure(!_mesh->is_compact() || _material->supports_compact_vertices(), "material cannot draw compact vertices");
     }
 
     Entity::Entity(const Mesh *mesh,
@@ -58,6 +61,9 @@ namespace game
           _static_collider{std::move(static_collider)}
     {
         _transform.rotation = _local_transform.rotation;
+
+        // fail on load rather than on the first draw
+        ensure(!_mesh->is_compact() || _material->supports_compact_vertices(), "material cannot draw compact vertices");
     }
 
     auto Entity::mesh() const -> const Mesh *
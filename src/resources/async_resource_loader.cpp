@@ -0,0 +1,134 @@
+#include "resources/async_resource_loader.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "file.h"
+#include "log.h"
+#include "resources/pack.h"
+#include "resources/resource_loader.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    // stride used to touch every page of a mapping
+    constexpr auto page_size = 4096u;
+
+    // only there so the reads in page_in cannot be optimised away
+    auto page_in_checksum = std::atomic<std::uint64_t>{};
+
+    /**
+     * Fault in every page of a mapping, so the worker takes the faults instead of whoever reads the mapping next.
+     */
+    auto page_in(std::span<const std::byte> bytes) -> void
+    {
+        auto checksum = std::uint64_t{};
+        for (auto offset = std::size_t{}; offset < bytes.size(); offset += page_size)
+        {
+            checksum += static_cast<std::uint64_t>(bytes[offset]);
+        }
+
+        page_in_checksum.fetch_add(checksum, std::memory_order_relaxed);
+    }
+}
+
+namespace game
+{
+    AsyncResourceLoader::AsyncResourceLoader(const ResourceLoader &loader, std::uint32_t thread_count)
+        : _loader{loader},
+          _mutex{},
+          _jobs_available{},
+          _jobs{},
+          _workers{}
+    {
+        ensure(thread_count > 0u, "need at least one loader thread");
+
+        for (auto i = 0u; i < thread_count; ++i)
+        {
+            _workers.emplace_back([this](std::stop_token stop)
+                                  { run_worker(stop); });
+        }
+    }
+
+    AsyncResourceLoader::~AsyncResourceLoader() = default;
+
+    auto AsyncResourceLoader::load(std::string_view name) -> LoadHandle<File>
+    {
+        return submit<File>(name, [this, name = std::string{name}]
+                            {
+                                // constructed in place, a File must not be moved once it is mapped
+                                auto file = std::unique_ptr<File>{new File{_loader.load(name)}};
+                                page_in(file->as_bytes());
+                                return file; });
+    }
+
+    auto AsyncResourceLoader::load_pack(std::string_view name) -> LoadHandle<Pack>
+    {
+        return submit<Pack>(name, [this, name = std::string{name}]
+                            {
+                                auto pack = std::make_unique<Pack>(_loader, name);
+                                if (pack->is_mapped())
+                                {
+                                    page_in(pack->as_bytes());
+                                }
+                                return pack; });
+    }
+
+    auto AsyncResourceLoader::prefetch(std::string_view name, std::size_t offset, std::size_t length) -> void
+    {
+        enqueue([this, name = std::string{name}, offset, length]
+                {
+                    try
+                    {
+                        // the kernel reads the range in on its own, the pages stay cached after the file is closed
+                        const auto file = _loader.load(name);
+                        file.advise(AccessHint::WILL_NEED, offset, length);
+                    }
+                    catch (const Exception &err)
+                    {
+                        log::warn("could not prefetch {}: {}", name, err);
+                    } });
+    }
+
+    auto AsyncResourceLoader::enqueue(std::move_only_function<void()> job) -> void
+    {
+        {
+            const auto lock = std::scoped_lock{_mutex};
+            _jobs.push_back(std::move(job));
+        }
+
+        _jobs_available.notify_one();
+    }
+
+    auto AsyncResourceLoader::run_worker(std::stop_token stop) -> void
+    {
+        while (!stop.stop_requested())
+        {
+            auto job = std::move_only_function<void()>{};
+
+            {
+                auto lock = std::unique_lock{_mutex};
+                if (!_jobs_available.wait(lock, stop, [this]
+                                          { return !_jobs.empty(); }))
+                {
+                    return;
+                }
+
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+
+            job();
+        }
+    }
+}
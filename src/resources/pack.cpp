@@ -0,0 +1,117 @@
+#include "resources/pack.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "file.h"
+#include "resources/resource_loader.h"
+#include "tlv/tlv_sink.h"
+#include "utils/compress.h"
+#include "utils/decompress.h"
+#include "utils/exception.h"
+
+namespace
+{
+    // large enough to keep the ratio close to a single frame, small enough to give every core some work
+    constexpr auto chunk_size = std::size_t{1024u * 1024u};
+
+    // zstd's default level, the chunked modes only differ from it in how they are split
+    constexpr auto default_level = 3;
+    constexpr auto chunked_level = default_level;
+    constexpr auto fast_level = -5;
+}
+
+namespace game
+{
+    auto encode_pack(std::span<const std::byte> tlv, PackMode mode) -> std::vector<std::byte>
+    {
+        switch (mode)
+        {
+            using enum PackMode;
+        case ZSTD:
+            return compress(tlv);
+        case ZSTD_CHUNKED:
+            return compress_chunked(tlv, chunk_size, chunked_level);
+        case ZSTD_FAST:
+            return compress_chunked(tlv, chunk_size, fast_level);
+        case RAW:
+            return {std::ranges::cbegin(tlv), std::ranges::cend(tlv)};
+        }
+
+        throw Exception("unknown pack mode {}", std::to_underlying(mode));
+    }
+
+    auto create_pack_sink(const std::filesystem::path &path, PackMode mode) -> std::unique_ptr<TlvSink>
+    {
+        switch (mode)
+        {
+            using enum PackMode;
+        case ZSTD:
+            return std::make_unique<CompressedFileSink>(path, default_level);
+        case ZSTD_CHUNKED:
+            return std::make_unique<CompressedFileSink>(path, chunked_level, chunk_size);
+        case ZSTD_FAST:
+            return std::make_unique<CompressedFileSink>(path, fast_level, chunk_size);
+        case RAW:
+            return std::make_unique<FileSink>(path);
+        }
+
+        throw Exception("unknown pack mode {}", std::to_underlying(mode));
+    }
+
+    Pack::Pack(const ResourceLoader &loader, std::string_view name)
+        : _file{loader.load(name)},
+          _decompressed{}
+    {
+        if (is_compressed(_file.as_bytes()))
+        {
+            // the compressed file is read front to back exactly once
+            _file.advise(AccessHint::SEQUENTIAL);
+            _decompressed = decompress(_file.as_bytes());
+        }
+    }
+
+    auto Pack::as_bytes() const -> std::span<const std::byte>
+    {
+        return is_mapped() ? _file.as_bytes() : std::span<const std::byte>{_decompressed};
+    }
+
+    auto Pack::is_mapped() const -> bool
+    {
+        return !is_compressed(_file.as_bytes());
+    }
+
+    auto Pack::advise(AccessHint hint) const -> void
+    {
+        if (is_mapped())
+        {
+            _file.advise(hint);
+        }
+    }
+
+    auto to_string(PackMode obj) -> std::string
+    {
+        switch (obj)
+        {
+            using enum PackMode;
+        case ZSTD:
+            return "ZSTD";
+        case ZSTD_CHUNKED:
+            return "ZSTD_CHUNKED";
+        case ZSTD_FAST:
+            return "ZSTD_FAST";
+        case RAW:
+            return "RAW";
+        default:
+            return std::format("{}", std::to_underlying(obj));
+        }
+    }
+}
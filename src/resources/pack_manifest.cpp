@@ -0,0 +1,112 @@
+#include "resources/pack_manifest.h"
+
+#include <algorithm>
+#include <format>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto split_words(std::string_view line) -> std::vector<std::string_view>
+    {
+        return line |
+               std::views::split(' ') |
+               std::views::transform([](const auto &word)
+                                     { return std::string_view{word}; }) |
+               std::views::filter([](const auto &word)
+                                  { return !word.empty(); }) |
+               std::ranges::to<std::vector>();
+    }
+
+    // a name has to read back as a single word that does not start a comment
+    auto ensure_writable(std::string_view name) -> void
+    {
+        game::ensure(!name.empty() && !name.starts_with('#') && !name.contains(' ') && !name.contains('\n') && !name.contains('\r'),
+                     "'{}' cannot be written to a manifest", name);
+    }
+}
+
+namespace game
+{
+    auto PackManifest::level_pack(std::string_view level_name) const -> std::optional<std::string>
+    {
+        const auto pack = level_packs.find(level_name);
+        if (pack == std::ranges::cend(level_packs))
+        {
+            return std::nullopt;
+        }
+
+        return pack->second;
+    }
+
+    auto parse_pack_manifest(std::string_view text) -> PackManifest
+    {
+        auto manifest = PackManifest{};
+
+        auto line_num = 0u;
+        for (const auto line : text | std::views::split('\n'))
+        {
+            ++line_num;
+
+            auto line_view = std::string_view{line};
+            if (line_view.ends_with('\r'))
+            {
+                line_view.remove_suffix(1u);
+            }
+
+            const auto words = split_words(line_view);
+            if (words.empty() || words.front().starts_with('#'))
+            {
+                continue;
+            }
+
+            if (words.front() == "base")
+            {
+                ensure(words.size() == 2u, "manifest line {}: expected 'base <pack>'", line_num);
+                manifest.base = words[1];
+            }
+            else if (words.front() == "level")
+            {
+                ensure(words.size() == 3u, "manifest line {}: expected 'level <level script> <pack>'", line_num);
+
+                const auto [iter, inserted] = manifest.level_packs.emplace(words[1], words[2]);
+                ensure(inserted, "manifest line {}: level {} already has a pack", line_num, words[1]);
+            }
+            else
+            {
+                throw Exception("manifest line {}: unknown statement '{}'", line_num, words.front());
+            }
+        }
+
+        return manifest;
+    }
+
+    auto write_pack_manifest(const PackManifest &manifest) -> std::string
+    {
+        ensure_writable(manifest.base);
+        auto text = std::format("base {}\n", manifest.base);
+
+        auto level_names = manifest.level_packs |
+                           std::views::keys |
+                           std::ranges::to<std::vector>();
+        std::ranges::sort(level_names);
+
+        for (const auto &level_name : level_names)
+        {
+            const auto &pack = manifest.level_packs.find(level_name)->second;
+            ensure_writable(level_name);
+            ensure_writable(pack);
+
+            std::format_to(std::back_inserter(text), "level {} {}\n", level_name, pack);
+        }
+
+        return text;
+    }
+}
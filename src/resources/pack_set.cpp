@@ -0,0 +1,110 @@
+#include "resources/pack_set.h"
+
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "file.h"
+#include "log.h"
+#include "resources/pack.h"
+#include "resources/pack_manifest.h"
+#include "resources/resource_loader.h"
+#include "tlv/tlv_reader.h"
+#include "utils/ensure.h"
+
+namespace
+{
+    auto load_manifest(const game::ResourceLoader &loader, std::string_view manifest_name) -> game::PackManifest
+    {
+        if (!loader.exists(manifest_name))
+        {
+            return {};
+        }
+
+        return game::parse_pack_manifest(loader.load(manifest_name).as_string());
+    }
+}
+
+namespace game
+{
+    PackSet::MountedPack::MountedPack(std::string_view name, std::unique_ptr<Pack> pack)
+        : name{name},
+          pack{std::move(pack)},
+          reader{this->pack->as_bytes()}
+    {
+    }
+
+    PackSet::PackSet(const ResourceLoader &loader, std::string_view manifest_name)
+        : _loader{loader},
+          _manifest{load_manifest(loader, manifest_name)},
+          _packs{}
+    {
+        mount(_manifest.base);
+    }
+
+    auto PackSet::manifest() const -> const PackManifest &
+    {
+        return _manifest;
+    }
+
+    auto PackSet::base() const -> const TlvReader &
+    {
+        return _packs.front()->reader;
+    }
+
+    auto PackSet::mount(std::string_view name) -> const TlvReader &
+    {
+        if (is_mounted(name))
+        {
+            return mount(name, nullptr);
+        }
+
+        return mount(name, std::make_unique<Pack>(_loader, name));
+    }
+
+    auto PackSet::mount(std::string_view name, std::unique_ptr<Pack> pack) -> const TlvReader &
+    {
+        const auto mounted = std::ranges::find(_packs, name, [](const auto &p)
+                                               { return std::string_view{p->name}; });
+        if (mounted != std::ranges::end(_packs))
+        {
+            return (*mounted)->reader;
+        }
+
+        expect(pack != nullptr, "no pack to mount as {}", name);
+
+        const auto &mounted_pack = _packs.emplace_back(std::make_unique<MountedPack>(name, std::move(pack)));
+        log::info("mounted pack {} ({} bytes, {})", name, mounted_pack->pack->as_bytes().size(), mounted_pack->pack->is_mapped() ? "mapped" : "decompressed");
+
+        return mounted_pack->reader;
+    }
+
+    auto PackSet::unmount(std::string_view name) -> void
+    {
+        expect(name != _manifest.base, "cannot unmount the base pack {}", name);
+
+        const auto removed = std::erase_if(_packs, [name](const auto &p)
+                                           { return p->name == name; });
+        if (removed != 0u)
+        {
+            log::info("unmounted pack {}", name);
+        }
+    }
+
+    auto PackSet::is_mounted(std::string_view name) const -> bool
+    {
+        return std::ranges::contains(_packs, name, [](const auto &p)
+                                     { return std::string_view{p->name}; });
+    }
+
+    auto PackSet::advise(AccessHint hint) const -> void
+    {
+        for (const auto &mounted : _packs)
+        {
+            mounted->pack->advise(hint);
+        }
+    }
+}
@@ -25,4 +25,9 @@ namespace game
         return {_root / name};
     }
 
+    auto ResourceLoader::exists(std::string_view name) const -> bool
+    {
+        return std::filesystem::is_regular_file(_root / name);
+    }
+
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <deque>
+#include <functional>
 #include <optional>
 #include <ranges>
 
@@ -76,6 +77,15 @@ namespace game
         { return _state == state || _state == GameState::EXITING; };
     }
 
+    auto Scheduler::reschedule(std::coroutine_handle<> handle, std::move_only_function<bool()> check_resume) -> void
+    {
+        auto task = std::ranges::find_if(_queue, [handle](const auto &e)
+                                         { return e.task.has_handle(handle); });
+        expect(task != std::ranges::end(_queue), "could not find task");
+
+        task->check_resume = std::move(check_resume);
+    }
+
     auto Scheduler::run() -> void
     {
         while (!_queue.empty())
@@ -1,6 +1,10 @@
 #include "scripting/script_loader.h"
 
+#include <memory>
+#include <string>
+
 #include "file.h"
+#include "resources/async_resource_loader.h"
 #include "tlv/tlv_reader.h"
 
 namespace game
@@ -32,4 +36,11 @@ namespace game
         const auto file = File{_name};
         return std::string{file.as_string()};
     }
+
+    auto ScriptLoader::load(AsyncResourceLoader &loader) const -> LoadHandle<std::string>
+    {
+        // loose scripts are named by their path, not relative to the resource root, so not loader.load()
+        return loader.submit<std::string>(_name, [script_loader = *this]
+                                          { return std::make_unique<std::string>(script_loader.load()); });
+    }
 }
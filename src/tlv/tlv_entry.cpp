@@ -4,9 +4,12 @@
 #include <cstdint>
 #include <cstring>
 #include <format>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "graphics/mesh.h"
 #include "graphics/texture.h"
@@ -18,8 +21,16 @@ using namespace std::literals;
 namespace game
 {
     TlvEntry::TlvEntry(TlvType type, std::span<const std::byte> value)
+        : TlvEntry{type, value, {.version = TlvVersion::V1, .alignment = 1u}, sizeof(TlvType) + sizeof(std::uint32_t) + value.size()}
+    {
+    }
+
+    TlvEntry::TlvEntry(TlvType type, std::span<const std::byte> value, TlvFormat format, std::uint64_t size, std::span<const std::byte> pack)
         : _type{type},
-          _value(value)
+          _value(value),
+          _format{format},
+          _size{size},
+          _pack{pack}
     {
     }
 
@@ -28,9 +39,9 @@ namespace game
         return _type;
     }
 
-    auto TlvEntry::length() const -> std::uint32_t
+    auto TlvEntry::length() const -> std::uint64_t
     {
-        return static_cast<std::uint32_t>(_value.size_bytes());
+        return _value.size_bytes();
     }
 
     auto TlvEntry::uint32_value() const -> std::uint32_t
@@ -44,6 +55,17 @@ namespace game
         return value;
     }
 
+    auto TlvEntry::float_value() const -> float
+    {
+        ensure(_type == TlvType::FLOAT, "incorrect type");
+        ensure(_value.size() == sizeof(float), "incorrect size");
+
+        auto value = float{};
+        std::memcpy(&value, _value.data(), sizeof(value));
+
+        return value;
+    }
+
     auto TlvEntry::uint32_array_value() const -> std::vector<std::uint32_t>
     {
         ensure(_type == TlvType::UINT32_ARRAY, "incorrect type");
@@ -53,6 +75,15 @@ namespace game
         return value;
     }
 
+    auto TlvEntry::uint16_array_value() const -> std::vector<std::uint16_t>
+    {
+        ensure(_type == TlvType::UINT16_ARRAY, "incorrect type");
+        auto value = std::vector<std::uint16_t>(_value.size() / sizeof(std::uint16_t));
+        std::memcpy(value.data(), _value.data(), _value.size_bytes());
+
+        return value;
+    }
+
     auto TlvEntry::string_value() const -> std::string
     {
         ensure(_type == TlvType::STRING, "incorrect type");
@@ -94,7 +125,7 @@ namespace game
     {
         ensure(_type == TlvType::TEXTURE_DESCRIPTION, "incorrect type");
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "texture TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -116,10 +147,17 @@ namespace game
         ensure(reader_cursor != std::ranges::end(reader), "texture TLV too small");
         const auto data = (*reader_cursor).byte_array_value();
 
+        // mip levels were added later, older packs only have a single level
+        auto mip_levels = 1u;
         ++reader_cursor;
+        if (reader_cursor != std::ranges::end(reader))
+        {
+            mip_levels = (*reader_cursor).uint32_value();
+            ++reader_cursor;
+        }
         ensure(reader_cursor == std::ranges::end(reader), "texture TLV too large");
 
-        return {name, format, usage, width, height, data};
+        return {name, format, usage, width, height, data, mip_levels};
     }
 
     auto TlvEntry::is_texture(std::string_view name) const -> bool
@@ -129,13 +167,19 @@ namespace game
             return false;
         }
 
-        auto reader = TlvReader(_value);
+        return texture_name_value() == name;
+    }
+
+    auto TlvEntry::texture_name_value() const -> std::string
+    {
+        ensure(_type == TlvType::TEXTURE_DESCRIPTION, "incorrect type");
+
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "texture TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
 
-        const auto texture_name = (*reader_cursor).string_value();
-        return texture_name == name;
+        return (*reader_cursor).string_value();
     }
 
     auto TlvEntry::vertex_data_value() const -> VertexData
@@ -157,11 +201,74 @@ namespace game
         return value;
     }
 
+    auto TlvEntry::compact_vertex_data_array_value() const -> std::vector<CompactVertexData>
+    {
+        ensure(_type == TlvType::COMPACT_VERTEX_DATA_ARRAY, "incorrect type");
+        auto value = std::vector<CompactVertexData>(_value.size() / sizeof(CompactVertexData));
+        std::memcpy(value.data(), _value.data(), _value.size_bytes());
+
+        return value;
+    }
+
+    auto TlvEntry::vertex_quantization_value() const -> VertexQuantization
+    {
+        ensure(_type == TlvType::VERTEX_QUANTIZATION, "incorrect type");
+        ensure(_value.size() == sizeof(VertexQuantization), "incorrect size");
+
+        auto value = VertexQuantization{};
+        std::memcpy(&value, _value.data(), sizeof(value));
+
+        return value;
+    }
+
+    auto TlvEntry::mesh_lod_value() const -> MeshLod
+    {
+        ensure(_type == TlvType::MESH_LOD, "incorrect type");
+
+        auto reader = TlvReader(_value, _format, _pack);
+        auto reader_cursor = std::ranges::begin(reader);
+        ensure(reader_cursor != std::ranges::end(reader), "mesh lod TLV too small");
+
+        auto lod = MeshLod{};
+        if ((*reader_cursor).type() == TlvType::UINT16_ARRAY)
+        {
+            lod.short_indices = std::span<const std::uint16_t>{
+                reinterpret_cast<const std::uint16_t *>((*reader_cursor)._value.data()),
+                (*reader_cursor)._value.size() / sizeof(std::uint16_t)};
+        }
+        else
+        {
+            ensure((*reader_cursor).type() == TlvType::UINT32_ARRAY, "first member not uint32 or uint16 data array");
+            lod.indices = std::span<const std::uint32_t>{
+                reinterpret_cast<const std::uint32_t *>((*reader_cursor)._value.data()),
+                (*reader_cursor)._value.size() / sizeof(std::uint32_t)};
+        }
+        ++reader_cursor;
+        ensure(reader_cursor != std::ranges::end(reader), "mesh lod TLV too small");
+
+        lod.error = (*reader_cursor).float_value();
+        ++reader_cursor;
+        ensure(reader_cursor == std::ranges::end(reader), "mesh lod TLV too large");
+
+        return lod;
+    }
+
+    auto TlvEntry::mesh_bounds_value() const -> MeshBounds
+    {
+        ensure(_type == TlvType::MESH_BOUNDS, "incorrect type");
+        ensure(_value.size() == sizeof(MeshBounds), "incorrect size");
+
+        auto value = MeshBounds{};
+        std::memcpy(&value, _value.data(), sizeof(value));
+
+        return value;
+    }
+
     auto TlvEntry::mesh_value() const -> MeshData
     {
         ensure(_type == TlvType::MESH_DATA, "incorrect type");
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "mesh TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -170,22 +277,72 @@ namespace game
         ++reader_cursor;
         ensure(reader_cursor != std::ranges::end(reader), "mesh TLV too small");
 
-        ensure((*reader_cursor).type() == TlvType::VERTEX_DATA_ARRAY, "second member not vertex data array");
-        const auto vertex_data = std::span<const VertexData>{
-            reinterpret_cast<const VertexData *>((*reader_cursor)._value.data()),
-            static_cast<std::uint32_t>((*reader_cursor)._value.size() / sizeof(VertexData))};
+        // meshes packed with compact vertices store their quantisation in front of the vertex data
+        auto vertex_data = std::span<const VertexData>{};
+        auto compact_vertex_data = std::span<const CompactVertexData>{};
+        auto quantization = VertexQuantization{};
+        if ((*reader_cursor).type() == TlvType::VERTEX_QUANTIZATION)
+        {
+            quantization = (*reader_cursor).vertex_quantization_value();
+            ++reader_cursor;
+            ensure(reader_cursor != std::ranges::end(reader), "mesh TLV too small");
+
+            ensure((*reader_cursor).type() == TlvType::COMPACT_VERTEX_DATA_ARRAY, "vertex quantization not followed by compact vertex data array");
+            compact_vertex_data = std::span<const CompactVertexData>{
+                reinterpret_cast<const CompactVertexData *>((*reader_cursor)._value.data()),
+                (*reader_cursor)._value.size() / sizeof(CompactVertexData)};
+        }
+        else
+        {
+            ensure((*reader_cursor).type() == TlvType::VERTEX_DATA_ARRAY, "second member not vertex data array");
+            vertex_data = std::span<const VertexData>{
+                reinterpret_cast<const VertexData *>((*reader_cursor)._value.data()),
+                (*reader_cursor)._value.size() / sizeof(VertexData)};
+        }
         ++reader_cursor;
         ensure(reader_cursor != std::ranges::end(reader), "mesh TLV too small");
 
-        ensure((*reader_cursor).type() == TlvType::UINT32_ARRAY, "third member not uint32 data array");
-        const auto index_data = std::span<const std::uint32_t>{
-            reinterpret_cast<const std::uint32_t *>((*reader_cursor)._value.data()),
-            static_cast<std::uint32_t>((*reader_cursor)._value.size()) / sizeof(std::uint32_t)};
+        // small meshes are packed with 16 bit indices
+        auto index_data = std::span<const std::uint32_t>{};
+        auto short_index_data = std::span<const std::uint16_t>{};
+        if ((*reader_cursor).type() == TlvType::UINT16_ARRAY)
+        {
+            short_index_data = std::span<const std::uint16_t>{
+                reinterpret_cast<const std::uint16_t *>((*reader_cursor)._value.data()),
+                (*reader_cursor)._value.size() / sizeof(std::uint16_t)};
+        }
+        else
+        {
+            ensure((*reader_cursor).type() == TlvType::UINT32_ARRAY, "third member not uint32 or uint16 data array");
+            index_data = std::span<const std::uint32_t>{
+                reinterpret_cast<const std::uint32_t *>((*reader_cursor)._value.data()),
+                (*reader_cursor)._value.size() / sizeof(std::uint32_t)};
+        }
         ++reader_cursor;
-        ensure(reader_cursor == std::ranges::end(reader), "mesh TLV too large");
+
+        auto bounds = std::optional<MeshBounds>{};
+        if (reader_cursor != std::ranges::end(reader) && (*reader_cursor).type() == TlvType::MESH_BOUNDS)
+        {
+            bounds = (*reader_cursor).mesh_bounds_value();
+            ++reader_cursor;
+        }
+
+        // any remaining members are coarser levels of detail
+        auto lods = std::vector<MeshLod>{};
+        for (; reader_cursor != std::ranges::end(reader); ++reader_cursor)
+        {
+            lods.push_back((*reader_cursor).mesh_lod_value());
+        }
 
         // log::debug("loaded mesh {} - {} verts, {} indices", name, vertex_data.size(), index_data.size());
-        return {vertex_data, index_data};
+        return {
+            .vertices = vertex_data,
+            .indices = index_data,
+            .short_indices = short_index_data,
+            .compact_vertices = compact_vertex_data,
+            .quantization = quantization,
+            .bounds = bounds,
+            .lods = std::move(lods)};
     }
 
     auto TlvEntry::is_mesh(std::string_view name) const -> bool
@@ -195,7 +352,7 @@ namespace game
             return false;
         }
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "mesh TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -208,7 +365,7 @@ namespace game
     {
         ensure(_type == TlvType::TEXT_FILE, "incorrect type");
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "text_file TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -232,7 +389,7 @@ namespace game
             return false;
         }
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "text file TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -248,7 +405,7 @@ namespace game
             return false;
         }
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "object sub mesh TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -261,7 +418,7 @@ namespace game
     {
         ensure(_type == TlvType::OBJECT_SUB_MESH_NAMES, "incorrect type");
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "object sub mesh TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -291,20 +448,40 @@ namespace game
             {
                 ensure(reader_cursor != std::ranges::end(reader), "object sub mesh TLV too small");
             }
-            else
+        }
+
+        // the bounds of the whole object follow the names, older packs do not have them
+        if (reader_cursor != std::ranges::end(reader))
+        {
+            ensure((*reader_cursor).type() == TlvType::MESH_BOUNDS, "last member not mesh bounds");
+            ++reader_cursor;
+        }
+        ensure(reader_cursor == std::ranges::end(reader), "object sub mesh TLV too large");
+
+        return value;
+    }
+
+    auto TlvEntry::object_bounds_value() const -> std::optional<MeshBounds>
+    {
+        ensure(_type == TlvType::OBJECT_SUB_MESH_NAMES, "incorrect type");
+
+        auto bounds = std::optional<MeshBounds>{};
+        for (const auto &member : TlvReader(_value, _format, _pack))
+        {
+            if (member.type() == TlvType::MESH_BOUNDS)
             {
-                ensure(reader_cursor == std::ranges::end(reader), "object sub mesh TLV too large");
+                bounds = member.mesh_bounds_value();
             }
         }
 
-        return value;
+        return bounds;
     }
 
     auto TlvEntry::sound_data_value() const -> SoundData
     {
         ensure(_type == TlvType::SOUND_DATA, "incorrect type");
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -333,7 +510,7 @@ namespace game
             return false;
         }
 
-        auto reader = TlvReader(_value);
+        auto reader = TlvReader(_value, _format, _pack);
         auto reader_cursor = std::ranges::begin(reader);
         ensure(reader_cursor != std::ranges::end(reader), "mesh TLV too small");
         ensure((*reader_cursor).type() == TlvType::STRING, "first member not a string");
@@ -342,10 +519,16 @@ namespace game
         return mesh_name == name;
     }
 
-    auto TlvEntry::size() const -> std::uint32_t
+    auto TlvEntry::size() const -> std::uint64_t
+    {
+        return _size;
+    }
+
+    auto TlvEntry::value() const -> std::span<const std::byte>
     {
-        return static_cast<std::uint32_t>(sizeof(_type)) + static_cast<std::uint32_t>(sizeof(std::uint32_t)) + static_cast<std::uint32_t>(_value.size());
+        return _value;
     }
+
     auto TlvEntry::to_string() -> std::string
     {
         auto str = "unknown"sv;
@@ -391,6 +574,27 @@ namespace game
         case SOUND_DATA:
             str = "SOUND_DATA"sv;
             break;
+        case UINT16_ARRAY:
+            str = "UINT16_ARRAY"sv;
+            break;
+        case COMPACT_VERTEX_DATA_ARRAY:
+            str = "COMPACT_VERTEX_DATA_ARRAY"sv;
+            break;
+        case VERTEX_QUANTIZATION:
+            str = "VERTEX_QUANTIZATION"sv;
+            break;
+        case FLOAT:
+            str = "FLOAT"sv;
+            break;
+        case MESH_LOD:
+            str = "MESH_LOD"sv;
+            break;
+        case MESH_BOUNDS:
+            str = "MESH_BOUNDS"sv;
+            break;
+        case ALIAS:
+            str = "ALIAS"sv;
+            break;
         }
         return std::format("{}", str);
     }
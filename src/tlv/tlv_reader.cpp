@@ -1,39 +1,150 @@
 #include "tlv/tlv_reader.h"
 
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <iterator>
+#include <optional>
 #include <span>
+#include <utility>
 
+#include "tlv/tlv_entry.h"
 #include "utils/ensure.h"
 
+namespace
+{
+    auto read_header(std::span<const std::byte> buffer) -> std::optional<game::TlvFileHeader>
+    {
+        if (buffer.size() < sizeof(game::TlvFileHeader))
+        {
+            return std::nullopt;
+        }
+
+        auto header = game::TlvFileHeader{};
+        std::memcpy(&header, buffer.data(), sizeof(header));
+
+        return header.magic == game::tlv_magic ? std::make_optional(header) : std::nullopt;
+    }
+
+    auto round_up(std::uint64_t value, std::uint64_t alignment) -> std::uint64_t
+    {
+        return (value + alignment - 1u) & ~(alignment - 1u);
+    }
+
+    struct RawEntry
+    {
+        game::TlvType type;
+        std::span<const std::byte> value;
+        std::uint64_t size;
+    };
+
+    /**
+     * Parse the entry at the start of a buffer, without resolving aliases.
+     */
+    auto read_entry(std::span<const std::byte> buffer, game::TlvFormat format) -> RawEntry
+    {
+        const auto remaining_byes = buffer.size();
+
+        if (format.version == game::TlvVersion::V1)
+        {
+            game::ensure(remaining_byes >= sizeof(game::TlvType) + sizeof(std::uint32_t), "invalid entry size {}", remaining_byes);
+
+            auto type = game::TlvType{};
+            std::memcpy(&type, buffer.data(), sizeof(type));
+
+            auto length = std::uint32_t{};
+            std::memcpy(&length, buffer.data() + sizeof(type), sizeof(length));
+
+            auto needed_bytes = sizeof(game::TlvType) + sizeof(std::uint32_t) + length;
+            game::ensure(remaining_byes >= needed_bytes, "invalid entry size. Remaining {}, need {}", remaining_byes, needed_bytes);
+
+            return {type, buffer.subspan(sizeof(type) + sizeof(length), length), needed_bytes};
+        }
+
+        game::ensure(remaining_byes >= sizeof(game::TlvEntryHeader), "invalid entry size {}", remaining_byes);
+
+        auto header = game::TlvEntryHeader{};
+        std::memcpy(&header, buffer.data(), sizeof(header));
+
+        // compare against the remaining bytes piecewise, so a corrupt length can not overflow the sum
+        const auto payload_offset = sizeof(game::TlvEntryHeader) + std::uint64_t{header.padding};
+        game::ensure(remaining_byes >= payload_offset, "invalid entry padding {}", header.padding);
+        game::ensure(remaining_byes - payload_offset >= header.length, "invalid entry size. Remaining {}, need {}", remaining_byes, payload_offset + header.length);
+
+        const auto needed_bytes = round_up(payload_offset + header.length, sizeof(game::TlvEntryHeader));
+        game::ensure(remaining_byes >= needed_bytes, "invalid entry size. Remaining {}, need {}", remaining_byes, needed_bytes);
+
+        return {header.type, buffer.subspan(payload_offset, header.length), needed_bytes};
+    }
+}
+
 namespace game
 {
     TlvReader::TlvReader(std::span<const std::byte> buffer)
-        : _buffer{buffer}
+        : _buffer{buffer},
+          _format{.version = TlvVersion::V1, .alignment = 1u},
+          _pack{buffer}
     {
+        if (const auto header = read_header(buffer); header)
+        {
+            ensure(header->version == TlvVersion::V2, "unsupported tlv version {}", std::to_underlying(header->version));
+            ensure(
+                std::has_single_bit(header->alignment) && header->alignment >= sizeof(TlvEntryHeader),
+                "invalid tlv alignment {}",
+                header->alignment);
+
+            const auto header_size = round_up(sizeof(TlvFileHeader), header->alignment);
+            ensure(buffer.size() >= header_size, "tlv header truncated");
+
+            _format = {.version = header->version, .alignment = header->alignment};
+            _buffer = buffer.subspan(header_size);
+        }
     }
 
-    TlvReader::Iterator::Iterator(std::span<const std::byte> buffer)
-        : _buffer(buffer)
+    TlvReader::TlvReader(std::span<const std::byte> buffer, TlvFormat format, std::span<const std::byte> pack)
+        : _buffer{buffer},
+          _format{format},
+          _pack{pack}
+    {
+    }
+
+    auto TlvReader::format() const -> TlvFormat
+    {
+        return _format;
+    }
+
+    TlvReader::Iterator::Iterator(std::span<const std::byte> buffer, TlvFormat format, std::span<const std::byte> pack)
+        : _buffer(buffer),
+          _format{format},
+          _pack{pack}
     {
     }
 
     auto TlvReader::Iterator::operator*() const -> TlvReader::Iterator::value_type
     {
-        const auto remaining_byes = _buffer.size();
-        ensure(remaining_byes >= sizeof(TlvType) + sizeof(std::uint32_t), "invalid entry size {}", remaining_byes);
+        const auto entry = read_entry(_buffer, _format);
+        if (entry.type != TlvType::ALIAS)
+        {
+            return {entry.type, entry.value, _format, entry.size, _pack};
+        }
+
+        ensure(entry.value.size() == sizeof(std::uint64_t), "invalid alias size {}", entry.value.size());
 
-        auto type = TlvType{};
-        std::memcpy(&type, _buffer.data(), sizeof(type));
+        auto offset = std::uint64_t{};
+        std::memcpy(&offset, entry.value.data(), sizeof(offset));
 
-        auto length = std::uint32_t{};
-        std::memcpy(&length, _buffer.data() + sizeof(type), sizeof(length));
+        // the target is always written before the alias, which keeps aliases from forming cycles
+        ensure(!_pack.empty(), "alias outside of a pack");
+        const auto alias_offset = static_cast<std::uint64_t>(_buffer.data() - _pack.data());
+        ensure(alias_offset < _pack.size(), "alias outside of its pack");
+        ensure(offset < alias_offset, "invalid alias offset {}", offset);
 
-        auto needed_bytes = sizeof(TlvType) + sizeof(std::uint32_t) + length;
-        ensure(remaining_byes >= needed_bytes, "invalid entry size. Remaining {}, need {}", remaining_byes, needed_bytes);
+        const auto target = read_entry(_pack.subspan(static_cast<std::size_t>(offset)), _format);
+        ensure(target.type != TlvType::ALIAS, "alias at {} points at another alias", alias_offset);
 
-        return {type, _buffer.subspan(sizeof(type) + sizeof(length), length)};
+        // iterating continues after the alias, not after its target
+        return {target.type, target.value, _format, entry.size, _pack};
     }
 
     auto TlvReader::Iterator::operator++() -> TlvReader::Iterator &
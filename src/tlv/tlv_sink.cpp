@@ -0,0 +1,124 @@
+#include "tlv/tlv_sink.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <vector>
+
+#include <zstd.h>
+
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    auto write_file(std::ofstream &out, std::span<const std::byte> data) -> void
+    {
+        out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        game::ensure(!!out, "failed to write to file");
+    }
+}
+
+namespace game
+{
+    FileSink::FileSink(const std::filesystem::path &path)
+        : _out{path, std::ios::binary | std::ios::trunc}
+    {
+        ensure(!!_out, "failed to open {}", path.string());
+    }
+
+    auto FileSink::write(std::span<const std::byte> data) -> void
+    {
+        write_file(_out, data);
+    }
+
+    auto FileSink::finish() -> void
+    {
+        _out.flush();
+        ensure(!!_out, "failed to flush file");
+    }
+
+    CompressedFileSink::CompressedFileSink(const std::filesystem::path &path, int level, std::size_t chunk_size)
+        : _out{path, std::ios::binary | std::ios::trunc},
+          _context{::ZSTD_createCCtx(), ::ZSTD_freeCCtx},
+          _chunk_size{chunk_size},
+          _chunk{},
+          _compressed(::ZSTD_CStreamOutSize())
+    {
+        ensure(!!_out, "failed to open {}", path.string());
+        ensure(_context, "failed to create compression context");
+
+        const auto result = ::ZSTD_CCtx_setParameter(_context, ZSTD_c_compressionLevel, level);
+        ensure(::ZSTD_isError(result) == 0, "failed to set compression level: {}", ::ZSTD_getErrorName(result));
+
+        _chunk.reserve(_chunk_size);
+    }
+
+    auto CompressedFileSink::write(std::span<const std::byte> data) -> void
+    {
+        if (_chunk_size == 0u)
+        {
+            write_stream(data, false);
+            return;
+        }
+
+        // chunks are compressed whole, so every frame knows its content size
+        while (!data.empty())
+        {
+            const auto count = std::min(_chunk_size - _chunk.size(), data.size());
+            _chunk.append_range(data.first(count));
+            data = data.subspan(count);
+
+            if (_chunk.size() == _chunk_size)
+            {
+                compress_chunk();
+            }
+        }
+    }
+
+    auto CompressedFileSink::finish() -> void
+    {
+        if (_chunk_size == 0u)
+        {
+            write_stream({}, true);
+        }
+        else if (!_chunk.empty())
+        {
+            compress_chunk();
+        }
+
+        _out.flush();
+        ensure(!!_out, "failed to flush file");
+    }
+
+    auto CompressedFileSink::compress_chunk() -> void
+    {
+        _compressed.resize(std::max(_compressed.size(), ::ZSTD_compressBound(_chunk.size())));
+
+        const auto result = ::ZSTD_compress2(_context, _compressed.data(), _compressed.size(), _chunk.data(), _chunk.size());
+        ensure(::ZSTD_isError(result) == 0, "failed to compress data: {}", ::ZSTD_getErrorName(result));
+
+        write_file(_out, std::span{_compressed}.first(result));
+        _chunk.clear();
+    }
+
+    auto CompressedFileSink::write_stream(std::span<const std::byte> data, bool end) -> void
+    {
+        auto input = ::ZSTD_inBuffer{data.data(), data.size(), 0u};
+        const auto mode = end ? ZSTD_e_end : ZSTD_e_continue;
+
+        // keep going until all input is consumed, and when ending until the frame epilogue has been written
+        for (auto done = false; !done;)
+        {
+            auto output = ::ZSTD_outBuffer{_compressed.data(), _compressed.size(), 0u};
+
+            const auto remaining = ::ZSTD_compressStream2(_context, &output, &input, mode);
+            ensure(::ZSTD_isError(remaining) == 0, "failed to compress data: {}", ::ZSTD_getErrorName(remaining));
+
+            write_file(_out, std::span{_compressed}.first(output.pos));
+            done = end ? remaining == 0u : input.pos == input.size;
+        }
+    }
+}
@@ -1,182 +1,507 @@
 #include "tlv/tlv_writer.h"
 
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <limits>
 #include <ranges>
 #include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "tlv/tlv_entry.h"
+#include "tlv/tlv_sink.h"
+#include "utils/ensure.h"
 
 namespace
 {
+    // completed top level entries are collected up to this size before they are passed to the sink
+    constexpr auto flush_threshold = std::size_t{1024u * 1024u};
+
+    // an alias costs an entry of its own, so small payloads are always written out
+    constexpr auto min_deduplicated_size = std::size_t{256u};
+
+    // v1 entry header, u32 type and u32 length
+    constexpr auto v1_header_size = sizeof(game::TlvType) + sizeof(std::uint32_t);
+
+    auto round_up(std::uint64_t value, std::uint64_t alignment) -> std::uint64_t
+    {
+        return (value + alignment - 1u) & ~(alignment - 1u);
+    }
+
     auto write_bytes(std::vector<std::byte> &buffer, std::span<const std::byte> data) -> void
     {
         buffer.insert(std::ranges::end(buffer), std::ranges::cbegin(data), std::ranges::cend(data));
     }
 
-    auto write_entry(std::vector<std::byte> &buffer, game::TlvType type, std::uint32_t length, std::span<const std::byte> value) -> void
+    /**
+     * Only bulk data is worth deduplicating: texture data, vertices and indices.
+     */
+    auto is_deduplicated(game::TlvType type) -> bool
+    {
+        switch (type)
+        {
+            using enum game::TlvType;
+        case BYTE_ARRAY:
+        case UINT32_ARRAY:
+        case UINT16_ARRAY:
+        case VERTEX_DATA_ARRAY:
+        case COMPACT_VERTEX_DATA_ARRAY:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * 128 bit FNV-1a, as (high, low). The prime is 2^88 + 0x13b, so the multiply is a shift and a small product.
+     */
+    auto fnv1a_128(std::span<const std::byte> data) -> std::pair<std::uint64_t, std::uint64_t>
+    {
+        auto high = std::uint64_t{0x6c62272e07bb0142u};
+        auto low = std::uint64_t{0x62b821756295c58du};
+
+        for (const auto byte : data)
+        {
+            low ^= static_cast<std::uint64_t>(byte);
+
+            // low * 0x13b as 128 bits, from its two 32 bit halves
+            const auto product_low = (low & 0xffffffffu) * 0x13bu;
+            const auto product_mid = (low >> 32u) * 0x13bu;
+            const auto new_low = product_low + (product_mid << 32u);
+            const auto carry = (product_mid >> 32u) + (new_low < product_low ? 1u : 0u);
+
+            high = high * 0x13bu + carry + (low << 24u);
+            low = new_low;
+        }
+
+        return {high, low};
+    }
+
+    /**
+     * Write an entry header and the padding in front of the payload.
+     */
+    auto write_entry_header(std::vector<std::byte> &buffer, std::uint64_t flushed, game::TlvFormat format, game::TlvType type, std::uint64_t length) -> void
     {
-        write_bytes(buffer, {reinterpret_cast<const std::byte *>(&type), sizeof(type)});
-        write_bytes(buffer, {reinterpret_cast<const std::byte *>(&length), sizeof(length)});
-        write_bytes(buffer, value);
+        if (format.version == game::TlvVersion::V1)
+        {
+            game::ensure(length <= std::numeric_limits<std::uint32_t>::max(), "entry of {} bytes too large for tlv v1", length);
+
+            const auto short_length = static_cast<std::uint32_t>(length);
+            write_bytes(buffer, {reinterpret_cast<const std::byte *>(&type), sizeof(type)});
+            write_bytes(buffer, {reinterpret_cast<const std::byte *>(&short_length), sizeof(short_length)});
+            return;
+        }
+
+        // composite payloads are aligned, so aligning relative to the start of the pack aligns members as well
+        const auto payload_offset = flushed + buffer.size() + sizeof(game::TlvEntryHeader);
+        const auto header = game::TlvEntryHeader{
+            .type = type,
+            .padding = static_cast<std::uint32_t>(round_up(payload_offset, format.alignment) - payload_offset),
+            .length = length};
+
+        write_bytes(buffer, {reinterpret_cast<const std::byte *>(&header), sizeof(header)});
+        buffer.resize(buffer.size() + header.padding);
     }
 
+    /**
+     * Pad a v2 entry so the next one starts on a 16 byte boundary.
+     */
+    auto write_entry_footer(std::vector<std::byte> &buffer, std::uint64_t flushed, game::TlvFormat format) -> void
+    {
+        if (format.version == game::TlvVersion::V2)
+        {
+            buffer.resize(round_up(flushed + buffer.size(), sizeof(game::TlvEntryHeader)) - flushed);
+        }
+    }
 }
 
 namespace game
 {
     TlvWriter::TlvWriter()
-        : _buffer{}
+        : TlvWriter{TlvFormat{}}
+    {
+    }
+
+    TlvWriter::TlvWriter(TlvFormat format)
+        : _buffer{},
+          _format{format},
+          _sink{nullptr},
+          _flushed{0u},
+          _open_composites{0u},
+          _deduplicate{false},
+          _deduplicated_bytes{0u},
+          _payloads{}
+    {
+        if (_format.version == TlvVersion::V1)
+        {
+            _format.alignment = 1u;
+        }
+        else
+        {
+            ensure(_format.version == TlvVersion::V2, "unsupported tlv version {}", std::to_underlying(_format.version));
+            ensure(
+                std::has_single_bit(_format.alignment) && _format.alignment >= sizeof(TlvEntryHeader),
+                "invalid tlv alignment {}",
+                _format.alignment);
+        }
+
+        write_header();
+    }
+
+    TlvWriter::TlvWriter(TlvFormat format, TlvSink &sink)
+        : TlvWriter{format}
     {
+        _sink = &sink;
     }
 
     auto TlvWriter::yield() -> std::vector<std::byte>
     {
+        ensure(_sink == nullptr, "cannot yield a streaming writer");
+        ensure(_open_composites == 0u, "cannot yield inside a composite entry");
+
         auto tmp = std::vector<std::byte>{};
         std::ranges::swap(tmp, _buffer);
+        write_header();
         return tmp;
     }
 
+    auto TlvWriter::finish() -> void
+    {
+        ensure(_sink != nullptr, "cannot finish a writer without a sink");
+        ensure(_open_composites == 0u, "cannot finish inside a composite entry");
+
+        flush(true);
+        _sink->finish();
+    }
+
+    auto TlvWriter::format() const -> TlvFormat
+    {
+        return _format;
+    }
+
+    auto TlvWriter::size() const -> std::uint64_t
+    {
+        return _flushed + _buffer.size();
+    }
+
+    auto TlvWriter::set_deduplicate(bool deduplicate) -> void
+    {
+        _deduplicate = deduplicate;
+    }
+
+    auto TlvWriter::deduplicated_bytes() const -> std::uint64_t
+    {
+        return _deduplicated_bytes;
+    }
+
+    auto TlvWriter::write_entry(TlvType type, std::span<const std::byte> value) -> void
+    {
+        if (write_alias(type, value))
+        {
+            flush(false);
+            return;
+        }
+
+        write_entry_header(_buffer, _flushed, _format, type, value.size());
+        write_bytes(_buffer, value);
+        write_entry_footer(_buffer, _flushed, _format);
+
+        flush(false);
+    }
+
+    auto TlvWriter::write_alias(TlvType type, std::span<const std::byte> value) -> bool
+    {
+        if (!_deduplicate || !is_deduplicated(type) || value.size() < min_deduplicated_size)
+        {
+            return false;
+        }
+
+        // earlier payloads may already be in the sink, so they are matched on a 128 bit digest instead of their bytes,
+        // an accidental collision is out of reach even for packs with billions of payloads
+        const auto [high, low] = fnv1a_128(value);
+        const auto offset = size();
+        const auto [record, inserted] = _payloads.try_emplace(PayloadDigest{.high = high, .low = low}, PayloadRecord{.type = type, .length = value.size(), .offset = offset});
+
+        if (inserted || record->second.type != type || record->second.length != value.size())
+        {
+            return false;
+        }
+
+        const auto target = record->second.offset;
+        write_entry_header(_buffer, _flushed, _format, TlvType::ALIAS, sizeof(target));
+        write_bytes(_buffer, {reinterpret_cast<const std::byte *>(&target), sizeof(target)});
+        write_entry_footer(_buffer, _flushed, _format);
+
+        _deduplicated_bytes += value.size();
+
+        return true;
+    }
+
+    auto TlvWriter::begin_composite(TlvType type) -> std::size_t
+    {
+        const auto header_offset = _buffer.size();
+        write_entry_header(_buffer, _flushed, _format, type, 0u);
+        ++_open_composites;
+
+        return header_offset;
+    }
+
+    auto TlvWriter::end_composite(std::size_t header_offset) -> void
+    {
+        auto *header = _buffer.data() + header_offset;
+
+        if (_format.version == TlvVersion::V1)
+        {
+            const auto length = _buffer.size() - header_offset - v1_header_size;
+            ensure(length <= std::numeric_limits<std::uint32_t>::max(), "entry of {} bytes too large for tlv v1", length);
+
+            const auto short_length = static_cast<std::uint32_t>(length);
+            std::memcpy(header + sizeof(TlvType), &short_length, sizeof(short_length));
+        }
+        else
+        {
+            auto entry_header = TlvEntryHeader{};
+            std::memcpy(&entry_header, header, sizeof(entry_header));
+
+            entry_header.length = _buffer.size() - header_offset - sizeof(TlvEntryHeader) - entry_header.padding;
+            std::memcpy(header, &entry_header, sizeof(entry_header));
+        }
+
+        write_entry_footer(_buffer, _flushed, _format);
+
+        --_open_composites;
+        flush(false);
+    }
+
+    auto TlvWriter::write_header() -> void
+    {
+        _buffer.clear();
+        _flushed = 0u;
+        _payloads.clear();
+
+        if (_format.version == TlvVersion::V1)
+        {
+            return;
+        }
+
+        const auto header = TlvFileHeader{.magic = tlv_magic, .version = _format.version, .flags = 0u, .alignment = _format.alignment};
+        write_bytes(_buffer, {reinterpret_cast<const std::byte *>(&header), sizeof(header)});
+        _buffer.resize(round_up(_buffer.size(), _format.alignment));
+    }
+
+    auto TlvWriter::flush(bool force) -> void
+    {
+        // lengths of open composites still have to be patched, so they stay in the buffer
+        if (_sink == nullptr || _open_composites != 0u || (!force && _buffer.size() < flush_threshold))
+        {
+            return;
+        }
+
+        _sink->write(_buffer);
+        _flushed += _buffer.size();
+        _buffer.clear();
+    }
+
     auto TlvWriter::write(std::uint32_t value) -> void
     {
         const auto type = TlvType::UINT32;
-        const auto length = static_cast<std::uint32_t>(sizeof(value));
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(&value), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
+    }
+
+    auto TlvWriter::write(float value) -> void
+    {
+        const auto type = TlvType::FLOAT;
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
+        const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(&value), length};
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(std::span<const std::uint32_t> value) -> void
     {
         const auto type = TlvType::UINT32_ARRAY;
-        const auto length = static_cast<std::uint32_t>(value.size_bytes());
+        const auto length = static_cast<std::uint64_t>(value.size_bytes());
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(value.data()), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
+    }
+
+    auto TlvWriter::write(std::span<const std::uint16_t> value) -> void
+    {
+        const auto type = TlvType::UINT16_ARRAY;
+        const auto length = static_cast<std::uint64_t>(value.size_bytes());
+        const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(value.data()), length};
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(std::string_view value) -> void
     {
         const auto type = TlvType::STRING;
-        const auto length = static_cast<std::uint32_t>(value.length());
+        const auto length = static_cast<std::uint64_t>(value.length());
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(value.data()), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(std::span<const std::byte> value) -> void
     {
         const auto type = TlvType::BYTE_ARRAY;
-        const auto length = static_cast<std::uint32_t>(value.size());
+        const auto length = static_cast<std::uint64_t>(value.size());
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(value.data()), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(TextureFormat value) -> void
     {
         const auto type = TlvType::TEXTURE_FORMAT;
-        const auto length = static_cast<std::uint32_t>(sizeof(value));
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(&value), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(TextureUsage value) -> void
     {
         const auto type = TlvType::TEXTURE_USAGE;
-        const auto length = static_cast<std::uint32_t>(sizeof(value));
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<std::byte *>(&value), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(TextureDescription &data) -> void
     {
-        auto sub_writer = TlvWriter{};
-        sub_writer.write(data.name);
-        sub_writer.write(data.width);
-        sub_writer.write(data.height);
-        sub_writer.write(data.format);
-        sub_writer.write(data.usage);
-        sub_writer.write(data.data);
-
-        const auto type = TlvType::TEXTURE_DESCRIPTION;
-        const auto value_bytes = sub_writer.yield();
-        const auto length = static_cast<std::uint32_t>(value_bytes.size());
-
-        write_entry(_buffer, type, length, value_bytes);
+        const auto composite = begin_composite(TlvType::TEXTURE_DESCRIPTION);
+        write(data.name);
+        write(data.width);
+        write(data.height);
+        write(data.format);
+        write(data.usage);
+        write(data.data);
+        write(data.mip_levels);
+        end_composite(composite);
     }
 
     auto TlvWriter::write(const VertexData &value) -> void
     {
         const auto type = TlvType::VERTEX_DATA;
-        const auto length = static_cast<std::uint32_t>(sizeof(value));
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(&value), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
     }
 
     auto TlvWriter::write(std::span<const VertexData> value) -> void
     {
         const auto type = TlvType::VERTEX_DATA_ARRAY;
-        const auto length = static_cast<std::uint32_t>(value.size_bytes());
+        const auto length = static_cast<std::uint64_t>(value.size_bytes());
         const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(value.data()), length};
-        write_entry(_buffer, type, length, value_bytes);
+        write_entry(type, value_bytes);
     }
 
-    auto TlvWriter::write(std::string_view name, const MeshData &value) -> void
+    auto TlvWriter::write(const VertexQuantization &value) -> void
     {
-        auto sub_writer = TlvWriter{};
-        sub_writer.write(name);
-        sub_writer.write(value.vertices);
-        sub_writer.write(value.indices);
+        const auto type = TlvType::VERTEX_QUANTIZATION;
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
+        const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(&value), length};
+        write_entry(type, value_bytes);
+    }
 
-        const auto type = TlvType::MESH_DATA;
-        const auto value_bytes = sub_writer.yield();
-        const auto length = static_cast<std::uint32_t>(value_bytes.size());
+    auto TlvWriter::write(std::span<const CompactVertexData> value) -> void
+    {
+        const auto type = TlvType::COMPACT_VERTEX_DATA_ARRAY;
+        const auto length = static_cast<std::uint64_t>(value.size_bytes());
+        const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(value.data()), length};
+        write_entry(type, value_bytes);
+    }
 
-        write_entry(_buffer, type, length, value_bytes);
+    auto TlvWriter::write(const MeshLod &value) -> void
+    {
+        const auto composite = begin_composite(TlvType::MESH_LOD);
+        if (value.short_indices.empty())
+        {
+            write(value.indices);
+        }
+        else
+        {
+            write(value.short_indices);
+        }
+        write(value.error);
+        end_composite(composite);
     }
 
-    auto TlvWriter::write(std::string_view name, std::string_view value) -> void
+    auto TlvWriter::write(const MeshBounds &value) -> void
     {
-        auto sub_writer = TlvWriter{};
-        sub_writer.write(name);
-        sub_writer.write(value);
+        const auto type = TlvType::MESH_BOUNDS;
+        const auto length = static_cast<std::uint64_t>(sizeof(value));
+        const auto value_bytes = std::span<const std::byte>{reinterpret_cast<const std::byte *>(&value), length};
+        write_entry(type, value_bytes);
+    }
 
-        const auto type = TlvType::TEXT_FILE;
-        const auto value_bytes = sub_writer.yield();
-        const auto length = static_cast<std::uint32_t>(value_bytes.size());
+    auto TlvWriter::write(std::string_view name, const MeshData &value) -> void
+    {
+        const auto composite = begin_composite(TlvType::MESH_DATA);
+        write(name);
+        if (value.is_compact())
+        {
+            write(value.quantization);
+            write(value.compact_vertices);
+        }
+        else
+        {
+            write(value.vertices);
+        }
+        if (value.short_indices.empty())
+        {
+            write(value.indices);
+        }
+        else
+        {
+            write(value.short_indices);
+        }
+        if (value.bounds)
+        {
+            write(*value.bounds);
+        }
+        for (const auto &lod : value.lods)
+        {
+            write(lod);
+        }
+        end_composite(composite);
+    }
 
-        write_entry(_buffer, type, length, value_bytes);
+    auto TlvWriter::write(std::string_view name, std::string_view value) -> void
+    {
+        const auto composite = begin_composite(TlvType::TEXT_FILE);
+        write(name);
+        write(value);
+        end_composite(composite);
     }
 
-    auto TlvWriter::write(std::string_view name, std::span<const std::string> sub_mesh_names) -> void
+    auto TlvWriter::write(std::string_view name, std::span<const std::string> sub_mesh_names, const std::optional<MeshBounds> &bounds) -> void
     {
-        auto sub_writer = TlvWriter{};
-        sub_writer.write(name);
-        sub_writer.write(static_cast<std::uint32_t>(sub_mesh_names.size()));
+        const auto composite = begin_composite(TlvType::OBJECT_SUB_MESH_NAMES);
+        write(name);
+        write(static_cast<std::uint32_t>(sub_mesh_names.size()));
         for (const auto &str : sub_mesh_names)
         {
-            sub_writer.write(str);
+            write(str);
         }
-
-        const auto type = TlvType::OBJECT_SUB_MESH_NAMES;
-        const auto value_bytes = sub_writer.yield();
-        const auto length = static_cast<std::uint32_t>(value_bytes.size());
-
-        write_entry(_buffer, type, length, value_bytes);
+        if (bounds)
+        {
+            write(*bounds);
+        }
+        end_composite(composite);
     }
 
     auto TlvWriter::write(std::string_view name, const SoundData &data) -> void
     {
-        auto sub_writer = TlvWriter{};
-        sub_writer.write(name);
-        sub_writer.write(data.format);
-        sub_writer.write(data.data);
-
-        const auto type = TlvType::SOUND_DATA;
-        const auto value_bytes = sub_writer.yield();
-        const auto length = static_cast<std::uint32_t>(value_bytes.size());
-
-        write_entry(_buffer, type, length, value_bytes);
+        const auto composite = begin_composite(TlvType::SOUND_DATA);
+        write(name);
+        write(data.format);
+        write(data.data);
+        end_composite(composite);
     }
 }
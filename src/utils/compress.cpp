@@ -1,16 +1,24 @@
 #include "utils/compress.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <span>
 #include <vector>
 
 #include <zstd.h>
 
+#include "utils/ensure.h"
 #include "utils/exception.h"
 
 namespace game
 {
     auto compress(std::span<const std::byte> data) -> std::vector<std::byte>
+    {
+        return compress(data, ::ZSTD_defaultCLevel());
+    }
+
+    auto compress(std::span<const std::byte> data, int level) -> std::vector<std::byte>
     {
         const auto compressed_buffer_size = ::ZSTD_compressBound(data.size_bytes());
         auto compressed_buffer = std::vector<std::byte>(compressed_buffer_size);
@@ -20,7 +28,7 @@ namespace game
             compressed_buffer.size(),
             data.data(),
             data.size_bytes(),
-            ::ZSTD_defaultCLevel());
+            level);
 
         if (::ZSTD_isError(compressed_result) != 0)
         {
@@ -31,4 +39,19 @@ namespace game
 
         return compressed_buffer;
     }
-}
\ No newline at end of file
+
+    auto compress_chunked(std::span<const std::byte> data, std::size_t chunk_size, int level) -> std::vector<std::byte>
+    {
+        ensure(chunk_size > 0u, "chunk size must not be zero");
+
+        auto compressed_buffer = std::vector<std::byte>{};
+
+        for (auto offset = std::size_t{}; offset < data.size(); offset += chunk_size)
+        {
+            const auto chunk = compress(data.subspan(offset, std::min(chunk_size, data.size() - offset)), level);
+            compressed_buffer.append_range(chunk);
+        }
+
+        return compressed_buffer;
+    }
+}
@@ -1,36 +1,154 @@
 #include "utils/decompress.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <span>
+#include <thread>
 #include <vector>
 
 #include <zstd.h>
 
+#include "utils/auto_release.h"
 #include "utils/ensure.h"
 #include "utils/exception.h"
 
+namespace
+{
+    struct Frame
+    {
+        std::span<const std::byte> compressed;
+        std::size_t offset;
+        std::uint64_t size;
+    };
+
+    auto find_frames(std::span<const std::byte> data) -> std::vector<Frame>
+    {
+        auto frames = std::vector<Frame>{};
+        auto offset = std::size_t{};
+
+        while (!data.empty())
+        {
+            const auto decompressed_size = ::ZSTD_getFrameContentSize(data.data(), data.size_bytes());
+
+            game::expect(decompressed_size != ZSTD_CONTENTSIZE_ERROR, "not compressed by zstd");
+            const auto compressed_size = ::ZSTD_findFrameCompressedSize(data.data(), data.size_bytes());
+            game::ensure(::ZSTD_isError(compressed_size) == 0, "invalid frame: {}", ::ZSTD_getErrorName(compressed_size));
+
+            frames.push_back({data.first(compressed_size), offset, decompressed_size});
+
+            // offsets are meaningless once a frame of unknown size was seen, decompress then streams everything
+            offset += static_cast<std::size_t>(decompressed_size);
+            data = data.subspan(compressed_size);
+        }
+
+        return frames;
+    }
+
+    auto decompress_frame(const Frame &frame, std::span<std::byte> out) -> std::size_t
+    {
+        return ::ZSTD_decompress(
+            out.data() + frame.offset, static_cast<std::size_t>(frame.size), frame.compressed.data(), frame.compressed.size_bytes());
+    }
+
+    /**
+     * Decompress frames that do not store their content size (written by a streaming compressor), the output grows as
+     * it is produced.
+     */
+    auto decompress_stream(std::span<const std::byte> data) -> std::vector<std::byte>
+    {
+        const auto context = game::AutoRelease<::ZSTD_DCtx *, nullptr>{::ZSTD_createDCtx(), ::ZSTD_freeDCtx};
+        game::ensure(context, "failed to create decompression context");
+
+        auto decompressed_buffer = std::vector<std::byte>{};
+        auto input = ::ZSTD_inBuffer{data.data(), data.size(), 0u};
+        auto last_result = std::size_t{};
+
+        while (input.pos < input.size)
+        {
+            const auto offset = decompressed_buffer.size();
+            decompressed_buffer.resize(offset + ::ZSTD_DStreamOutSize());
+
+            auto output = ::ZSTD_outBuffer{decompressed_buffer.data() + offset, ::ZSTD_DStreamOutSize(), 0u};
+            last_result = ::ZSTD_decompressStream(context, &output, &input);
+            if (::ZSTD_isError(last_result) != 0)
+            {
+                throw game::Exception("failed to decompress data: {}", ::ZSTD_getErrorName(last_result));
+            }
+
+            decompressed_buffer.resize(offset + output.pos);
+        }
+
+        // a non zero result means the last frame was cut short
+        game::expect(last_result == 0u, "truncated zstd frame");
+
+        return decompressed_buffer;
+    }
+}
+
 namespace game
 {
-    auto decompress([[maybe_unused]] std::span<const std::byte> data) -> std::vector<std::byte>
+    auto decompress(std::span<const std::byte> data) -> std::vector<std::byte>
     {
-        const auto decompressed_buffer_size = ::ZSTD_getFrameContentSize(data.data(), data.size_bytes());
+        const auto frames = find_frames(data);
+        if (std::ranges::any_of(frames, [](const auto &frame) { return frame.size == ZSTD_CONTENTSIZE_UNKNOWN; }))
+        {
+            return decompress_stream(data);
+        }
 
-        expect(decompressed_buffer_size != ZSTD_CONTENTSIZE_ERROR, "not compressed by zstd");
-        expect(decompressed_buffer_size != ZSTD_CONTENTSIZE_UNKNOWN, "cannot get original size");
+        const auto decompressed_buffer_size =
+            frames.empty() ? 0u : frames.back().offset + static_cast<std::size_t>(frames.back().size);
 
         auto decompressed_buffer = std::vector<std::byte>(decompressed_buffer_size);
 
-        const auto decompressed_result = ::ZSTD_decompress(
-            decompressed_buffer.data(),
-            decompressed_buffer.size(),
-            data.data(),
-            data.size_bytes());
+        // frames are independent, so a chunked pack is spread over all cores
+        auto next_frame = std::atomic<std::size_t>{};
+        auto error = std::atomic<std::size_t>{};
+        const auto worker = [&]
+        {
+            for (auto i = next_frame++; i < frames.size(); i = next_frame++)
+            {
+                if (const auto result = decompress_frame(frames[i], decompressed_buffer); ::ZSTD_isError(result) != 0)
+                {
+                    error = result;
+                }
+            }
+        };
 
-        if (::ZSTD_isError(decompressed_result) != 0)
+        const auto worker_count = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), frames.size());
+        if (worker_count <= 1u)
+        {
+            worker();
+        }
+        else
         {
-            throw Exception("failed to decompress data: {}", ::ZSTD_getErrorName(decompressed_result));
+            auto workers = std::vector<std::jthread>{};
+            for (auto i = 0u; i < worker_count; ++i)
+            {
+                workers.emplace_back(worker);
+            }
+        }
+
+        if (::ZSTD_isError(error) != 0)
+        {
+            throw Exception("failed to decompress data: {}", ::ZSTD_getErrorName(error));
         }
 
         return decompressed_buffer;
     }
-}
\ No newline at end of file
+
+    auto is_compressed(std::span<const std::byte> data) -> bool
+    {
+        if (data.size() < sizeof(std::uint32_t))
+        {
+            return false;
+        }
+
+        auto magic = std::uint32_t{};
+        std::memcpy(&magic, data.data(), sizeof(magic));
+
+        return magic == ZSTD_MAGICNUMBER;
+    }
+}
@@ -4,6 +4,7 @@
 
 #include "file.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
@@ -61,6 +62,23 @@ namespace game
         return {reinterpret_cast<const std::byte *>(_map_view.get()), _filesize};
     }
 
+    auto File::advise(AccessHint hint, std::size_t offset, std::size_t length) const -> void
+    {
+        // a mapped view only takes prefetch requests, the other hints have no equivalent
+        if (hint != AccessHint::WILL_NEED || offset >= _filesize)
+        {
+            return;
+        }
+
+        auto range = ::WIN32_MEMORY_RANGE_ENTRY{
+            .VirtualAddress = static_cast<std::byte *>(_map_view.get()) + offset,
+            .NumberOfBytes = std::min(length, _filesize - offset)};
+        if (::PrefetchVirtualMemory(::GetCurrentProcess(), 1u, &range, 0u) == 0)
+        {
+            log::warn("prefetch failed: {:x}", ::GetLastError());
+        }
+    }
+
     auto File::get_file_size() -> void
     {
         _filesize = ::GetFileSize(_handle, nullptr);
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "messaging/message_bus.h"
+#include "resources/async_resource_loader.h"
+#include "resources/resource_loader.h"
+#include "scheduler/scheduler.h"
+#include "scheduler/task.h"
+#include "scheduler/wait.h"
+#include "utils/exception.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto write_file(const std::filesystem::path &path, const std::string &contents) -> void
+    {
+        auto out = std::ofstream{path, std::ios::binary};
+        out << contents;
+    }
+}
+
+TEST(async_resource_loader, load_file)
+{
+    const auto root = std::filesystem::temp_directory_path();
+    write_file(root / "async_resource_loader_load_file.txt", "hello async");
+
+    TEST_IMPL(
+        const auto loader = game::ResourceLoader{root};
+        auto async_loader = game::AsyncResourceLoader{loader};
+
+        auto handle = async_loader.load("async_resource_loader_load_file.txt");
+        handle.wait();
+
+        const auto file = handle.get();
+        ASSERT_EQ(file->as_string(), "hello async");
+
+    )
+
+    std::filesystem::remove(root / "async_resource_loader_load_file.txt");
+}
+
+TEST(async_resource_loader, missing_file)
+{
+    const auto loader = game::ResourceLoader{std::filesystem::temp_directory_path()};
+    auto async_loader = game::AsyncResourceLoader{loader};
+
+    auto handle = async_loader.load("async_resource_loader_does_not_exist.txt");
+    handle.wait();
+
+    ASSERT_THROW(handle.get(), game::Exception);
+}
+
+TEST(async_resource_loader, submit)
+{
+    const auto loader = game::ResourceLoader{std::filesystem::temp_directory_path()};
+    auto async_loader = game::AsyncResourceLoader{loader};
+
+    auto handle = async_loader.submit<int>("answer", []
+                                           { return std::make_unique<int>(42); });
+    handle.wait();
+
+    ASSERT_EQ(handle.name(), "answer");
+    ASSERT_EQ(*handle.get(), 42);
+}
+
+TEST(async_resource_loader, await_in_scheduler)
+{
+    const auto root = std::filesystem::temp_directory_path();
+    write_file(root / "async_resource_loader_await.txt", "awaited");
+
+    TEST_IMPL(
+        const auto loader = game::ResourceLoader{root};
+        auto async_loader = game::AsyncResourceLoader{loader};
+        auto bus = game::messaging::MessageBus{};
+        auto sched = game::Scheduler{bus};
+        auto contents = std::string{};
+
+        sched.add([](game::Scheduler &scheduler, game::AsyncResourceLoader &async_loader, std::string &contents) -> game::Task
+                  {
+                      auto handle = async_loader.load("async_resource_loader_await.txt");
+                      co_await game::Wait{scheduler, handle};
+                      contents = handle.get()->as_string(); }(sched, async_loader, contents));
+
+        sched.run();
+
+        ASSERT_EQ(contents, "awaited");
+
+    )
+
+    std::filesystem::remove(root / "async_resource_loader_await.txt");
+}
+
+TEST(async_resource_loader, prefetch)
+{
+    const auto root = std::filesystem::temp_directory_path();
+    write_file(root / "async_resource_loader_prefetch.txt", "prefetched");
+
+    TEST_IMPL(
+        const auto loader = game::ResourceLoader{root};
+        auto async_loader = game::AsyncResourceLoader{loader, 1u};
+
+        // a failed prefetch is only logged
+        async_loader.prefetch("async_resource_loader_does_not_exist.txt");
+        async_loader.prefetch("async_resource_loader_prefetch.txt", 0u, 4u);
+
+        auto handle = async_loader.load("async_resource_loader_prefetch.txt");
+        handle.wait();
+
+        ASSERT_EQ(handle.get()->as_string(), "prefetched");
+
+    )
+
+    std::filesystem::remove(root / "async_resource_loader_prefetch.txt");
+}
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/texture.h"
+#include "packer/block_compression.h"
+#include "packer/mip_chain.h"
+#include "utils/exception.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto create_gradient(std::uint32_t width, std::uint32_t height) -> std::vector<std::byte>
+    {
+        auto rgba = std::vector<std::byte>(width * height * 4u);
+
+        for (auto y = 0u; y < height; ++y)
+        {
+            for (auto x = 0u; x < width; ++x)
+            {
+                auto *pixel = rgba.data() + (y * width + x) * 4u;
+                pixel[0] = static_cast<std::byte>(x * 255u / width);
+                pixel[1] = static_cast<std::byte>(y * 255u / height);
+                pixel[2] = static_cast<std::byte>((x + y) * 127u / (width + height));
+                pixel[3] = static_cast<std::byte>(255u - x * 255u / width);
+            }
+        }
+
+        return rgba;
+    }
+
+    auto create_solid(std::uint32_t width, std::uint32_t height, std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a)
+        -> std::vector<std::byte>
+    {
+        auto rgba = std::vector<std::byte>{};
+        for (auto i = 0u; i < width * height; ++i)
+        {
+            rgba.push_back(static_cast<std::byte>(r));
+            rgba.push_back(static_cast<std::byte>(g));
+            rgba.push_back(static_cast<std::byte>(b));
+            rgba.push_back(static_cast<std::byte>(a));
+        }
+        return rgba;
+    }
+
+    auto rmse(const std::vector<std::byte> &a, const std::vector<std::byte> &b, std::size_t channel) -> float
+    {
+        auto error = 0.0f;
+        for (auto i = channel; i < a.size(); i += 4u)
+        {
+            const auto d = static_cast<float>(std::to_integer<int>(a[i]) - std::to_integer<int>(b[i]));
+            error += d * d;
+        }
+        return std::sqrt(error / static_cast<float>(a.size() / 4u));
+    }
+}
+
+TEST(block_compression, encoded_size)
+{
+    const auto image = create_gradient(16u, 8u);
+
+    ASSERT_EQ(game::packer::encode(game::TextureFormat::BC1, image, 16u, 8u).size(), 8u * 8u);
+    ASSERT_EQ(game::packer::encode(game::TextureFormat::BC3, image, 16u, 8u).size(), 8u * 16u);
+    ASSERT_EQ(game::packer::encode(game::TextureFormat::BC5, image, 16u, 8u).size(), 8u * 16u);
+    ASSERT_EQ(game::packer::encode(game::TextureFormat::BC7, image, 16u, 8u).size(), 8u * 16u);
+}
+
+TEST(block_compression, encoded_size_matches_mip_level_size)
+{
+    const auto image = create_gradient(7u, 5u);
+
+    for (const auto format : {game::TextureFormat::BC1, game::TextureFormat::BC3, game::TextureFormat::BC5, game::TextureFormat::BC7})
+    {
+        ASSERT_EQ(game::packer::encode(format, image, 7u, 5u).size(), game::mip_level_size(format, 7u, 5u));
+    }
+}
+
+TEST(block_compression, bc1_solid_colour)
+{
+    // colours exactly representable in 565 must survive the round trip
+    const auto image = create_solid(4u, 4u, 0xff, 0x00, 0xff, 0xff);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC1, game::packer::encode(game::TextureFormat::BC1, image, 4u, 4u), 4u, 4u);
+
+    ASSERT_EQ(decoded, image);
+}
+
+TEST(block_compression, bc1_gradient)
+{
+    const auto image = create_gradient(32u, 32u);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC1, game::packer::encode(game::TextureFormat::BC1, image, 32u, 32u), 32u, 32u);
+
+    ASSERT_LT(rmse(image, decoded, 0u), 10.0f);
+    ASSERT_LT(rmse(image, decoded, 1u), 10.0f);
+    ASSERT_LT(rmse(image, decoded, 2u), 10.0f);
+}
+
+TEST(block_compression, bc3_keeps_alpha)
+{
+    const auto image = create_gradient(32u, 32u);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC3, game::packer::encode(game::TextureFormat::BC3, image, 32u, 32u), 32u, 32u);
+
+    ASSERT_LT(rmse(image, decoded, 0u), 10.0f);
+    ASSERT_LT(rmse(image, decoded, 3u), 2.0f);
+}
+
+TEST(block_compression, bc5_two_channels)
+{
+    const auto image = create_gradient(32u, 32u);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC5, game::packer::encode(game::TextureFormat::BC5, image, 32u, 32u), 32u, 32u);
+
+    ASSERT_LT(rmse(image, decoded, 0u), 2.0f);
+    ASSERT_LT(rmse(image, decoded, 1u), 2.0f);
+}
+
+TEST(block_compression, bc5_extremes)
+{
+    // a block with a single 0 and 255 outlier should use the six value mode and keep them exactly
+    auto image = create_solid(4u, 4u, 0x80, 0x80, 0x00, 0xff);
+    image[0] = std::byte{0x00};
+    image[4] = std::byte{0xff};
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC5, game::packer::encode(game::TextureFormat::BC5, image, 4u, 4u), 4u, 4u);
+
+    ASSERT_EQ(decoded[0], std::byte{0x00});
+    ASSERT_EQ(decoded[4], std::byte{0xff});
+    ASSERT_EQ(decoded[8], std::byte{0x80});
+}
+
+TEST(block_compression, bc7_gradient)
+{
+    const auto image = create_gradient(32u, 32u);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC7, game::packer::encode(game::TextureFormat::BC7, image, 32u, 32u), 32u, 32u);
+
+    for (auto channel = 0u; channel < 4u; ++channel)
+    {
+        ASSERT_LT(rmse(image, decoded, channel), 10.0f);
+    }
+}
+
+TEST(block_compression, bc7_solid_colour)
+{
+    const auto image = create_solid(4u, 4u, 200u, 100u, 50u, 128u);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC7, game::packer::encode(game::TextureFormat::BC7, image, 4u, 4u), 4u, 4u);
+
+    ASSERT_EQ(decoded, image);
+}
+
+TEST(block_compression, non_multiple_of_four)
+{
+    const auto image = create_solid(5u, 3u, 0xff, 0x00, 0x00, 0xff);
+
+    const auto decoded = game::packer::decode(game::TextureFormat::BC1, game::packer::encode(game::TextureFormat::BC1, image, 5u, 3u), 5u, 3u);
+
+    ASSERT_EQ(decoded, image);
+}
+
+TEST(block_compression, invalid_image_size)
+{
+    const auto image = create_solid(4u, 4u, 0u, 0u, 0u, 0u);
+
+    ASSERT_THROW(game::packer::encode(game::TextureFormat::BC1, image, 8u, 8u), game::Exception);
+}
+
+TEST(block_compression, invalid_format)
+{
+    const auto image = create_solid(4u, 4u, 0u, 0u, 0u, 0u);
+
+    ASSERT_THROW(game::packer::encode(game::TextureFormat::RGBA, image, 4u, 4u), game::Exception);
+}
+
+TEST(block_compression, expand_to_rgba)
+{
+    const auto rgb = std::vector<std::byte>{std::byte{1}, std::byte{2}, std::byte{3}, std::byte{4}, std::byte{5}, std::byte{6}};
+
+    const auto rgba = game::packer::expand_to_rgba(rgb, 3u);
+
+    const auto expected = std::vector<std::byte>{
+        std::byte{1}, std::byte{2}, std::byte{3}, std::byte{0xff}, std::byte{4}, std::byte{5}, std::byte{6}, std::byte{0xff}};
+    ASSERT_EQ(rgba, expected);
+}
+
+TEST(block_compression, mip_chain)
+{
+    const auto image = create_solid(8u, 2u, 10u, 20u, 30u, 40u);
+
+    const auto mips = game::packer::generate_mip_chain(image, 8u, 2u, false);
+
+    ASSERT_EQ(mips.size(), 4u);
+    ASSERT_EQ(mips[1].width, 4u);
+    ASSERT_EQ(mips[1].height, 1u);
+    ASSERT_EQ(mips[3].width, 1u);
+    ASSERT_EQ(mips[3].height, 1u);
+    ASSERT_EQ(mips[3].data, create_solid(1u, 1u, 10u, 20u, 30u, 40u));
+}
+
+TEST(block_compression, mip_chain_srgb)
+{
+    // a black and white checkerboard, with alternating alpha
+    auto image = std::vector<std::byte>{};
+    for (const auto value : {0u, 255u, 255u, 0u})
+    {
+        image.append_range(std::vector<std::byte>(3u, static_cast<std::byte>(value)));
+        image.push_back(static_cast<std::byte>(value));
+    }
+
+    const auto linear = game::packer::generate_mip_chain(image, 2u, 2u, false);
+    const auto srgb = game::packer::generate_mip_chain(image, 2u, 2u, true);
+
+    ASSERT_EQ(linear[1].data, create_solid(1u, 1u, 128u, 128u, 128u, 128u));
+
+    // half of the light is 188 when sRGB encoded, alpha is still averaged as is
+    ASSERT_EQ(srgb[1].data, create_solid(1u, 1u, 188u, 188u, 188u, 128u));
+}
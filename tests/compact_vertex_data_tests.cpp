@@ -0,0 +1,147 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/compact_vertex_data.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "packer/vertex_quantizer.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto create_sphere_directions() -> std::vector<game::Vector3>
+    {
+        auto directions = std::vector<game::Vector3>{};
+        for (auto i = 0; i < 16; ++i)
+        {
+            for (auto j = 0; j <= 16; ++j)
+            {
+                const auto theta = static_cast<float>(i) * 0.3926991f;
+                const auto phi = static_cast<float>(j) * 0.1963495f;
+                directions.push_back({std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi)});
+            }
+        }
+
+        return directions;
+    }
+}
+
+TEST(compact_vertex_data, half_exact_values)
+{
+    for (const auto value : {0.f, 1.f, -2.f, 0.5f, 1024.f, 65504.f, 0.00006103515625f})
+    {
+        ASSERT_EQ(game::from_half(game::to_half(value)), value);
+    }
+
+    ASSERT_EQ(game::to_half(1.f), 0x3c00u);
+    ASSERT_EQ(game::to_half(-2.f), 0xc000u);
+}
+
+TEST(compact_vertex_data, half_rounding)
+{
+    // 1 + 2^-11 is exactly between two halves and rounds to even, anything above rounds up
+    ASSERT_EQ(game::to_half(1.f + 0.00048828125f), 0x3c00u);
+    ASSERT_EQ(game::to_half(1.f + 0.0006f), 0x3c01u);
+
+    for (auto value = -4.f; value <= 4.f; value += 0.01f)
+    {
+        ASSERT_NEAR(game::from_half(game::to_half(value)), value, 0.002f);
+    }
+}
+
+TEST(compact_vertex_data, half_special_values)
+{
+    ASSERT_EQ(game::to_half(100000.f), 0x7c00u);
+    ASSERT_TRUE(std::isinf(game::from_half(game::to_half(std::numeric_limits<float>::infinity()))));
+    ASSERT_TRUE(std::isnan(game::from_half(game::to_half(std::numeric_limits<float>::quiet_NaN()))));
+
+    // smallest subnormal half
+    ASSERT_EQ(game::to_half(0.000000059604645f), 0x0001u);
+    ASSERT_EQ(game::from_half(0x0001u), 0.000000059604645f);
+    ASSERT_EQ(game::to_half(0.00000001f), 0x0000u);
+}
+
+TEST(compact_vertex_data, snorm16)
+{
+    ASSERT_EQ(game::to_snorm16(1.f), 32767);
+    ASSERT_EQ(game::to_snorm16(-1.f), -32767);
+    ASSERT_EQ(game::to_snorm16(2.f), 32767);
+    ASSERT_EQ(game::to_snorm16(0.f), 0);
+
+    ASSERT_EQ(game::from_snorm16(32767), 1.f);
+    ASSERT_EQ(game::from_snorm16(-32768), -1.f);
+    ASSERT_NEAR(game::from_snorm16(game::to_snorm16(0.3f)), 0.3f, 1.f / 32767.f);
+}
+
+TEST(compact_vertex_data, octahedral_axes)
+{
+    for (const auto &axis : {
+             game::Vector3{1.f, 0.f, 0.f},
+             game::Vector3{-1.f, 0.f, 0.f},
+             game::Vector3{0.f, 1.f, 0.f},
+             game::Vector3{0.f, -1.f, 0.f},
+             game::Vector3{0.f, 0.f, 1.f},
+             game::Vector3{0.f, 0.f, -1.f}})
+    {
+        ASSERT_EQ(game::decode_octahedral(game::encode_octahedral(axis)), axis);
+    }
+}
+
+TEST(compact_vertex_data, octahedral_round_trip)
+{
+    for (const auto &direction : create_sphere_directions())
+    {
+        const auto decoded = game::decode_octahedral(game::encode_octahedral(direction));
+
+        ASSERT_NEAR(decoded.length(), 1.f, 0.0001f);
+        ASSERT_GT(game::Vector3::dot(decoded, game::Vector3::normalize(direction)), 0.99999f);
+    }
+}
+
+TEST(compact_vertex_data, compact_vertex_round_trip)
+{
+    const auto quantization = game::VertexQuantization{.scale = {10.f, 1.f, 0.5f}, .bias = {0.f, -1.f, 2.f}};
+    const auto vertex = game::VertexData{
+        .position = {-5.f, -0.25f, 2.4f},
+        .normal = game::Vector3::normalize({1.f, 2.f, -3.f}),
+        .tangent = game::Vector3::normalize({-3.f, 0.f, -1.f}),
+        .uv = {0.75f, 3.5f}};
+
+    const auto compact = game::compact_vertex(vertex, quantization);
+    const auto expanded = game::expand_vertex(compact, quantization);
+
+    ASSERT_NEAR(expanded.position.x, vertex.position.x, 0.0005f);
+    ASSERT_NEAR(expanded.position.y, vertex.position.y, 0.0001f);
+    ASSERT_NEAR(expanded.position.z, vertex.position.z, 0.0001f);
+    ASSERT_GT(game::Vector3::dot(expanded.normal, vertex.normal), 0.9999f);
+    ASSERT_GT(game::Vector3::dot(expanded.tangent, vertex.tangent), 0.9999f);
+    ASSERT_EQ(expanded.uv.u, 0.75f);
+    ASSERT_EQ(expanded.uv.v, 3.5f);
+    ASSERT_EQ(game::expand_position(compact, quantization), expanded.position);
+}
+
+TEST(compact_vertex_data, quantize_vertices)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {-2.f, 1.f, 5.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {0.f, 0.f}},
+        {.position = {6.f, 1.f, 7.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {1.f, 0.f}},
+        {.position = {0.f, 1.f, 6.f}, .normal = {0.f, 0.f, -1.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {0.5f, 1.f}}};
+
+    const auto quantized = game::packer::quantize_vertices(vertices);
+
+    ASSERT_EQ(quantized.vertices.size(), 3u);
+    ASSERT_EQ(quantized.quantization.bias, (game::Vector3{2.f, 1.f, 6.f}));
+    // the flat y axis still gets a usable scale
+    ASSERT_EQ(quantized.quantization.scale, (game::Vector3{4.f, 1.f, 1.f}));
+
+    const auto error = game::packer::measure_quantization_error(vertices, quantized);
+
+    ASSERT_LT(error.position, 0.0002f);
+    ASSERT_LT(error.direction, 0.01f);
+    ASSERT_EQ(error.uv, 0.f);
+}
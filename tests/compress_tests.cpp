@@ -31,4 +31,44 @@ TEST(compress, round_trip)
         ASSERT_TRUE(std::ranges::equal(decompressed, text_as_bytes));
 
     )
-}
\ No newline at end of file
+}
+
+TEST(compress, chunked_round_trip)
+{
+    TEST_IMPL(
+        auto data = std::vector<std::byte>(10000u);
+        for (auto i = 0u; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::byte>((i * 7u) % 251u);
+        }
+
+        const auto compressed = game::compress_chunked(data, 1000u, -5);
+
+        const auto decompressed = game::decompress(compressed);
+
+        ASSERT_TRUE(game::is_compressed(compressed));
+        ASSERT_EQ(decompressed, data);
+
+    )
+}
+
+TEST(compress, chunked_uneven_last_chunk)
+{
+    TEST_IMPL(
+        const auto data = std::vector<std::byte>(2500u, std::byte{0x2a});
+
+        const auto compressed = game::compress_chunked(data, 1000u, 3);
+
+        ASSERT_EQ(game::decompress(compressed), data);
+
+    )
+}
+
+TEST(compress, is_compressed)
+{
+    const auto data = std::vector<std::byte>(64u, std::byte{0x01});
+
+    ASSERT_TRUE(game::is_compressed(game::compress(data)));
+    ASSERT_FALSE(game::is_compressed(data));
+    ASSERT_FALSE(game::is_compressed({}));
+}
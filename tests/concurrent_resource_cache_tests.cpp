@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "resources/concurrent_resource_cache.h"
+#include "resources/resource_id.h"
+#include "utils/exception.h"
+
+TEST(concurrent_resource_cache, insert_get)
+{
+    using namespace game::literals;
+
+    auto cache = game::ConcurrentResourceCache<int>{};
+
+    const auto *v = cache.insert<int>("test_int", 12345);
+
+    ASSERT_EQ(cache.get<int>("test_int"), v);
+    ASSERT_EQ(*cache.get<int>("test_int"_id), 12345);
+    ASSERT_FALSE(cache.contains<int>("other_int"));
+}
+
+TEST(concurrent_resource_cache, get_or_create_once)
+{
+    auto cache = game::ConcurrentResourceCache<int>{};
+    auto created = std::atomic<int>{};
+    auto results = std::vector<int *>(8u);
+
+    {
+        auto threads = std::vector<std::jthread>{};
+        for (auto i = 0u; i < results.size(); ++i)
+        {
+            threads.emplace_back([&, i]
+                                 { results[i] = cache.get_or_create<int>("shared", [&]
+                                                                         {
+                                                                             ++created;
+                                                                             std::this_thread::yield();
+                                                                             return 42; }); });
+        }
+    }
+
+    ASSERT_EQ(created, 1);
+    for (const auto *result : results)
+    {
+        ASSERT_EQ(result, results.front());
+        ASSERT_EQ(*result, 42);
+    }
+}
+
+TEST(concurrent_resource_cache, get_or_create_retries_after_failure)
+{
+    auto cache = game::ConcurrentResourceCache<int>{};
+
+    ASSERT_THROW(cache.get_or_create<int>("flaky", []() -> int
+                                          { throw game::Exception("load failed"); }),
+                 game::Exception);
+    ASSERT_FALSE(cache.contains<int>("flaky"));
+
+    ASSERT_EQ(*cache.get_or_create<int>("flaky", []
+                                        { return 7; }),
+              7);
+}
+
+TEST(concurrent_resource_cache, parallel_inserts)
+{
+    auto cache = game::ConcurrentResourceCache<int>{};
+
+    {
+        auto threads = std::vector<std::jthread>{};
+        for (auto t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&cache, t]
+                                 {
+                                     for (auto i = 0; i < 1000; ++i)
+                                     {
+                                         cache.insert<int>(std::to_string(t) + "_" + std::to_string(i), i);
+                                     } });
+        }
+    }
+
+    for (auto t = 0; t < 4; ++t)
+    {
+        for (auto i = 0; i < 1000; ++i)
+        {
+            ASSERT_EQ(*cache.get<int>(std::to_string(t) + "_" + std::to_string(i)), i);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstdint>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "graphics/camera.h"
+#include "math/frustum_culler.h"
+#include "math/frustum_plane.h"
+#include "math/vector3.h"
+
+namespace
+{
+    auto test_planes() -> std::array<game::FrustumPlane, 6u>
+    {
+        const auto camera = game::Camera{{0.f, 0.f, 20.f},
+                                         {0.f, 0.f, 0.f},
+                                         {0.f, 1.f, 0.f},
+                                         std::numbers::pi_v<float> / 4.f,
+                                         1920.f,
+                                         1080.f,
+                                         0.1f,
+                                         500.f};
+        return camera.frustum_planes();
+    }
+
+    auto test_bounds(std::int64_t count) -> game::BoundsBatch
+    {
+        auto rng = std::mt19937{42u};
+        auto position = std::uniform_real_distribution{-500.f, 500.f};
+        auto size = std::uniform_real_distribution{0.1f, 5.f};
+
+        auto bounds = game::BoundsBatch{};
+        for (auto i = 0; i < count; ++i)
+        {
+            bounds.add({position(rng), position(rng), position(rng)}, {size(rng), size(rng), size(rng)});
+        }
+
+        return bounds;
+    }
+}
+
+static auto frustum_cull(benchmark::State &state) -> void
+{
+    const auto bounds = test_bounds(state.range(0));
+    const auto culler = game::FrustumCuller{test_planes()};
+    auto visible = std::vector<std::uint64_t>{};
+
+    for (auto _ : state)
+    {
+        culler.cull(bounds, visible);
+        benchmark::DoNotOptimize(visible.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(frustum_cull)->Arg(100'000);
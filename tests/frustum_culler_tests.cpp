@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "math/frustum_culler.h"
+#include "math/frustum_plane.h"
+#include "math/vector3.h"
+
+namespace
+{
+    // the box from -10 to 10 on every axis, normals pointing inwards
+    const auto planes = std::array<game::FrustumPlane, 6u>{{
+        {1.f, 0.f, 0.f, 10.f},
+        {-1.f, 0.f, 0.f, 10.f},
+        {0.f, 1.f, 0.f, 10.f},
+        {0.f, -1.f, 0.f, 10.f},
+        {0.f, 0.f, 1.f, 10.f},
+        {0.f, 0.f, -1.f, 10.f},
+    }};
+
+    // the test the culler replaced, using the corner furthest along each normal
+    auto intersects(const game::Vector3 &center, const game::Vector3 &extents, const std::array<game::FrustumPlane, 6u> &frustum) -> bool
+    {
+        const auto min = center - extents;
+        const auto max = center + extents;
+
+        for (const auto &plane : frustum)
+        {
+            const auto corner = game::Vector3{
+                plane.normal.x >= 0.f ? max.x : min.x,
+                plane.normal.y >= 0.f ? max.y : min.y,
+                plane.normal.z >= 0.f ? max.z : min.z};
+
+            if (game::Vector3::dot(plane.normal, corner) + plane.distance < 0.f)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+TEST(frustum_culler, inside_outside_intersecting)
+{
+    auto bounds = game::BoundsBatch{};
+    bounds.add({0.f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+    bounds.add({20.f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+    bounds.add({10.5f, 0.f, 0.f}, {1.f, 1.f, 1.f});
+    bounds.add({0.f, -12.f, 0.f}, {1.f, 1.f, 1.f});
+    bounds.add({0.f, 0.f, -30.f}, {1.f, 1.f, 25.f});
+
+    auto visible = std::vector<std::uint64_t>{};
+    game::FrustumCuller{planes}.cull(bounds, visible);
+
+    ASSERT_EQ(visible.size(), 1u);
+    EXPECT_TRUE(game::FrustumCuller::is_visible(visible, 0u));
+    EXPECT_FALSE(game::FrustumCuller::is_visible(visible, 1u));
+    EXPECT_TRUE(game::FrustumCuller::is_visible(visible, 2u));
+    EXPECT_FALSE(game::FrustumCuller::is_visible(visible, 3u));
+    EXPECT_TRUE(game::FrustumCuller::is_visible(visible, 4u));
+}
+
+TEST(frustum_culler, matches_corner_test)
+{
+    const auto frustum = std::array<game::FrustumPlane, 6u>{{
+        {0.3f, 0.1f, 1.f, 5.f},
+        {-0.2f, 0.f, -1.f, 50.f},
+        {1.f, 0.2f, -0.4f, 12.f},
+        {-1.f, 0.1f, -0.4f, 12.f},
+        {0.1f, 1.f, -0.3f, 8.f},
+        {0.f, -1.f, -0.3f, 8.f},
+    }};
+
+    auto rng = std::mt19937{42u};
+    auto position = std::uniform_real_distribution{-60.f, 60.f};
+    auto size = std::uniform_real_distribution{0.1f, 5.f};
+
+    // not a multiple of eight, so every path is taken
+    auto centers = std::vector<game::Vector3>{};
+    auto extents = std::vector<game::Vector3>{};
+    auto bounds = game::BoundsBatch{};
+    for (auto i = 0u; i < 1003u; ++i)
+    {
+        centers.push_back({position(rng), position(rng), position(rng)});
+        extents.push_back({size(rng), size(rng), size(rng)});
+        bounds.add(centers.back(), extents.back());
+    }
+
+    auto visible = std::vector<std::uint64_t>{};
+    game::FrustumCuller{frustum}.cull(bounds, visible);
+
+    ASSERT_EQ(visible.size(), 16u);
+
+    auto visible_count = 0u;
+    for (auto i = 0u; i < centers.size(); ++i)
+    {
+        const auto expected = intersects(centers[i], extents[i], frustum);
+        EXPECT_EQ(game::FrustumCuller::is_visible(visible, i), expected) << "box " << i;
+        visible_count += expected;
+    }
+
+    // make sure the test is not trivially passing
+    EXPECT_GT(visible_count, 0u);
+    EXPECT_LT(visible_count, centers.size());
+}
+
+TEST(frustum_culler, empty)
+{
+    auto visible = std::vector<std::uint64_t>{1u, 2u};
+    game::FrustumCuller{planes}.cull(game::BoundsBatch{}, visible);
+
+    EXPECT_TRUE(visible.empty());
+}
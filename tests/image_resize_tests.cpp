@@ -0,0 +1,110 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "packer/image_resize.h"
+#include "utils/exception.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto create_checkerboard(std::uint32_t width, std::uint32_t height, std::uint32_t num_channels) -> std::vector<std::byte>
+    {
+        auto pixels = std::vector<std::byte>(width * height * num_channels);
+
+        for (auto y = 0u; y < height; ++y)
+        {
+            for (auto x = 0u; x < width; ++x)
+            {
+                for (auto c = 0u; c < num_channels; ++c)
+                {
+                    pixels[(y * width + x) * num_channels + c] = (x + y) % 2u == 0u ? std::byte{0xff} : std::byte{0x00};
+                }
+            }
+        }
+
+        return pixels;
+    }
+}
+
+TEST(image_resize, constant_image)
+{
+    const auto pixels = std::vector<std::byte>(64u * 32u * 3u, std::byte{0x5a});
+
+    TEST_IMPL(
+        const auto result = game::packer::downscale_image(pixels, 64u, 32u, 3u, 16u, 8u, true);
+
+        ASSERT_EQ(result.size(), 16u * 8u * 3u);
+        for (const auto value : result)
+        {
+            ASSERT_EQ(value, std::byte{0x5a});
+        }
+
+    )
+}
+
+TEST(image_resize, checkerboard_linear)
+{
+    const auto pixels = create_checkerboard(32u, 32u, 1u);
+
+    TEST_IMPL(
+        const auto result = game::packer::downscale_image(pixels, 32u, 32u, 1u, 16u, 16u, false);
+
+        // the edges repeat the border pixel, so only pixels the filter does not reach past the edge from are exact
+        for (auto y = 3u; y < 13u; ++y)
+        {
+            for (auto x = 3u; x < 13u; ++x)
+            {
+                ASSERT_LE(std::abs(std::to_integer<int>(result[y * 16u + x]) - 128), 1);
+            }
+        }
+
+    )
+}
+
+TEST(image_resize, checkerboard_srgb)
+{
+    // half the light of white is 188 in srgb, averaging the encoded values would give 128
+    const auto pixels = create_checkerboard(64u, 64u, 4u);
+
+    TEST_IMPL(
+        const auto result = game::packer::downscale_image(pixels, 64u, 64u, 4u, 16u, 16u, true);
+
+        for (auto y = 3u; y < 13u; ++y)
+        {
+            for (auto x = 3u; x < 13u; ++x)
+            {
+                for (auto c = 0u; c < 4u; ++c)
+                {
+                    const auto expected = c == 3u ? 128 : 188;
+                    ASSERT_LE(std::abs(std::to_integer<int>(result[(y * 16u + x) * 4u + c]) - expected), 1);
+                }
+            }
+        }
+
+    )
+}
+
+TEST(image_resize, odd_dimensions)
+{
+    const auto pixels = std::vector<std::byte>(5u * 3u * 4u, std::byte{0x10});
+
+    TEST_IMPL(
+        const auto result = game::packer::downscale_image(pixels, 5u, 3u, 4u, 2u, 1u, false);
+
+        ASSERT_EQ(result.size(), 2u * 1u * 4u);
+        ASSERT_EQ(result[0], std::byte{0x10});
+
+    )
+}
+
+TEST(image_resize, upscale)
+{
+    const auto pixels = std::vector<std::byte>(4u * 4u, std::byte{0x10});
+
+    ASSERT_THROW(game::packer::downscale_image(pixels, 4u, 4u, 1u, 8u, 8u, false), game::Exception);
+}
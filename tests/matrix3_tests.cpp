@@ -4,6 +4,8 @@
 #include <print>
 
 #include "math/matrix3.h"
+#include "math/matrix3x4.h"
+#include "math/matrix4.h"
 #include "math/vector3.h"
 
 TEST(matrix3, ctor_identity)
@@ -51,6 +53,19 @@ TEST(matrix3, ctor_from_three_vectors)
     ASSERT_FLOAT_EQ(m[8], 6.f);
 }
 
+TEST(matrix3, ctor_from_matrix4)
+{
+    const auto m4 = game::Matrix4{{1.f, 2.f, 3.f, 0.f,
+                                   4.f, 5.f, 6.f, 0.f,
+                                   7.f, 8.f, 9.f, 0.f,
+                                   10.f, 11.f, 12.f, 1.f}};
+
+    const auto m = game::Matrix3{m4};
+
+    ASSERT_EQ(m, (game::Matrix3{{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f}}));
+    ASSERT_EQ(game::Matrix3{game::Matrix3x4{m4}}, m);
+}
+
 TEST(matrix3, multiply_by_identity)
 {
     float vals[] = {
@@ -164,4 +179,27 @@ TEST(matrix3, matrix_times_invert_equals_identiy)
     ASSERT_FLOAT_EQ(result[6], identity[6]);
     ASSERT_FLOAT_EQ(result[7], identity[7]);
     ASSERT_FLOAT_EQ(result[8], identity[8]);
-}
\ No newline at end of file
+}
+
+TEST(matrix3, inverse_transpose)
+{
+    float vals[] = {
+        1.f, 2.f, -1.f,
+        2.f, 1.f, 2.f,
+        -1.f, 3.f, 1.f};
+
+    const auto m = game::Matrix3{vals};
+
+    const auto result = game::Matrix3::inverse_transpose(m);
+    const auto expected = game::Matrix3::transpose(game::Matrix3::invert(m));
+
+    ASSERT_FLOAT_EQ(result[0], expected[0]);
+    ASSERT_FLOAT_EQ(result[1], expected[1]);
+    ASSERT_FLOAT_EQ(result[2], expected[2]);
+    ASSERT_FLOAT_EQ(result[3], expected[3]);
+    ASSERT_FLOAT_EQ(result[4], expected[4]);
+    ASSERT_FLOAT_EQ(result[5], expected[5]);
+    ASSERT_FLOAT_EQ(result[6], expected[6]);
+    ASSERT_FLOAT_EQ(result[7], expected[7]);
+    ASSERT_FLOAT_EQ(result[8], expected[8]);
+}
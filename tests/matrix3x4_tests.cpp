@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+
+#include "math/matrix3x4.h"
+#include "math/matrix4.h"
+#include "math/quaternion.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    constexpr auto rotation = game::Quaternion{0.f, 0.6f, 0.f, 0.8f};
+}
+
+TEST(matrix3x4, identity_ctor)
+{
+    const auto m = game::Matrix3x4{};
+    const auto expected = std::array<float, 12u>{1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f};
+
+    expect_near(m.data(), expected);
+}
+
+TEST(matrix3x4, from_matrix4_by_rows)
+{
+    const auto m = game::Matrix3x4{game::Matrix4{game::Vector3{1.f, 2.f, 3.f}, game::Vector3{4.f, 5.f, 6.f}}};
+    const auto expected = std::array<float, 12u>{4.f, 0.f, 0.f, 1.f, 0.f, 5.f, 0.f, 2.f, 0.f, 0.f, 6.f, 3.f};
+
+    expect_near(m.data(), expected);
+    ASSERT_EQ(static_cast<game::Matrix4>(m), (game::Matrix4{game::Vector3{1.f, 2.f, 3.f}, game::Vector3{4.f, 5.f, 6.f}}));
+}
+
+TEST(matrix3x4, compose)
+{
+    const auto m = game::Matrix3x4::compose({1.f, -2.f, 3.f}, rotation, {2.f, 3.f, 4.f});
+    const auto expected = game::Matrix4::compose({1.f, -2.f, 3.f}, rotation, {2.f, 3.f, 4.f});
+
+    expect_near(static_cast<game::Matrix4>(m).data(), expected.data());
+}
+
+TEST(matrix3x4, multiply)
+{
+    const auto m1 = game::Matrix4::compose({1.f, -2.f, 3.f}, rotation, {2.f, 3.f, 4.f});
+    const auto m2 = game::Matrix4::compose({-4.f, 0.5f, 2.f}, {0.f, 0.f, 0.6f, 0.8f}, {1.f, 2.f, 1.f});
+
+    const auto result = game::Matrix3x4{m1} * game::Matrix3x4{m2};
+
+    expect_near(static_cast<game::Matrix4>(result).data(), (m1 * m2).data());
+}
+
+TEST(matrix3x4, invert)
+{
+    const auto m = game::Matrix3x4::compose({1.f, -2.f, 3.f}, rotation, {2.f, 3.f, 4.f});
+
+    expect_near((game::Matrix3x4::invert(m) * m).data(), game::Matrix3x4{}.data());
+    expect_near((m * game::Matrix3x4::invert(m)).data(), game::Matrix3x4{}.data());
+}
+
+TEST(matrix3x4, transform_point_and_vector)
+{
+    const auto m4 = game::Matrix4::compose({1.f, -2.f, 3.f}, rotation, {2.f, 3.f, 4.f});
+    const auto m = game::Matrix3x4{m4};
+    const auto v = game::Vector3{.5f, 1.5f, 2.5f};
+
+    const auto point = m.transform_point(v);
+    const auto expected_point = m4 * game::Vector4{v, 1.f};
+    EXPECT_NEAR(point.x, expected_point.x, 0.00001f);
+    EXPECT_NEAR(point.y, expected_point.y, 0.00001f);
+    EXPECT_NEAR(point.z, expected_point.z, 0.00001f);
+
+    const auto vector = m.transform_vector(v);
+    const auto expected_vector = m4 * game::Vector4{v, 0.f};
+    EXPECT_NEAR(vector.x, expected_vector.x, 0.00001f);
+    EXPECT_NEAR(vector.y, expected_vector.y, 0.00001f);
+    EXPECT_NEAR(vector.z, expected_vector.z, 0.00001f);
+}
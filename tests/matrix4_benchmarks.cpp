@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <vector>
+
+#include "math/matrix4.h"
+#include "math/quaternion.h"
+#include "math/transform.h"
+#include "math/transform_batch.h"
+#include "math/vector3.h"
+#include "math/vector4.h"
+
+namespace
+{
+    // the product as it was before the simd kernels, to compare against
+    auto multiply_scalar(const game::Matrix4 &m1, const game::Matrix4 &m2) -> game::Matrix4
+    {
+        auto result = std::array<float, 16u>{};
+        for (auto i = 0u; i < 4u; i++)
+        {
+            for (auto j = 0u; j < 4u; j++)
+            {
+                auto sum = 0.f;
+                for (auto k = 0u; k < 4u; ++k)
+                {
+                    sum += m1[i + k * 4] * m2[k + j * 4];
+                }
+                result[i + j * 4] = sum;
+            }
+        }
+
+        return {result};
+    }
+
+    auto test_matrix() -> game::Matrix4
+    {
+        return game::Transform{{1.f, -2.f, 3.f}, {2.f, 3.f, 4.f}, {0.f, 0.6f, 0.f, 0.8f}};
+    }
+}
+
+static auto matrix4_multiply_scalar(benchmark::State &state) -> void
+{
+    auto m1 = test_matrix();
+    const auto m2 = test_matrix();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m1);
+        benchmark::DoNotOptimize(multiply_scalar(m1, m2));
+    }
+}
+BENCHMARK(matrix4_multiply_scalar);
+
+static auto matrix4_multiply(benchmark::State &state) -> void
+{
+    auto m1 = test_matrix();
+    const auto m2 = test_matrix();
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m1);
+        benchmark::DoNotOptimize(m1 * m2);
+    }
+}
+BENCHMARK(matrix4_multiply);
+
+static auto matrix4_mul_vector4(benchmark::State &state) -> void
+{
+    auto m = test_matrix();
+    const auto v = game::Vector4{.5f, 1.5f, 2.5f, 1.f};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(m);
+        benchmark::DoNotOptimize(m * v);
+    }
+}
+BENCHMARK(matrix4_mul_vector4);
+
+static auto transform_to_matrix4(benchmark::State &state) -> void
+{
+    auto transform = game::Transform{{1.f, -2.f, 3.f}, {2.f, 3.f, 4.f}, {0.f, 0.6f, 0.f, 0.8f}};
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(transform);
+        benchmark::DoNotOptimize(static_cast<game::Matrix4>(transform));
+    }
+}
+BENCHMARK(transform_to_matrix4);
+
+static auto transform_batch_compose(benchmark::State &state) -> void
+{
+    auto batch = game::TransformBatch{};
+    for (auto i = 0; i < state.range(0); ++i)
+    {
+        batch.add({{static_cast<float>(i), -2.f, 3.f}, {2.f, 3.f, 4.f}, {0.f, 0.6f, 0.f, 0.8f}});
+    }
+    auto models = std::vector<game::Matrix4>(batch.size());
+
+    for (auto _ : state)
+    {
+        batch.compose(models);
+        benchmark::DoNotOptimize(models.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(transform_batch_compose)->Arg(1024);
@@ -190,4 +190,46 @@ TEST(matrix4, mul_vector4)
     const auto expected = game::Vector4{76.f, 84.f, 92.f, 100.f};
 
     ASSERT_EQ(result, expected);
-}
\ No newline at end of file
+}
+
+TEST(matrix4, multiply_matches_constant_evaluation)
+{
+    static constexpr auto translate = game::Matrix4{game::Vector3{1.f, -2.f, 3.f}};
+    static constexpr auto rotate = game::Matrix4{game::Quaternion{0.f, 0.6f, 0.f, 0.8f}};
+    static constexpr auto scale = game::Matrix4{game::Vector3{2.f, 3.f, 4.f}, game::Matrix4::Scale{}};
+
+    static constexpr auto expected = translate * rotate * scale;
+
+    // not constexpr, so the product runs through the simd path
+    const auto result = translate * rotate * scale;
+
+    const auto result_spn = result.data();
+    const auto expected_spn = expected.data();
+    for (auto i = 0u; i < 16u; ++i)
+    {
+        ASSERT_NEAR(result_spn[i], expected_spn[i], 0.00001f);
+    }
+}
+
+TEST(matrix4, multiply_assign_self)
+{
+    auto m = game::Matrix4{{1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f,
+                            11.f, 12.f, 13.f, 14.f, 15.f, 16.f}};
+
+    m *= m;
+
+    const auto expected = game::Matrix4{{90.f, 100.f, 110.f, 120.f, 202.f, 228.f, 254.f, 280.f, 314.f, 356.f, 398.f, 440.f, 426.f, 484.f, 542.f, 600.f}};
+
+    ASSERT_EQ(m, expected);
+}
+
+TEST(matrix4, mul_vector4_matches_constant_evaluation)
+{
+    static constexpr auto m = game::Matrix4{game::Vector3{1.f, -2.f, 3.f}, game::Vector3{2.f, 3.f, 4.f}};
+    static constexpr auto v = game::Vector4{.5f, 1.5f, 2.5f, 1.f};
+
+    static constexpr auto expected = m * v;
+    static_assert(expected == game::Vector4{2.f, 2.5f, 13.f, 1.f});
+
+    ASSERT_EQ(m * v, expected);
+}
@@ -0,0 +1,166 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
+#include "graphics/mesh_data.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto create_vertices(const std::vector<game::Vector3> &positions) -> std::vector<game::VertexData>
+    {
+        auto vertices = std::vector<game::VertexData>{};
+        for (const auto &position : positions)
+        {
+            vertices.push_back({.position = position, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {}});
+        }
+
+        return vertices;
+    }
+}
+
+TEST(mesh_bounds, empty_mesh)
+{
+    const auto bounds = game::compute_bounds({.vertices = {}, .indices = {}});
+
+    ASSERT_EQ(bounds.min, game::Vector3{});
+    ASSERT_EQ(bounds.max, game::Vector3{});
+    ASSERT_EQ(bounds.radius, 0.f);
+}
+
+TEST(mesh_bounds, single_vertex)
+{
+    const auto vertices = create_vertices({{1.f, 2.f, 3.f}});
+
+    const auto bounds = game::compute_bounds({.vertices = vertices, .indices = {}});
+
+    ASSERT_EQ(bounds.min, (game::Vector3{1.f, 2.f, 3.f}));
+    ASSERT_EQ(bounds.max, (game::Vector3{1.f, 2.f, 3.f}));
+    ASSERT_EQ(bounds.center, (game::Vector3{1.f, 2.f, 3.f}));
+    ASSERT_EQ(bounds.radius, 0.f);
+}
+
+TEST(mesh_bounds, box)
+{
+    const auto vertices = create_vertices({
+        {-1.f, -2.f, -3.f},
+        {1.f, -2.f, -3.f},
+        {-1.f, 2.f, -3.f},
+        {1.f, 2.f, -3.f},
+        {-1.f, -2.f, 3.f},
+        {1.f, -2.f, 3.f},
+        {-1.f, 2.f, 3.f},
+        {1.f, 2.f, 3.f},
+        {0.f, 0.f, 0.f},
+    });
+
+    const auto bounds = game::compute_bounds({.vertices = vertices, .indices = {}});
+
+    ASSERT_EQ(bounds.min, (game::Vector3{-1.f, -2.f, -3.f}));
+    ASSERT_EQ(bounds.max, (game::Vector3{1.f, 2.f, 3.f}));
+    ASSERT_EQ(bounds.center, (game::Vector3{0.f, 0.f, 0.f}));
+    ASSERT_NEAR(bounds.radius, (game::Vector3{1.f, 2.f, 3.f}.length()), 1e-5f);
+}
+
+TEST(mesh_bounds, sphere_contains_all_vertices)
+{
+    auto rng = std::mt19937{42u};
+    auto dist = std::uniform_real_distribution<float>{-10.f, 10.f};
+
+    auto positions = std::vector<game::Vector3>{};
+    for (auto i = 0u; i < 1000u; ++i)
+    {
+        positions.push_back({dist(rng), dist(rng) * 0.1f + 5.f, dist(rng) * 2.f});
+    }
+    const auto vertices = create_vertices(positions);
+
+    const auto bounds = game::compute_bounds({.vertices = vertices, .indices = {}});
+
+    for (const auto &position : positions)
+    {
+        ASSERT_GE(position.x, bounds.min.x);
+        ASSERT_GE(position.y, bounds.min.y);
+        ASSERT_GE(position.z, bounds.min.z);
+        ASSERT_LE(position.x, bounds.max.x);
+        ASSERT_LE(position.y, bounds.max.y);
+        ASSERT_LE(position.z, bounds.max.z);
+        ASSERT_LE(game::Vector3::distance(bounds.center, position), bounds.radius * 1.0001f);
+    }
+
+    // never worse than the sphere around the box
+    ASSERT_LE(bounds.radius, ((bounds.max - bounds.min) * 0.5f).length() * 1.0001f);
+}
+
+TEST(mesh_bounds, compact_vertices)
+{
+    const auto quantization = game::VertexQuantization{.scale = {2.f}, .bias = {1.f}};
+    const auto compact_vertices = std::vector<game::CompactVertexData>{
+        game::compact_vertex({.position = {-1.f, 1.f, 1.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {}}, quantization),
+        game::compact_vertex({.position = {3.f, 2.f, 0.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {}}, quantization),
+    };
+
+    const auto bounds = game::compute_bounds(
+        {.vertices = {}, .indices = {}, .compact_vertices = compact_vertices, .quantization = quantization});
+
+    ASSERT_NEAR(bounds.min.x, -1.f, 1e-3f);
+    ASSERT_NEAR(bounds.min.y, 1.f, 1e-3f);
+    ASSERT_NEAR(bounds.min.z, 0.f, 1e-3f);
+    ASSERT_NEAR(bounds.max.x, 3.f, 1e-3f);
+    ASSERT_NEAR(bounds.max.y, 2.f, 1e-3f);
+    ASSERT_NEAR(bounds.max.z, 1.f, 1e-3f);
+}
+
+TEST(mesh_bounds, merge_contains_both_meshes)
+{
+    auto rng = std::mt19937{7u};
+    auto dist = std::uniform_real_distribution<float>{-1.f, 1.f};
+
+    auto first = std::vector<game::Vector3>{};
+    auto second = std::vector<game::Vector3>{};
+    for (auto i = 0u; i < 200u; ++i)
+    {
+        first.push_back({dist(rng), dist(rng), dist(rng)});
+        second.push_back({dist(rng) * 3.f + 10.f, dist(rng), dist(rng) * 0.5f - 2.f});
+    }
+    const auto first_vertices = create_vertices(first);
+    const auto second_vertices = create_vertices(second);
+
+    const auto bounds = game::merge(
+        game::compute_bounds({.vertices = first_vertices, .indices = {}}),
+        game::compute_bounds({.vertices = second_vertices, .indices = {}}));
+
+    for (const auto &positions : {first, second})
+    {
+        for (const auto &position : positions)
+        {
+            ASSERT_GE(position.x, bounds.min.x);
+            ASSERT_GE(position.y, bounds.min.y);
+            ASSERT_GE(position.z, bounds.min.z);
+            ASSERT_LE(position.x, bounds.max.x);
+            ASSERT_LE(position.y, bounds.max.y);
+            ASSERT_LE(position.z, bounds.max.z);
+            ASSERT_LE(game::Vector3::distance(bounds.center, position), bounds.radius * 1.0001f);
+        }
+    }
+}
+
+TEST(mesh_bounds, merge_nested_spheres)
+{
+    const auto outer = game::MeshBounds{.min = {-4.f}, .max = {4.f}, .center = {}, .radius = 4.f};
+    const auto inner = game::MeshBounds{.min = {0.5f}, .max = {1.5f}, .center = {1.f}, .radius = 0.5f};
+
+    for (const auto &bounds : {game::merge(outer, inner), game::merge(inner, outer)})
+    {
+        ASSERT_EQ(bounds.min, game::Vector3{-4.f});
+        ASSERT_EQ(bounds.max, game::Vector3{4.f});
+        ASSERT_EQ(bounds.center, game::Vector3{});
+        ASSERT_EQ(bounds.radius, 4.f);
+    }
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "packer/mesh_optimizer.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    /**
+     * Create a flat grid of size x size quads, with triangles in random order and every corner stored per triangle
+     * (as an unindexed export would).
+     */
+    auto create_shuffled_grid(std::uint32_t size) -> game::packer::OptimizedMesh
+    {
+        auto triangles = std::vector<std::array<std::uint32_t, 3u>>{};
+        for (auto y = 0u; y < size; ++y)
+        {
+            for (auto x = 0u; x < size; ++x)
+            {
+                const auto i = y * (size + 1u) + x;
+                triangles.push_back({i, i + size + 1u, i + 1u});
+                triangles.push_back({i + 1u, i + size + 1u, i + size + 2u});
+            }
+        }
+
+        auto rng = std::mt19937{42u};
+        std::ranges::shuffle(triangles, rng);
+
+        auto mesh = game::packer::OptimizedMesh{};
+        for (const auto &triangle : triangles)
+        {
+            for (const auto index : triangle)
+            {
+                const auto x = static_cast<float>(index % (size + 1u));
+                const auto y = static_cast<float>(index / (size + 1u));
+                mesh.indices.push_back(static_cast<std::uint32_t>(mesh.vertices.size()));
+                mesh.vertices.push_back({.position = {x, y, 0.f}, .normal = {0.f, 0.f, 1.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {x, y}});
+            }
+        }
+
+        return mesh;
+    }
+
+    auto sorted_triangles(const std::vector<game::VertexData> &vertices, const std::vector<std::uint32_t> &indices)
+        -> std::vector<std::array<float, 9u>>
+    {
+        auto triangles = std::vector<std::array<float, 9u>>{};
+        for (auto t = 0u; t < indices.size() / 3u; ++t)
+        {
+            auto triangle = std::array<float, 9u>{};
+            for (auto i = 0u; i < 3u; ++i)
+            {
+                const auto &p = vertices[indices[t * 3u + i]].position;
+                triangle[i * 3u] = p.x;
+                triangle[i * 3u + 1u] = p.y;
+                triangle[i * 3u + 2u] = p.z;
+            }
+            triangles.push_back(triangle);
+        }
+
+        std::ranges::sort(triangles);
+        return triangles;
+    }
+}
+
+TEST(mesh_optimizer, deduplicate_vertices)
+{
+    const auto grid = create_shuffled_grid(4u);
+
+    const auto mesh = game::packer::deduplicate_vertices(grid.vertices, grid.indices);
+
+    ASSERT_EQ(mesh.vertices.size(), 25u);
+    ASSERT_EQ(mesh.indices.size(), grid.indices.size());
+    ASSERT_EQ(sorted_triangles(grid.vertices, grid.indices), sorted_triangles(mesh.vertices, mesh.indices));
+}
+
+TEST(mesh_optimizer, analyze_vertex_cache)
+{
+    // two triangles sharing an edge, 4 unique vertices
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u, 2u, 1u, 3u};
+
+    const auto stats = game::packer::analyze_vertex_cache(indices, 4u);
+
+    ASSERT_EQ(stats.vertices_transformed, 4u);
+    ASSERT_FLOAT_EQ(stats.acmr, 2.0f);
+    ASSERT_FLOAT_EQ(stats.atvr, 1.0f);
+}
+
+TEST(mesh_optimizer, analyze_vertex_cache_small_cache)
+{
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u, 3u, 4u, 5u, 0u, 1u, 2u};
+
+    const auto stats = game::packer::analyze_vertex_cache(indices, 6u, 3u);
+
+    ASSERT_EQ(stats.vertices_transformed, 9u);
+    ASSERT_FLOAT_EQ(stats.atvr, 1.5f);
+}
+
+TEST(mesh_optimizer, optimize_vertex_cache)
+{
+    const auto grid = create_shuffled_grid(32u);
+    const auto mesh = game::packer::deduplicate_vertices(grid.vertices, grid.indices);
+
+    const auto before = game::packer::analyze_vertex_cache(mesh.indices, mesh.vertices.size());
+    const auto indices = game::packer::optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+    const auto after = game::packer::analyze_vertex_cache(indices, mesh.vertices.size());
+
+    ASSERT_EQ(sorted_triangles(mesh.vertices, mesh.indices), sorted_triangles(mesh.vertices, indices));
+    ASSERT_LT(after.acmr, before.acmr * 0.5f);
+    ASSERT_LT(after.acmr, 0.85f);
+}
+
+TEST(mesh_optimizer, optimize_overdraw_keeps_triangles)
+{
+    const auto grid = create_shuffled_grid(16u);
+    const auto mesh = game::packer::deduplicate_vertices(grid.vertices, grid.indices);
+    const auto cache_optimized = game::packer::optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+
+    const auto indices = game::packer::optimize_overdraw(cache_optimized, mesh.vertices, 1.05f);
+
+    const auto before = game::packer::analyze_vertex_cache(cache_optimized, mesh.vertices.size());
+    const auto after = game::packer::analyze_vertex_cache(indices, mesh.vertices.size());
+
+    ASSERT_EQ(sorted_triangles(mesh.vertices, cache_optimized), sorted_triangles(mesh.vertices, indices));
+    ASSERT_LE(after.acmr, before.acmr * 1.05f);
+}
+
+TEST(mesh_optimizer, optimize_overdraw_back_to_back)
+{
+    // every triangle is also drawn facing the other way, so the normals of every cluster cancel out
+    auto mesh = create_shuffled_grid(8u);
+    const auto triangle_count = mesh.indices.size() / 3u;
+    for (auto t = 0u; t < triangle_count; ++t)
+    {
+        mesh.indices.append_range(std::vector<std::uint32_t>{mesh.indices[t * 3u], mesh.indices[t * 3u + 2u], mesh.indices[t * 3u + 1u]});
+    }
+
+    const auto indices = game::packer::optimize_overdraw(mesh.indices, mesh.vertices, 2.f);
+
+    ASSERT_EQ(sorted_triangles(mesh.vertices, mesh.indices), sorted_triangles(mesh.vertices, indices));
+}
+
+TEST(mesh_optimizer, optimize_vertex_fetch)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {0.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {1.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {2.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {3.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {4.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint32_t>{3u, 1u, 4u, 4u, 1u, 0u};
+
+    const auto mesh = game::packer::optimize_vertex_fetch(vertices, indices);
+
+    // vertex 2 is unused and dropped, the rest is ordered by first use
+    ASSERT_EQ(mesh.vertices.size(), 4u);
+    ASSERT_EQ(mesh.indices, (std::vector<std::uint32_t>{0u, 1u, 2u, 2u, 1u, 3u}));
+    ASSERT_EQ(mesh.vertices[0].position, game::Vector3{3.f});
+    ASSERT_EQ(mesh.vertices[3].position, game::Vector3{0.f});
+}
+
+TEST(mesh_optimizer, optimize_mesh)
+{
+    const auto grid = create_shuffled_grid(32u);
+
+    const auto mesh = game::packer::optimize_mesh(grid.vertices, grid.indices);
+
+    ASSERT_EQ(mesh.vertices.size(), 33u * 33u);
+    ASSERT_EQ(sorted_triangles(grid.vertices, grid.indices), sorted_triangles(mesh.vertices, mesh.indices));
+    ASSERT_LT(game::packer::analyze_vertex_cache(mesh.indices, mesh.vertices.size()).acmr, 0.85f);
+}
+
+TEST(mesh_optimizer, to_short_indices)
+{
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 65535u};
+
+    const auto short_indices = game::packer::to_short_indices(indices);
+
+    ASSERT_TRUE(short_indices.has_value());
+    ASSERT_EQ(*short_indices, (std::vector<std::uint16_t>{0u, 1u, 65535u}));
+}
+
+TEST(mesh_optimizer, to_short_indices_too_large)
+{
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 65536u};
+
+    ASSERT_FALSE(game::packer::to_short_indices(indices).has_value());
+}
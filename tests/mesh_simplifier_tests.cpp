@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
+#include "packer/mesh_simplifier.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    struct TestMesh
+    {
+        std::vector<game::VertexData> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+    auto create_grid(std::uint32_t size) -> TestMesh
+    {
+        auto mesh = TestMesh{};
+        for (auto y = 0u; y <= size; ++y)
+        {
+            for (auto x = 0u; x <= size; ++x)
+            {
+                const auto fx = static_cast<float>(x);
+                const auto fy = static_cast<float>(y);
+                mesh.vertices.push_back({.position = {fx, fy, 0.f}, .normal = {0.f, 0.f, 1.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {fx, fy}});
+            }
+        }
+
+        for (auto y = 0u; y < size; ++y)
+        {
+            for (auto x = 0u; x < size; ++x)
+            {
+                const auto i = y * (size + 1u) + x;
+                mesh.indices.append_range(std::vector<std::uint32_t>{i, i + 1u, i + size + 1u, i + 1u, i + size + 2u, i + size + 1u});
+            }
+        }
+
+        return mesh;
+    }
+
+    /**
+     * Closed unit sphere, the poles are single vertices so that there are no seams or borders.
+     */
+    auto create_sphere(std::uint32_t rings, std::uint32_t segments) -> TestMesh
+    {
+        auto mesh = TestMesh{};
+        const auto pi = 3.14159265f;
+
+        mesh.vertices.push_back({.position = {0.f, 1.f, 0.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {}, .uv = {}});
+        for (auto r = 1u; r < rings; ++r)
+        {
+            const auto phi = pi * static_cast<float>(r) / static_cast<float>(rings);
+            for (auto s = 0u; s < segments; ++s)
+            {
+                const auto theta = 2.f * pi * static_cast<float>(s) / static_cast<float>(segments);
+                const auto p = game::Vector3{std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)};
+                mesh.vertices.push_back({.position = p, .normal = p, .tangent = {}, .uv = {}});
+            }
+        }
+        mesh.vertices.push_back({.position = {0.f, -1.f, 0.f}, .normal = {0.f, -1.f, 0.f}, .tangent = {}, .uv = {}});
+
+        const auto ring_start = [segments](auto r)
+        { return 1u + (r - 1u) * segments; };
+        const auto bottom = static_cast<std::uint32_t>(mesh.vertices.size() - 1u);
+
+        for (auto s = 0u; s < segments; ++s)
+        {
+            const auto next = (s + 1u) % segments;
+            mesh.indices.append_range(std::vector<std::uint32_t>{0u, ring_start(1u) + next, ring_start(1u) + s});
+            mesh.indices.append_range(std::vector<std::uint32_t>{bottom, ring_start(rings - 1u) + s, ring_start(rings - 1u) + next});
+        }
+
+        for (auto r = 1u; r < rings - 1u; ++r)
+        {
+            for (auto s = 0u; s < segments; ++s)
+            {
+                const auto next = (s + 1u) % segments;
+                const auto a = ring_start(r) + s;
+                const auto b = ring_start(r) + next;
+                const auto c = ring_start(r + 1u) + s;
+                const auto d = ring_start(r + 1u) + next;
+                mesh.indices.append_range(std::vector<std::uint32_t>{a, b, c, b, d, c});
+            }
+        }
+
+        return mesh;
+    }
+
+    auto triangle_normal(const TestMesh &mesh, const std::vector<std::uint32_t> &indices, std::size_t triangle) -> game::Vector3
+    {
+        const auto &p0 = mesh.vertices[indices[triangle * 3u]].position;
+        const auto &p1 = mesh.vertices[indices[triangle * 3u + 1u]].position;
+        const auto &p2 = mesh.vertices[indices[triangle * 3u + 2u]].position;
+        return game::Vector3::cross(p1 - p0, p2 - p0);
+    }
+}
+
+TEST(mesh_simplifier, flat_grid)
+{
+    const auto grid = create_grid(16u);
+
+    const auto simplified = game::packer::simplify_mesh(grid.vertices, grid.indices, 0u, 0.01f);
+
+    // only the border has to stay, the interior is flat and collapses without error
+    ASSERT_LT(simplified.indices.size(), grid.indices.size() / 4u);
+    ASSERT_EQ(simplified.indices.size() % 3u, 0u);
+    ASSERT_FLOAT_EQ(simplified.error, 0.f);
+
+    for (auto t = 0u; t < simplified.indices.size() / 3u; ++t)
+    {
+        ASSERT_GT(triangle_normal(grid, simplified.indices, t).z, 0.f);
+    }
+}
+
+TEST(mesh_simplifier, keeps_border)
+{
+    const auto grid = create_grid(8u);
+
+    const auto simplified = game::packer::simplify_mesh(grid.vertices, grid.indices, 0u, 0.01f);
+
+    // every border vertex is still referenced
+    for (auto i = 0u; i < grid.vertices.size(); ++i)
+    {
+        const auto &p = grid.vertices[i].position;
+        if (p.x == 0.f || p.y == 0.f || p.x == 8.f || p.y == 8.f)
+        {
+            ASSERT_TRUE(std::ranges::contains(simplified.indices, i));
+        }
+    }
+}
+
+TEST(mesh_simplifier, respects_target_index_count)
+{
+    const auto sphere = create_sphere(16u, 32u);
+    const auto target = sphere.indices.size() / 2u;
+
+    const auto simplified = game::packer::simplify_mesh(sphere.vertices, sphere.indices, target, 1.f);
+
+    ASSERT_LE(simplified.indices.size(), target);
+    ASSERT_GT(simplified.indices.size(), target / 2u);
+    ASSERT_GT(simplified.error, 0.f);
+    ASSERT_LT(simplified.error, 0.2f);
+}
+
+TEST(mesh_simplifier, respects_target_error)
+{
+    const auto sphere = create_sphere(16u, 32u);
+
+    const auto simplified = game::packer::simplify_mesh(sphere.vertices, sphere.indices, 0u, 0.001f);
+
+    ASSERT_LE(simplified.error, 0.001f);
+    ASSERT_GT(simplified.indices.size(), sphere.indices.size() / 2u);
+}
+
+TEST(mesh_simplifier, degenerate_triangles)
+{
+    auto grid = create_grid(8u);
+    grid.indices.append_range(std::vector<std::uint32_t>{0u, 0u, 1u, 2u, 3u, 4u});
+
+    const auto simplified = game::packer::simplify_mesh(grid.vertices, grid.indices, 0u, 0.01f);
+
+    ASSERT_TRUE(std::isfinite(simplified.error));
+    ASSERT_LE(simplified.error, 0.01f);
+    ASSERT_LT(simplified.indices.size(), grid.indices.size());
+}
+
+TEST(mesh_simplifier, lod_chain)
+{
+    const auto sphere = create_sphere(32u, 64u);
+
+    const auto lods = game::packer::generate_lod_chain(sphere.vertices, sphere.indices, 4u);
+
+    ASSERT_EQ(lods.size(), 4u);
+
+    auto previous_size = sphere.indices.size();
+    auto previous_error = 0.f;
+    for (const auto &lod : lods)
+    {
+        ASSERT_LE(lod.indices.size() * 5u, previous_size * 4u);
+        ASSERT_GE(lod.error, previous_error);
+        ASSERT_TRUE(std::ranges::all_of(lod.indices, [&sphere](auto index)
+                                        { return index < sphere.vertices.size(); }));
+
+        previous_size = lod.indices.size();
+        previous_error = lod.error;
+    }
+}
+
+TEST(mesh_simplifier, lod_chain_empty)
+{
+    ASSERT_TRUE(game::packer::generate_lod_chain({}, {}, 4u).empty());
+}
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+
+#include "resources/pack_manifest.h"
+#include "utils/exception.h"
+
+#include "test_utils.h"
+
+TEST(pack_manifest, empty)
+{
+    const auto manifest = game::parse_pack_manifest("");
+
+    ASSERT_EQ(manifest.base, "resources");
+    ASSERT_TRUE(manifest.level_packs.empty());
+}
+
+TEST(pack_manifest, base_and_levels)
+{
+    TEST_IMPL(
+        const auto manifest = game::parse_pack_manifest(R"(# shared assets
+base   base_pack
+
+level level_1.lua  factory
+level level_2.lua warehouse
+)");
+
+        ASSERT_EQ(manifest.base, "base_pack");
+        ASSERT_EQ(manifest.level_packs.size(), 2u);
+        ASSERT_EQ(manifest.level_pack("level_1.lua"), std::optional<std::string>{"factory"});
+        ASSERT_EQ(manifest.level_pack("level_2.lua"), std::optional<std::string>{"warehouse"});
+        ASSERT_EQ(manifest.level_pack("level_3.lua"), std::nullopt);
+
+    )
+}
+
+TEST(pack_manifest, crlf_line_endings)
+{
+    const auto manifest = game::parse_pack_manifest("base base_pack\r\nlevel level_1.lua factory\r\n");
+
+    ASSERT_EQ(manifest.base, "base_pack");
+    ASSERT_EQ(manifest.level_pack("level_1.lua"), std::optional<std::string>{"factory"});
+}
+
+TEST(pack_manifest, invalid)
+{
+    ASSERT_THROW(game::parse_pack_manifest("base"), game::Exception);
+    ASSERT_THROW(game::parse_pack_manifest("level level_1.lua"), game::Exception);
+    ASSERT_THROW(game::parse_pack_manifest("level level_1.lua a\nlevel level_1.lua b"), game::Exception);
+    ASSERT_THROW(game::parse_pack_manifest("mount something"), game::Exception);
+}
+
+TEST(pack_manifest, write_round_trip)
+{
+    auto manifest = game::PackManifest{.base = "base_pack"};
+    manifest.level_packs.emplace("level_2.lua", "warehouse");
+    manifest.level_packs.emplace("level_1.lua", "factory");
+
+    const auto text = game::write_pack_manifest(manifest);
+    ASSERT_EQ(text, "base base_pack\nlevel level_1.lua factory\nlevel level_2.lua warehouse\n");
+
+    const auto parsed = game::parse_pack_manifest(text);
+    ASSERT_EQ(parsed.base, manifest.base);
+    ASSERT_EQ(parsed.level_packs, manifest.level_packs);
+}
+
+TEST(pack_manifest, write_invalid)
+{
+    ASSERT_THROW(game::write_pack_manifest({.base = "base pack"}), game::Exception);
+    ASSERT_THROW(game::write_pack_manifest({.base = ""}), game::Exception);
+
+    auto manifest = game::PackManifest{};
+    manifest.level_packs.emplace("#level_1.lua", "factory");
+    ASSERT_THROW(game::write_pack_manifest(manifest), game::Exception);
+}
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <string>
+
 #include "resources/resource_cache.h"
 
 TEST(resource_cache, insert_int)
@@ -21,3 +24,173 @@ TEST(resource_cache, get_int)
 
     ASSERT_EQ(*v, 12345);
 }
+
+TEST(resource_cache, erase_int)
+{
+    auto cache = game::ResourceCache<int>{};
+
+    cache.insert<int>("test_int", 12345);
+    cache.erase<int>("test_int");
+
+    ASSERT_FALSE(cache.contains<int>("test_int"));
+    ASSERT_NE(cache.insert<int>("test_int", 54321), nullptr);
+}
+
+TEST(resource_cache, get_by_id)
+{
+    using namespace game::literals;
+
+    auto cache = game::ResourceCache<int>{};
+
+    cache.insert<int>("test_int", 12345);
+
+    ASSERT_EQ(*cache.get<int>("test_int"_id), 12345);
+    ASSERT_TRUE(cache.contains<int>("test_int"_id));
+    ASSERT_FALSE(cache.contains<int>("other_int"_id));
+}
+
+TEST(resource_cache, get_by_handle)
+{
+    auto cache = game::ResourceCache<int>{};
+
+    cache.insert<int>("test_int", 12345);
+    const auto handle = cache.handle<int>(game::ResourceId{"test_int"});
+
+    ASSERT_TRUE(handle);
+    ASSERT_EQ(*cache.get(handle), 12345);
+    ASSERT_FALSE(cache.handle<int>(game::ResourceId{"other_int"}));
+}
+
+TEST(resource_cache, stale_handle)
+{
+    auto cache = game::ResourceCache<int>{};
+
+    cache.insert<int>("test_int", 12345);
+    const auto handle = cache.handle<int>(game::ResourceId{"test_int"});
+    cache.erase(handle);
+
+    // the slot is reused, but the old handle must not see the new object
+    cache.insert<int>("other_int", 54321);
+    const auto other = cache.handle<int>(game::ResourceId{"other_int"});
+
+    ASSERT_EQ(other.index, handle.index);
+    ASSERT_FALSE(cache.contains(handle));
+    ASSERT_TRUE(cache.contains(other));
+}
+
+TEST(resource_cache, stable_pointers)
+{
+    auto cache = game::ResourceCache<int>{};
+
+    const auto *first = cache.insert<int>("first", 1);
+    for (auto i = 0; i < 1000; ++i)
+    {
+        cache.insert<int>("int_" + std::to_string(i), i);
+    }
+
+    ASSERT_EQ(cache.get<int>("first"), first);
+    ASSERT_EQ(*cache.get<int>("int_999"), 999);
+}
+
+namespace
+{
+    struct Sized
+    {
+        std::size_t size;
+
+        auto memory_size() const -> std::size_t
+        {
+            return size;
+        }
+    };
+}
+
+TEST(resource_cache, ref_counts)
+{
+    auto cache = game::ResourceCache<int>{};
+
+    auto ref = cache.insert_evictable<int>("test_int", 12345);
+    auto copy = ref;
+    ASSERT_EQ(*copy, 12345);
+
+    // the last reference is gone, but nothing is evicted while within budget
+    ref.reset();
+    copy.reset();
+    ASSERT_TRUE(cache.contains<int>("test_int"));
+}
+
+TEST(resource_cache, memory_used)
+{
+    auto cache = game::ResourceCache<Sized>{};
+
+    cache.insert<Sized>("a", 100u);
+    auto ref = cache.insert_evictable<Sized>("b", 50u);
+    ASSERT_EQ(cache.memory_used<Sized>(), 150u);
+
+    ref.reset();
+    cache.erase<Sized>("b");
+    ASSERT_EQ(cache.memory_used<Sized>(), 100u);
+}
+
+TEST(resource_cache, evict_least_recently_used)
+{
+    auto cache = game::ResourceCache<Sized>{};
+    cache.set_budget<Sized>(250u);
+
+    auto pinned = cache.insert<Sized>("pinned", 100u);
+    auto a = cache.insert_evictable<Sized>("a", 50u);
+    auto b = cache.insert_evictable<Sized>("b", 50u);
+    a.reset();
+    b.reset();
+
+    // a was released first, so it goes first
+    auto c = cache.insert_evictable<Sized>("c", 100u);
+    ASSERT_FALSE(cache.contains<Sized>("a"));
+    ASSERT_TRUE(cache.contains<Sized>("b"));
+    ASSERT_EQ(cache.memory_used<Sized>(), 250u);
+
+    // referenced and pinned objects are never evicted, even over budget
+    cache.set_budget<Sized>(0u);
+    ASSERT_FALSE(cache.contains<Sized>("b"));
+    ASSERT_TRUE(cache.contains<Sized>("c"));
+    ASSERT_EQ(cache.get<Sized>("pinned"), pinned);
+
+    c.reset();
+    ASSERT_FALSE(cache.contains<Sized>("c"));
+    ASSERT_EQ(cache.memory_used<Sized>(), 100u);
+}
+
+TEST(resource_cache, acquire_keeps_cached)
+{
+    using namespace game::literals;
+
+    auto cache = game::ResourceCache<Sized>{};
+    cache.set_budget<Sized>(0u);
+
+    auto ref = cache.insert_evictable<Sized>("a", 50u);
+    ref.reset();
+    ASSERT_FALSE(cache.contains<Sized>("a"));
+
+    auto pinned = cache.insert<Sized>("b", 50u);
+    auto b = cache.acquire<Sized>("b"_id);
+    b.reset();
+
+    // acquiring a pinned object does not make it evictable
+    ASSERT_TRUE(cache.contains<Sized>("b"));
+    ASSERT_EQ(b.get(), nullptr);
+    ASSERT_EQ(pinned->size, 50u);
+}
+
+TEST(resource_cache, replace_in_place)
+{
+    auto cache = game::ResourceCache<Sized>{};
+
+    auto ref = cache.insert_evictable<Sized>("a", 1u);
+    const auto *placeholder = ref.get();
+
+    cache.replace(ref.handle(), 100u);
+
+    ASSERT_EQ(ref.get(), placeholder);
+    ASSERT_EQ(placeholder->size, 100u);
+    ASSERT_EQ(cache.memory_used<Sized>(), 100u);
+}
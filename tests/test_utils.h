@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <print>
+#include <span>
 
 #include <gtest/gtest.h>
 
@@ -17,3 +19,16 @@
         std::println("{}", e);       \
         throw;                       \
     }
+
+/**
+ * Check that two sequences of floats match element by element, within a tolerance, and report the first element that
+ * does not.
+ */
+inline auto expect_near(std::span<const float> result, std::span<const float> expected, float tolerance = 0.00001f) -> void
+{
+    ASSERT_EQ(result.size(), expected.size());
+    for (auto i = 0zu; i < result.size(); ++i)
+    {
+        ASSERT_NEAR(result[i], expected[i], tolerance) << "element " << i;
+    }
+}
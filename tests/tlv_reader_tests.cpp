@@ -65,3 +65,103 @@ TEST(tlv_reader, range_loop)
         }
     }
 }
+
+TEST(tlv_reader, v2_header)
+{
+    const auto bytes = create_binary_vector(
+        'U', 'G', 'T', 'L',
+        0x02, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x10, 0x00, 0x00, 0x00,
+        std::to_underlying(game::TlvType::UINT32), 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xdd, 0xcc, 0xbb, 0xaa,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        std::to_underlying(game::TlvType::STRING), 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        'y', 'o',
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00);
+
+    const auto reader = game::TlvReader{{bytes}};
+
+    ASSERT_EQ(reader.format().version, game::TlvVersion::V2);
+    ASSERT_EQ(reader.format().alignment, 16u);
+
+    const auto entries = reader | std::ranges::to<std::vector>();
+    ASSERT_EQ(entries.size(), 2u);
+    ASSERT_EQ(entries[0].uint32_value(), 0xaabbccdd);
+    ASSERT_EQ(entries[0].value().data(), bytes.data() + 32u);
+    ASSERT_EQ(entries[1].string_value(), "yo");
+    ASSERT_EQ(entries[1].value().data(), bytes.data() + 64u);
+}
+
+TEST(tlv_reader, v2_truncated_entry)
+{
+    const auto bytes = create_binary_vector(
+        'U', 'G', 'T', 'L',
+        0x02, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x10, 0x00, 0x00, 0x00,
+        std::to_underlying(game::TlvType::UINT32), 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+        0xdd, 0xcc, 0xbb, 0xaa);
+
+    const auto reader = game::TlvReader{{bytes}};
+
+    ASSERT_THROW(*std::ranges::begin(reader), game::Exception);
+}
+
+TEST(tlv_reader, unsupported_version)
+{
+    const auto bytes = create_binary_vector(
+        'U', 'G', 'T', 'L',
+        0x03, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+        0x10, 0x00, 0x00, 0x00);
+
+    ASSERT_THROW((game::TlvReader{{bytes}}), game::Exception);
+}
+
+TEST(tlv_reader, resolve_alias)
+{
+    const auto bytes = create_binary_vector(
+        std::to_underlying(game::TlvType::STRING), 0x00, 0x00, 0x00,
+        0x02, 0x00, 0x00, 0x00,
+        'y', 'o',
+        std::to_underlying(game::TlvType::ALIAS), 0x00, 0x00, 0x00,
+        0x08, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        std::to_underlying(game::TlvType::UINT32), 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00,
+        0xdd, 0xcc, 0xbb, 0xaa);
+
+    const auto reader = game::TlvReader{{bytes}};
+    auto entry = std::ranges::begin(reader);
+    ++entry;
+
+    ASSERT_EQ((*entry).type(), game::TlvType::STRING);
+    ASSERT_EQ((*entry).string_value(), "yo");
+
+    // iteration continues after the alias
+    ++entry;
+    ASSERT_EQ((*entry).uint32_value(), 0xaabbccdd);
+}
+
+TEST(tlv_reader, forward_alias)
+{
+    // an alias may only point at an earlier entry
+    const auto bytes = create_binary_vector(
+        std::to_underlying(game::TlvType::ALIAS), 0x00, 0x00, 0x00,
+        0x08, 0x00, 0x00, 0x00,
+        0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        std::to_underlying(game::TlvType::UINT32), 0x00, 0x00, 0x00,
+        0x04, 0x00, 0x00, 0x00,
+        0xdd, 0xcc, 0xbb, 0xaa);
+
+    const auto reader = game::TlvReader{{bytes}};
+
+    ASSERT_THROW(*std::ranges::begin(reader), game::Exception);
+}
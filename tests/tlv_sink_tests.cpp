@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "tlv/tlv_sink.h"
+#include "utils/decompress.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto create_data(std::size_t size) -> std::vector<std::byte>
+    {
+        auto data = std::vector<std::byte>(size);
+        for (auto i = 0u; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::byte>((i * 7u) % 251u);
+        }
+
+        return data;
+    }
+
+    auto read_file(const std::filesystem::path &path) -> std::vector<std::byte>
+    {
+        auto in = std::ifstream{path, std::ios::binary};
+        const auto chars = std::vector<char>{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+        const auto bytes = std::as_bytes(std::span{chars});
+
+        return {bytes.begin(), bytes.end()};
+    }
+
+    auto write_in_pieces(game::TlvSink &sink, std::span<const std::byte> data) -> void
+    {
+        // uneven pieces so writes straddle chunk boundaries
+        while (!data.empty())
+        {
+            const auto count = std::min<std::size_t>(data.size(), 777u);
+            sink.write(data.first(count));
+            data = data.subspan(count);
+        }
+
+        sink.finish();
+    }
+}
+
+TEST(tlv_sink, file_sink)
+{
+    const auto path = std::filesystem::temp_directory_path() / "tlv_sink_file_sink.bin";
+    const auto data = create_data(10000u);
+
+    TEST_IMPL(
+        {
+            auto sink = game::FileSink{path};
+            write_in_pieces(sink, data);
+        }
+
+        ASSERT_EQ(read_file(path), data);
+
+    )
+
+    std::filesystem::remove(path);
+}
+
+TEST(tlv_sink, compressed_stream_round_trip)
+{
+    const auto path = std::filesystem::temp_directory_path() / "tlv_sink_compressed_stream.bin";
+    const auto data = create_data(10000u);
+
+    TEST_IMPL(
+        {
+            auto sink = game::CompressedFileSink(path, 3);
+            write_in_pieces(sink, data);
+        }
+
+        const auto compressed = read_file(path);
+
+        ASSERT_TRUE(game::is_compressed(compressed));
+        ASSERT_LT(compressed.size(), data.size());
+        ASSERT_EQ(game::decompress(compressed), data);
+
+    )
+
+    std::filesystem::remove(path);
+}
+
+TEST(tlv_sink, compressed_chunked_round_trip)
+{
+    const auto path = std::filesystem::temp_directory_path() / "tlv_sink_compressed_chunked.bin";
+    const auto data = create_data(10000u);
+
+    TEST_IMPL(
+        {
+            auto sink = game::CompressedFileSink(path, -5, 1000u);
+            write_in_pieces(sink, data);
+        }
+
+        ASSERT_EQ(game::decompress(read_file(path)), data);
+
+    )
+
+    std::filesystem::remove(path);
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <fstream>
@@ -9,8 +10,13 @@
 
 #include <gtest/gtest.h>
 
+#include "graphics/compact_vertex_data.h"
+#include "graphics/mesh_bounds.h"
+#include "graphics/vertex_data.h"
+#include "math/vector3.h"
 #include "tlv/tlv_entry.h"
 #include "tlv/tlv_reader.h"
+#include "tlv/tlv_sink.h"
 #include "tlv/tlv_writer.h"
 #include "utils/exception.h"
 
@@ -23,6 +29,25 @@ namespace
     {
         return {std::byte(args)...};
     }
+
+    class VectorSink : public game::TlvSink
+    {
+    public:
+        auto write(std::span<const std::byte> data) -> void override
+        {
+            ++write_count;
+            bytes.append_range(data);
+        }
+
+        auto finish() -> void override
+        {
+            finished = true;
+        }
+
+        std::vector<std::byte> bytes;
+        std::size_t write_count = 0u;
+        bool finished = false;
+    };
 }
 
 TEST(tlv_writer, write_uint32)
@@ -127,6 +152,36 @@ TEST(tlv_writer, write_texture_data)
     ASSERT_EQ(texture_data.width, tlv_tex.width);
     ASSERT_EQ(texture_data.height, tlv_tex.height);
     ASSERT_EQ(data, tlv_tex.data);
+    ASSERT_EQ(1u, tlv_tex.mip_levels);
+    ASSERT_EQ(texture_data.name, (*entry).texture_name_value());
+}
+
+TEST(tlv_writer, write_compressed_texture_data)
+{
+    // 8x8 BC1 with a full mip chain: 4 blocks for the top level and 1 block for each of the other three
+    auto data = std::vector<std::byte>(7u * 8u, std::byte{0x5a});
+    auto texture_data = game::TextureDescription{
+        .name = "Compressed texture",
+        .format = game::TextureFormat::BC1,
+        .usage = game::TextureUsage::SRGB,
+        .width = 8u,
+        .height = 8u,
+        .data = data,
+        .mip_levels = 4u};
+    auto writer = game::TlvWriter{};
+
+    writer.write(texture_data);
+
+    const auto buffer = writer.yield();
+
+    auto reader = game::TlvReader{buffer};
+    const auto entry = std::ranges::begin(reader);
+
+    const auto tlv_tex = (*entry).texture_description_value();
+
+    ASSERT_EQ(texture_data.format, tlv_tex.format);
+    ASSERT_EQ(texture_data.mip_levels, tlv_tex.mip_levels);
+    ASSERT_EQ(data, tlv_tex.data);
 }
 
 TEST(tlv_writer, write_object_sub_mesh_names)
@@ -152,3 +207,403 @@ TEST(tlv_writer, write_object_sub_mesh_names)
 
     )
 }
+
+TEST(tlv_writer, write_object_sub_mesh_names_with_bounds)
+{
+    const auto sub_meshes = std::vector<std::string>{"sub_mesh_A", "sub_mesh_B"};
+    const auto bounds = game::MeshBounds{.min = {-1.f, -2.f, -3.f}, .max = {1.f, 2.f, 3.f}, .center = {}, .radius = 3.75f};
+
+    auto writer = game::TlvWriter{};
+
+    TEST_IMPL(
+        writer.write("complex_obj", sub_meshes, bounds);
+        writer.write("plain_obj", sub_meshes);
+
+        const auto buffer = writer.yield();
+
+        auto reader = game::TlvReader{buffer};
+        auto entry = std::ranges::begin(reader);
+
+        ASSERT_EQ((*entry).object_data_value(), sub_meshes);
+        const auto read_bounds = (*entry).object_bounds_value();
+        ASSERT_TRUE(read_bounds);
+        ASSERT_EQ(read_bounds->min, bounds.min);
+        ASSERT_EQ(read_bounds->max, bounds.max);
+        ASSERT_EQ(read_bounds->center, bounds.center);
+        ASSERT_EQ(read_bounds->radius, bounds.radius);
+
+        ++entry;
+        ASSERT_EQ((*entry).object_data_value(), sub_meshes);
+        ASSERT_FALSE((*entry).object_bounds_value());
+    )
+}
+
+TEST(tlv_writer, write_mesh_data)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {1.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {2.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {3.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u};
+
+    auto writer = game::TlvWriter{};
+
+    TEST_IMPL(
+
+        writer.write("mesh", {.vertices = vertices, .indices = indices});
+
+        const auto buffer = writer.yield();
+
+        auto reader = game::TlvReader{buffer};
+        auto entry = std::ranges::begin(reader);
+
+        const auto mesh = (*entry).mesh_value();
+
+        ASSERT_TRUE((*entry).is_mesh("mesh"));
+        ASSERT_EQ(mesh.vertices.size(), 3u);
+        ASSERT_EQ(mesh.vertices[2].position, game::Vector3{3.f});
+        ASSERT_TRUE(std::ranges::equal(mesh.indices, indices));
+        ASSERT_TRUE(mesh.short_indices.empty());
+        ASSERT_EQ(mesh.index_count(), 3u);
+
+    )
+}
+
+TEST(tlv_writer, write_mesh_data_short_indices)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {1.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {2.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {3.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint16_t>{2u, 1u, 0u};
+
+    auto writer = game::TlvWriter{};
+
+    TEST_IMPL(
+
+        writer.write("mesh", {.vertices = vertices, .indices = {}, .short_indices = indices});
+
+        const auto buffer = writer.yield();
+
+        auto reader = game::TlvReader{buffer};
+        auto entry = std::ranges::begin(reader);
+
+        const auto mesh = (*entry).mesh_value();
+
+        ASSERT_TRUE(mesh.indices.empty());
+        ASSERT_TRUE(std::ranges::equal(mesh.short_indices, indices));
+        ASSERT_EQ(mesh.index_count(), 3u);
+        ASSERT_EQ(mesh.index(0u), 2u);
+
+    )
+}
+
+TEST(tlv_writer, write_mesh_data_compact_vertices)
+{
+    const auto quantization = game::VertexQuantization{.scale = {2.f}, .bias = {1.f, 0.f, 0.f}};
+    const auto vertices = std::vector<game::CompactVertexData>{
+        game::compact_vertex({.position = {3.f, 0.f, 0.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {}}, quantization),
+        game::compact_vertex({.position = {-1.f, 2.f, 0.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {}}, quantization),
+        game::compact_vertex({.position = {1.f, 0.f, -2.f}, .normal = {0.f, 1.f, 0.f}, .tangent = {1.f, 0.f, 0.f}, .uv = {}}, quantization)};
+    const auto indices = std::vector<std::uint16_t>{0u, 1u, 2u};
+
+    auto writer = game::TlvWriter{};
+
+    TEST_IMPL(
+
+        writer.write("mesh", {.vertices = {}, .indices = {}, .short_indices = indices, .compact_vertices = vertices, .quantization = quantization});
+
+        const auto buffer = writer.yield();
+
+        auto reader = game::TlvReader{buffer};
+        auto entry = std::ranges::begin(reader);
+
+        const auto mesh = (*entry).mesh_value();
+
+        ASSERT_TRUE((*entry).is_mesh("mesh"));
+        ASSERT_TRUE(mesh.is_compact());
+        ASSERT_TRUE(mesh.vertices.empty());
+        ASSERT_EQ(mesh.vertex_count(), 3u);
+        ASSERT_EQ(mesh.quantization.scale, game::Vector3{2.f});
+        ASSERT_EQ(mesh.quantization.bias, (game::Vector3{1.f, 0.f, 0.f}));
+        ASSERT_EQ(mesh.position(0u), (game::Vector3{3.f, 0.f, 0.f}));
+        ASSERT_EQ(mesh.position(1u), (game::Vector3{-1.f, 2.f, 0.f}));
+        ASSERT_EQ(mesh.position(2u), (game::Vector3{1.f, 0.f, -2.f}));
+
+    )
+}
+
+TEST(tlv_writer, write_mesh_data_lods)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {1.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {2.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {3.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {4.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint16_t>{0u, 1u, 2u, 2u, 1u, 3u};
+    const auto lod_indices = std::vector<std::uint16_t>{0u, 1u, 3u};
+
+    auto writer = game::TlvWriter{};
+
+    TEST_IMPL(
+
+        writer.write("mesh", {.vertices = vertices, .indices = {}, .short_indices = indices, .lods = {{.indices = {}, .short_indices = lod_indices, .error = 0.5f}}});
+
+        const auto buffer = writer.yield();
+
+        auto reader = game::TlvReader{buffer};
+        auto entry = std::ranges::begin(reader);
+
+        const auto mesh = (*entry).mesh_value();
+
+        ASSERT_TRUE((*entry).is_mesh("mesh"));
+        ASSERT_EQ(mesh.index_count(), 6u);
+        ASSERT_EQ(mesh.lods.size(), 1u);
+        ASSERT_TRUE(std::ranges::equal(mesh.lods[0].short_indices, lod_indices));
+        ASSERT_EQ(mesh.lods[0].index_count(), 3u);
+        ASSERT_FLOAT_EQ(mesh.lods[0].error, 0.5f);
+
+    )
+}
+
+TEST(tlv_writer, write_mesh_data_bounds)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {-1.f, 0.f, 0.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {1.f, 0.f, 0.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {0.f, 2.f, 0.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u};
+    const auto bounds = game::MeshBounds{.min = {-1.f, 0.f, 0.f}, .max = {1.f, 2.f, 0.f}, .center = {0.f, 1.f, 0.f}, .radius = 1.5f};
+
+    auto writer = game::TlvWriter{};
+
+    TEST_IMPL(
+
+        writer.write("mesh", {.vertices = vertices, .indices = indices, .bounds = bounds});
+
+        const auto buffer = writer.yield();
+
+        auto reader = game::TlvReader{buffer};
+        auto entry = std::ranges::begin(reader);
+
+        const auto mesh = (*entry).mesh_value();
+
+        ASSERT_TRUE((*entry).is_mesh("mesh"));
+        ASSERT_EQ(mesh.index_count(), 3u);
+        ASSERT_TRUE(mesh.bounds.has_value());
+        ASSERT_EQ(mesh.bounds->min, bounds.min);
+        ASSERT_EQ(mesh.bounds->max, bounds.max);
+        ASSERT_EQ(mesh.bounds->center, bounds.center);
+        ASSERT_FLOAT_EQ(mesh.bounds->radius, bounds.radius);
+        ASSERT_TRUE(mesh.lods.empty());
+
+    )
+}
+
+TEST(tlv_writer, write_v1)
+{
+    const auto indices = std::vector<std::uint32_t>{1u, 2u, 3u};
+    auto writer = game::TlvWriter{{.version = game::TlvVersion::V1, .alignment = 1u}};
+
+    writer.write(std::string_view{"abc"});
+    writer.write(indices);
+
+    const auto buffer = writer.yield();
+
+    // no header, 8 byte entry headers and no padding
+    ASSERT_EQ(buffer.size(), 8u + 3u + 8u + 12u);
+
+    const auto reader = game::TlvReader{buffer};
+    ASSERT_EQ(reader.format().version, game::TlvVersion::V1);
+
+    auto entry = std::ranges::begin(reader);
+    ASSERT_EQ((*entry).string_value(), "abc");
+    ++entry;
+    ASSERT_EQ((*entry).uint32_array_value(), indices);
+}
+
+TEST(tlv_writer, write_v2_aligned_payloads)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {1.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {2.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {3.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u};
+
+    for (const auto alignment : {16u, 64u})
+    {
+        auto writer = game::TlvWriter{{.version = game::TlvVersion::V2, .alignment = alignment}};
+
+        TEST_IMPL(
+
+            // an odd sized string in front pushes everything after it off alignment in a v1 pack
+            writer.write(std::string_view{"odd"});
+            writer.write("mesh", {.vertices = vertices, .indices = indices});
+
+            const auto buffer = writer.yield();
+
+            const auto reader = game::TlvReader{buffer};
+            ASSERT_EQ(reader.format().version, game::TlvVersion::V2);
+            ASSERT_EQ(reader.format().alignment, alignment);
+
+            auto entry = std::ranges::begin(reader);
+            ASSERT_EQ((*entry).string_value(), "odd");
+            ++entry;
+
+            const auto mesh = (*entry).mesh_value();
+            const auto vertex_offset = reinterpret_cast<const std::byte *>(mesh.vertices.data()) - buffer.data();
+            const auto index_offset = reinterpret_cast<const std::byte *>(mesh.indices.data()) - buffer.data();
+
+            ASSERT_EQ(vertex_offset % alignment, 0u);
+            ASSERT_EQ(index_offset % alignment, 0u);
+            ASSERT_EQ(buffer.size() % 16u, 0u);
+            ASSERT_TRUE(std::ranges::equal(mesh.indices, indices));
+            ASSERT_EQ(mesh.vertices[2].position, vertices[2].position);
+
+        )
+    }
+}
+
+TEST(tlv_writer, invalid_alignment)
+{
+    ASSERT_THROW((game::TlvWriter{{.version = game::TlvVersion::V2, .alignment = 8u}}), game::Exception);
+    ASSERT_THROW((game::TlvWriter{{.version = game::TlvVersion::V2, .alignment = 48u}}), game::Exception);
+}
+
+TEST(tlv_writer, stream_to_sink)
+{
+    const auto vertices = std::vector<game::VertexData>{
+        {.position = {1.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {2.f}, .normal = {}, .tangent = {}, .uv = {}},
+        {.position = {3.f}, .normal = {}, .tangent = {}, .uv = {}}};
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u};
+
+    // larger than the flush threshold, so the sink sees more than the final flush
+    const auto large = std::vector<std::byte>(3u * 1024u * 1024u, std::byte{0x2a});
+
+    for (const auto format : {game::TlvFormat{.version = game::TlvVersion::V1, .alignment = 1u},
+                              game::TlvFormat{.version = game::TlvVersion::V2, .alignment = 64u}})
+    {
+        auto sink = VectorSink{};
+        auto streaming_writer = game::TlvWriter{format, sink};
+        auto writer = game::TlvWriter{format};
+
+        for (auto *w : {&streaming_writer, &writer})
+        {
+            w->write(std::string_view{"odd"});
+            w->write(large);
+            w->write("mesh", {.vertices = vertices, .indices = indices});
+            w->write(large);
+        }
+
+        TEST_IMPL(
+            streaming_writer.finish();
+            const auto buffer = writer.yield();
+
+            ASSERT_TRUE(sink.finished);
+            ASSERT_GT(sink.write_count, 1u);
+            ASSERT_EQ(streaming_writer.size(), buffer.size());
+            ASSERT_EQ(sink.bytes, buffer);
+
+            const auto reader = game::TlvReader{sink.bytes};
+            auto entry = std::ranges::begin(reader);
+            ++entry;
+            ++entry;
+            const auto mesh = (*entry).mesh_value();
+            ASSERT_TRUE(std::ranges::equal(mesh.indices, indices));
+            ASSERT_EQ(mesh.vertices[2].position, vertices[2].position);
+
+        )
+    }
+}
+
+TEST(tlv_writer, yield_streaming_writer)
+{
+    auto sink = VectorSink{};
+    auto writer = game::TlvWriter{{}, sink};
+
+    ASSERT_THROW(writer.yield(), game::Exception);
+}
+
+TEST(tlv_writer, deduplicate_payloads)
+{
+    auto vertices = std::vector<game::VertexData>(32u);
+    for (auto i = 0u; i < vertices.size(); ++i)
+    {
+        vertices[i].position = {static_cast<float>(i)};
+    }
+    const auto indices = std::vector<std::uint32_t>{0u, 1u, 2u};
+
+    auto texture = game::TextureDescription{
+        .name = "albedo",
+        .format = game::TextureFormat::RGBA,
+        .usage = game::TextureUsage::SRGB,
+        .width = 16u,
+        .height = 16u,
+        .data = std::vector<std::byte>(16u * 16u * 4u, std::byte{0x7f})};
+    auto copy = texture;
+    copy.name = "albedo_copy";
+
+    auto writer = game::TlvWriter{};
+    writer.set_deduplicate(true);
+
+    TEST_IMPL(
+        writer.write(texture);
+        writer.write(copy);
+        writer.write("mesh", {.vertices = vertices, .indices = indices});
+        writer.write("mesh_copy", {.vertices = vertices, .indices = indices});
+
+        ASSERT_EQ(writer.deduplicated_bytes(), texture.data.size() + vertices.size() * sizeof(game::VertexData));
+
+        const auto buffer = writer.yield();
+        const auto reader = game::TlvReader{buffer};
+
+        auto entry = std::ranges::begin(reader);
+        const auto first_texture = (*entry++).texture_description_value();
+        const auto second_texture = (*entry++).texture_description_value();
+        ASSERT_EQ(second_texture.name, "albedo_copy");
+        ASSERT_EQ(second_texture.data, first_texture.data);
+
+        const auto first_mesh = (*entry++).mesh_value();
+        const auto second_mesh = (*entry++).mesh_value();
+        ASSERT_EQ(entry, std::ranges::end(reader));
+
+        // the copy reads the payload of the first mesh
+        ASSERT_EQ(second_mesh.vertices.data(), first_mesh.vertices.data());
+        ASSERT_EQ(second_mesh.vertices[31].position, vertices[31].position);
+        ASSERT_TRUE(std::ranges::equal(second_mesh.indices, indices));
+
+    )
+}
+
+TEST(tlv_writer, deduplicate_keeps_distinct_payloads_of_same_size)
+{
+    auto texture = game::TextureDescription{
+        .name = "albedo",
+        .format = game::TextureFormat::RGBA,
+        .usage = game::TextureUsage::SRGB,
+        .width = 16u,
+        .height = 16u,
+        .data = std::vector<std::byte>(16u * 16u * 4u, std::byte{0x7f})};
+    auto other = texture;
+    other.name = "other";
+    other.data.back() = std::byte{0x80};
+
+    auto writer = game::TlvWriter{};
+    writer.set_deduplicate(true);
+
+    TEST_IMPL(
+        writer.write(texture);
+        writer.write(other);
+
+        ASSERT_EQ(writer.deduplicated_bytes(), 0u);
+
+        const auto buffer = writer.yield();
+        const auto reader = game::TlvReader{buffer};
+
+        auto entry = std::ranges::begin(reader);
+        ASSERT_EQ((*entry++).texture_description_value().data, texture.data);
+        ASSERT_EQ((*entry++).texture_description_value().data, other.data);
+        ASSERT_EQ(entry, std::ranges::end(reader));
+    )
+}
@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "math/matrix3x4.h"
+#include "math/matrix4.h"
+#include "math/quaternion.h"
+#include "math/transform.h"
+#include "math/transform_batch.h"
+#include "math/vector3.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto test_transform(float n) -> game::Transform
+    {
+        const auto half_angle = 0.1f * n;
+        const auto axis = game::Vector3::normalize({1.f, n, -2.f});
+        return {
+            {n, -2.f * n, 3.f + n},
+            {1.f + n, 2.f, 0.5f * n + 1.f},
+            {axis.x * std::sin(half_angle), axis.y * std::sin(half_angle), axis.z * std::sin(half_angle), std::cos(half_angle)}};
+    }
+}
+
+TEST(transform_batch, compose_matches_product)
+{
+    const auto transform = test_transform(3.f);
+
+    const auto expected = game::Matrix4{transform.position} * game::Matrix4{transform.rotation} * game::Matrix4{transform.scale, game::Matrix4::Scale{}};
+
+    expect_near(game::Matrix4::compose(transform.position, transform.rotation, transform.scale).data(), expected.data());
+    expect_near(game::Matrix4{transform}.data(), expected.data());
+}
+
+TEST(transform_batch, compose_constexpr)
+{
+    static constexpr auto m = game::Matrix4::compose({1.f, 2.f, 3.f}, {}, {2.f, 3.f, 4.f});
+
+    static_assert(m == game::Matrix4{game::Vector3{1.f, 2.f, 3.f}, game::Vector3{2.f, 3.f, 4.f}});
+}
+
+TEST(transform_batch, compose_batch)
+{
+    // not a multiple of four, so the tail is composed as well
+    auto batch = game::TransformBatch{};
+    for (auto i = 0u; i < 7u; ++i)
+    {
+        batch.add(test_transform(static_cast<float>(i)));
+    }
+
+    ASSERT_EQ(batch.size(), 7u);
+
+    auto models = std::vector<game::Matrix4>(batch.size());
+    batch.compose(models);
+
+    for (auto i = 0u; i < 7u; ++i)
+    {
+        expect_near(models[i].data(), game::Matrix4{test_transform(static_cast<float>(i))}.data());
+    }
+}
+
+TEST(transform_batch, compose_batch_matrix3x4)
+{
+    auto batch = game::TransformBatch{};
+    for (auto i = 0u; i < 7u; ++i)
+    {
+        batch.add(test_transform(static_cast<float>(i)));
+    }
+
+    auto models = std::vector<game::Matrix3x4>(batch.size());
+    batch.compose(models);
+
+    for (auto i = 0u; i < 7u; ++i)
+    {
+        expect_near(static_cast<game::Matrix4>(models[i]).data(), game::Matrix4{test_transform(static_cast<float>(i))}.data());
+    }
+}
+
+TEST(transform_batch, clear)
+{
+    auto batch = game::TransformBatch{};
+    batch.add(test_transform(1.f));
+    batch.clear();
+
+    ASSERT_EQ(batch.size(), 0u);
+
+    batch.add(test_transform(2.f));
+    auto models = std::vector<game::Matrix4>(1u);
+    batch.compose(models);
+
+    expect_near(models.front().data(), game::Matrix4{test_transform(2.f)}.data());
+}
@@ -0,0 +1,94 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "math/vector3.h"
+#include "math/vector3a.h"
+
+namespace
+{
+    constexpr auto vector_count = 10'000u;
+
+    auto test_vectors() -> std::vector<game::Vector3>
+    {
+        auto vectors = std::vector<game::Vector3>{};
+        for (auto i = 0u; i < vector_count; ++i)
+        {
+            const auto f = static_cast<float>(i);
+            vectors.push_back({f - 3.f, 2.f * f + 1.f, 0.5f - f});
+        }
+
+        return vectors;
+    }
+}
+
+static auto vector3_normalize(benchmark::State &state) -> void
+{
+    const auto vectors = test_vectors();
+    auto result = std::vector<game::Vector3>(vectors.size());
+
+    for (auto _ : state)
+    {
+        for (auto i = 0u; i < vectors.size(); ++i)
+        {
+            result[i] = game::Vector3::normalize(vectors[i]);
+        }
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(vector3_normalize);
+
+static auto vector3a_normalize(benchmark::State &state) -> void
+{
+    auto vectors = std::vector<game::Vector3A>{};
+    for (const auto &v : test_vectors())
+    {
+        vectors.push_back(game::Vector3A{v});
+    }
+    auto result = std::vector<game::Vector3A>(vectors.size());
+
+    for (auto _ : state)
+    {
+        game::Vector3A::normalize(vectors, result);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(vector3a_normalize);
+
+static auto vector3_dot(benchmark::State &state) -> void
+{
+    const auto vectors = test_vectors();
+    auto result = std::vector<float>(vectors.size());
+
+    for (auto _ : state)
+    {
+        for (auto i = 0u; i < vectors.size(); ++i)
+        {
+            result[i] = game::Vector3::dot(vectors[i], vectors[vectors.size() - i - 1u]);
+        }
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(vector3_dot);
+
+static auto vector3a_dot(benchmark::State &state) -> void
+{
+    auto vectors = std::vector<game::Vector3A>{};
+    for (const auto &v : test_vectors())
+    {
+        vectors.push_back(game::Vector3A{v});
+    }
+    const auto reversed = std::vector<game::Vector3A>(vectors.rbegin(), vectors.rend());
+    auto result = std::vector<float>(vectors.size());
+
+    for (auto _ : state)
+    {
+        game::Vector3A::dot(vectors, reversed, result);
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(vector3a_dot);
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "math/vector3.h"
+#include "math/vector3a.h"
+#include "utils/formatter.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto test_vectors(std::size_t count) -> std::vector<game::Vector3A>
+    {
+        auto vectors = std::vector<game::Vector3A>{};
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto f = static_cast<float>(i);
+            vectors.push_back({f - 3.f, 2.f * f + 1.f, 0.5f - f * f});
+        }
+
+        return vectors;
+    }
+
+    // rsqrt based normalize is approximate, so compare within the tolerance of expect_near, w included
+    auto floats(const game::Vector3A &v) -> std::span<const float>
+    {
+        return {&v.x, 4u};
+    }
+}
+
+TEST(vector3a, layout)
+{
+    ASSERT_EQ(sizeof(game::Vector3A), 16u);
+    ASSERT_EQ(alignof(game::Vector3A), 16u);
+}
+
+TEST(vector3a, all_components_ctor)
+{
+    const auto v = game::Vector3A{1.1f, 2.2f, 3.3f};
+    ASSERT_FLOAT_EQ(v.x, 1.1f);
+    ASSERT_FLOAT_EQ(v.y, 2.2f);
+    ASSERT_FLOAT_EQ(v.z, 3.3f);
+    ASSERT_FLOAT_EQ(v.w, 0.f);
+}
+
+TEST(vector3a, convert_vector3)
+{
+    const auto v = game::Vector3{1.f, -2.f, 3.f};
+
+    ASSERT_EQ(static_cast<game::Vector3>(game::Vector3A{v}), v);
+}
+
+TEST(vector3a, dot)
+{
+    const auto v1 = game::Vector3A{1.f, 2.f, 3.f};
+    const auto v2 = game::Vector3A{4.f, -5.f, 6.f};
+
+    ASSERT_FLOAT_EQ(game::Vector3A::dot(v1, v2), 12.f);
+}
+
+TEST(vector3a, cross)
+{
+    const auto v1 = game::Vector3{1.f, 2.f, 3.f};
+    const auto v2 = game::Vector3{4.f, -5.f, 6.f};
+
+    const auto result = game::Vector3A::cross(game::Vector3A{v1}, game::Vector3A{v2});
+
+    ASSERT_EQ(result, game::Vector3A{game::Vector3::cross(v1, v2)});
+}
+
+TEST(vector3a, normalize)
+{
+    const auto v = game::Vector3{1.f, 2.f, 3.f};
+
+    expect_near(floats(game::Vector3A::normalize(game::Vector3A{v})), floats(game::Vector3A{game::Vector3::normalize(v)}));
+}
+
+TEST(vector3a, normalize_zero)
+{
+    ASSERT_EQ(game::Vector3A::normalize({}), game::Vector3A{});
+}
+
+TEST(vector3a, normalize_subnormal)
+{
+    // the squared length is subnormal, the batch path has to agree with the single vector one
+    const auto tiny = std::vector<game::Vector3A>(5u, game::Vector3A{1e-20f, -1e-20f, 0.f});
+
+    auto result = std::vector<game::Vector3A>(tiny.size(), game::Vector3A{1.f});
+    game::Vector3A::normalize(tiny, result);
+
+    ASSERT_EQ(game::Vector3A::normalize(tiny.front()), game::Vector3A{});
+    for (const auto &v : result)
+    {
+        ASSERT_EQ(v, game::Vector3A{});
+    }
+}
+
+TEST(vector3a, length)
+{
+    ASSERT_FLOAT_EQ((game::Vector3A{2.f, 3.f, 6.f}).length(), 7.f);
+}
+
+TEST(vector3a, dot_batch)
+{
+    const auto v1 = test_vectors(11u);
+    auto v2 = test_vectors(11u);
+    std::ranges::reverse(v2);
+
+    auto result = std::vector<float>(v1.size());
+    game::Vector3A::dot(v1, v2, result);
+
+    for (auto i = 0u; i < v1.size(); ++i)
+    {
+        EXPECT_FLOAT_EQ(result[i], game::Vector3::dot(static_cast<game::Vector3>(v1[i]), static_cast<game::Vector3>(v2[i])));
+    }
+}
+
+TEST(vector3a, cross_batch)
+{
+    const auto v1 = test_vectors(7u);
+    auto v2 = test_vectors(7u);
+    std::ranges::reverse(v2);
+
+    auto result = std::vector<game::Vector3A>(v1.size());
+    game::Vector3A::cross(v1, v2, result);
+
+    for (auto i = 0u; i < v1.size(); ++i)
+    {
+        EXPECT_EQ(result[i], game::Vector3A{game::Vector3::cross(static_cast<game::Vector3>(v1[i]), static_cast<game::Vector3>(v2[i]))});
+    }
+}
+
+TEST(vector3a, normalize_batch)
+{
+    auto vectors = test_vectors(11u);
+    vectors[2] = {};
+    vectors[9] = {};
+
+    auto result = std::vector<game::Vector3A>(vectors.size());
+    game::Vector3A::normalize(vectors, result);
+
+    for (auto i = 0u; i < vectors.size(); ++i)
+    {
+        expect_near(floats(result[i]), floats(game::Vector3A{game::Vector3::normalize(static_cast<game::Vector3>(vectors[i]))}));
+    }
+}
+
+TEST(vector3a, normalize_batch_in_place)
+{
+    auto vectors = test_vectors(5u);
+    const auto expected = vectors;
+
+    game::Vector3A::normalize(vectors, vectors);
+
+    for (auto i = 0u; i < vectors.size(); ++i)
+    {
+        expect_near(floats(vectors[i]), floats(game::Vector3A{game::Vector3::normalize(static_cast<game::Vector3>(expected[i]))}));
+    }
+}
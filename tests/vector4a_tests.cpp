@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include "math/vector3.h"
+#include "math/vector4.h"
+#include "math/vector4a.h"
+#include "utils/formatter.h"
+
+#include "test_utils.h"
+
+namespace
+{
+    auto test_vectors(std::size_t count) -> std::vector<game::Vector4A>
+    {
+        auto vectors = std::vector<game::Vector4A>{};
+        for (auto i = 0u; i < count; ++i)
+        {
+            const auto f = static_cast<float>(i);
+            vectors.push_back({f - 3.f, 2.f * f + 1.f, 0.5f - f * f, f * 0.25f});
+        }
+
+        return vectors;
+    }
+
+    // rsqrt based normalize is approximate, so compare within the tolerance of expect_near
+    auto floats(const game::Vector4A &v) -> std::span<const float>
+    {
+        return {&v.x, 4u};
+    }
+}
+
+TEST(vector4a, layout)
+{
+    ASSERT_EQ(sizeof(game::Vector4A), 16u);
+    ASSERT_EQ(alignof(game::Vector4A), 16u);
+}
+
+TEST(vector4a, convert)
+{
+    const auto v = game::Vector4{1.f, -2.f, 3.f, 4.f};
+
+    ASSERT_EQ(static_cast<game::Vector4>(game::Vector4A{v}), v);
+    ASSERT_EQ(static_cast<game::Vector3>(game::Vector4A{v}), (game::Vector3{1.f, -2.f, 3.f}));
+    ASSERT_EQ((game::Vector4A{game::Vector3{1.f, -2.f, 3.f}, 4.f}), game::Vector4A{v});
+}
+
+TEST(vector4a, dot)
+{
+    const auto v1 = game::Vector4A{1.f, 2.f, 3.f, 4.f};
+    const auto v2 = game::Vector4A{4.f, -5.f, 6.f, 0.5f};
+
+    ASSERT_FLOAT_EQ(game::Vector4A::dot(v1, v2), 14.f);
+}
+
+TEST(vector4a, normalize)
+{
+    const auto v = game::Vector4{1.f, 2.f, 3.f, 4.f};
+
+    expect_near(floats(game::Vector4A::normalize(game::Vector4A{v})), floats(game::Vector4A{game::Vector4::normalize(v)}));
+}
+
+TEST(vector4a, normalize_zero)
+{
+    ASSERT_EQ(game::Vector4A::normalize({}), game::Vector4A{});
+}
+
+TEST(vector4a, normalize_subnormal)
+{
+    const auto tiny = std::vector<game::Vector4A>(5u, game::Vector4A{1e-20f, 0.f, -1e-20f, 1e-20f});
+
+    auto result = std::vector<game::Vector4A>(tiny.size(), game::Vector4A{1.f});
+    game::Vector4A::normalize(tiny, result);
+
+    ASSERT_EQ(game::Vector4A::normalize(tiny.front()), game::Vector4A{});
+    for (const auto &v : result)
+    {
+        ASSERT_EQ(v, game::Vector4A{});
+    }
+}
+
+TEST(vector4a, dot_batch)
+{
+    const auto v1 = test_vectors(11u);
+    auto v2 = test_vectors(11u);
+    std::ranges::reverse(v2);
+
+    auto result = std::vector<float>(v1.size());
+    game::Vector4A::dot(v1, v2, result);
+
+    for (auto i = 0u; i < v1.size(); ++i)
+    {
+        EXPECT_FLOAT_EQ(result[i], game::Vector4::dot(static_cast<game::Vector4>(v1[i]), static_cast<game::Vector4>(v2[i])));
+    }
+}
+
+TEST(vector4a, normalize_batch)
+{
+    auto vectors = test_vectors(11u);
+    vectors[5] = {};
+
+    auto result = std::vector<game::Vector4A>(vectors.size());
+    game::Vector4A::normalize(vectors, result);
+
+    for (auto i = 0u; i < vectors.size(); ++i)
+    {
+        expect_near(floats(result[i]), floats(game::Vector4A{game::Vector4::normalize(static_cast<game::Vector4>(vectors[i]))}));
+    }
+}
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log.h"
+#include "resources/concurrent_resource_cache.h"
+#include "resources/resource_cache.h"
+#include "resources/resource_id.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /** Stand-in for a cached resource, big enough to not share cache lines. */
+    struct Payload
+    {
+        std::uint64_t value;
+        std::array<std::uint64_t, 7u> padding;
+    };
+
+    /**
+     * Run the same lookup loop on several threads at once.
+     *
+     * @param thread_count
+     *   Number of threads.
+     *
+     * @param iterations
+     *   Lookups per thread.
+     *
+     * @param lookup
+     *   Called with the thread and iteration, returns the looked up payload value.
+     *
+     * @returns
+     *   Wall clock time until all threads finished.
+     */
+    auto run_threads(std::uint32_t thread_count, std::uint32_t iterations, const std::function<std::uint64_t(std::uint32_t, std::uint32_t)> &lookup) -> Clock::duration
+    {
+        auto checksum = std::atomic<std::uint64_t>{};
+        auto go = std::atomic<bool>{false};
+
+        auto threads = std::vector<std::jthread>{};
+        for (auto t = 0u; t < thread_count; ++t)
+        {
+            threads.emplace_back([&, t]
+                                 {
+                                     while (!go.load(std::memory_order_acquire))
+                                     {
+                                         std::this_thread::yield();
+                                     }
+
+                                     auto sum = std::uint64_t{};
+                                     for (auto i = 0u; i < iterations; ++i)
+                                     {
+                                         sum += lookup(t, i);
+                                     }
+                                     checksum.fetch_add(sum, std::memory_order_relaxed); });
+        }
+
+        const auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        threads.clear();
+
+        return Clock::now() - start;
+    }
+
+    auto to_mops(std::uint64_t ops, Clock::duration duration) -> double
+    {
+        return static_cast<double>(ops) / std::chrono::duration<double, std::micro>(duration).count();
+    }
+}
+
+auto main(int argc, char **argv) -> int
+{
+    try
+    {
+        game::log::info("cache benchmark");
+
+        const auto resource_count = argc >= 2 ? static_cast<std::uint32_t>(std::stoul(argv[1])) : 1000u;
+        const auto iterations = argc >= 3 ? static_cast<std::uint32_t>(std::stoul(argv[2])) : 1'000'000u;
+        const auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+        game::ensure(resource_count > 0u && iterations > 0u, "usage: ./{} [resources] [iterations per thread]", argv[0]);
+
+        auto ids = std::vector<game::ResourceId>{};
+        auto names = std::vector<std::string>{};
+        for (auto i = 0u; i < resource_count; ++i)
+        {
+            names.push_back(std::format("resource_{}", i));
+            ids.emplace_back(names.back());
+        }
+
+        // a ResourceCache can only be shared behind a lock, the game loads on a single thread so it has none of its own
+        auto locked_cache = game::ResourceCache<Payload>{};
+        auto mutex = std::mutex{};
+        auto concurrent_cache = game::ConcurrentResourceCache<Payload>{};
+        for (auto i = 0u; i < resource_count; ++i)
+        {
+            locked_cache.insert<Payload>(names[i], Payload{i, {}});
+            concurrent_cache.insert<Payload>(names[i], Payload{i, {}});
+        }
+
+        // spread the threads over the resources, so they do not all hammer the same bucket
+        const auto pick = [&](std::uint32_t t, std::uint32_t i)
+        { return ids[(i * 7u + t * 131u) % resource_count]; };
+
+        game::log::info("{} resources, {} lookups per thread, up to {} threads", resource_count, iterations, max_threads);
+
+        for (auto thread_count = 1u; thread_count <= max_threads; thread_count *= 2u)
+        {
+            const auto ops = static_cast<std::uint64_t>(iterations) * thread_count;
+
+            const auto mutex_time = run_threads(thread_count, iterations, [&](auto t, auto i)
+                                                {
+                                                    const auto lock = std::scoped_lock{mutex};
+                                                    return locked_cache.get<Payload>(pick(t, i))->value; });
+
+            const auto concurrent_time = run_threads(thread_count, iterations, [&](auto t, auto i)
+                                                     { return concurrent_cache.get<Payload>(pick(t, i))->value; });
+
+            // every thread asks for the same resources, each of them must be created only once
+            auto created = std::atomic<std::uint32_t>{};
+            auto get_or_create_cache = game::ConcurrentResourceCache<Payload>{};
+            const auto get_or_create_time = run_threads(thread_count, iterations, [&](auto, auto i)
+                                                        {
+                                                            const auto index = i % resource_count;
+                                                            return get_or_create_cache.get_or_create<Payload>(names[index], [&]
+                                                                                                              {
+                                                                                                                  created.fetch_add(1u, std::memory_order_relaxed);
+                                                                                                                  return Payload{index, {}}; })
+                                                                ->value; });
+            game::ensure(created == resource_count, "created {} resources instead of {}", created.load(), resource_count);
+
+            game::log::info(
+                "{:2} threads: mutex {:8.2f} Mops/s, concurrent {:8.2f} Mops/s, get_or_create {:8.2f} Mops/s",
+                thread_count,
+                to_mops(ops, mutex_time),
+                to_mops(ops, concurrent_time),
+                to_mops(ops, get_or_create_time));
+        }
+
+        game::log::info("done.");
+        return 0;
+    }
+    catch (const game::Exception &err)
+    {
+        game::log::info("{}", err);
+    }
+    catch (...)
+    {
+        game::log::info("unknown exception");
+    }
+
+    return 1;
+}
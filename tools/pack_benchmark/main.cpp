@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "file.h"
+#include "log.h"
+#include "resources/pack.h"
+#include "resources/resource_loader.h"
+#include "tlv/tlv_entry.h"
+#include "tlv/tlv_reader.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    // stride used to touch every page of a payload
+    constexpr auto page_size = 4096u;
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Walk every entry of a pack and touch every page of its payload, which is what loading all resources costs at
+     * the very least.
+     */
+    auto touch_all(const game::TlvReader &reader) -> std::uint64_t
+    {
+        auto checksum = std::uint64_t{};
+        for (const auto &entry : reader)
+        {
+            const auto value = entry.value();
+            for (auto offset = std::size_t{}; offset < value.size(); offset += page_size)
+            {
+                checksum += static_cast<std::uint64_t>(value[offset]);
+            }
+            checksum += entry.length();
+        }
+
+        return checksum;
+    }
+
+    auto to_ms(Clock::duration duration) -> double
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+auto main(int argc, char **argv) -> int
+{
+    try
+    {
+        game::log::info("pack benchmark");
+
+        game::ensure(argc >= 3, "usage: ./{} <pack> <work_dir> [iterations]", argv[0]);
+
+        const auto pack_path = std::filesystem::path{argv[1]};
+        const auto work_dir = std::filesystem::path{argv[2]};
+        const auto iterations = argc >= 4 ? std::stoul(argv[3]) : 10ul;
+        game::ensure(iterations > 0u, "need at least one iteration");
+
+        std::filesystem::create_directories(work_dir);
+
+        // every mode is benchmarked on the same TLV, whatever mode the source pack was written in
+        const auto source = game::Pack{game::ResourceLoader{pack_path.parent_path()}, pack_path.filename().string()};
+        const auto tlv = std::vector<std::byte>(std::ranges::cbegin(source.as_bytes()), std::ranges::cend(source.as_bytes()));
+        const auto expected_checksum = touch_all(game::TlvReader{tlv});
+
+        game::log::info("source {}: {} bytes of tlv, {} iterations", pack_path.string(), tlv.size(), iterations);
+        game::log::info("page cache is warm after the first iteration, drop caches between runs for cold numbers");
+
+        const auto loader = game::ResourceLoader{work_dir};
+
+        for (const auto mode : {game::PackMode::ZSTD, game::PackMode::ZSTD_CHUNKED, game::PackMode::ZSTD_FAST, game::PackMode::RAW})
+        {
+            const auto encode_start = Clock::now();
+            const auto encoded = game::encode_pack(tlv, mode);
+            const auto encode_time = Clock::now() - encode_start;
+
+            const auto name = std::format("pack_{}", mode);
+            std::filesystem::remove(work_dir / name);
+            {
+                auto out = game::File{work_dir / name, game::CreationMode::CREATE};
+                out.write(encoded);
+            }
+
+            auto times = std::vector<Clock::duration>{};
+            for (auto i = 0ul; i < iterations; ++i)
+            {
+                const auto start = Clock::now();
+
+                const auto pack = game::Pack{loader, name};
+                const auto checksum = touch_all(game::TlvReader{pack.as_bytes()});
+
+                times.push_back(Clock::now() - start);
+                game::ensure(checksum == expected_checksum, "{} pack does not match the source", mode);
+            }
+
+            std::ranges::sort(times);
+
+            game::log::info(
+                "{}: {} bytes ({:5.1f}%), encode {:8.1f} ms, open {:8.2f} ms min {:8.2f} ms median",
+                mode,
+                encoded.size(),
+                100.0 * static_cast<double>(encoded.size()) / static_cast<double>(tlv.size()),
+                to_ms(encode_time),
+                to_ms(times.front()),
+                to_ms(times[times.size() / 2u]));
+        }
+
+        game::log::info("done.");
+        return 0;
+    }
+    catch (const game::Exception &err)
+    {
+        game::log::info("{}", err);
+    }
+    catch (...)
+    {
+        game::log::info("unknown exception");
+    }
+
+    return 1;
+}
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <print>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "resources/pack.h"
+#include "resources/resource_loader.h"
+#include "tlv/tlv_entry.h"
+#include "tlv/tlv_reader.h"
+#include "utils/compress.h"
+#include "utils/ensure.h"
+#include "utils/exception.h"
+
+namespace
+{
+    struct InspectorOptions
+    {
+        bool json = false;
+
+        /** Largest entry the budget allows in bytes, 0 to not check. */
+        std::uint64_t budget = 0u;
+
+        std::optional<std::filesystem::path> out_path = std::nullopt;
+    };
+
+    /**
+     * Size report of a single top level entry of a pack.
+     */
+    struct AssetReport
+    {
+        std::string type;
+        std::string name;
+
+        /** Bytes the entry takes up in the TLV, header and padding included. */
+        std::uint64_t raw_size;
+
+        /** Bytes the entry takes up on disk, estimated by compressing it on its own for compressed packs. */
+        std::uint64_t compressed_size;
+
+        /** Members that are stored as an alias of an earlier payload, or 1 if the entry itself is an alias. */
+        std::uint32_t alias_count;
+
+        /** Payload bytes the aliases share with earlier entries instead of storing them again. */
+        std::uint64_t aliased_size;
+    };
+
+    struct PackReport
+    {
+        std::string path;
+        std::uint64_t file_size;
+        std::uint64_t tlv_size;
+        game::TlvFormat format;
+        bool mapped;
+        std::vector<AssetReport> assets;
+    };
+
+    auto is_composite(game::TlvType type) -> bool
+    {
+        switch (type)
+        {
+            using enum game::TlvType;
+        case TEXTURE_DESCRIPTION:
+        case MESH_DATA:
+        case OBJECT_SUB_MESH_NAMES:
+        case TEXT_FILE:
+        case SOUND_DATA:
+        case MESH_LOD:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * Every composite entry starts with its name.
+     */
+    auto entry_name(const game::TlvEntry &entry, game::TlvFormat format, std::span<const std::byte> pack) -> std::string
+    {
+        if (!is_composite(entry.type()))
+        {
+            return {};
+        }
+
+        const auto members = game::TlvReader{entry.value(), format, pack};
+        const auto first = std::ranges::begin(members);
+        if (first == std::ranges::end(members) || (*first).type() != game::TlvType::STRING)
+        {
+            return {};
+        }
+
+        return (*first).string_value();
+    }
+
+    /**
+     * Count the aliases among the members of a composite entry. The reader resolves aliases transparently, but a
+     * resolved alias still gives itself away as its payload lies outside of the composite it was read from.
+     */
+    auto count_aliases(const game::TlvEntry &entry, game::TlvFormat format, std::span<const std::byte> pack, AssetReport &report) -> void
+    {
+        const auto payload = entry.value();
+        const auto payload_begin = payload.data() - pack.data();
+        const auto payload_end = payload_begin + std::ssize(payload);
+
+        for (const auto &member : game::TlvReader{payload, format, pack})
+        {
+            const auto value = member.value();
+            const auto value_begin = value.data() - pack.data();
+
+            if (!value.empty() && (value_begin < payload_begin || value_begin >= payload_end))
+            {
+                ++report.alias_count;
+                report.aliased_size += value.size();
+            }
+            else if (is_composite(member.type()))
+            {
+                count_aliases(member, format, pack, report);
+            }
+        }
+    }
+
+    auto inspect(const std::filesystem::path &pack_path) -> PackReport
+    {
+        const auto pack = game::Pack{game::ResourceLoader{pack_path.parent_path()}, pack_path.filename().string()};
+        const auto tlv = pack.as_bytes();
+        const auto reader = game::TlvReader{tlv};
+
+        auto report = PackReport{
+            .path = pack_path.string(),
+            .file_size = std::filesystem::file_size(pack_path),
+            .tlv_size = tlv.size(),
+            .format = reader.format(),
+            .mapped = pack.is_mapped(),
+            .assets = {}};
+
+        // end of the furthest payload so far, the reader resolves a top level alias to a payload before it
+        auto payload_end = tlv.data();
+
+        for (auto entry : reader)
+        {
+            const auto payload = entry.value();
+            const auto is_alias = !payload.empty() && payload.data() < payload_end;
+
+            auto asset = AssetReport{
+                .type = entry.to_string(),
+                .name = entry_name(entry, report.format, tlv),
+                .raw_size = entry.size(),
+                .compressed_size = entry.size(),
+                .alias_count = 0u,
+                .aliased_size = 0u};
+
+            if (is_alias)
+            {
+                // both sizes are those of the alias itself, its payload is already counted for the target
+                asset.alias_count = 1u;
+                asset.aliased_size = payload.size();
+            }
+            else
+            {
+                payload_end = std::max(payload_end, payload.data() + payload.size());
+
+                if (!report.mapped)
+                {
+                    asset.compressed_size = game::compress(payload).size();
+                }
+
+                if (is_composite(entry.type()))
+                {
+                    count_aliases(entry, report.format, tlv, asset);
+                }
+            }
+
+            report.assets.push_back(std::move(asset));
+        }
+
+        std::ranges::sort(report.assets, std::ranges::greater{}, &AssetReport::raw_size);
+
+        return report;
+    }
+
+    auto share(std::uint64_t size, std::uint64_t total) -> double
+    {
+        return total == 0u ? 0.0 : 100.0 * static_cast<double>(size) / static_cast<double>(total);
+    }
+
+    auto is_over_budget(const AssetReport &asset, const InspectorOptions &options) -> bool
+    {
+        return options.budget != 0u && asset.raw_size > options.budget;
+    }
+
+    auto json_escape(std::string_view str) -> std::string
+    {
+        auto escaped = std::string{};
+        escaped.reserve(str.size());
+
+        for (const auto c : str)
+        {
+            switch (c)
+            {
+            case '"':
+                escaped += "\\\"";
+                break;
+            case '\\':
+                escaped += "\\\\";
+                break;
+            case '\n':
+                escaped += "\\n";
+                break;
+            case '\r':
+                escaped += "\\r";
+                break;
+            case '\t':
+                escaped += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20u)
+                {
+                    escaped += std::format("\\u{:04x}", static_cast<unsigned>(c));
+                }
+                else
+                {
+                    escaped += c;
+                }
+                break;
+            }
+        }
+
+        return escaped;
+    }
+
+    auto format_table(const PackReport &report, const InspectorOptions &options) -> std::string
+    {
+        auto out = std::format(
+            "{}: {} bytes on disk, {} bytes of tlv v{} aligned to {}, {}\n\n",
+            report.path,
+            report.file_size,
+            report.tlv_size,
+            std::to_underlying(report.format.version),
+            report.format.alignment,
+            report.mapped ? "raw" : "compressed");
+
+        out += std::format(
+            "{:<24} {:<48} {:>12} {:>12} {:>7} {:>8} {:>12}\n", "type", "name", "raw", "compressed", "share", "aliases", "aliased");
+
+        // totals per type, ordered by name so the summary is stable between runs
+        auto type_totals = std::map<std::string, std::pair<std::uint64_t, std::uint64_t>>{};
+        auto aliased_total = std::uint64_t{};
+
+        for (const auto &asset : report.assets)
+        {
+            out += std::format(
+                "{:<24} {:<48} {:>12} {:>12} {:>6.2f}% {:>8} {:>12}{}\n",
+                asset.type,
+                asset.name,
+                asset.raw_size,
+                asset.compressed_size,
+                share(asset.raw_size, report.tlv_size),
+                asset.alias_count,
+                asset.aliased_size,
+                is_over_budget(asset, options) ? " over budget" : "");
+
+            auto &[raw, compressed] = type_totals[asset.type];
+            raw += asset.raw_size;
+            compressed += asset.compressed_size;
+            aliased_total += asset.aliased_size;
+        }
+
+        out += "\n";
+        for (const auto &[type, totals] : type_totals)
+        {
+            const auto &[raw, compressed] = totals;
+            out += std::format("{:<24} {:<48} {:>12} {:>12} {:>6.2f}%\n", type, "total", raw, compressed, share(raw, report.tlv_size));
+        }
+
+        out += std::format("\n{} entries, {} bytes shared through aliases\n", report.assets.size(), aliased_total);
+
+        return out;
+    }
+
+    auto format_json(const PackReport &report, const InspectorOptions &options) -> std::string
+    {
+        auto out = std::format(
+            "{{\n  \"path\": \"{}\",\n  \"file_size\": {},\n  \"tlv_size\": {},\n  \"version\": {},\n  \"alignment\": {},\n"
+            "  \"mapped\": {},\n  \"budget\": {},\n  \"assets\": [",
+            json_escape(report.path),
+            report.file_size,
+            report.tlv_size,
+            std::to_underlying(report.format.version),
+            report.format.alignment,
+            report.mapped,
+            options.budget);
+
+        for (const auto &[index, asset] : std::views::enumerate(report.assets))
+        {
+            out += std::format(
+                "{}\n    {{\"type\": \"{}\", \"name\": \"{}\", \"raw_size\": {}, \"compressed_size\": {}, \"share\": {:.4f}, "
+                "\"alias_count\": {}, \"aliased_size\": {}, \"over_budget\": {}}}",
+                index == 0 ? "" : ",",
+                asset.type,
+                json_escape(asset.name),
+                asset.raw_size,
+                asset.compressed_size,
+                share(asset.raw_size, report.tlv_size),
+                asset.alias_count,
+                asset.aliased_size,
+                is_over_budget(asset, options));
+        }
+
+        out += "\n  ]\n}\n";
+
+        return out;
+    }
+}
+
+auto main(int argc, char **argv) -> int
+{
+    try
+    {
+        game::ensure(argc >= 2, "usage: ./{} <pack> [--json] [--budget=<bytes>] [--out=<path>]", argv[0]);
+
+        auto options = InspectorOptions{};
+        for (const auto arg : std::span{argv + 2, argv + argc} | std::views::transform([](const char *a)
+                                                                                      { return std::string_view{a}; }))
+        {
+            if (arg == "--json")
+            {
+                options.json = true;
+            }
+            else if (arg.starts_with("--budget="))
+            {
+                options.budget = std::stoull(std::string{arg.substr(std::string_view{"--budget="}.size())});
+            }
+            else if (arg.starts_with("--out="))
+            {
+                options.out_path = std::filesystem::path{arg.substr(std::string_view{"--out="}.size())};
+            }
+            else
+            {
+                throw game::Exception("unknown option {}", arg);
+            }
+        }
+
+        const auto report = inspect(argv[1]);
+        const auto output = options.json ? format_json(report, options) : format_table(report, options);
+
+        if (options.out_path)
+        {
+            auto out = std::ofstream{*options.out_path, std::ios::binary};
+            game::ensure(!!out, "could not open {}", options.out_path->string());
+            out << output;
+        }
+        else
+        {
+            std::print("{}", output);
+        }
+
+        // the report may go to stdout, so budget violations are listed on stderr where a build still sees them
+        auto over_budget = false;
+        for (const auto &asset : report.assets)
+        {
+            if (is_over_budget(asset, options))
+            {
+                std::println(std::cerr, "{} {} is {} bytes, over the budget of {} bytes", asset.type, asset.name, asset.raw_size, options.budget);
+                over_budget = true;
+            }
+        }
+
+        return over_budget ? 2 : 0;
+    }
+    catch (const game::Exception &err)
+    {
+        std::println(std::cerr, "{}", err);
+    }
+    catch (...)
+    {
+        std::println(std::cerr, "unknown exception");
+    }
+
+    return 1;
+}
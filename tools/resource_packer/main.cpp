@@ -1,13 +1,18 @@
 #include <algorithm>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <set>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 #include <assimp/Importer.hpp>
@@ -21,18 +26,54 @@
 #include <stb_image.h>
 
 #include "file.h"
+#include "graphics/mesh_bounds.h"
 #include "graphics/mesh_data.h"
+#include "graphics/texture.h"
 #include "graphics/vertex_data.h"
 #include "log.h"
 #include "math/vector3.h"
+#include "packer/block_compression.h"
+#include "packer/image_resize.h"
+#include "packer/mesh_optimizer.h"
+#include "packer/mesh_simplifier.h"
+#include "packer/mip_chain.h"
+#include "packer/vertex_quantizer.h"
+#include "resources/pack.h"
+#include "resources/pack_manifest.h"
 #include "tlv/tlv_writer.h"
 #include "utils/auto_release.h"
-#include "utils/compress.h"
 #include "utils/ensure.h"
 #include "utils/exception.h"
 
 namespace
 {
+    /** Assets packed into a pack of their own, mounted only while the level is running. */
+    struct LevelPack
+    {
+        std::string level_name;
+        std::string asset_dir;
+    };
+
+    struct PackerOptions
+    {
+        bool raw_textures = false;
+        bool bc3_alpha = false;
+
+        /** Pack meshes as imported. Levels of detail are only generated from optimised meshes, so this implies no_lods. */
+        bool raw_meshes = false;
+
+        bool compact_vertices = false;
+        bool no_lods = false;
+        bool no_dedup = false;
+        bool no_texture_tiers = false;
+        game::TlvFormat tlv_format = {};
+        game::PackMode pack_mode = game::PackMode::ZSTD;
+        std::vector<LevelPack> level_packs = {};
+    };
+
+    // levels of detail generated per mesh, not counting the full detail mesh
+    constexpr auto max_lod_levels = 4u;
+
     auto to_texture_format(int num_channels) -> game::TextureFormat
     {
         switch (num_channels)
@@ -62,6 +103,84 @@ namespace
         throw game::Exception("unsupported usage type: {}", path);
     }
 
+    auto is_normal_map(std::string_view asset_name) -> bool
+    {
+        const auto lower = asset_name |
+                           std::views::transform([](auto c)
+                                                 { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }) |
+                           std::ranges::to<std::string>();
+        return lower.contains("normal");
+    }
+
+    /**
+     * Pick the format a texture is stored in. Colour data is compressed with BC1 (or BC7/BC3 when it has alpha),
+     * normal maps use BC5 which keeps x and y in two independent channels, everything else stays uncompressed.
+     */
+    auto select_texture_format(int num_channels, game::TextureUsage usage, std::string_view asset_name, const PackerOptions &options)
+        -> game::TextureFormat
+    {
+        if (options.raw_textures || num_channels == 1)
+        {
+            return to_texture_format(num_channels);
+        }
+
+        if (is_normal_map(asset_name))
+        {
+            return game::TextureFormat::BC5;
+        }
+
+        if (usage == game::TextureUsage::DATA)
+        {
+            return to_texture_format(num_channels);
+        }
+
+        if (num_channels == 4)
+        {
+            return options.bc3_alpha ? game::TextureFormat::BC3 : game::TextureFormat::BC7;
+        }
+
+        return game::TextureFormat::BC1;
+    }
+
+    /**
+     * Build the description of a texture, block compressed formats are encoded with their full mip chain.
+     */
+    auto encode_texture(
+        const std::string &name,
+        game::TextureFormat format,
+        game::TextureUsage usage,
+        std::span<const std::byte> pixels,
+        std::uint32_t width,
+        std::uint32_t height,
+        std::uint32_t num_channels) -> game::TextureDescription
+    {
+        auto tex_data = game::TextureDescription{
+            .name = name,
+            .format = format,
+            .usage = usage,
+            .width = width,
+            .height = height,
+            .data = pixels | std::ranges::to<std::vector>(),
+            .mip_levels = 1u};
+
+        if (game::is_block_compressed(format))
+        {
+            // the gpu cannot generate mips for compressed textures, so encode the whole chain here
+            const auto mips = game::packer::generate_mip_chain(game::packer::expand_to_rgba(pixels, num_channels), width, height, usage == game::TextureUsage::SRGB);
+
+            tex_data.data.clear();
+            for (const auto &mip : mips)
+            {
+                tex_data.data.append_range(game::packer::encode(format, mip.data, mip.width, mip.height));
+            }
+            tex_data.mip_levels = static_cast<std::uint32_t>(mips.size());
+
+            game::log::info("encoded: {} as {} {} -> {} bytes ({} mips)", name, format, pixels.size(), tex_data.data.size(), tex_data.mip_levels);
+        }
+
+        return tex_data;
+    }
+
     template <class... Args>
     std::vector<game::VertexData> vertices(Args &&...args)
     {
@@ -112,8 +231,9 @@ namespace
 
 }
 
-auto write_texture(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, game::TlvWriter &writer) -> void;
-auto write_mesh(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, game::TlvWriter &writer) -> void;
+auto write_pack(const std::string &asset_dir, const std::filesystem::path &out_path, const PackerOptions &options) -> void;
+auto write_texture(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, const PackerOptions &options, game::TlvWriter &writer) -> void;
+auto write_mesh(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, const PackerOptions &options, game::TlvWriter &writer) -> void;
 auto write_text_file(const std::string &path, const std::string &file_name, game::TlvWriter &writer) -> void;
 auto write_sound_file(const std::string &path, const std::string &file_name, game::TlvWriter &writer) -> void;
 
@@ -123,60 +243,111 @@ auto main(int argc, char **argv) -> int
     {
         game::log::info("resource packer");
 
-        game::ensure(argc == 3, "usage: ./{} <asset_dir> <out_path>", argv[0]);
-
-        const auto image_extensions = std::set<std::string>{".png", ".jpg"};
-        const auto mesh_extensions = std::set<std::string>{".fbx", ".obj"};
-        const auto text_file_extensions = std::set<std::string>{".vert", ".frag", ".lua"};
-        const auto sound_file_extensions = std::set<std::string>{".wav"};
-
-        game::log::info("packing {} into {}", std::string{argv[1]}, std::string{argv[2]});
-
-        auto writer = game::TlvWriter{};
+        game::ensure(argc >= 3, "usage: ./{} <asset_dir> <out_path> [--raw-textures] [--bc3-alpha] [--raw-meshes] [--compact-vertices] [--no-lods] [--no-dedup] [--no-texture-tiers] [--tlv-v1] [--align-64] [--pack=zstd|zstd-chunked|zstd-fast|raw] [--level=<level script>=<asset_dir>]...", argv[0]);
 
-        auto files = std::filesystem::directory_iterator{argv[1]} | std::ranges::to<std::vector>();
-        std::ranges::sort(files, [](const auto &a, const auto &b)
-                          { return a.path() <= b.path(); });
-
-        for (const auto &entry : files)
+        auto options = PackerOptions{};
+        for (const auto arg : std::span{argv + 3, argv + argc} | std::views::transform([](const char *a)
+                                                                                      { return std::string_view{a}; }))
         {
-            const auto path = entry.path().string();
-            const auto file_name = entry.path().filename().string();
-
-            const auto ext = entry.path().extension().string();
-            const auto dot_idx = file_name.find(".");
-            const auto asset_name = dot_idx != std::string::npos ? file_name.substr(0, dot_idx) : file_name;
-
-            if (image_extensions.contains(ext))
+            if (arg == "--raw-textures")
             {
-                write_texture(path, asset_name, ext, file_name, writer);
-                continue;
+                options.raw_textures = true;
             }
-            if (mesh_extensions.contains(ext))
+            else if (arg == "--bc3-alpha")
             {
-                write_mesh(path, asset_name, ext, file_name, writer);
-                continue;
+                options.bc3_alpha = true;
             }
-            if (text_file_extensions.contains(ext))
+            else if (arg == "--raw-meshes")
             {
-                write_text_file(path, file_name, writer);
-                continue;
+                options.raw_meshes = true;
             }
-            if (sound_file_extensions.contains(ext))
+            else if (arg == "--compact-vertices")
             {
-                write_sound_file(path, file_name, writer);
+                options.compact_vertices = true;
             }
+            else if (arg == "--no-lods")
+            {
+                options.no_lods = true;
+            }
+            else if (arg == "--no-dedup")
+            {
+                options.no_dedup = true;
+            }
+            else if (arg == "--no-texture-tiers")
+            {
+                options.no_texture_tiers = true;
+            }
+            else if (arg == "--tlv-v1")
+            {
+                options.tlv_format.version = game::TlvVersion::V1;
+            }
+            else if (arg == "--align-64")
+            {
+                options.tlv_format.alignment = 64u;
+            }
+            else if (arg == "--pack=zstd")
+            {
+                options.pack_mode = game::PackMode::ZSTD;
+            }
+            else if (arg == "--pack=zstd-chunked")
+            {
+                options.pack_mode = game::PackMode::ZSTD_CHUNKED;
+            }
+            else if (arg == "--pack=zstd-fast")
+            {
+                options.pack_mode = game::PackMode::ZSTD_FAST;
+            }
+            else if (arg == "--pack=raw")
+            {
+                options.pack_mode = game::PackMode::RAW;
+            }
+            else if (arg.starts_with("--level="))
+            {
+                // split at the first '=', a level script name has none but a path may
+                const auto level = arg.substr(std::string_view{"--level="}.size());
+                const auto split = level.find('=');
+                game::ensure(split != std::string_view::npos && split != 0u && split + 1u < level.size(), "expected --level=<level script>=<asset_dir>: {}", arg);
+
+                options.level_packs.push_back({.level_name = std::string{level.substr(0u, split)}, .asset_dir = std::string{level.substr(split + 1u)}});
+            }
+            else
+            {
+                throw game::Exception("unknown option: {}", arg);
+            }
+        }
+
+        if (options.raw_meshes && !options.no_lods)
+        {
+            game::log::warn("--raw-meshes implies --no-lods, meshes are packed without levels of detail");
+            options.no_lods = true;
         }
-        const auto resource_data = writer.yield();
 
-        game::log::info("compressing....");
+        const auto out_path = std::filesystem::path{argv[2]};
+        write_pack(argv[1], out_path, options);
 
-        const auto compressed = game::compress(resource_data);
+        if (!options.level_packs.empty())
+        {
+            // level packs and the manifest go next to the base pack, the game resolves them all against one root
+            auto manifest = game::PackManifest{.base = out_path.filename().string()};
 
-        game::log::info("writing resource {} -> {} bytes", resource_data.size(), compressed.size());
+            for (const auto &[level_name, asset_dir] : options.level_packs)
+            {
+                const auto pack_name = std::filesystem::path{level_name}.stem().string();
+                game::ensure(pack_name != manifest.base, "level {} would overwrite the base pack", level_name);
 
-        game::File out{argv[2], game::CreationMode::CREATE};
-        out.write(compressed);
+                write_pack(asset_dir, out_path.parent_path() / pack_name, options);
+
+                const auto [iter, inserted] = manifest.level_packs.emplace(level_name, pack_name);
+                game::ensure(inserted, "level {} already has a pack", level_name);
+            }
+
+            const auto manifest_path = out_path.parent_path() / "manifest";
+            auto manifest_file = std::ofstream{manifest_path, std::ios::binary};
+            manifest_file << game::write_pack_manifest(manifest);
+            game::ensure(manifest_file.good(), "failed to write manifest {}", manifest_path.string());
+
+            game::log::info("wrote manifest {} with {} level packs", manifest_path.string(), manifest.level_packs.size());
+        }
 
         game::log::info("done.");
         return 0;
@@ -193,7 +364,62 @@ auto main(int argc, char **argv) -> int
     return 1;
 }
 
-auto write_texture(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, game::TlvWriter &writer) -> void
+auto write_pack(const std::string &asset_dir, const std::filesystem::path &out_path, const PackerOptions &options) -> void
+{
+    const auto image_extensions = std::set<std::string>{".png", ".jpg"};
+    const auto mesh_extensions = std::set<std::string>{".fbx", ".obj"};
+    const auto text_file_extensions = std::set<std::string>{".vert", ".frag", ".lua"};
+    const auto sound_file_extensions = std::set<std::string>{".wav"};
+
+    game::log::info("packing {} into {}", asset_dir, out_path.string());
+
+    // entries go straight to the output as they are written, so memory use does not grow with the pack
+    const auto sink = game::create_pack_sink(out_path, options.pack_mode);
+    auto writer = game::TlvWriter{options.tlv_format, *sink};
+    writer.set_deduplicate(!options.no_dedup);
+    game::log::info("writing {} pack", options.pack_mode);
+    game::log::info("writing tlv v{} with {} byte alignment", std::to_underlying(writer.format().version), writer.format().alignment);
+
+    auto files = std::filesystem::directory_iterator{asset_dir} | std::ranges::to<std::vector>();
+    std::ranges::sort(files, [](const auto &a, const auto &b)
+                      { return a.path() <= b.path(); });
+
+    for (const auto &entry : files)
+    {
+        const auto path = entry.path().string();
+        const auto file_name = entry.path().filename().string();
+
+        const auto ext = entry.path().extension().string();
+        const auto dot_idx = file_name.find(".");
+        const auto asset_name = dot_idx != std::string::npos ? file_name.substr(0, dot_idx) : file_name;
+
+        if (image_extensions.contains(ext))
+        {
+            write_texture(path, asset_name, ext, file_name, options, writer);
+            continue;
+        }
+        if (mesh_extensions.contains(ext))
+        {
+            write_mesh(path, asset_name, ext, file_name, options, writer);
+            continue;
+        }
+        if (text_file_extensions.contains(ext))
+        {
+            write_text_file(path, file_name, writer);
+            continue;
+        }
+        if (sound_file_extensions.contains(ext))
+        {
+            write_sound_file(path, file_name, writer);
+        }
+    }
+    writer.finish();
+
+    game::log::info("writing resource {} -> {} bytes", writer.size(), std::filesystem::file_size(out_path));
+    game::log::info("deduplicated {} bytes of identical payloads", writer.deduplicated_bytes());
+}
+
+auto write_texture(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, const PackerOptions &options, game::TlvWriter &writer) -> void
 {
     auto w = int{};
     auto h = int{};
@@ -217,18 +443,38 @@ auto write_texture(const std::string &path, const std::string &asset_name, const
     auto s = std::span<const std::byte>{reinterpret_cast<const std::byte *>(raw_data.get()), static_cast<size_t>(num_bytes)};
     v.assign(s.begin(), s.end());
 
-    auto tex_data = game::TextureDescription{
-        .name = asset_name,
-        .format = to_texture_format(num_channels),
-        .usage = to_texture_usage(file_name),
-        .width = static_cast<std::uint32_t>(w),
-        .height = static_cast<std::uint32_t>(h),
-        .data = v};
+    const auto usage = to_texture_usage(file_name);
+    const auto format = select_texture_format(num_channels, usage, asset_name, options);
 
+    auto tex_data = encode_texture(asset_name, format, usage, v, static_cast<std::uint32_t>(w), static_cast<std::uint32_t>(h), static_cast<std::uint32_t>(num_channels));
     writer.write(tex_data);
+
+    if (options.no_texture_tiers)
+    {
+        return;
+    }
+
+    // every tier is filtered from the source, not from the tier above it
+    for (auto tier = 1u; tier < game::texture_tier_count; ++tier)
+    {
+        const auto tier_width = tex_data.width >> tier;
+        const auto tier_height = tex_data.height >> tier;
+        if (std::min(tier_width, tier_height) < 4u)
+        {
+            break;
+        }
+
+        const auto pixels = game::packer::downscale_image(
+            v, tex_data.width, tex_data.height, static_cast<std::uint32_t>(num_channels), tier_width, tier_height, usage == game::TextureUsage::SRGB);
+
+        auto tier_data = encode_texture(
+            game::texture_tier_name(asset_name, tier), format, usage, pixels, tier_width, tier_height, static_cast<std::uint32_t>(num_channels));
+        game::log::info("tier: {} {}x{} -> {} bytes", tier_data.name, tier_width, tier_height, tier_data.data.size());
+        writer.write(tier_data);
+    }
 }
 
-auto write_mesh(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, game::TlvWriter &writer) -> void
+auto write_mesh(const std::string &path, const std::string &asset_name, const std::string &ext, const std::string &file_name, const PackerOptions &options, game::TlvWriter &writer) -> void
 {
     auto stream = ::aiGetPredefinedLogStream(::aiDefaultLogStream_STDOUT, NULL);
     ::aiAttachLogStream(&stream);
@@ -248,7 +494,13 @@ auto write_mesh(const std::string &path, const std::string &asset_name, const st
 
     game::log::info("packing: {} from {} {} - {} sub_meshes", asset_name, file_name, ext, mesh_names.size());
 
-    writer.write(asset_name, mesh_names);
+    // the object entry follows its sub-meshes, so it can carry their merged bounds
+    auto object_bounds = std::optional<game::MeshBounds>{};
+    const auto write_sub_mesh = [&](const char *name, const game::MeshData &data)
+    {
+        object_bounds = object_bounds ? game::merge(*object_bounds, *data.bounds) : *data.bounds;
+        writer.write(name, data);
+    };
 
     for (const auto *mesh : loaded_meshes)
     {
@@ -282,8 +534,82 @@ auto write_mesh(const std::string &path, const std::string &asset_name, const st
         game::log::info("packing: {} from {} {} - {} verts, {} indices", mesh->mName.C_Str(), file_name, ext, verts.size(), indices.size());
 
         const auto vertex_data = vertices(verts, normals, tangents, texture_coords);
-        writer.write(mesh->mName.C_Str(), {vertex_data, indices});
+
+        auto optimized = game::packer::OptimizedMesh{.vertices = vertex_data, .indices = indices};
+        auto short_indices = std::optional<std::vector<std::uint16_t>>{};
+
+        if (!options.raw_meshes)
+        {
+            const auto before = game::packer::analyze_vertex_cache(indices, vertex_data.size());
+            optimized = game::packer::optimize_mesh(vertex_data, indices);
+            const auto after = game::packer::analyze_vertex_cache(optimized.indices, optimized.vertices.size());
+
+            game::log::info("optimized: {} - {} -> {} verts, {} -> {}", mesh->mName.C_Str(), vertex_data.size(), optimized.vertices.size(), before, after);
+
+            short_indices = game::packer::to_short_indices(optimized.indices);
+        }
+
+        auto mesh_data = short_indices ? game::MeshData{.vertices = optimized.vertices, .indices = {}, .short_indices = *short_indices}
+                                       : game::MeshData{.vertices = optimized.vertices, .indices = optimized.indices};
+
+        // coarser levels share the vertices, so they use the same index width as the full detail mesh
+        auto lods = std::vector<game::packer::SimplifiedMesh>{};
+        auto short_lod_indices = std::vector<std::vector<std::uint16_t>>{};
+        if (!options.no_lods)
+        {
+            lods = game::packer::generate_lod_chain(optimized.vertices, optimized.indices, max_lod_levels);
+            short_lod_indices.reserve(lods.size());
+
+            for (const auto &lod : lods)
+            {
+                if (short_indices)
+                {
+                    short_lod_indices.push_back(*game::packer::to_short_indices(lod.indices));
+                    mesh_data.lods.push_back({.indices = {}, .short_indices = short_lod_indices.back(), .error = lod.error});
+                }
+                else
+                {
+                    mesh_data.lods.push_back({.indices = lod.indices, .short_indices = {}, .error = lod.error});
+                }
+
+                game::log::info("lod: {} - {} -> {} indices, error {}", mesh->mName.C_Str(), optimized.indices.size(), lod.indices.size(), lod.error);
+            }
+        }
+
+        mesh_data.bounds = game::compute_bounds(mesh_data);
+        game::log::info("bounds: {} - {} {}, radius {}", mesh->mName.C_Str(), mesh_data.bounds->min, mesh_data.bounds->max, mesh_data.bounds->radius);
+
+        if (!options.compact_vertices)
+        {
+            write_sub_mesh(mesh->mName.C_Str(), mesh_data);
+            continue;
+        }
+
+        const auto quantized = game::packer::quantize_vertices(optimized.vertices);
+        const auto error = game::packer::measure_quantization_error(optimized.vertices, quantized);
+
+        game::log::info(
+            "compacted: {} - {} -> {} bytes, max error {}",
+            mesh->mName.C_Str(),
+            std::span{optimized.vertices}.size_bytes(),
+            std::span{quantized.vertices}.size_bytes(),
+            error);
+
+        mesh_data.vertices = {};
+        mesh_data.compact_vertices = quantized.vertices;
+        mesh_data.quantization = quantized.quantization;
+
+        // rounding can move positions slightly, so the bounds have to cover the dequantised vertices
+        mesh_data.bounds = game::compute_bounds(mesh_data);
+        write_sub_mesh(mesh->mName.C_Str(), mesh_data);
     }
+
+    if (object_bounds)
+    {
+        game::log::info("bounds: {} - {} {}, radius {}", asset_name, object_bounds->min, object_bounds->max, object_bounds->radius);
+    }
+
+    writer.write(asset_name, mesh_names, object_bounds);
 }
 
 auto write_text_file(const std::string &path, const std::string &file_name, game::TlvWriter &writer) -> void